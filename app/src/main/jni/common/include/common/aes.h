@@ -0,0 +1,100 @@
+/*
+ * common - AES Block Cipher
+ *
+ * AES-128/192/256 with CBC mode. The key schedule is expanded once into a
+ * common_aes_key_t and reused; block processing uses AES-NI or the ARMv8
+ * AES instructions when available and a table-driven C path otherwise.
+ */
+
+#ifndef COMMON_AES_H
+#define COMMON_AES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COMMON_AES_BLOCK_SIZE    16
+#define COMMON_AES_MAX_ROUNDS    14
+
+// ============================================================================
+// Key Schedule
+// ============================================================================
+
+// Round keys are stored as bytes in cipher order so every backend can load
+// them directly. dec_keys holds the equivalent-inverse-cipher schedule.
+typedef struct {
+    uint8_t enc_keys[(COMMON_AES_MAX_ROUNDS + 1) * 16] __attribute__((aligned(16)));
+    uint8_t dec_keys[(COMMON_AES_MAX_ROUNDS + 1) * 16] __attribute__((aligned(16)));
+    uint32_t rounds;              // 10, 12 or 14
+} common_aes_key_t;
+
+/**
+ * Expand a 16, 24 or 32 byte key
+ * @return 0 on success, -1 for an unsupported key length
+ */
+int common_aes_set_key(common_aes_key_t* key, const uint8_t* raw_key, size_t key_len);
+
+/**
+ * Wipe an expanded key
+ */
+void common_aes_clear_key(common_aes_key_t* key);
+
+// ============================================================================
+// Block and CBC Operations
+// ============================================================================
+
+void common_aes_encrypt_block(const common_aes_key_t* key,
+                              const uint8_t input[16], uint8_t output[16]);
+void common_aes_decrypt_block(const common_aes_key_t* key,
+                              const uint8_t input[16], uint8_t output[16]);
+
+/**
+ * CBC encrypt len bytes (a multiple of 16). input and output may alias.
+ * iv is updated to the last ciphertext block so calls can be chained.
+ */
+void common_aes_cbc_encrypt(const common_aes_key_t* key, uint8_t iv[16],
+                            const uint8_t* input, uint8_t* output, size_t len);
+
+/**
+ * CBC decrypt len bytes (a multiple of 16). input and output may alias.
+ * iv is updated to the last ciphertext block so calls can be chained.
+ */
+void common_aes_cbc_decrypt(const common_aes_key_t* key, uint8_t iv[16],
+                            const uint8_t* input, uint8_t* output, size_t len);
+
+/**
+ * Name of the selected backend ("aes-ni", "armv8-ce", "c")
+ */
+const char* common_aes_backend(void);
+
+// ============================================================================
+// PKCS#7 Padding
+// ============================================================================
+
+/**
+ * Padded size for a plaintext length (always adds 1..16 bytes)
+ */
+static inline size_t common_pkcs7_padded_size(size_t len) {
+    return (len / COMMON_AES_BLOCK_SIZE + 1) * COMMON_AES_BLOCK_SIZE;
+}
+
+/**
+ * Write padding after len bytes of data in buf (capacity >= padded size)
+ * @return Padded length
+ */
+size_t common_pkcs7_pad(uint8_t* buf, size_t len);
+
+/**
+ * Validate padding in constant time with respect to the pad value
+ * @return Unpadded length, or (size_t)-1 if the padding is invalid
+ */
+size_t common_pkcs7_unpad(const uint8_t* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMMON_AES_H
@@ -0,0 +1,42 @@
+/*
+ * common - CPU Feature Detection
+ *
+ * Runtime probing of the instruction set extensions used by the
+ * accelerated crypto backends. Results are computed once and cached.
+ */
+
+#ifndef COMMON_CPU_FEATURES_H
+#define COMMON_CPU_FEATURES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Feature bits returned by common_cpu_features()
+#define COMMON_CPU_AES      0x00000001  // AES round instructions (AES-NI / ARMv8 AES)
+#define COMMON_CPU_PMULL    0x00000002  // Carry-less multiply (PCLMULQDQ / PMULL)
+#define COMMON_CPU_SHA1     0x00000004  // SHA-1 instructions (SHA-NI / ARMv8 SHA1)
+#define COMMON_CPU_SHA256   0x00000008  // SHA-256 instructions (SHA-NI / ARMv8 SHA2)
+#define COMMON_CPU_SHA512   0x00000010  // SHA-512 instructions (ARMv8.2 SHA512)
+#define COMMON_CPU_SIMD128  0x00000020  // 128-bit integer SIMD (SSE4.1 / NEON)
+
+/**
+ * Get the feature bits supported by the running CPU
+ */
+uint32_t common_cpu_features(void);
+
+/**
+ * Check a single feature bit
+ */
+static inline bool common_cpu_has(uint32_t feature) {
+    return (common_cpu_features() & feature) == feature;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMMON_CPU_FEATURES_H
@@ -0,0 +1,174 @@
+/*
+ * common - Hash Engine
+ *
+ * Streaming MD5, SHA-1, SHA-256 and SHA-512 shared by all native libraries.
+ * Each algorithm picks its fastest backend (ARMv8 crypto extensions, x86
+ * SHA-NI or portable C) once at first use.
+ */
+
+#ifndef COMMON_HASH_H
+#define COMMON_HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// Digest and Block Sizes
+// ============================================================================
+
+#define COMMON_MD5_DIGEST_SIZE     16
+#define COMMON_SHA1_DIGEST_SIZE    20
+#define COMMON_SHA256_DIGEST_SIZE  32
+#define COMMON_SHA512_DIGEST_SIZE  64
+#define COMMON_HASH_MAX_DIGEST_SIZE COMMON_SHA512_DIGEST_SIZE
+
+#define COMMON_MD5_BLOCK_SIZE      64
+#define COMMON_SHA1_BLOCK_SIZE     64
+#define COMMON_SHA256_BLOCK_SIZE   64
+#define COMMON_SHA512_BLOCK_SIZE   128
+
+// ============================================================================
+// Contexts
+// ============================================================================
+
+// All contexts are plain data: they may be copied to snapshot a partial hash.
+
+typedef struct {
+    uint32_t state[4];            // Hash state (A, B, C, D)
+    uint64_t count;               // Number of bytes processed
+    uint8_t buffer[64];           // Pending partial block
+} common_md5_context_t;
+
+typedef struct {
+    uint32_t state[5];            // Hash state (H0-H4)
+    uint64_t count;               // Number of bytes processed
+    uint8_t buffer[64];           // Pending partial block
+} common_sha1_context_t;
+
+typedef struct {
+    uint32_t state[8];            // Hash state (H0-H7)
+    uint64_t count;               // Number of bytes processed
+    uint8_t buffer[64];           // Pending partial block
+} common_sha256_context_t;
+
+typedef struct {
+    uint64_t state[8];            // Hash state (H0-H7)
+    uint64_t count;               // Number of bytes processed
+    uint8_t buffer[128];          // Pending partial block
+} common_sha512_context_t;
+
+typedef enum {
+    COMMON_HASH_MD5 = 0,
+    COMMON_HASH_SHA1,
+    COMMON_HASH_SHA256,
+    COMMON_HASH_SHA512
+} common_hash_algo_t;
+
+// Algorithm-agnostic context
+typedef struct {
+    common_hash_algo_t algo;
+    union {
+        common_md5_context_t md5;
+        common_sha1_context_t sha1;
+        common_sha256_context_t sha256;
+        common_sha512_context_t sha512;
+    } u;
+} common_hash_context_t;
+
+// ============================================================================
+// MD5
+// ============================================================================
+
+void common_md5_init(common_md5_context_t* ctx);
+void common_md5_update(common_md5_context_t* ctx, const void* data, size_t len);
+void common_md5_final(common_md5_context_t* ctx, uint8_t digest[COMMON_MD5_DIGEST_SIZE]);
+void common_md5(const void* data, size_t len, uint8_t digest[COMMON_MD5_DIGEST_SIZE]);
+
+// ============================================================================
+// SHA-1
+// ============================================================================
+
+void common_sha1_init(common_sha1_context_t* ctx);
+void common_sha1_update(common_sha1_context_t* ctx, const void* data, size_t len);
+void common_sha1_final(common_sha1_context_t* ctx, uint8_t digest[COMMON_SHA1_DIGEST_SIZE]);
+void common_sha1(const void* data, size_t len, uint8_t digest[COMMON_SHA1_DIGEST_SIZE]);
+
+// ============================================================================
+// SHA-256
+// ============================================================================
+
+void common_sha256_init(common_sha256_context_t* ctx);
+void common_sha256_update(common_sha256_context_t* ctx, const void* data, size_t len);
+void common_sha256_final(common_sha256_context_t* ctx, uint8_t digest[COMMON_SHA256_DIGEST_SIZE]);
+void common_sha256(const void* data, size_t len, uint8_t digest[COMMON_SHA256_DIGEST_SIZE]);
+
+/**
+ * Compress whole 64-byte blocks into a SHA-256 state (no padding)
+ */
+void common_sha256_blocks(uint32_t state[8], const uint8_t* data, size_t num_blocks);
+
+/**
+ * Hash count independent messages of the same length: digests[i] is the
+ * SHA-256 of data[i]. Without SHA instructions, four messages are hashed
+ * together in SIMD lanes; with them each is hashed on the hardware path.
+ */
+void common_sha256_multi(const uint8_t* const* data, size_t len,
+                         uint8_t (*digests)[COMMON_SHA256_DIGEST_SIZE], size_t count);
+
+// ============================================================================
+// SHA-512
+// ============================================================================
+
+void common_sha512_init(common_sha512_context_t* ctx);
+void common_sha512_update(common_sha512_context_t* ctx, const void* data, size_t len);
+void common_sha512_final(common_sha512_context_t* ctx, uint8_t digest[COMMON_SHA512_DIGEST_SIZE]);
+void common_sha512(const void* data, size_t len, uint8_t digest[COMMON_SHA512_DIGEST_SIZE]);
+
+// ============================================================================
+// Generic Interface
+// ============================================================================
+
+/**
+ * Digest size in bytes for an algorithm (0 if unknown)
+ */
+size_t common_hash_digest_size(common_hash_algo_t algo);
+
+/**
+ * Initialize a generic context
+ * @return 0 on success, -1 for an unknown algorithm
+ */
+int common_hash_init(common_hash_context_t* ctx, common_hash_algo_t algo);
+
+void common_hash_update(common_hash_context_t* ctx, const void* data, size_t len);
+
+/**
+ * Finalize into digest (must hold common_hash_digest_size() bytes)
+ * @return Number of digest bytes written
+ */
+size_t common_hash_final(common_hash_context_t* ctx, uint8_t* digest);
+
+/**
+ * One-shot hash
+ * @return Number of digest bytes written, 0 for an unknown algorithm
+ */
+size_t common_hash(common_hash_algo_t algo, const void* data, size_t len, uint8_t* digest);
+
+/**
+ * Name of the backend selected for an algorithm ("armv8-ce", "sha-ni", "c")
+ */
+const char* common_hash_backend(common_hash_algo_t algo);
+
+/**
+ * Lowercase hex encoding; hex must hold 2 * len + 1 bytes
+ */
+void common_hex_encode(const uint8_t* data, size_t len, char* hex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMMON_HASH_H
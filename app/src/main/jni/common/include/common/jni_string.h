@@ -0,0 +1,83 @@
+/*
+ * common - JNI Strings
+ *
+ * String marshalling across JNI without a heap copy per call. Java strings
+ * are copied once, with GetStringUTFRegion, into inline storage or a
+ * per-thread scratch arena; native strings are checked to be modified
+ * UTF-8 before NewStringUTF so CheckJNI never aborts on device data.
+ */
+
+#ifndef COMMON_JNI_STRING_H
+#define COMMON_JNI_STRING_H
+
+#include <jni.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * True if data is modified UTF-8 as JNI expects it: no NUL bytes (NUL is
+ * written C0 80), no 4-byte sequences (supplementary characters are
+ * surrogate pairs) and no truncated or stray continuation bytes.
+ */
+bool isModifiedUtf8(const char* data, size_t size) noexcept;
+
+// Scoped, NUL-terminated view of a Java string's modified UTF-8 bytes.
+// Short strings live inside the object; longer ones borrow the calling
+// thread's scratch arena, which is returned on destruction. Views must be
+// destroyed in reverse order of creation, as scoped locals are.
+class JniUtf8 {
+public:
+    static constexpr size_t kInlineSize = 256;
+
+    JniUtf8(JNIEnv* env, jstring str) noexcept;
+    ~JniUtf8();
+
+    JniUtf8(const JniUtf8&) = delete;
+    JniUtf8& operator=(const JniUtf8&) = delete;
+
+    // False for a null jstring or if storage could not be obtained
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    const char* c_str() const noexcept { return data_ ? data_ : ""; }
+    size_t size() const noexcept { return size_; }
+    std::string_view view() const noexcept { return std::string_view(c_str(), size_); }
+    std::string str() const { return std::string(c_str(), size_); }
+
+private:
+    char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t arena_mark_;
+    bool in_arena_ = false;
+    bool on_heap_ = false;
+    char inline_[kInlineSize];
+};
+
+/**
+ * NewStringUTF for arbitrary bytes. Valid modified UTF-8 is passed straight
+ * through when nul_terminated says data[size] is a readable NUL; otherwise,
+ * or if it is not valid, it is copied and re-encoded first (4-byte sequences
+ * to surrogate pairs, NUL to C0 80, malformed bytes to U+FFFD).
+ * Returns nullptr on failure.
+ */
+jstring newStringUtf(JNIEnv* env, const char* data, size_t size,
+                     bool nul_terminated = false) noexcept;
+
+inline jstring newStringUtf(JNIEnv* env, const char* str) noexcept {
+    return str ? newStringUtf(env, str, std::char_traits<char>::length(str), true) : nullptr;
+}
+
+inline jstring newStringUtf(JNIEnv* env, const std::string& str) noexcept {
+    return newStringUtf(env, str.c_str(), str.size(), true);
+}
+
+inline jstring newStringUtf(JNIEnv* env, std::string_view str) noexcept {
+    return newStringUtf(env, str.data(), str.size(), false);
+}
+
+} // namespace common
+
+#endif // COMMON_JNI_STRING_H
@@ -0,0 +1,128 @@
+/*
+ * common - Logging
+ *
+ * Asynchronous logging shared by all native libraries. The calling thread
+ * only copies the format string pointer and the raw arguments into its own
+ * lock-free ring; a background thread formats the record and hands it to
+ * the sink (logcat on Android, stderr or a file elsewhere). Levels below
+ * COMMON_LOG_MIN_LEVEL are removed at compile time.
+ */
+
+#ifndef COMMON_LOG_H
+#define COMMON_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// Levels
+// ============================================================================
+
+// Same values as android_LogPriority so they map onto logcat directly
+#define COMMON_LOG_VERBOSE  2
+#define COMMON_LOG_DEBUG    3
+#define COMMON_LOG_INFO     4
+#define COMMON_LOG_WARN     5
+#define COMMON_LOG_ERROR    6
+#define COMMON_LOG_SILENT   8
+
+// Build-time threshold; calls below it compile to nothing
+#ifndef COMMON_LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define COMMON_LOG_MIN_LEVEL COMMON_LOG_INFO
+#  else
+#    define COMMON_LOG_MIN_LEVEL COMMON_LOG_VERBOSE
+#  endif
+#endif
+
+#define COMMON_LOG_COMPILED(level) ((level) >= COMMON_LOG_MIN_LEVEL)
+
+// ============================================================================
+// Producers
+// ============================================================================
+
+/**
+ * Queue a printf-style record.
+ *
+ * fmt must outlive the process (a string literal): only its address is
+ * queued. String arguments and tag are copied, so they may be temporaries.
+ * Records are dropped, never blocked on, when the thread's ring is full.
+ */
+void common_log(int level, const char* tag, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * va_list form of common_log() for wrapper functions
+ */
+void common_logv(int level, const char* tag, const char* fmt, va_list args)
+    __attribute__((format(printf, 3, 0)));
+
+/**
+ * Queue a hex dump of data, 16 bytes per line, under a label line
+ */
+void common_log_hexdump(int level, const char* tag, const char* label,
+                        const void* data, size_t size);
+
+#define COMMON_LOG_AT(level, tag, ...)                   \
+    do {                                                 \
+        if (COMMON_LOG_COMPILED(level)) {                \
+            common_log((level), (tag), __VA_ARGS__);     \
+        }                                                \
+    } while (0)
+
+#define COMMON_LOGV(tag, ...) COMMON_LOG_AT(COMMON_LOG_VERBOSE, tag, __VA_ARGS__)
+#define COMMON_LOGD(tag, ...) COMMON_LOG_AT(COMMON_LOG_DEBUG, tag, __VA_ARGS__)
+#define COMMON_LOGI(tag, ...) COMMON_LOG_AT(COMMON_LOG_INFO, tag, __VA_ARGS__)
+#define COMMON_LOGW(tag, ...) COMMON_LOG_AT(COMMON_LOG_WARN, tag, __VA_ARGS__)
+#define COMMON_LOGE(tag, ...) COMMON_LOG_AT(COMMON_LOG_ERROR, tag, __VA_ARGS__)
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+/**
+ * Runtime threshold on top of the build-time one (default: COMMON_LOG_VERBOSE)
+ */
+void common_log_set_level(int level);
+int common_log_get_level(void);
+
+/**
+ * Sink receiving formatted records on the logging thread.
+ * time_ns is CLOCK_REALTIME at the call site, tid the calling thread.
+ */
+typedef void (*common_log_sink_fn)(void* user, int level, const char* tag,
+                                   const char* message, uint64_t time_ns, uint32_t tid);
+
+/**
+ * Replace the sink; NULL restores the default (logcat, or stderr off Android).
+ * Records already queued go to whichever sink is set when they are drained.
+ */
+void common_log_set_sink(common_log_sink_fn sink, void* user);
+
+/**
+ * Append records to a file instead of the default sink.
+ * Returns 0 on success, -1 (keeping the current sink) if it cannot be opened.
+ */
+int common_log_open_file(const char* path);
+
+/**
+ * Block until every record queued before the call has reached the sink.
+ * Call before abort() or process exit so the last records are not lost.
+ */
+void common_log_flush(void);
+
+/**
+ * Number of records dropped because a ring was full
+ */
+uint64_t common_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMMON_LOG_H
@@ -0,0 +1,76 @@
+/*
+ * common - Mapped File
+ *
+ * Read-only whole-file access. Large regular files are mapped so callers
+ * read the page cache directly; small files and files without a reliable
+ * size (procfs, sysfs, pipes) are read into a private buffer instead.
+ */
+
+#ifndef COMMON_MAPPED_FILE_H
+#define COMMON_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "common/span.h"
+
+namespace common {
+
+class MappedFile {
+public:
+    // Access pattern hint passed to madvise() for mapped files
+    enum class Access {
+        Sequential,     // Read front to back once; read ahead aggressively
+        Random          // Scattered lookups; disable read-ahead
+    };
+
+    // Regular files at least this large are mapped, smaller ones are read
+    // with a single pread() - below this a mapping costs more than a copy.
+    static constexpr size_t kMapThreshold = 64 * 1024;
+
+    MappedFile() noexcept = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Open and load a file, replacing any previous contents.
+     * Returns false (and leaves the object empty) if it cannot be read.
+     */
+    bool open(const char* path, Access access = Access::Sequential);
+
+    /**
+     * Release the mapping or buffer
+     */
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return open_; }
+    bool isMapped() const noexcept { return mapped_; }
+
+    // Contents stay valid until close(), open() or destruction
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    ByteSpan bytes() const noexcept { return ByteSpan(data_, size_); }
+    std::string_view view() const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+private:
+    bool readSized(int fd, size_t size);
+    bool readUntilEof(int fd);
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    uint8_t* buffer_ = nullptr;     // malloc'd when not mapped
+    bool mapped_ = false;
+    bool open_ = false;
+};
+
+} // namespace common
+
+#endif // COMMON_MAPPED_FILE_H
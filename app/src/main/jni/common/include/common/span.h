@@ -0,0 +1,85 @@
+/*
+ * common - Span
+ *
+ * Minimal non-owning view over contiguous memory. The libraries build as
+ * C++17, so this stands in for std::span with the subset we need.
+ */
+
+#ifndef COMMON_SPAN_H
+#define COMMON_SPAN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace common {
+
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+    using iterator = T*;
+
+    constexpr Span() noexcept : data_(nullptr), size_(0) {}
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    template <size_t N>
+    constexpr Span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+    template <typename U, size_t N,
+              typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    constexpr Span(std::array<U, N>& array) noexcept : data_(array.data()), size_(N) {}
+
+    template <typename U, size_t N,
+              typename = typename std::enable_if<std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+    constexpr Span(const std::array<U, N>& array) noexcept : data_(array.data()), size_(N) {}
+
+    template <typename U, typename A,
+              typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Span(std::vector<U, A>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template <typename U, typename A,
+              typename = typename std::enable_if<std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+    Span(const std::vector<U, A>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template <typename U,
+              typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    constexpr Span(const Span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+
+    constexpr T& operator[](size_t index) const noexcept { return data_[index]; }
+
+    constexpr Span first(size_t count) const noexcept { return Span(data_, count); }
+    constexpr Span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const noexcept {
+        return Span(data_ + offset, count == static_cast<size_t>(-1) ? size_ - offset : count);
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+typedef Span<const uint8_t> ByteSpan;
+typedef Span<uint8_t> MutableByteSpan;
+
+/**
+ * View the bytes of a string without copying
+ */
+inline ByteSpan asBytes(std::string_view str) noexcept {
+    return ByteSpan(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+}
+
+} // namespace common
+
+#endif // COMMON_SPAN_H
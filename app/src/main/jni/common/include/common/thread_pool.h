@@ -0,0 +1,246 @@
+/*
+ * common - Thread Pool
+ *
+ * One work-stealing pool per shared object for the parallel crypto,
+ * hashing, directory scans and periodic background checks that used to
+ * spawn their own threads. Each worker owns a deque: tasks a worker
+ * submits go to the back of its own deque and are taken LIFO while they
+ * are cache-hot, idle workers steal FIFO from the front of others. Work
+ * from outside the pool enters a bounded injection queue, one lane per
+ * priority, so a burst of submissions blocks its producers instead of
+ * growing without limit.
+ *
+ * Workers are named "<name>-<n>" so they are identifiable in systrace and
+ * trace dumps. Background tasks have a worker of their own, "<name>-bg",
+ * running at a raised nice value: they never hold up foreground work and
+ * never run at foreground priority.
+ *
+ * The size defaults to one worker per core minus one (callers of
+ * parallel_for take part themselves). COMMON_POOL_THREADS (host) or the
+ * debug.common.pool_threads system property (Android) overrides it, as
+ * does common_pool_set_threads() before the first use.
+ */
+
+#ifndef COMMON_THREAD_POOL_H
+#define COMMON_THREAD_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// C Interface (shared pool)
+// ============================================================================
+
+typedef enum {
+    COMMON_POOL_PRIORITY_HIGH = 0,       // Latency-sensitive, ahead of everything queued
+    COMMON_POOL_PRIORITY_NORMAL = 1,
+    COMMON_POOL_PRIORITY_BACKGROUND = 2  // Periodic checks; run on the background worker
+} common_pool_priority_t;
+
+typedef void (*common_pool_task_fn)(void* ctx);
+typedef void (*common_pool_index_fn)(void* ctx, size_t index);
+
+/**
+ * Size of the shared pool. Must be called before its first use.
+ * Returns 0 on success, -1 if the pool is already running.
+ */
+int common_pool_set_threads(unsigned threads);
+
+/**
+ * Number of workers in the shared pool (starting it if needed)
+ */
+unsigned common_pool_thread_count(void);
+
+/**
+ * Run fn(ctx) on the shared pool. Blocks while the injection queue is
+ * full, except on a pool worker, whose own deque is unbounded.
+ * Returns 0, or -1 if fn is NULL.
+ */
+int common_pool_submit(common_pool_task_fn fn, void* ctx, common_pool_priority_t priority);
+
+/**
+ * common_pool_submit() that returns -1 instead of blocking when full
+ */
+int common_pool_try_submit(common_pool_task_fn fn, void* ctx, common_pool_priority_t priority);
+
+/**
+ * Call fn(ctx, i) for every i in [0, count) and return when all calls
+ * have finished. The caller runs indices itself alongside at most
+ * max_workers - 1 pool workers (0: no limit), so it never waits on work
+ * that has not started and is safe to call from a pool worker.
+ */
+void common_pool_parallel_for(size_t count, unsigned max_workers,
+                              common_pool_index_fn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace common {
+
+// ============================================================================
+// C++ Interface
+// ============================================================================
+
+enum class TaskPriority : uint8_t {
+    High = COMMON_POOL_PRIORITY_HIGH,
+    Normal = COMMON_POOL_PRIORITY_NORMAL,
+    Background = COMMON_POOL_PRIORITY_BACKGROUND,
+};
+
+namespace thread_pool_detail {
+struct Pool;
+struct TimerState;
+} // namespace thread_pool_detail
+
+// Pending delayed task; copies refer to the same task
+class DelayedTask {
+public:
+    DelayedTask() = default;
+
+    // True if the task was still pending and now never runs
+    bool cancel() noexcept;
+
+    explicit operator bool() const noexcept { return state_ != nullptr; }
+
+private:
+    friend class ThreadPool;
+    explicit DelayedTask(std::shared_ptr<thread_pool_detail::TimerState> state)
+        : state_(std::move(state)) {}
+
+    std::shared_ptr<thread_pool_detail::TimerState> state_;
+};
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    struct Options {
+        const char* name = "pool";      // Worker name prefix; keep it short (15 chars total)
+        unsigned threads = 0;           // Foreground workers; 0: one per core minus one, at least one
+        size_t queue_capacity = 1024;   // Bound of the global injection queue
+    };
+
+    explicit ThreadPool(const Options& options);
+
+    // Finishes every queued task, drops pending delayed tasks and joins
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * The library's pool, started on first use and never destroyed
+     */
+    static ThreadPool& shared();
+
+    unsigned threadCount() const noexcept;
+
+    // True on a worker of this pool
+    bool isWorkerThread() const noexcept;
+
+    /**
+     * Queue a task. From a worker of this pool it goes to the worker's own
+     * deque (or the injection queue for the other tier) and never blocks;
+     * any other thread blocks while the injection queue is full.
+     */
+    void post(Task task, TaskPriority priority = TaskPriority::Normal);
+
+    // post() that returns false instead of blocking
+    bool tryPost(Task task, TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * Run task after delay (posted with priority once due). Delayed tasks
+     * are held by a timer thread and do not count against the queue bound.
+     */
+    DelayedTask postAfter(std::chrono::milliseconds delay, Task task,
+                          TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * Run fn on the pool; its result or exception arrives through the future
+     */
+    template <typename F>
+    auto submit(F&& fn, TaskPriority priority = TaskPriority::Normal)
+        -> std::future<std::invoke_result_t<std::decay_t<F>&>> {
+        using Result = std::invoke_result_t<std::decay_t<F>&>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        std::future<Result> result = task->get_future();
+        post([task]() { (*task)(); }, priority);
+        return result;
+    }
+
+    /**
+     * Run fn on the pool, then on_done(result) (on_done() for void) on the
+     * same worker. Exceptions must not escape either.
+     */
+    template <typename F, typename Done>
+    void submit(F&& fn, Done&& on_done, TaskPriority priority = TaskPriority::Normal) {
+        post([fn = std::forward<F>(fn), on_done = std::forward<Done>(on_done)]() mutable {
+            if constexpr (std::is_void_v<std::invoke_result_t<std::decay_t<F>&>>) {
+                fn();
+                on_done();
+            } else {
+                on_done(fn());
+            }
+        }, priority);
+    }
+
+    /**
+     * Call body(i) for every i in [0, count); see common_pool_parallel_for()
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body,
+                     unsigned max_workers = 0);
+
+private:
+    std::unique_ptr<thread_pool_detail::Pool> pool_;
+};
+
+// Task re-posted to a pool every interval, replacing a dedicated thread
+// that sleeps in a loop. The first run is immediate. stop() cancels the
+// next run and waits for one in progress, so the callback may safely use
+// the owner until stop() returns.
+class PeriodicTask {
+public:
+    PeriodicTask();
+    ~PeriodicTask() { stop(); }
+
+    PeriodicTask(const PeriodicTask&) = delete;
+    PeriodicTask& operator=(const PeriodicTask&) = delete;
+
+    // Restarts the task if it is already running
+    void start(std::chrono::milliseconds interval, std::function<void()> fn,
+               TaskPriority priority = TaskPriority::Background,
+               ThreadPool& pool = ThreadPool::shared());
+
+    // Safe to call from the callback itself (it then does not wait)
+    void stop();
+
+    // Takes effect from the next scheduling
+    void setInterval(std::chrono::milliseconds interval) noexcept;
+
+    bool running() const noexcept;
+
+private:
+    struct State;
+    static void schedule(const std::shared_ptr<State>& state, uint64_t generation,
+                         std::chrono::milliseconds delay);
+    static void run(const std::shared_ptr<State>& state, uint64_t generation);
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace common
+
+#endif // __cplusplus
+
+#endif // COMMON_THREAD_POOL_H
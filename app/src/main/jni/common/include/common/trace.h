@@ -0,0 +1,119 @@
+/*
+ * common - Tracing
+ *
+ * Scoped timing spans exported as Chrome trace-event JSON (loadable in
+ * Perfetto or chrome://tracing). Each thread appends to its own buffer
+ * without locking; when tracing is off a span costs one predictable branch.
+ *
+ * Every shared object links its own copy of jni_common and therefore has
+ * its own recorder. Timestamps are CLOCK_MONOTONIC, so dumps taken from
+ * several libraries line up when their traceEvents arrays are merged.
+ *
+ * Tracing starts at load time when the COMMON_TRACE environment variable
+ * (host) or the debug.common.trace system property (Android) holds an
+ * output path prefix; the dump is then written at exit or on
+ * common_trace_dump(NULL) as <prefix>.<library>.json.
+ */
+
+#ifndef COMMON_TRACE_H
+#define COMMON_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Non-zero while recording; read through common_trace_enabled()
+extern int common_trace_active_flag;
+
+static inline bool common_trace_enabled(void) {
+    return __builtin_expect(__atomic_load_n(&common_trace_active_flag, __ATOMIC_RELAXED), 0);
+}
+
+/**
+ * Monotonic timestamp in nanoseconds, the clock all events use
+ */
+static inline uint64_t common_trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Discard recorded events and start recording
+ */
+void common_trace_start(void);
+
+/**
+ * Stop recording; recorded events are kept for common_trace_dump()
+ */
+void common_trace_stop(void);
+
+/**
+ * Record a completed span. name must be a string literal (only the
+ * pointer is stored). Events past a thread's buffer capacity are dropped.
+ */
+void common_trace_record(const char* name, uint64_t begin_ns, uint64_t end_ns);
+
+/**
+ * Record a zero-length marker at the current time
+ */
+void common_trace_instant(const char* name);
+
+/**
+ * Write the recorded events as Chrome trace-event JSON.
+ * NULL writes to the path configured at load time.
+ * Returns 0 on success, -1 on error. Safe while other threads record.
+ */
+int common_trace_dump(const char* path);
+
+/**
+ * Number of events dropped because a thread buffer was full
+ */
+uint64_t common_trace_dropped(void);
+
+#ifdef __cplusplus
+}
+
+namespace common {
+
+// Times the enclosing scope. The name is captured by pointer and must be a
+// string literal.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) noexcept : name_(name), begin_(0) {
+        if (common_trace_enabled()) begin_ = common_trace_now_ns();
+    }
+    ~TraceSpan() {
+        if (begin_) common_trace_record(name_, begin_, common_trace_now_ns());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    uint64_t begin_;
+};
+
+} // namespace common
+
+#define COMMON_TRACE_CONCAT_(a, b) a##b
+#define COMMON_TRACE_CONCAT(a, b) COMMON_TRACE_CONCAT_(a, b)
+
+// Define COMMON_TRACE_DISABLE to compile every span out
+#ifdef COMMON_TRACE_DISABLE
+#define COMMON_TRACE_SCOPE(name) do {} while (0)
+#else
+#define COMMON_TRACE_SCOPE(name) \
+    ::common::TraceSpan COMMON_TRACE_CONCAT(common_trace_span_, __LINE__)(name)
+#endif
+
+#define COMMON_TRACE_FUNCTION() COMMON_TRACE_SCOPE(__func__)
+
+#endif // __cplusplus
+
+#endif // COMMON_TRACE_H
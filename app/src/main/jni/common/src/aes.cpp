@@ -0,0 +1,326 @@
+/*
+ * common - AES (FIPS 197)
+ *
+ * Key expansion, the portable table-driven cipher, PKCS#7 helpers and
+ * runtime backend selection.
+ */
+
+#include "common/aes.h"
+#include "common/cpu_features.h"
+#include "aes_internal.h"
+#include <string.h>
+
+namespace common {
+namespace aes_detail {
+
+static const uint8_t kSbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static const uint8_t kRcon[10] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+};
+
+static inline uint8_t gf_mul(uint8_t a, uint8_t b) {
+    uint8_t p = 0;
+    while (b) {
+        if (b & 1) p ^= a;
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0));
+        b >>= 1;
+    }
+    return p;
+}
+
+static inline uint32_t rotr32(uint32_t v, int n) {
+    return (v >> n) | (v << (32 - n));
+}
+
+static inline uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void store_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+// Encryption/decryption T-tables (one each; the other three columns are
+// byte rotations) plus the inverse S-box, derived once from kSbox.
+struct AesTables {
+    uint32_t te[256];
+    uint32_t td[256];
+    uint8_t inv_sbox[256];
+
+    AesTables() {
+        for (int i = 0; i < 256; i++) {
+            inv_sbox[kSbox[i]] = (uint8_t)i;
+        }
+        for (int i = 0; i < 256; i++) {
+            uint8_t s = kSbox[i];
+            te[i] = ((uint32_t)gf_mul(s, 2) << 24) | ((uint32_t)s << 16) |
+                    ((uint32_t)s << 8) | gf_mul(s, 3);
+            uint8_t si = inv_sbox[i];
+            td[i] = ((uint32_t)gf_mul(si, 0x0e) << 24) | ((uint32_t)gf_mul(si, 0x09) << 16) |
+                    ((uint32_t)gf_mul(si, 0x0d) << 8) | gf_mul(si, 0x0b);
+        }
+    }
+};
+
+static const AesTables& tables() {
+    static const AesTables instance;
+    return instance;
+}
+
+static void encrypt_block_c(const common_aes_key_t* key, const uint8_t* input, uint8_t* output) {
+    const AesTables& t = tables();
+    const uint32_t* te = t.te;
+    const uint8_t* rk = key->enc_keys;
+
+    uint32_t s0 = load_be32(input) ^ load_be32(rk);
+    uint32_t s1 = load_be32(input + 4) ^ load_be32(rk + 4);
+    uint32_t s2 = load_be32(input + 8) ^ load_be32(rk + 8);
+    uint32_t s3 = load_be32(input + 12) ^ load_be32(rk + 12);
+
+    for (uint32_t round = 1; round < key->rounds; round++) {
+        rk += 16;
+        uint32_t t0 = te[s0 >> 24] ^ rotr32(te[(s1 >> 16) & 0xff], 8) ^
+                      rotr32(te[(s2 >> 8) & 0xff], 16) ^ rotr32(te[s3 & 0xff], 24) ^ load_be32(rk);
+        uint32_t t1 = te[s1 >> 24] ^ rotr32(te[(s2 >> 16) & 0xff], 8) ^
+                      rotr32(te[(s3 >> 8) & 0xff], 16) ^ rotr32(te[s0 & 0xff], 24) ^ load_be32(rk + 4);
+        uint32_t t2 = te[s2 >> 24] ^ rotr32(te[(s3 >> 16) & 0xff], 8) ^
+                      rotr32(te[(s0 >> 8) & 0xff], 16) ^ rotr32(te[s1 & 0xff], 24) ^ load_be32(rk + 8);
+        uint32_t t3 = te[s3 >> 24] ^ rotr32(te[(s0 >> 16) & 0xff], 8) ^
+                      rotr32(te[(s1 >> 8) & 0xff], 16) ^ rotr32(te[s2 & 0xff], 24) ^ load_be32(rk + 12);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    rk += 16;
+    store_be32(output, (((uint32_t)kSbox[s0 >> 24] << 24) | ((uint32_t)kSbox[(s1 >> 16) & 0xff] << 16) |
+                        ((uint32_t)kSbox[(s2 >> 8) & 0xff] << 8) | kSbox[s3 & 0xff]) ^ load_be32(rk));
+    store_be32(output + 4, (((uint32_t)kSbox[s1 >> 24] << 24) | ((uint32_t)kSbox[(s2 >> 16) & 0xff] << 16) |
+                            ((uint32_t)kSbox[(s3 >> 8) & 0xff] << 8) | kSbox[s0 & 0xff]) ^ load_be32(rk + 4));
+    store_be32(output + 8, (((uint32_t)kSbox[s2 >> 24] << 24) | ((uint32_t)kSbox[(s3 >> 16) & 0xff] << 16) |
+                            ((uint32_t)kSbox[(s0 >> 8) & 0xff] << 8) | kSbox[s1 & 0xff]) ^ load_be32(rk + 8));
+    store_be32(output + 12, (((uint32_t)kSbox[s3 >> 24] << 24) | ((uint32_t)kSbox[(s0 >> 16) & 0xff] << 16) |
+                             ((uint32_t)kSbox[(s1 >> 8) & 0xff] << 8) | kSbox[s2 & 0xff]) ^ load_be32(rk + 12));
+}
+
+static void decrypt_block_c(const common_aes_key_t* key, const uint8_t* input, uint8_t* output) {
+    const AesTables& t = tables();
+    const uint32_t* td = t.td;
+    const uint8_t* isb = t.inv_sbox;
+    const uint8_t* rk = key->dec_keys;
+
+    uint32_t s0 = load_be32(input) ^ load_be32(rk);
+    uint32_t s1 = load_be32(input + 4) ^ load_be32(rk + 4);
+    uint32_t s2 = load_be32(input + 8) ^ load_be32(rk + 8);
+    uint32_t s3 = load_be32(input + 12) ^ load_be32(rk + 12);
+
+    for (uint32_t round = 1; round < key->rounds; round++) {
+        rk += 16;
+        uint32_t t0 = td[s0 >> 24] ^ rotr32(td[(s3 >> 16) & 0xff], 8) ^
+                      rotr32(td[(s2 >> 8) & 0xff], 16) ^ rotr32(td[s1 & 0xff], 24) ^ load_be32(rk);
+        uint32_t t1 = td[s1 >> 24] ^ rotr32(td[(s0 >> 16) & 0xff], 8) ^
+                      rotr32(td[(s3 >> 8) & 0xff], 16) ^ rotr32(td[s2 & 0xff], 24) ^ load_be32(rk + 4);
+        uint32_t t2 = td[s2 >> 24] ^ rotr32(td[(s1 >> 16) & 0xff], 8) ^
+                      rotr32(td[(s0 >> 8) & 0xff], 16) ^ rotr32(td[s3 & 0xff], 24) ^ load_be32(rk + 8);
+        uint32_t t3 = td[s3 >> 24] ^ rotr32(td[(s2 >> 16) & 0xff], 8) ^
+                      rotr32(td[(s1 >> 8) & 0xff], 16) ^ rotr32(td[s0 & 0xff], 24) ^ load_be32(rk + 12);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+
+    rk += 16;
+    store_be32(output, (((uint32_t)isb[s0 >> 24] << 24) | ((uint32_t)isb[(s3 >> 16) & 0xff] << 16) |
+                        ((uint32_t)isb[(s2 >> 8) & 0xff] << 8) | isb[s1 & 0xff]) ^ load_be32(rk));
+    store_be32(output + 4, (((uint32_t)isb[s1 >> 24] << 24) | ((uint32_t)isb[(s0 >> 16) & 0xff] << 16) |
+                            ((uint32_t)isb[(s3 >> 8) & 0xff] << 8) | isb[s2 & 0xff]) ^ load_be32(rk + 4));
+    store_be32(output + 8, (((uint32_t)isb[s2 >> 24] << 24) | ((uint32_t)isb[(s1 >> 16) & 0xff] << 16) |
+                            ((uint32_t)isb[(s0 >> 8) & 0xff] << 8) | isb[s3 & 0xff]) ^ load_be32(rk + 8));
+    store_be32(output + 12, (((uint32_t)isb[s3 >> 24] << 24) | ((uint32_t)isb[(s2 >> 16) & 0xff] << 16) |
+                             ((uint32_t)isb[(s1 >> 8) & 0xff] << 8) | isb[s0 & 0xff]) ^ load_be32(rk + 12));
+}
+
+static void cbc_encrypt_c(const common_aes_key_t* key, uint8_t* iv,
+                          const uint8_t* input, uint8_t* output, size_t len) {
+    uint8_t block[16];
+    for (size_t off = 0; off < len; off += 16) {
+        for (int i = 0; i < 16; i++) {
+            block[i] = input[off + i] ^ iv[i];
+        }
+        encrypt_block_c(key, block, output + off);
+        memcpy(iv, output + off, 16);
+    }
+}
+
+static void cbc_decrypt_c(const common_aes_key_t* key, uint8_t* iv,
+                          const uint8_t* input, uint8_t* output, size_t len) {
+    uint8_t cipher[16];
+    uint8_t plain[16];
+    for (size_t off = 0; off < len; off += 16) {
+        memcpy(cipher, input + off, 16);
+        decrypt_block_c(key, cipher, plain);
+        for (int i = 0; i < 16; i++) {
+            output[off + i] = plain[i] ^ iv[i];
+        }
+        memcpy(iv, cipher, 16);
+    }
+}
+
+static const AesBackend kAesBackendC = {
+    "c", encrypt_block_c, decrypt_block_c, cbc_encrypt_c, cbc_decrypt_c
+};
+
+static const AesBackend* select_backend(void) {
+#if defined(__aarch64__)
+    if (common_cpu_has(COMMON_CPU_AES)) {
+        return &kAesBackendArmv8;
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    if (common_cpu_has(COMMON_CPU_AES)) {
+        return &kAesBackendAesni;
+    }
+#endif
+    return &kAesBackendC;
+}
+
+static const AesBackend& backend() {
+    static const AesBackend* selected = select_backend();
+    return *selected;
+}
+
+// InvMixColumns on one round-key column (used for the decryption schedule)
+static void inv_mix_column(uint8_t* col) {
+    uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+    col[0] = gf_mul(a0, 0x0e) ^ gf_mul(a1, 0x0b) ^ gf_mul(a2, 0x0d) ^ gf_mul(a3, 0x09);
+    col[1] = gf_mul(a0, 0x09) ^ gf_mul(a1, 0x0e) ^ gf_mul(a2, 0x0b) ^ gf_mul(a3, 0x0d);
+    col[2] = gf_mul(a0, 0x0d) ^ gf_mul(a1, 0x09) ^ gf_mul(a2, 0x0e) ^ gf_mul(a3, 0x0b);
+    col[3] = gf_mul(a0, 0x0b) ^ gf_mul(a1, 0x0d) ^ gf_mul(a2, 0x09) ^ gf_mul(a3, 0x0e);
+}
+
+} // namespace aes_detail
+} // namespace common
+
+using namespace common::aes_detail;
+
+int common_aes_set_key(common_aes_key_t* key, const uint8_t* raw_key, size_t key_len) {
+    if (key_len != 16 && key_len != 24 && key_len != 32) {
+        return -1;
+    }
+
+    uint32_t nk = (uint32_t)(key_len / 4);
+    uint32_t nr = nk + 6;
+    uint32_t total = 4 * (nr + 1);
+    uint8_t* w = key->enc_keys;
+
+    memcpy(w, raw_key, key_len);
+    for (uint32_t i = nk; i < total; i++) {
+        uint8_t temp[4];
+        memcpy(temp, w + (i - 1) * 4, 4);
+
+        if (i % nk == 0) {
+            uint8_t t0 = temp[0];
+            temp[0] = (uint8_t)(kSbox[temp[1]] ^ kRcon[i / nk - 1]);
+            temp[1] = kSbox[temp[2]];
+            temp[2] = kSbox[temp[3]];
+            temp[3] = kSbox[t0];
+        } else if (nk > 6 && i % nk == 4) {
+            for (int j = 0; j < 4; j++) {
+                temp[j] = kSbox[temp[j]];
+            }
+        }
+
+        for (int j = 0; j < 4; j++) {
+            w[i * 4 + j] = w[(i - nk) * 4 + j] ^ temp[j];
+        }
+    }
+
+    // Equivalent inverse cipher: reverse the round order and apply
+    // InvMixColumns to every round key except the first and last.
+    for (uint32_t r = 0; r <= nr; r++) {
+        memcpy(key->dec_keys + r * 16, key->enc_keys + (nr - r) * 16, 16);
+        if (r != 0 && r != nr) {
+            for (int c = 0; c < 4; c++) {
+                inv_mix_column(key->dec_keys + r * 16 + c * 4);
+            }
+        }
+    }
+
+    key->rounds = nr;
+    return 0;
+}
+
+void common_aes_clear_key(common_aes_key_t* key) {
+    volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(key);
+    for (size_t i = 0; i < sizeof(*key); i++) {
+        p[i] = 0;
+    }
+}
+
+void common_aes_encrypt_block(const common_aes_key_t* key,
+                              const uint8_t input[16], uint8_t output[16]) {
+    backend().encrypt_block(key, input, output);
+}
+
+void common_aes_decrypt_block(const common_aes_key_t* key,
+                              const uint8_t input[16], uint8_t output[16]) {
+    backend().decrypt_block(key, input, output);
+}
+
+void common_aes_cbc_encrypt(const common_aes_key_t* key, uint8_t iv[16],
+                            const uint8_t* input, uint8_t* output, size_t len) {
+    if (len != 0) {
+        backend().cbc_encrypt(key, iv, input, output, len);
+    }
+}
+
+void common_aes_cbc_decrypt(const common_aes_key_t* key, uint8_t iv[16],
+                            const uint8_t* input, uint8_t* output, size_t len) {
+    if (len != 0) {
+        backend().cbc_decrypt(key, iv, input, output, len);
+    }
+}
+
+const char* common_aes_backend(void) {
+    return backend().name;
+}
+
+size_t common_pkcs7_pad(uint8_t* buf, size_t len) {
+    size_t padded = common_pkcs7_padded_size(len);
+    memset(buf + len, (int)(padded - len), padded - len);
+    return padded;
+}
+
+size_t common_pkcs7_unpad(const uint8_t* buf, size_t len) {
+    if (len == 0 || len % COMMON_AES_BLOCK_SIZE != 0) {
+        return (size_t)-1;
+    }
+
+    uint32_t pad = buf[len - 1];
+    uint32_t bad = (uint32_t)(pad == 0) | (uint32_t)(pad > COMMON_AES_BLOCK_SIZE);
+
+    // Inspect the whole final block so timing doesn't depend on the pad value
+    for (uint32_t i = 0; i < COMMON_AES_BLOCK_SIZE; i++) {
+        uint32_t in_pad = (uint32_t)(i < pad);
+        bad |= in_pad & (uint32_t)(buf[len - 1 - i] != pad);
+    }
+
+    return bad ? (size_t)-1 : len - pad;
+}
@@ -0,0 +1,36 @@
+/*
+ * common - AES Internals
+ *
+ * Backend table shared by the portable and hardware AES implementations.
+ */
+
+#ifndef COMMON_AES_INTERNAL_H
+#define COMMON_AES_INTERNAL_H
+
+#include "common/aes.h"
+
+namespace common {
+namespace aes_detail {
+
+struct AesBackend {
+    const char* name;
+    void (*encrypt_block)(const common_aes_key_t* key, const uint8_t* input, uint8_t* output);
+    void (*decrypt_block)(const common_aes_key_t* key, const uint8_t* input, uint8_t* output);
+    void (*cbc_encrypt)(const common_aes_key_t* key, uint8_t* iv,
+                        const uint8_t* input, uint8_t* output, size_t len);
+    void (*cbc_decrypt)(const common_aes_key_t* key, uint8_t* iv,
+                        const uint8_t* input, uint8_t* output, size_t len);
+};
+
+// Only built for the matching architecture; the caller checks CPU features.
+#if defined(__aarch64__)
+extern const AesBackend kAesBackendArmv8;
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+extern const AesBackend kAesBackendAesni;
+#endif
+
+} // namespace aes_detail
+} // namespace common
+
+#endif // COMMON_AES_INTERNAL_H
@@ -0,0 +1,118 @@
+/*
+ * common - x86 AES-NI Backend
+ *
+ * Compiled with -maes -msse2; only selected after common_cpu_features()
+ * has reported AES-NI support.
+ */
+
+#include "aes_internal.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+namespace common {
+namespace aes_detail {
+
+static inline __m128i load_key(const uint8_t* keys, uint32_t round) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + round * 16));
+}
+
+static inline __m128i encrypt(const common_aes_key_t* key, __m128i block) {
+    uint32_t nr = key->rounds;
+    block = _mm_xor_si128(block, load_key(key->enc_keys, 0));
+    for (uint32_t r = 1; r < nr; r++) {
+        block = _mm_aesenc_si128(block, load_key(key->enc_keys, r));
+    }
+    return _mm_aesenclast_si128(block, load_key(key->enc_keys, nr));
+}
+
+static inline __m128i decrypt(const common_aes_key_t* key, __m128i block) {
+    uint32_t nr = key->rounds;
+    block = _mm_xor_si128(block, load_key(key->dec_keys, 0));
+    for (uint32_t r = 1; r < nr; r++) {
+        block = _mm_aesdec_si128(block, load_key(key->dec_keys, r));
+    }
+    return _mm_aesdeclast_si128(block, load_key(key->dec_keys, nr));
+}
+
+static void encrypt_block_aesni(const common_aes_key_t* key, const uint8_t* input, uint8_t* output) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), encrypt(key, block));
+}
+
+static void decrypt_block_aesni(const common_aes_key_t* key, const uint8_t* input, uint8_t* output) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), decrypt(key, block));
+}
+
+static void cbc_encrypt_aesni(const common_aes_key_t* key, uint8_t* iv,
+                              const uint8_t* input, uint8_t* output, size_t len) {
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t off = 0; off < len; off += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + off));
+        chain = encrypt(key, _mm_xor_si128(block, chain));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + off), chain);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), chain);
+}
+
+static void cbc_decrypt_aesni(const common_aes_key_t* key, uint8_t* iv,
+                              const uint8_t* input, uint8_t* output, size_t len) {
+    uint32_t nr = key->rounds;
+    __m128i chain = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    size_t off = 0;
+
+    // CBC decryption has no serial dependency; keep four blocks in flight
+    for (; off + 64 <= len; off += 64) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(input + off);
+        __m128i c0 = _mm_loadu_si128(in);
+        __m128i c1 = _mm_loadu_si128(in + 1);
+        __m128i c2 = _mm_loadu_si128(in + 2);
+        __m128i c3 = _mm_loadu_si128(in + 3);
+
+        __m128i k = load_key(key->dec_keys, 0);
+        __m128i b0 = _mm_xor_si128(c0, k);
+        __m128i b1 = _mm_xor_si128(c1, k);
+        __m128i b2 = _mm_xor_si128(c2, k);
+        __m128i b3 = _mm_xor_si128(c3, k);
+        for (uint32_t r = 1; r < nr; r++) {
+            k = load_key(key->dec_keys, r);
+            b0 = _mm_aesdec_si128(b0, k);
+            b1 = _mm_aesdec_si128(b1, k);
+            b2 = _mm_aesdec_si128(b2, k);
+            b3 = _mm_aesdec_si128(b3, k);
+        }
+        k = load_key(key->dec_keys, nr);
+        b0 = _mm_aesdeclast_si128(b0, k);
+        b1 = _mm_aesdeclast_si128(b1, k);
+        b2 = _mm_aesdeclast_si128(b2, k);
+        b3 = _mm_aesdeclast_si128(b3, k);
+
+        __m128i* out = reinterpret_cast<__m128i*>(output + off);
+        _mm_storeu_si128(out, _mm_xor_si128(b0, chain));
+        _mm_storeu_si128(out + 1, _mm_xor_si128(b1, c0));
+        _mm_storeu_si128(out + 2, _mm_xor_si128(b2, c1));
+        _mm_storeu_si128(out + 3, _mm_xor_si128(b3, c2));
+        chain = c3;
+    }
+
+    for (; off < len; off += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + off));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + off),
+                         _mm_xor_si128(decrypt(key, c), chain));
+        chain = c;
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), chain);
+}
+
+const AesBackend kAesBackendAesni = {
+    "aes-ni", encrypt_block_aesni, decrypt_block_aesni, cbc_encrypt_aesni, cbc_decrypt_aesni
+};
+
+} // namespace aes_detail
+} // namespace common
+
+#endif // __x86_64__ || __i386__
@@ -0,0 +1,73 @@
+/*
+ * common - CPU Feature Detection
+ */
+
+#include "common/cpu_features.h"
+
+#if defined(__aarch64__) || defined(__arm__)
+#include <sys/auxv.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__aarch64__)
+// Values from <asm/hwcap.h>; spelled out so older NDK headers still build.
+#define COMMON_HWCAP_ASIMD   (1UL << 1)
+#define COMMON_HWCAP_AES     (1UL << 3)
+#define COMMON_HWCAP_PMULL   (1UL << 4)
+#define COMMON_HWCAP_SHA1    (1UL << 5)
+#define COMMON_HWCAP_SHA2    (1UL << 6)
+#define COMMON_HWCAP_SHA512  (1UL << 21)
+#elif defined(__arm__)
+#define COMMON_HWCAP_NEON    (1UL << 12)
+#define COMMON_HWCAP2_AES    (1UL << 0)
+#define COMMON_HWCAP2_PMULL  (1UL << 1)
+#define COMMON_HWCAP2_SHA1   (1UL << 2)
+#define COMMON_HWCAP2_SHA2   (1UL << 3)
+#endif
+
+static uint32_t common_probe_cpu_features(void) {
+    uint32_t features = 0;
+
+#if defined(__aarch64__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & COMMON_HWCAP_ASIMD)  features |= COMMON_CPU_SIMD128;
+    if (hwcap & COMMON_HWCAP_AES)    features |= COMMON_CPU_AES;
+    if (hwcap & COMMON_HWCAP_PMULL)  features |= COMMON_CPU_PMULL;
+    if (hwcap & COMMON_HWCAP_SHA1)   features |= COMMON_CPU_SHA1;
+    if (hwcap & COMMON_HWCAP_SHA2)   features |= COMMON_CPU_SHA256;
+    if (hwcap & COMMON_HWCAP_SHA512) features |= COMMON_CPU_SHA512;
+#elif defined(__arm__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    if (hwcap & COMMON_HWCAP_NEON)    features |= COMMON_CPU_SIMD128;
+    if (hwcap2 & COMMON_HWCAP2_AES)   features |= COMMON_CPU_AES;
+    if (hwcap2 & COMMON_HWCAP2_PMULL) features |= COMMON_CPU_PMULL;
+    if (hwcap2 & COMMON_HWCAP2_SHA1)  features |= COMMON_CPU_SHA1;
+    if (hwcap2 & COMMON_HWCAP2_SHA2)  features |= COMMON_CPU_SHA256;
+#elif defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        bool ssse3 = (ecx & (1u << 9)) != 0;
+        bool sse41 = (ecx & (1u << 19)) != 0;
+        if (ssse3 && sse41)      features |= COMMON_CPU_SIMD128;
+        if (ecx & (1u << 25))    features |= COMMON_CPU_AES;
+        if (ecx & (1u << 1))     features |= COMMON_CPU_PMULL;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        // SHA-NI implies SHA-1 and SHA-256; the kernels also need SSE4.1
+        if ((ebx & (1u << 29)) && (features & COMMON_CPU_SIMD128)) {
+            features |= COMMON_CPU_SHA1 | COMMON_CPU_SHA256;
+        }
+    }
+#endif
+
+    return features;
+}
+
+uint32_t common_cpu_features(void) {
+    static const uint32_t features = common_probe_cpu_features();
+    return features;
+}
@@ -0,0 +1,118 @@
+/*
+ * common - Hash Engine Dispatch
+ *
+ * Backend selection and the algorithm-agnostic interface.
+ */
+
+#include "common/hash.h"
+#include "common/cpu_features.h"
+#include "hash_internal.h"
+
+namespace common {
+namespace hash_detail {
+
+Sha1BlocksFn select_sha1_blocks(const char** backend) {
+#if defined(__aarch64__)
+    if (common_cpu_has(COMMON_CPU_SHA1)) {
+        if (backend) *backend = "armv8-ce";
+        return sha1_blocks_armv8;
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    if (common_cpu_has(COMMON_CPU_SHA1)) {
+        if (backend) *backend = "sha-ni";
+        return sha1_blocks_shani;
+    }
+#endif
+    if (backend) *backend = "c";
+    return sha1_blocks_c;
+}
+
+Sha256BlocksFn select_sha256_blocks(const char** backend) {
+#if defined(__aarch64__)
+    if (common_cpu_has(COMMON_CPU_SHA256)) {
+        if (backend) *backend = "armv8-ce";
+        return sha256_blocks_armv8;
+    }
+#elif defined(__x86_64__) || defined(__i386__)
+    if (common_cpu_has(COMMON_CPU_SHA256)) {
+        if (backend) *backend = "sha-ni";
+        return sha256_blocks_shani;
+    }
+#endif
+    if (backend) *backend = "c";
+    return sha256_blocks_c;
+}
+
+} // namespace hash_detail
+} // namespace common
+
+using namespace common::hash_detail;
+
+size_t common_hash_digest_size(common_hash_algo_t algo) {
+    switch (algo) {
+        case COMMON_HASH_MD5:    return COMMON_MD5_DIGEST_SIZE;
+        case COMMON_HASH_SHA1:   return COMMON_SHA1_DIGEST_SIZE;
+        case COMMON_HASH_SHA256: return COMMON_SHA256_DIGEST_SIZE;
+        case COMMON_HASH_SHA512: return COMMON_SHA512_DIGEST_SIZE;
+    }
+    return 0;
+}
+
+int common_hash_init(common_hash_context_t* ctx, common_hash_algo_t algo) {
+    ctx->algo = algo;
+    switch (algo) {
+        case COMMON_HASH_MD5:    common_md5_init(&ctx->u.md5);       return 0;
+        case COMMON_HASH_SHA1:   common_sha1_init(&ctx->u.sha1);     return 0;
+        case COMMON_HASH_SHA256: common_sha256_init(&ctx->u.sha256); return 0;
+        case COMMON_HASH_SHA512: common_sha512_init(&ctx->u.sha512); return 0;
+    }
+    return -1;
+}
+
+void common_hash_update(common_hash_context_t* ctx, const void* data, size_t len) {
+    switch (ctx->algo) {
+        case COMMON_HASH_MD5:    common_md5_update(&ctx->u.md5, data, len);       break;
+        case COMMON_HASH_SHA1:   common_sha1_update(&ctx->u.sha1, data, len);     break;
+        case COMMON_HASH_SHA256: common_sha256_update(&ctx->u.sha256, data, len); break;
+        case COMMON_HASH_SHA512: common_sha512_update(&ctx->u.sha512, data, len); break;
+    }
+}
+
+size_t common_hash_final(common_hash_context_t* ctx, uint8_t* digest) {
+    switch (ctx->algo) {
+        case COMMON_HASH_MD5:    common_md5_final(&ctx->u.md5, digest);       break;
+        case COMMON_HASH_SHA1:   common_sha1_final(&ctx->u.sha1, digest);     break;
+        case COMMON_HASH_SHA256: common_sha256_final(&ctx->u.sha256, digest); break;
+        case COMMON_HASH_SHA512: common_sha512_final(&ctx->u.sha512, digest); break;
+        default: return 0;
+    }
+    return common_hash_digest_size(ctx->algo);
+}
+
+size_t common_hash(common_hash_algo_t algo, const void* data, size_t len, uint8_t* digest) {
+    common_hash_context_t ctx;
+    if (common_hash_init(&ctx, algo) != 0) {
+        return 0;
+    }
+    common_hash_update(&ctx, data, len);
+    return common_hash_final(&ctx, digest);
+}
+
+const char* common_hash_backend(common_hash_algo_t algo) {
+    const char* backend = "c";
+    switch (algo) {
+        case COMMON_HASH_SHA1:   select_sha1_blocks(&backend);   break;
+        case COMMON_HASH_SHA256: select_sha256_blocks(&backend); break;
+        default: break;
+    }
+    return backend;
+}
+
+void common_hex_encode(const uint8_t* data, size_t len, char* hex) {
+    static const char kDigits[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+        hex[i * 2] = kDigits[data[i] >> 4];
+        hex[i * 2 + 1] = kDigits[data[i] & 0x0f];
+    }
+    hex[len * 2] = '\0';
+}
@@ -0,0 +1,107 @@
+/*
+ * common - ARMv8 Crypto Extension Hash Backends
+ *
+ * SHA-1 and SHA-256 block functions using the SHA1 and SHA256 instructions.
+ * This file is compiled with -march=armv8-a+crypto; it is only entered
+ * after common_cpu_features() has reported the matching HWCAP bits.
+ */
+
+#include "hash_internal.h"
+
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+namespace common {
+namespace hash_detail {
+
+static inline uint32x4_t load_be_u32x4(const uint8_t* p) {
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+void sha256_blocks_armv8(uint32_t state[8], const uint8_t* data, size_t num_blocks) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+
+    while (num_blocks--) {
+        uint32x4_t m[4];
+        for (int i = 0; i < 4; i++) {
+            m[i] = load_be_u32x4(data + i * 16);
+        }
+
+        uint32x4_t s0 = abcd;
+        uint32x4_t s1 = efgh;
+
+        // 16 groups of 4 rounds; the schedule for group g+4 is produced
+        // while group g is hashed.
+        for (int g = 0; g < 16; g++) {
+            uint32x4_t wk = vaddq_u32(m[g & 3], vld1q_u32(kSha256RoundConstants + g * 4));
+            if (g < 12) {
+                m[g & 3] = vsha256su1q_u32(vsha256su0q_u32(m[g & 3], m[(g + 1) & 3]),
+                                           m[(g + 2) & 3], m[(g + 3) & 3]);
+            }
+            uint32x4_t prev = s0;
+            s0 = vsha256hq_u32(s0, s1, wk);
+            s1 = vsha256h2q_u32(s1, prev, wk);
+        }
+
+        abcd = vaddq_u32(abcd, s0);
+        efgh = vaddq_u32(efgh, s1);
+        data += 64;
+    }
+
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+void sha1_blocks_armv8(uint32_t state[5], const uint8_t* data, size_t num_blocks) {
+    static const uint32_t kRoundConstants[4] = {
+        0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6
+    };
+
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e = state[4];
+
+    while (num_blocks--) {
+        uint32x4_t m[4];
+        for (int i = 0; i < 4; i++) {
+            m[i] = load_be_u32x4(data + i * 16);
+        }
+
+        uint32x4_t s = abcd;
+        uint32_t se = e;
+
+        // 20 groups of 4 rounds: choose, parity, majority, parity
+        for (int g = 0; g < 20; g++) {
+            int stage = g / 5;
+            uint32x4_t wk = vaddq_u32(m[g & 3], vdupq_n_u32(kRoundConstants[stage]));
+            uint32_t next_e = vsha1h_u32(vgetq_lane_u32(s, 0));
+
+            if (stage == 0) {
+                s = vsha1cq_u32(s, se, wk);
+            } else if (stage == 2) {
+                s = vsha1mq_u32(s, se, wk);
+            } else {
+                s = vsha1pq_u32(s, se, wk);
+            }
+            se = next_e;
+
+            if (g < 16) {
+                m[g & 3] = vsha1su1q_u32(vsha1su0q_u32(m[g & 3], m[(g + 1) & 3], m[(g + 2) & 3]),
+                                         m[(g + 3) & 3]);
+            }
+        }
+
+        abcd = vaddq_u32(abcd, s);
+        e += se;
+        data += 64;
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e;
+}
+
+} // namespace hash_detail
+} // namespace common
+
+#endif // __aarch64__
@@ -0,0 +1,162 @@
+/*
+ * common - Hash Engine Internals
+ *
+ * Block-function signatures, backend declarations and the shared
+ * buffering logic used by every Merkle-Damgard hash in the engine.
+ */
+
+#ifndef COMMON_HASH_INTERNAL_H
+#define COMMON_HASH_INTERNAL_H
+
+#include "common/hash.h"
+#include <string.h>
+
+namespace common {
+namespace hash_detail {
+
+typedef void (*Md5BlocksFn)(uint32_t state[4], const uint8_t* data, size_t num_blocks);
+typedef void (*Sha1BlocksFn)(uint32_t state[5], const uint8_t* data, size_t num_blocks);
+typedef void (*Sha256BlocksFn)(uint32_t state[8], const uint8_t* data, size_t num_blocks);
+typedef void (*Sha512BlocksFn)(uint64_t state[8], const uint8_t* data, size_t num_blocks);
+
+// Portable backends (always available)
+void md5_blocks_c(uint32_t state[4], const uint8_t* data, size_t num_blocks);
+void sha1_blocks_c(uint32_t state[5], const uint8_t* data, size_t num_blocks);
+void sha256_blocks_c(uint32_t state[8], const uint8_t* data, size_t num_blocks);
+void sha512_blocks_c(uint64_t state[8], const uint8_t* data, size_t num_blocks);
+
+// Four equal-length messages at once in SIMD lanes (full hash, with padding)
+void sha256_x4(const uint8_t* const data[4], size_t len, uint8_t digests[4][COMMON_SHA256_DIGEST_SIZE]);
+
+// Hardware backends; only built for the matching architecture
+#if defined(__aarch64__)
+void sha1_blocks_armv8(uint32_t state[5], const uint8_t* data, size_t num_blocks);
+void sha256_blocks_armv8(uint32_t state[8], const uint8_t* data, size_t num_blocks);
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+void sha1_blocks_shani(uint32_t state[5], const uint8_t* data, size_t num_blocks);
+void sha256_blocks_shani(uint32_t state[8], const uint8_t* data, size_t num_blocks);
+#endif
+
+// Selected once per process
+Sha1BlocksFn select_sha1_blocks(const char** backend);
+Sha256BlocksFn select_sha256_blocks(const char** backend);
+
+extern const uint32_t kSha256RoundConstants[64];
+
+static inline uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint64_t load_be64(const uint8_t* p) {
+    return ((uint64_t)load_be32(p) << 32) | load_be32(p + 4);
+}
+
+static inline uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline void store_be64(uint8_t* p, uint64_t v) {
+    store_be32(p, (uint32_t)(v >> 32));
+    store_be32(p + 4, (uint32_t)v);
+}
+
+static inline void store_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t rotl32(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+static inline uint32_t rotr32(uint32_t v, int n) {
+    return (v >> n) | (v << (32 - n));
+}
+
+static inline uint64_t rotr64(uint64_t v, int n) {
+    return (v >> n) | (v << (64 - n));
+}
+
+/**
+ * Absorb input into a context: fill the pending block, then hand every
+ * whole block straight from the caller's buffer to the block function.
+ */
+template <size_t BlockSize, typename State, typename BlocksFn>
+static inline void buffered_update(State* state, uint8_t* buffer, uint64_t* count,
+                                   const uint8_t* data, size_t len, BlocksFn blocks) {
+    size_t used = (size_t)(*count % BlockSize);
+    *count += len;
+
+    if (used != 0) {
+        size_t take = BlockSize - used;
+        if (len < take) {
+            memcpy(buffer + used, data, len);
+            return;
+        }
+        memcpy(buffer + used, data, take);
+        blocks(state, buffer, 1);
+        data += take;
+        len -= take;
+    }
+
+    size_t whole = len / BlockSize;
+    if (whole != 0) {
+        blocks(state, data, whole);
+        data += whole * BlockSize;
+        len -= whole * BlockSize;
+    }
+
+    if (len != 0) {
+        memcpy(buffer, data, len);
+    }
+}
+
+/**
+ * Apply 0x80 || zeros || length padding and compress the final block(s).
+ * length_bytes is 8 (MD5/SHA-1/SHA-256) or 16 (SHA-512).
+ */
+template <size_t BlockSize, size_t LengthBytes, bool BigEndian, typename State, typename BlocksFn>
+static inline void buffered_final(State* state, uint8_t* buffer, uint64_t count,
+                                  BlocksFn blocks) {
+    size_t used = (size_t)(count % BlockSize);
+    buffer[used++] = 0x80;
+
+    if (used > BlockSize - LengthBytes) {
+        memset(buffer + used, 0, BlockSize - used);
+        blocks(state, buffer, 1);
+        used = 0;
+    }
+    memset(buffer + used, 0, BlockSize - used);
+
+    uint64_t bits = count << 3;
+    uint8_t* tail = buffer + BlockSize - 8;
+    if (BigEndian) {
+        store_be64(tail, bits);
+        if (LengthBytes == 16) {
+            // High 64 bits of the 128-bit length
+            store_be64(tail - 8, count >> 61);
+        }
+    } else {
+        store_le32(tail, (uint32_t)bits);
+        store_le32(tail + 4, (uint32_t)(bits >> 32));
+    }
+
+    blocks(state, buffer, 1);
+}
+
+} // namespace hash_detail
+} // namespace common
+
+#endif // COMMON_HASH_INTERNAL_H
@@ -0,0 +1,92 @@
+/*
+ * common - SHA-1 (FIPS 180-4)
+ */
+
+#include "hash_internal.h"
+
+namespace common {
+namespace hash_detail {
+
+void sha1_blocks_c(uint32_t state[5], const uint8_t* data, size_t num_blocks) {
+    while (num_blocks--) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = load_be32(data + i * 4);
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = d ^ (b & (c ^ d));
+                k = 0x5a827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (i < 60) {
+                f = (b & c) | (d & (b | c));
+                k = 0x8f1bbcdc;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+
+            uint32_t temp = rotl32(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl32(b, 30);
+            b = a;
+            a = temp;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+
+        data += 64;
+    }
+}
+
+} // namespace hash_detail
+} // namespace common
+
+using namespace common::hash_detail;
+
+static Sha1BlocksFn sha1_blocks(void) {
+    static const Sha1BlocksFn fn = select_sha1_blocks(nullptr);
+    return fn;
+}
+
+void common_sha1_init(common_sha1_context_t* ctx) {
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xc3d2e1f0;
+    ctx->count = 0;
+}
+
+void common_sha1_update(common_sha1_context_t* ctx, const void* data, size_t len) {
+    buffered_update<64>(ctx->state, ctx->buffer, &ctx->count,
+                        static_cast<const uint8_t*>(data), len, sha1_blocks());
+}
+
+void common_sha1_final(common_sha1_context_t* ctx, uint8_t digest[COMMON_SHA1_DIGEST_SIZE]) {
+    buffered_final<64, 8, true>(ctx->state, ctx->buffer, ctx->count, sha1_blocks());
+    for (int i = 0; i < 5; i++) {
+        store_be32(digest + i * 4, ctx->state[i]);
+    }
+}
+
+void common_sha1(const void* data, size_t len, uint8_t digest[COMMON_SHA1_DIGEST_SIZE]) {
+    common_sha1_context_t ctx;
+    common_sha1_init(&ctx);
+    common_sha1_update(&ctx, data, len);
+    common_sha1_final(&ctx, digest);
+}
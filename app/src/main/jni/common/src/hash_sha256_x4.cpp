@@ -0,0 +1,130 @@
+/*
+ * common - Multi-buffer SHA-256
+ *
+ * Compresses four independent messages at once, one per 32-bit SIMD lane.
+ * Built with the baseline vector unit (SSE2 / NEON) through the compiler's
+ * generic vector types, so it needs no extra target flags. Only used when
+ * the CPU lacks SHA instructions: a single hardware stream beats four
+ * software lanes.
+ */
+
+#include "hash_internal.h"
+#include "common/cpu_features.h"
+
+namespace common {
+namespace hash_detail {
+
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+
+static inline u32x4 splat(uint32_t v) {
+    return u32x4{v, v, v, v};
+}
+
+static inline u32x4 rotr(u32x4 v, int n) {
+    return (v >> n) | (v << (32 - n));
+}
+
+// Message word i of the current block from each lane
+static inline u32x4 load_words(const uint8_t* const lanes[4], size_t offset) {
+    return u32x4{load_be32(lanes[0] + offset), load_be32(lanes[1] + offset),
+                 load_be32(lanes[2] + offset), load_be32(lanes[3] + offset)};
+}
+
+static void sha256_x4_blocks(u32x4 state[8], const uint8_t* const lanes[4], size_t num_blocks) {
+    for (size_t block = 0; block < num_blocks; block++) {
+        u32x4 w[16];
+        for (int i = 0; i < 16; i++) {
+            w[i] = load_words(lanes, block * 64 + i * 4);
+        }
+
+        u32x4 a = state[0], b = state[1], c = state[2], d = state[3];
+        u32x4 e = state[4], f = state[5], g = state[6], h = state[7];
+
+        // Rolling 16-word schedule keeps the working set in registers
+        for (int i = 0; i < 64; i++) {
+            u32x4 wi;
+            if (i < 16) {
+                wi = w[i];
+            } else {
+                u32x4 w15 = w[(i - 15) & 15];
+                u32x4 w2 = w[(i - 2) & 15];
+                u32x4 s0 = rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3);
+                u32x4 s1 = rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10);
+                wi = w[i & 15] = w[i & 15] + s0 + w[(i - 7) & 15] + s1;
+            }
+
+            u32x4 S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            u32x4 ch = (e & f) ^ (~e & g);
+            u32x4 t1 = h + S1 + ch + splat(kSha256RoundConstants[i]) + wi;
+            u32x4 S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            u32x4 maj = (a & b) ^ (a & c) ^ (b & c);
+            u32x4 t2 = S0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+void sha256_x4(const uint8_t* const data[4], size_t len, uint8_t digests[4][COMMON_SHA256_DIGEST_SIZE]) {
+    static const uint32_t kInit[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    u32x4 state[8];
+    for (int i = 0; i < 8; i++) {
+        state[i] = splat(kInit[i]);
+    }
+
+    size_t whole = len / 64;
+    sha256_x4_blocks(state, data, whole);
+
+    // Equal lengths mean every lane pads identically: one or two blocks
+    size_t rest = len - whole * 64;
+    size_t tail_blocks = rest + 9 > 64 ? 2 : 1;
+    uint8_t tails[4][128];
+    const uint8_t* tail_lanes[4];
+    for (int lane = 0; lane < 4; lane++) {
+        uint8_t* tail = tails[lane];
+        memcpy(tail, data[lane] + whole * 64, rest);
+        tail[rest] = 0x80;
+        memset(tail + rest + 1, 0, tail_blocks * 64 - rest - 1);
+        store_be64(tail + tail_blocks * 64 - 8, (uint64_t)len << 3);
+        tail_lanes[lane] = tail;
+    }
+    sha256_x4_blocks(state, tail_lanes, tail_blocks);
+
+    for (int lane = 0; lane < 4; lane++) {
+        for (int i = 0; i < 8; i++) {
+            store_be32(digests[lane] + i * 4, state[i][lane]);
+        }
+    }
+}
+
+} // namespace hash_detail
+} // namespace common
+
+using namespace common::hash_detail;
+
+void common_sha256_multi(const uint8_t* const* data, size_t len,
+                         uint8_t (*digests)[COMMON_SHA256_DIGEST_SIZE], size_t count) {
+    size_t i = 0;
+    if (!common_cpu_has(COMMON_CPU_SHA256)) {
+        for (; i + 4 <= count; i += 4) {
+            sha256_x4(data + i, len, digests + i);
+        }
+    }
+    for (; i < count; i++) {
+        common_sha256(data[i], len, digests[i]);
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * common - x86 SHA Extension Hash Backends
+ *
+ * SHA-1 and SHA-256 block functions using SHA-NI. This file is compiled
+ * with -msse4.1 -msha; it is only entered after common_cpu_features() has
+ * reported SHA-NI support. Covers the x86/x86_64 Android ABIs (emulators,
+ * Chromebooks).
+ */
+
+#include "hash_internal.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+namespace common {
+namespace hash_detail {
+
+void sha256_blocks_shani(uint32_t state[8], const uint8_t* data, size_t num_blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The instructions work on the ABEF / CDGH register split
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+    __m128i cdgh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    cdgh = _mm_shuffle_epi32(cdgh, 0x1B);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+    while (num_blocks--) {
+        __m128i m[4];
+        for (int i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byte_swap);
+        }
+
+        __m128i abef_save = abef;
+        __m128i cdgh_save = cdgh;
+
+        for (int g = 0; g < 16; g++) {
+            __m128i wk = _mm_add_epi32(m[g & 3], _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(kSha256RoundConstants + g * 4)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0E));
+
+            if (g < 12) {
+                __m128i w = _mm_sha256msg1_epu32(m[g & 3], m[(g + 1) & 3]);
+                w = _mm_add_epi32(w, _mm_alignr_epi8(m[(g + 3) & 3], m[(g + 2) & 3], 4));
+                m[g & 3] = _mm_sha256msg2_epu32(w, m[(g + 3) & 3]);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    abef = _mm_blend_epi16(tmp, cdgh, 0xF0);
+    cdgh = _mm_alignr_epi8(cdgh, tmp, 8);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abef);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), cdgh);
+}
+
+void sha1_blocks_shani(uint32_t state[5], const uint8_t* data, size_t num_blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    while (num_blocks--) {
+        __m128i m[4];
+        for (int i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byte_swap);
+        }
+
+        __m128i abcd_save = abcd;
+        __m128i e_save = e0;
+        __m128i e_prev = e0;
+
+        // 20 groups of 4 rounds. Message word group k (k >= 4) is built by
+        // msg1 in group k-3, xor in group k-2 and msg2 in group k-1.
+        for (int g = 0; g < 20; g++) {
+            __m128i wk = (g == 0) ? _mm_add_epi32(e0, m[0])
+                                  : _mm_sha1nexte_epu32(e_prev, m[g & 3]);
+            e_prev = abcd;
+
+            if (g >= 3 && g <= 18) {
+                m[(g + 1) & 3] = _mm_sha1msg2_epu32(m[(g + 1) & 3], m[g & 3]);
+            }
+
+            switch (g / 5) {
+                case 0:  abcd = _mm_sha1rnds4_epu32(abcd, wk, 0); break;
+                case 1:  abcd = _mm_sha1rnds4_epu32(abcd, wk, 1); break;
+                case 2:  abcd = _mm_sha1rnds4_epu32(abcd, wk, 2); break;
+                default: abcd = _mm_sha1rnds4_epu32(abcd, wk, 3); break;
+            }
+
+            if (g >= 1 && g <= 16) {
+                m[(g - 1) & 3] = _mm_sha1msg1_epu32(m[(g - 1) & 3], m[g & 3]);
+            }
+            if (g >= 2 && g <= 17) {
+                m[(g - 2) & 3] = _mm_xor_si128(m[(g - 2) & 3], m[g & 3]);
+            }
+        }
+
+        e0 = _mm_sha1nexte_epu32(e_prev, e_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+        data += 64;
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+} // namespace hash_detail
+} // namespace common
+
+#endif // __x86_64__ || __i386__
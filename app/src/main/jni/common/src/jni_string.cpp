@@ -0,0 +1,239 @@
+/*
+ * common - JNI Strings
+ */
+
+#include "common/jni_string.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace common {
+namespace jni_string_detail {
+
+namespace {
+
+// Per-thread bump allocator for strings too long for inline storage.
+// Allocations are released in LIFO order by their scoped owners, so the
+// arena only ever needs a mark to roll back to.
+struct ScratchArena {
+    char* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+
+    ~ScratchArena() { free(base); }
+};
+
+constexpr size_t kArenaMinCapacity = 4096;
+constexpr size_t kArenaMaxRetained = 256 * 1024;   // Larger arenas are freed once idle
+
+thread_local ScratchArena t_arena;
+
+// Returns nullptr when the arena cannot grow because live views point into it
+char* arenaAlloc(size_t size, size_t* mark) {
+    ScratchArena& arena = t_arena;
+    if (size > arena.capacity - arena.used) {
+        if (arena.used != 0) return nullptr;
+
+        size_t capacity = arena.capacity ? arena.capacity : kArenaMinCapacity;
+        while (capacity < size) capacity *= 2;
+        char* base = static_cast<char*>(malloc(capacity));
+        if (!base) return nullptr;
+        free(arena.base);
+        arena.base = base;
+        arena.capacity = capacity;
+    }
+
+    *mark = arena.used;
+    arena.used += size;
+    return arena.base + *mark;
+}
+
+void arenaRelease(size_t mark) {
+    ScratchArena& arena = t_arena;
+    arena.used = mark;
+    if (mark == 0 && arena.capacity > kArenaMaxRetained) {
+        free(arena.base);
+        arena.base = nullptr;
+        arena.capacity = 0;
+    }
+}
+
+// Scratch output buffer for newStringUtf(): stack first, then the arena,
+// then the heap
+class Scratch {
+public:
+    explicit Scratch(size_t size) {
+        if (size <= sizeof(stack_)) {
+            data_ = stack_;
+        } else if ((data_ = arenaAlloc(size, &mark_)) != nullptr) {
+            in_arena_ = true;
+        } else {
+            data_ = static_cast<char*>(malloc(size));
+        }
+    }
+    ~Scratch() {
+        if (in_arena_) arenaRelease(mark_);
+        else if (data_ != stack_) free(data_);
+    }
+
+    Scratch(const Scratch&) = delete;
+    Scratch& operator=(const Scratch&) = delete;
+
+    char* data() const { return data_; }
+
+private:
+    char* data_ = nullptr;
+    size_t mark_ = 0;
+    bool in_arena_ = false;
+    char stack_[512];
+};
+
+inline bool isContinuation(uint8_t byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+// Length of the well-formed modified UTF-8 sequence at p, or 0
+size_t sequenceLength(const uint8_t* p, size_t remaining) {
+    uint8_t lead = p[0];
+    if (lead != 0 && lead < 0x80) return 1;
+    if ((lead & 0xE0) == 0xC0) {
+        return remaining >= 2 && isContinuation(p[1]) ? 2 : 0;
+    }
+    if ((lead & 0xF0) == 0xE0) {
+        return remaining >= 3 && isContinuation(p[1]) && isContinuation(p[2]) ? 3 : 0;
+    }
+    return 0;   // NUL, stray continuation or 4-byte lead
+}
+
+// Standard UTF-8 4-byte sequence at p, decoded; 0 if not well formed
+uint32_t decodeFourByte(const uint8_t* p, size_t remaining) {
+    if (remaining < 4 || (p[0] & 0xF8) != 0xF0 ||
+        !isContinuation(p[1]) || !isContinuation(p[2]) || !isContinuation(p[3])) {
+        return 0;
+    }
+    uint32_t cp = (static_cast<uint32_t>(p[0] & 0x07) << 18) |
+                  (static_cast<uint32_t>(p[1] & 0x3F) << 12) |
+                  (static_cast<uint32_t>(p[2] & 0x3F) << 6) |
+                  static_cast<uint32_t>(p[3] & 0x3F);
+    return cp >= 0x10000 && cp <= 0x10FFFF ? cp : 0;
+}
+
+inline char* putThreeByte(char* out, uint32_t unit) {
+    *out++ = static_cast<char>(0xE0 | (unit >> 12));
+    *out++ = static_cast<char>(0x80 | ((unit >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+    return out;
+}
+
+// Re-encode into out, which must hold 3 * size + 1 bytes (the worst case is
+// every byte malformed, each becoming a 3-byte U+FFFD)
+size_t toModifiedUtf8(const uint8_t* in, size_t size, char* out) {
+    char* start = out;
+    size_t i = 0;
+    while (i < size) {
+        size_t len = sequenceLength(in + i, size - i);
+        if (len != 0) {
+            memcpy(out, in + i, len);
+            out += len;
+            i += len;
+        } else if (in[i] == 0) {
+            *out++ = static_cast<char>(0xC0);
+            *out++ = static_cast<char>(0x80);
+            i++;
+        } else if (uint32_t cp = decodeFourByte(in + i, size - i)) {
+            cp -= 0x10000;
+            out = putThreeByte(out, 0xD800 | (cp >> 10));
+            out = putThreeByte(out, 0xDC00 | (cp & 0x3FF));
+            i += 4;
+        } else {
+            out = putThreeByte(out, 0xFFFD);
+            i++;
+        }
+    }
+    *out = '\0';
+    return static_cast<size_t>(out - start);
+}
+
+} // namespace
+
+} // namespace jni_string_detail
+
+using namespace jni_string_detail;
+
+bool isModifiedUtf8(const char* data, size_t size) noexcept {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+    while (i < size) {
+        // ASCII runs are the common case
+        if (p[i] != 0 && p[i] < 0x80) {
+            i++;
+            continue;
+        }
+        size_t len = sequenceLength(p + i, size - i);
+        if (len == 0) return false;
+        i += len;
+    }
+    return true;
+}
+
+// ============================================================================
+// JniUtf8
+// ============================================================================
+
+JniUtf8::JniUtf8(JNIEnv* env, jstring str) noexcept : arena_mark_(0) {
+    if (!env || !str) return;
+
+    jsize utf16_length = env->GetStringLength(str);
+    jsize utf8_length = env->GetStringUTFLength(str);
+    if (utf8_length < 0) return;
+
+    size_t needed = static_cast<size_t>(utf8_length) + 1;
+    char* data = inline_;
+    if (needed > sizeof(inline_)) {
+        data = arenaAlloc(needed, &arena_mark_);
+        if (data) {
+            in_arena_ = true;
+        } else {
+            // Arena pinned by an enclosing view; rare enough to allocate
+            data = static_cast<char*>(malloc(needed));
+            if (!data) return;
+            on_heap_ = true;
+        }
+    }
+
+    env->GetStringUTFRegion(str, 0, utf16_length, data);
+    data[utf8_length] = '\0';
+    data_ = data;
+    size_ = static_cast<size_t>(utf8_length);
+}
+
+JniUtf8::~JniUtf8() {
+    if (in_arena_) arenaRelease(arena_mark_);
+    else if (on_heap_) free(data_);
+}
+
+// ============================================================================
+// Native to Java
+// ============================================================================
+
+jstring newStringUtf(JNIEnv* env, const char* data, size_t size, bool nul_terminated) noexcept {
+    if (!env || !data) return nullptr;
+
+    if (isModifiedUtf8(data, size)) {
+        if (nul_terminated) return env->NewStringUTF(data);
+
+        Scratch copy(size + 1);
+        if (!copy.data()) return nullptr;
+        memcpy(copy.data(), data, size);
+        copy.data()[size] = '\0';
+        return env->NewStringUTF(copy.data());
+    }
+
+    Scratch encoded(size * 3 + 1);
+    if (!encoded.data()) return nullptr;
+    toModifiedUtf8(reinterpret_cast<const uint8_t*>(data), size, encoded.data());
+    return env->NewStringUTF(encoded.data());
+}
+
+} // namespace common
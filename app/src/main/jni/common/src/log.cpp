@@ -0,0 +1,940 @@
+/*
+ * common - Logging
+ *
+ * Each producing thread owns a single-producer/single-consumer byte ring.
+ * A record is a header, the copied tag and the raw arguments, pulled out of
+ * the va_list by walking the format string; nothing is formatted on the
+ * calling thread. The logging thread walks the same format string again to
+ * rebuild each conversion with snprintf and passes the line to the sink.
+ */
+
+#include "common/log.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+namespace common {
+namespace log_detail {
+
+namespace {
+
+constexpr size_t kRingSize = 64 * 1024;            // Per thread, power of two
+constexpr size_t kMaxRecord = 2048;                // Contiguous space reserved per record
+constexpr size_t kMaxTag = 63;
+constexpr size_t kMaxMessage = 4096;               // Logcat truncates beyond this anyway
+constexpr size_t kHexChunk = 512;                  // Dump bytes per record
+
+// Idle wait after a busy drain so bursts are written in batches and
+// producers rarely need to wake the logging thread
+constexpr auto kBatchWindow = std::chrono::milliseconds(2);
+
+constexpr const char* kDefaultTag = "native";
+constexpr const char* kSelfTag = "common-log";
+
+enum RecordKind : uint8_t {
+    kPad,                   // Filler up to the end of the ring
+    kFormat,                // Format string and captured arguments
+    kHex                    // Slice of a hex dump
+};
+
+struct RecordHeader {
+    uint32_t size;          // Whole record, multiple of 8
+    uint8_t kind;
+    uint8_t level;
+    uint8_t truncated;      // Arguments did not all fit
+    uint8_t tag_len;
+    uint64_t time_ns;
+    const char* fmt;
+};
+
+inline size_t align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+struct Ring {
+    alignas(64) std::atomic<uint64_t> head{0};     // Written by the owner thread
+    alignas(64) std::atomic<uint64_t> tail{0};     // Written by the logging thread
+    std::atomic<uint64_t> dropped{0};
+    uint64_t dropped_reported = 0;
+    std::atomic<bool> retired{false};              // Owner thread has exited
+    uint32_t tid = 0;
+    uint8_t* data = nullptr;
+    Ring* next = nullptr;
+};
+
+// ============================================================================
+// Format String Walking
+// ============================================================================
+
+enum class Length { None, Char, Short, Long, LongLong, IntMax, Size, PtrDiff, LongDouble };
+
+struct Spec {
+    const char* begin;      // Points at '%'
+    size_t len;             // Through the conversion character
+    size_t width_end;       // Offset just past the flags and width
+    bool width_star;
+    bool precision_star;
+    bool has_precision;
+    int precision;          // Literal precision, if any
+    Length length;
+    char conv;              // 0 for something printf would not accept
+};
+
+// Parse the conversion at p ('%'); returns the character after it
+const char* parseSpec(const char* p, Spec* spec) {
+    spec->begin = p++;
+    spec->width_star = spec->precision_star = spec->has_precision = false;
+    spec->precision = 0;
+    spec->length = Length::None;
+    spec->conv = 0;
+
+    while (*p && strchr("-+ #0'", *p)) p++;
+    if (*p == '*') {
+        spec->width_star = true;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    spec->width_end = static_cast<size_t>(p - spec->begin);
+    if (*p == '.') {
+        spec->has_precision = true;
+        p++;
+        if (*p == '*') {
+            spec->precision_star = true;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                spec->precision = spec->precision * 10 + (*p - '0');
+                p++;
+            }
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            p++;
+            if (*p == 'h') { spec->length = Length::Char; p++; }
+            else spec->length = Length::Short;
+            break;
+        case 'l':
+            p++;
+            if (*p == 'l') { spec->length = Length::LongLong; p++; }
+            else spec->length = Length::Long;
+            break;
+        case 'q': spec->length = Length::LongLong; p++; break;
+        case 'j': spec->length = Length::IntMax; p++; break;
+        case 'z': spec->length = Length::Size; p++; break;
+        case 't': spec->length = Length::PtrDiff; p++; break;
+        case 'L': spec->length = Length::LongDouble; p++; break;
+        default: break;
+    }
+
+    if (*p && strchr("diouxXcsfFeEgGaApnm%", *p)) {
+        spec->conv = *p++;
+    }
+    spec->len = static_cast<size_t>(p - spec->begin);
+    return p;
+}
+
+// ============================================================================
+// Record Encoding
+// ============================================================================
+
+class Writer {
+public:
+    Writer(uint8_t* begin, uint8_t* end) : p_(begin), end_(end) {}
+
+    template<typename T>
+    bool put(T value) {
+        size_t size = align8(sizeof(T));
+        if (static_cast<size_t>(end_ - p_) < size) return overflow();
+        memcpy(p_, &value, sizeof(T));
+        p_ += size;
+        return true;
+    }
+
+    // Length-prefixed copy of at most max bytes
+    bool putString(const char* str, size_t max) {
+        if (!str) str = "(null)";
+        size_t room = static_cast<size_t>(end_ - p_);
+        if (room < 8) return overflow();
+        size_t len = strnlen(str, max < room - 8 ? max : room - 8);
+        uint32_t len32 = static_cast<uint32_t>(len);
+        memcpy(p_, &len32, sizeof(len32));
+        memcpy(p_ + 8, str, len);
+        p_ += 8 + align8(len);
+        if (len < max && str[len] != '\0') overflowed_ = true;
+        return true;
+    }
+
+    bool putBytes(const void* data, size_t len) {
+        if (static_cast<size_t>(end_ - p_) < align8(len)) return overflow();
+        memcpy(p_, data, len);
+        p_ += align8(len);
+        return true;
+    }
+
+    uint8_t* position() const { return p_; }
+    bool overflowed() const { return overflowed_; }
+
+private:
+    bool overflow() {
+        overflowed_ = true;
+        return false;
+    }
+
+    uint8_t* p_;
+    uint8_t* end_;
+    bool overflowed_ = false;
+};
+
+// Copy every argument fmt consumes, in order. Integers are widened to 64
+// bits; the consumer narrows them back using the same length modifiers.
+void encodeArgs(Writer& out, const char* fmt, va_list args, int saved_errno) {
+    const char* p = fmt;
+    while ((p = strchr(p, '%')) != nullptr) {
+        Spec spec;
+        p = parseSpec(p, &spec);
+
+        int precision = spec.has_precision ? spec.precision : -1;
+        if (spec.width_star && !out.put<int64_t>(va_arg(args, int))) return;
+        if (spec.precision_star) {
+            precision = va_arg(args, int);
+            if (!out.put<int64_t>(precision)) return;
+        }
+
+        bool ok = true;
+        switch (spec.conv) {
+            case 'd': case 'i':
+                switch (spec.length) {
+                    case Length::Long: ok = out.put<int64_t>(va_arg(args, long)); break;
+                    case Length::LongLong: ok = out.put<int64_t>(va_arg(args, long long)); break;
+                    case Length::IntMax: ok = out.put<int64_t>(va_arg(args, intmax_t)); break;
+                    case Length::Size: ok = out.put<int64_t>(va_arg(args, ssize_t)); break;
+                    case Length::PtrDiff: ok = out.put<int64_t>(va_arg(args, ptrdiff_t)); break;
+                    default: ok = out.put<int64_t>(va_arg(args, int)); break;
+                }
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                switch (spec.length) {
+                    case Length::Long: ok = out.put<uint64_t>(va_arg(args, unsigned long)); break;
+                    case Length::LongLong: ok = out.put<uint64_t>(va_arg(args, unsigned long long)); break;
+                    case Length::IntMax: ok = out.put<uint64_t>(va_arg(args, uintmax_t)); break;
+                    case Length::Size: ok = out.put<uint64_t>(va_arg(args, size_t)); break;
+                    case Length::PtrDiff: ok = out.put<uint64_t>(va_arg(args, ptrdiff_t)); break;
+                    default: ok = out.put<uint64_t>(va_arg(args, unsigned int)); break;
+                }
+                break;
+            case 'c':
+                if (spec.length == Length::Long) {
+                    ok = out.put<int64_t>(static_cast<int64_t>(va_arg(args, wint_t)));
+                } else {
+                    ok = out.put<int64_t>(va_arg(args, int));
+                }
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                if (spec.length == Length::LongDouble) {
+                    ok = out.put<long double>(va_arg(args, long double));
+                } else {
+                    ok = out.put<double>(va_arg(args, double));
+                }
+                break;
+            case 's':
+                if (spec.length == Length::Long) {
+                    // Wide strings are not worth a conversion here
+                    va_arg(args, const wchar_t*);
+                    ok = out.putString("(wide string)", kMaxRecord);
+                } else {
+                    // A precision bounds the read, so unterminated buffers are fine
+                    ok = out.putString(va_arg(args, const char*),
+                                       precision >= 0 ? static_cast<size_t>(precision) : kMaxRecord);
+                }
+                break;
+            case 'p':
+                ok = out.put<uint64_t>(reinterpret_cast<uintptr_t>(va_arg(args, void*)));
+                break;
+            case 'n':
+                va_arg(args, void*);          // Never written through
+                break;
+            case 'm':
+                ok = out.put<int64_t>(saved_errno);
+                break;
+            default:
+                break;
+        }
+        if (!ok) return;
+    }
+}
+
+// ============================================================================
+// Record Decoding
+// ============================================================================
+
+class Reader {
+public:
+    Reader(const uint8_t* begin, const uint8_t* end) : p_(begin), end_(end) {}
+
+    template<typename T>
+    bool get(T* value) {
+        size_t size = align8(sizeof(T));
+        if (static_cast<size_t>(end_ - p_) < size) return false;
+        memcpy(value, p_, sizeof(T));
+        p_ += size;
+        return true;
+    }
+
+    bool getString(const char** str, size_t* len) {
+        uint32_t len32;
+        if (static_cast<size_t>(end_ - p_) < 8) return false;
+        memcpy(&len32, p_, sizeof(len32));
+        if (static_cast<size_t>(end_ - p_) - 8 < len32) return false;
+        *str = reinterpret_cast<const char*>(p_ + 8);
+        *len = len32;
+        p_ += 8 + align8(len32);
+        return true;
+    }
+
+    const uint8_t* position() const { return p_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+class Message {
+public:
+    void append(const char* str, size_t len) {
+        size_t room = sizeof(buf_) - 1 - len_;
+        if (len > room) len = room;
+        memcpy(buf_ + len_, str, len);
+        len_ += len;
+    }
+
+    // snprintf one conversion with the given leading '*' values
+    template<typename T>
+    void emit(const char* spec, const int* stars, int star_count, T value) {
+        size_t room = sizeof(buf_) - len_;
+        int n;
+        if (star_count == 0) {
+            n = snprintf(buf_ + len_, room, spec, value);
+        } else if (star_count == 1) {
+            n = snprintf(buf_ + len_, room, spec, stars[0], value);
+        } else {
+            n = snprintf(buf_ + len_, room, spec, stars[0], stars[1], value);
+        }
+        if (n > 0) len_ += static_cast<size_t>(n) < room ? static_cast<size_t>(n) : room - 1;
+    }
+
+    const char* c_str() {
+        buf_[len_] = '\0';
+        return buf_;
+    }
+
+private:
+    char buf_[kMaxMessage];
+    size_t len_ = 0;
+};
+
+// Rebuild the message from the format string and the captured arguments
+void formatRecord(Message& msg, const char* fmt, Reader& in, bool truncated) {
+    const char* p = fmt;
+    for (;;) {
+        const char* pct = strchr(p, '%');
+        if (!pct) {
+            msg.append(p, strlen(p));
+            break;
+        }
+        msg.append(p, static_cast<size_t>(pct - p));
+
+        Spec spec;
+        p = parseSpec(pct, &spec);
+        if (spec.conv == 0) {
+            msg.append(spec.begin, spec.len);
+            continue;
+        }
+        if (spec.conv == '%') {
+            msg.append("%", 1);
+            continue;
+        }
+
+        char conv[32];
+        if (spec.len >= sizeof(conv)) {
+            msg.append(spec.begin, spec.len);
+            continue;
+        }
+        memcpy(conv, spec.begin, spec.len);
+        conv[spec.len] = '\0';
+
+        int stars[2];
+        int star_count = 0;
+        int64_t star;
+        bool ok = true;
+        if (spec.width_star && (ok = in.get(&star))) stars[star_count++] = static_cast<int>(star);
+        if (ok && spec.precision_star && (ok = in.get(&star))) stars[star_count++] = static_cast<int>(star);
+
+        int64_t s;
+        uint64_t u;
+        switch (spec.conv) {
+            case 'd': case 'i':
+                if (!(ok = ok && in.get(&s))) break;
+                switch (spec.length) {
+                    case Length::Long: msg.emit(conv, stars, star_count, static_cast<long>(s)); break;
+                    case Length::LongLong: msg.emit(conv, stars, star_count, static_cast<long long>(s)); break;
+                    case Length::IntMax: msg.emit(conv, stars, star_count, static_cast<intmax_t>(s)); break;
+                    case Length::Size: msg.emit(conv, stars, star_count, static_cast<ssize_t>(s)); break;
+                    case Length::PtrDiff: msg.emit(conv, stars, star_count, static_cast<ptrdiff_t>(s)); break;
+                    default: msg.emit(conv, stars, star_count, static_cast<int>(s)); break;
+                }
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                if (!(ok = ok && in.get(&u))) break;
+                switch (spec.length) {
+                    case Length::Long: msg.emit(conv, stars, star_count, static_cast<unsigned long>(u)); break;
+                    case Length::LongLong: msg.emit(conv, stars, star_count, static_cast<unsigned long long>(u)); break;
+                    case Length::IntMax: msg.emit(conv, stars, star_count, static_cast<uintmax_t>(u)); break;
+                    case Length::Size: msg.emit(conv, stars, star_count, static_cast<size_t>(u)); break;
+                    case Length::PtrDiff: msg.emit(conv, stars, star_count, static_cast<ptrdiff_t>(u)); break;
+                    default: msg.emit(conv, stars, star_count, static_cast<unsigned int>(u)); break;
+                }
+                break;
+            case 'c':
+                if (!(ok = ok && in.get(&s))) break;
+                if (spec.length == Length::Long) {
+                    msg.emit(conv, stars, star_count, static_cast<wint_t>(s));
+                } else {
+                    msg.emit(conv, stars, star_count, static_cast<int>(s));
+                }
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                if (spec.length == Length::LongDouble) {
+                    long double value;
+                    if ((ok = ok && in.get(&value))) msg.emit(conv, stars, star_count, value);
+                } else {
+                    double value;
+                    if ((ok = ok && in.get(&value))) msg.emit(conv, stars, star_count, value);
+                }
+                break;
+            case 's': {
+                // The copy holds exactly the bytes to print (any precision was
+                // applied when capturing), so keep flags and width and bound
+                // the read to the copy
+                const char* str;
+                size_t len;
+                if (!(ok = ok && in.getString(&str, &len))) break;
+                char bounded[sizeof(conv) + 4];
+                memcpy(bounded, conv, spec.width_end);
+                memcpy(bounded + spec.width_end, ".*s", 4);
+                int bounded_stars[2] = { stars[0], static_cast<int>(len) };
+                if (spec.width_star) {
+                    msg.emit(bounded, bounded_stars, 2, str);
+                } else {
+                    msg.emit(bounded, bounded_stars + 1, 1, str);
+                }
+                break;
+            }
+            case 'p':
+                if ((ok = ok && in.get(&u))) {
+                    msg.emit(conv, stars, star_count, reinterpret_cast<void*>(static_cast<uintptr_t>(u)));
+                }
+                break;
+            case 'n':
+                break;
+            case 'm':
+                if ((ok = ok && in.get(&s))) {
+                    const char* text = strerror(static_cast<int>(s));
+                    msg.append(text, strlen(text));
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (!ok) {
+            if (!truncated) msg.append(" [bad record]", 13);
+            break;
+        }
+    }
+
+    // A clipped string still decodes, so mark every truncated record
+    if (truncated) msg.append(" [truncated]", 12);
+}
+
+// ============================================================================
+// Sinks
+// ============================================================================
+
+char levelChar(int level) {
+    switch (level) {
+        case COMMON_LOG_VERBOSE: return 'V';
+        case COMMON_LOG_DEBUG: return 'D';
+        case COMMON_LOG_INFO: return 'I';
+        case COMMON_LOG_WARN: return 'W';
+        case COMMON_LOG_ERROR: return 'E';
+        default: return 'F';
+    }
+}
+
+void writeLine(FILE* file, int level, const char* tag, const char* message,
+               uint64_t time_ns, uint32_t tid) {
+    time_t seconds = static_cast<time_t>(time_ns / 1000000000ull);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%m-%d %H:%M:%S", &local);
+    fprintf(file, "%s.%03u %5u %c %s: %s\n", stamp,
+            static_cast<unsigned>(time_ns / 1000000ull % 1000), tid, levelChar(level), tag, message);
+}
+
+void defaultSink(void*, int level, const char* tag, const char* message, uint64_t time_ns, uint32_t tid) {
+#ifdef __ANDROID__
+    (void)time_ns;
+    (void)tid;
+    __android_log_write(level, tag, message);
+#else
+    writeLine(stderr, level, tag, message, time_ns, tid);
+#endif
+}
+
+void fileSink(void* user, int level, const char* tag, const char* message, uint64_t time_ns, uint32_t tid) {
+    writeLine(static_cast<FILE*>(user), level, tag, message, time_ns, tid);
+}
+
+// ============================================================================
+// Shared State
+// ============================================================================
+
+std::atomic<int> g_level{COMMON_LOG_VERBOSE};
+std::atomic<uint64_t> g_dropped{0};
+
+// Locks and condition variables live on the heap and are never destroyed:
+// the logging thread is still waiting on them while static destructors run
+struct Sync {
+    std::mutex rings_mutex;          // Ring registry; producers only lock to register
+    std::mutex sink_mutex;
+    std::mutex wake_mutex;           // Logging thread wake-up and flush handshake
+    std::condition_variable wake_cv;
+    std::condition_variable flush_cv;
+};
+
+Sync& shared() {
+    static Sync* instance = new Sync;
+    return *instance;
+}
+
+Ring* g_rings = nullptr;
+
+common_log_sink_fn g_sink = defaultSink;
+void* g_sink_user = nullptr;
+FILE* g_file = nullptr;
+
+std::once_flag g_start_once;
+std::atomic<bool> g_idle{false};
+std::atomic<bool> g_urgent{false};   // A ring is past half full
+std::atomic<bool> g_started{false};
+uint64_t g_flush_requested = 0;      // Guarded by Sync::wake_mutex
+uint64_t g_flush_done = 0;
+pthread_t g_thread;
+
+pthread_key_t g_ring_key;
+thread_local Ring* t_ring = nullptr;
+
+uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// ============================================================================
+// Logging Thread
+// ============================================================================
+
+void emit(int level, const char* tag, const char* message, uint64_t time_ns, uint32_t tid) {
+    std::lock_guard<std::mutex> lock(shared().sink_mutex);
+    g_sink(g_sink_user, level, tag, message, time_ns, tid);
+}
+
+void emitRecord(const RecordHeader& hdr, const uint8_t* body, const uint8_t* end, uint32_t tid) {
+    char tag[kMaxTag + 1];
+    memcpy(tag, body, hdr.tag_len);
+    tag[hdr.tag_len] = '\0';
+    Reader in(body + align8(hdr.tag_len), end);
+
+    if (hdr.kind == kFormat) {
+        Message msg;
+        formatRecord(msg, hdr.fmt, in, hdr.truncated != 0);
+        emit(hdr.level, tag, msg.c_str(), hdr.time_ns, tid);
+        return;
+    }
+
+    // Hex dump slice: offset and length, then the bytes
+    uint64_t offset, len64;
+    if (!in.get(&offset) || !in.get(&len64) || len64 > in.remaining()) return;
+    const uint8_t* bytes = in.position();
+    size_t len = static_cast<size_t>(len64);
+    for (size_t i = 0; i < len; i += 16) {
+        char line[128];
+        int n = snprintf(line, sizeof(line), "%04zx: ", static_cast<size_t>(offset) + i);
+        for (size_t j = 0; j < 16 && i + j < len; j++) {
+            n += snprintf(line + n, sizeof(line) - static_cast<size_t>(n), "%02x ", bytes[i + j]);
+        }
+        emit(hdr.level, tag, line, hdr.time_ns, tid);
+    }
+}
+
+// Drain one ring; returns true if it held records
+bool drainRing(Ring* ring) {
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    bool any = tail != head;
+
+    while (tail != head) {
+        const uint8_t* rec = ring->data + (tail & (kRingSize - 1));
+        RecordHeader hdr;
+        memcpy(&hdr, rec, sizeof(uint32_t) + sizeof(uint8_t));
+        if (hdr.kind != kPad) {
+            memcpy(&hdr, rec, sizeof(hdr));
+            emitRecord(hdr, rec + align8(sizeof(hdr)), rec + hdr.size, ring->tid);
+        }
+        tail += hdr.size;
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+    if (dropped != ring->dropped_reported) {
+        char line[96];
+        snprintf(line, sizeof(line), "%llu records dropped (ring full)",
+                 static_cast<unsigned long long>(dropped - ring->dropped_reported));
+        ring->dropped_reported = dropped;
+        emit(COMMON_LOG_WARN, kSelfTag, line, nowNs(), ring->tid);
+    }
+    return any;
+}
+
+// Drain every ring and free those whose thread has exited
+bool drainAll() {
+    bool any = false;
+    std::lock_guard<std::mutex> lock(shared().rings_mutex);
+    for (Ring** link = &g_rings; *link;) {
+        Ring* ring = *link;
+        bool retired = ring->retired.load(std::memory_order_acquire);
+        any |= drainRing(ring);
+        if (retired && ring->tail.load(std::memory_order_relaxed) ==
+                           ring->head.load(std::memory_order_acquire)) {
+            *link = ring->next;
+            free(ring->data);
+            delete ring;
+        } else {
+            link = &ring->next;
+        }
+    }
+
+    std::lock_guard<std::mutex> sink_lock(shared().sink_mutex);
+    if (g_file) fflush(g_file);
+    return any;
+}
+
+bool anyPending() {
+    std::lock_guard<std::mutex> lock(shared().rings_mutex);
+    for (Ring* ring = g_rings; ring; ring = ring->next) {
+        if (ring->tail.load(std::memory_order_relaxed) != ring->head.load(std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void* loggingThread(void*) {
+#if defined(__ANDROID__) || defined(__GLIBC__)
+    pthread_setname_np(pthread_self(), kSelfTag);
+#endif
+    for (;;) {
+        uint64_t flush_target;
+        {
+            std::lock_guard<std::mutex> lock(shared().wake_mutex);
+            flush_target = g_flush_requested;
+        }
+
+        bool busy = drainAll();
+
+        std::unique_lock<std::mutex> lock(shared().wake_mutex);
+        if (flush_target != g_flush_done) {
+            g_flush_done = flush_target;
+            shared().flush_cv.notify_all();
+        }
+        if (busy) {
+            shared().wake_cv.wait_for(lock, kBatchWindow, [] {
+                return g_flush_requested != g_flush_done || g_urgent.load();
+            });
+            g_urgent.store(false);
+            continue;
+        }
+
+        // Announce idleness before the final check; pairs with the fence in
+        // publish() so a record is either seen here or wakes us
+        g_idle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (g_flush_requested != g_flush_done || anyPending()) {
+            g_idle.store(false);
+            continue;
+        }
+        shared().wake_cv.wait(lock, [] { return !g_idle.load(); });
+    }
+    return nullptr;
+}
+
+void retireRing(void* arg) {
+    Ring* ring = static_cast<Ring*>(arg);
+    ring->retired.store(true, std::memory_order_release);
+    t_ring = nullptr;
+}
+
+void start() {
+    pthread_key_create(&g_ring_key, retireRing);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&g_thread, &attr, loggingThread, nullptr) == 0) {
+        g_started.store(true, std::memory_order_release);
+        // Records queued just before a normal exit still reach the sink
+        atexit(common_log_flush);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+// ============================================================================
+// Producer Side
+// ============================================================================
+
+Ring* threadRing() {
+    Ring* ring = t_ring;
+    if (ring) return ring;
+
+    std::call_once(g_start_once, start);
+    if (!g_started.load(std::memory_order_acquire)) return nullptr;
+
+    // Records from sinks running on the logging thread are dropped; it
+    // holds the registry lock while draining
+    if (pthread_equal(pthread_self(), g_thread)) return nullptr;
+
+    ring = new (std::nothrow) Ring;
+    if (!ring) return nullptr;
+    ring->data = static_cast<uint8_t*>(malloc(kRingSize));
+    if (!ring->data) {
+        delete ring;
+        return nullptr;
+    }
+    ring->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+
+    {
+        std::lock_guard<std::mutex> lock(shared().rings_mutex);
+        ring->next = g_rings;
+        g_rings = ring;
+    }
+    pthread_setspecific(g_ring_key, ring);
+    t_ring = ring;
+    return ring;
+}
+
+// Reserve kMaxRecord contiguous bytes; returns nullptr when full
+uint8_t* reserve(Ring* ring, uint64_t* position) {
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    size_t offset = static_cast<size_t>(head & (kRingSize - 1));
+    size_t contiguous = kRingSize - offset;
+    size_t free_space = kRingSize - static_cast<size_t>(head - tail);
+
+    if (contiguous < kMaxRecord) {
+        if (free_space < contiguous + kMaxRecord) return nullptr;
+        uint32_t pad_size = static_cast<uint32_t>(contiguous);
+        uint8_t pad_kind = kPad;
+        memcpy(ring->data + offset, &pad_size, sizeof(pad_size));
+        memcpy(ring->data + offset + sizeof(pad_size), &pad_kind, sizeof(pad_kind));
+        head += contiguous;
+        offset = 0;
+    } else if (free_space < kMaxRecord) {
+        return nullptr;
+    }
+    *position = head;
+    return ring->data + offset;
+}
+
+void publish(Ring* ring, uint64_t position, uint8_t* rec, uint8_t* end) {
+    uint32_t size = static_cast<uint32_t>(align8(static_cast<size_t>(end - rec)));
+    memcpy(rec, &size, sizeof(size));
+    ring->head.store(position + size, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool wake = g_idle.load(std::memory_order_relaxed) && g_idle.exchange(false);
+    if (!wake && position + size - ring->tail.load(std::memory_order_relaxed) > kRingSize / 2) {
+        // Cut the batch window short rather than start dropping
+        wake = !g_urgent.load(std::memory_order_relaxed) && !g_urgent.exchange(true);
+    }
+    if (wake) {
+        std::lock_guard<std::mutex> lock(shared().wake_mutex);
+        shared().wake_cv.notify_one();
+    }
+}
+
+// Start a record and copy the tag; returns the argument writer position
+uint8_t* beginRecord(uint8_t* rec, uint8_t kind, int level, const char* tag, const char* fmt) {
+    if (!tag) tag = kDefaultTag;
+    RecordHeader hdr;
+    hdr.size = 0;
+    hdr.kind = kind;
+    hdr.level = static_cast<uint8_t>(level);
+    hdr.truncated = 0;
+    hdr.tag_len = static_cast<uint8_t>(strnlen(tag, kMaxTag));
+    hdr.time_ns = nowNs();
+    hdr.fmt = fmt;
+    memcpy(rec, &hdr, sizeof(hdr));
+
+    uint8_t* body = rec + align8(sizeof(hdr));
+    memcpy(body, tag, hdr.tag_len);
+    return body + align8(hdr.tag_len);
+}
+
+Ring* acquireRing(int level) {
+    if (!COMMON_LOG_COMPILED(level) || level < g_level.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return threadRing();
+}
+
+void dropRecord(Ring* ring) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    g_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+} // namespace log_detail
+} // namespace common
+
+using namespace common::log_detail;
+
+// ============================================================================
+// C API
+// ============================================================================
+
+void common_logv(int level, const char* tag, const char* fmt, va_list args) {
+    int saved_errno = errno;
+    Ring* ring = acquireRing(level);
+    if (!ring || !fmt) return;
+
+    uint64_t position;
+    uint8_t* rec = reserve(ring, &position);
+    if (!rec) {
+        dropRecord(ring);
+        errno = saved_errno;
+        return;
+    }
+
+    Writer out(beginRecord(rec, kFormat, level, tag, fmt), rec + kMaxRecord);
+    va_list copy;
+    va_copy(copy, args);
+    encodeArgs(out, fmt, copy, saved_errno);
+    va_end(copy);
+    if (out.overflowed()) {
+        rec[offsetof(RecordHeader, truncated)] = 1;
+    }
+    publish(ring, position, rec, out.position());
+    errno = saved_errno;
+}
+
+void common_log(int level, const char* tag, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    common_logv(level, tag, fmt, args);
+    va_end(args);
+}
+
+void common_log_hexdump(int level, const char* tag, const char* label,
+                        const void* data, size_t size) {
+    Ring* ring = acquireRing(level);
+    if (!ring) return;
+    common_log(level, tag, "=== %s (%zu bytes) ===", label ? label : "", size);
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t offset = 0; bytes && offset < size; offset += kHexChunk) {
+        size_t len = size - offset < kHexChunk ? size - offset : kHexChunk;
+        uint64_t position;
+        uint8_t* rec = reserve(ring, &position);
+        if (!rec) {
+            dropRecord(ring);
+            return;
+        }
+        Writer out(beginRecord(rec, kHex, level, tag, nullptr), rec + kMaxRecord);
+        out.put<uint64_t>(offset);
+        out.put<uint64_t>(len);
+        out.putBytes(bytes + offset, len);
+        publish(ring, position, rec, out.position());
+    }
+}
+
+void common_log_set_level(int level) {
+    g_level.store(level, std::memory_order_relaxed);
+}
+
+int common_log_get_level(void) {
+    return g_level.load(std::memory_order_relaxed);
+}
+
+void common_log_set_sink(common_log_sink_fn sink, void* user) {
+    FILE* old_file;
+    {
+        std::lock_guard<std::mutex> lock(shared().sink_mutex);
+        old_file = g_file;
+        g_file = nullptr;
+        g_sink = sink ? sink : defaultSink;
+        g_sink_user = sink ? user : nullptr;
+    }
+    if (old_file) fclose(old_file);
+}
+
+int common_log_open_file(const char* path) {
+    FILE* file = path ? fopen(path, "ae") : nullptr;
+    if (!file) return -1;
+
+    FILE* old_file;
+    {
+        std::lock_guard<std::mutex> lock(shared().sink_mutex);
+        old_file = g_file;
+        g_file = file;
+        g_sink = fileSink;
+        g_sink_user = file;
+    }
+    if (old_file) fclose(old_file);
+    return 0;
+}
+
+void common_log_flush(void) {
+    if (!g_started.load(std::memory_order_acquire) || pthread_equal(pthread_self(), g_thread)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(shared().wake_mutex);
+    uint64_t ticket = ++g_flush_requested;
+    g_idle.store(false);
+    shared().wake_cv.notify_one();
+    shared().flush_cv.wait(lock, [ticket] { return g_flush_done >= ticket; });
+}
+
+uint64_t common_log_dropped(void) {
+    return g_dropped.load(std::memory_order_relaxed);
+}
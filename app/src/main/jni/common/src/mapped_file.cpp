@@ -0,0 +1,179 @@
+/*
+ * common - Mapped File
+ */
+
+#include "common/mapped_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace common {
+
+namespace {
+
+// Initial buffer for files that report no size (procfs, sysfs, pipes)
+constexpr size_t kUnsizedInitial = 16 * 1024;
+
+class FdGuard {
+public:
+    explicit FdGuard(int fd) : fd_(fd) {}
+    ~FdGuard() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+    FdGuard(const FdGuard&) = delete;
+    FdGuard& operator=(const FdGuard&) = delete;
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), buffer_(other.buffer_),
+      mapped_(other.mapped_), open_(other.open_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.buffer_ = nullptr;
+    other.mapped_ = false;
+    other.open_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = other.data_;
+        size_ = other.size_;
+        buffer_ = other.buffer_;
+        mapped_ = other.mapped_;
+        open_ = other.open_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.buffer_ = nullptr;
+        other.mapped_ = false;
+        other.open_ = false;
+    }
+    return *this;
+}
+
+void MappedFile::close() noexcept {
+    if (mapped_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    free(buffer_);
+    data_ = nullptr;
+    size_ = 0;
+    buffer_ = nullptr;
+    mapped_ = false;
+    open_ = false;
+}
+
+bool MappedFile::open(const char* path, Access access) {
+    close();
+    if (!path) return false;
+
+    int fd;
+    do {
+        fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) return false;
+    FdGuard guard(fd);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+
+    // Pseudo-files report st_size 0 (or a page) regardless of content
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        open_ = readUntilEof(fd);
+        return open_;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size >= kMapThreshold) {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            if (access == Access::Sequential) {
+                madvise(addr, size, MADV_SEQUENTIAL);
+                madvise(addr, size, MADV_WILLNEED);
+            } else {
+                madvise(addr, size, MADV_RANDOM);
+            }
+            data_ = static_cast<const uint8_t*>(addr);
+            size_ = size;
+            mapped_ = true;
+            open_ = true;
+            return true;
+        }
+        // Fall back to reading (e.g. filesystems without mmap support)
+    }
+
+    open_ = readSized(fd, size);
+    return open_;
+}
+
+bool MappedFile::readSized(int fd, size_t size) {
+    // Deliberately uninitialised: every byte returned is overwritten by pread
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(size));
+    if (!buffer) return false;
+
+    // One pread normally suffices; loop only for short reads and signals.
+    // A file truncated under us is returned at its new length.
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pread(fd, buffer + done, size - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            free(buffer);
+            return false;
+        }
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+
+    buffer_ = buffer;
+    data_ = buffer;
+    size_ = done;
+    return true;
+}
+
+bool MappedFile::readUntilEof(int fd) {
+    size_t capacity = kUnsizedInitial;
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(capacity));
+    if (!buffer) return false;
+
+    size_t done = 0;
+    for (;;) {
+        if (done == capacity) {
+            uint8_t* grown = static_cast<uint8_t*>(realloc(buffer, capacity * 2));
+            if (!grown) {
+                free(buffer);
+                return false;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, buffer + done, capacity - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            free(buffer);
+            return false;
+        }
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+
+    buffer_ = buffer;
+    data_ = buffer;
+    size_ = done;
+    return true;
+}
+
+} // namespace common
@@ -0,0 +1,620 @@
+/*
+ * common - Thread Pool
+ *
+ * Foreground workers take from their own deque first (back, LIFO), then
+ * from the injection lanes in priority order, then steal from the front of
+ * another foreground worker's deque. A worker that finds nothing sleeps on
+ * one condition variable; producers only touch its mutex when somebody is
+ * asleep. The background worker has no deque to steal from and sleeps on
+ * its own lane.
+ */
+
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef __ANDROID__
+#include <sys/system_properties.h>
+#endif
+
+namespace common {
+namespace thread_pool_detail {
+
+struct TimerState {
+    std::atomic<bool> claimed{false};   // Set by whichever of run and cancel comes first
+    ThreadPool::Task task;
+    TaskPriority priority = TaskPriority::Normal;
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kBackgroundNice = 10;
+constexpr size_t kLaneCount = 3;
+constexpr size_t kNameMax = 16;        // Including NUL, as pthread_setname_np allows
+
+struct Job {
+    ThreadPool::Task fn;
+    TaskPriority priority;
+};
+
+// Foreground worker deque; the owner pushes and pops at the back, thieves
+// take from the front
+struct Worker {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::thread thread;
+};
+
+struct TimerEntry {
+    Clock::time_point due;
+    uint64_t seq;                        // FIFO among equal deadlines
+    std::shared_ptr<TimerState> state;
+
+    bool operator>(const TimerEntry& other) const {
+        return due != other.due ? due > other.due : seq > other.seq;
+    }
+};
+
+} // namespace
+
+struct Pool {
+    char name[kNameMax];
+    size_t capacity;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::thread background;
+
+    // Injection lanes, indexed by TaskPriority
+    std::mutex inject_mutex;
+    std::condition_variable space_cv;    // Producers waiting for room
+    std::condition_variable background_cv;
+    std::deque<Job> lanes[kLaneCount];
+    size_t foreground_injected = 0;      // Jobs in the High and Normal lanes
+    bool stopping = false;               // Guarded by inject_mutex and sleep_mutex
+
+    // Foreground jobs queued anywhere (lanes and deques), for sleeping
+    std::atomic<size_t> queued{0};
+    std::atomic<unsigned> sleepers{0};
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+
+    // Delayed tasks; the timer thread starts with the first one
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> timers;
+    std::thread timer_thread;
+    uint64_t timer_seq = 0;
+    bool timer_stop = false;
+};
+
+namespace {
+
+thread_local Pool* t_pool = nullptr;
+thread_local Worker* t_worker = nullptr;  // nullptr on the background worker
+
+// "prefix-suffix", cutting the prefix rather than the suffix when it
+// doesn't fit so worker numbers stay distinguishable
+void setThreadName(const char* prefix, const char* suffix) {
+    char name[kNameMax];
+    size_t suffix_len = strnlen(suffix, kNameMax - 2);
+    size_t prefix_len = strnlen(prefix, kNameMax - 2 - suffix_len);
+    memcpy(name, prefix, prefix_len);
+    name[prefix_len] = '-';
+    memcpy(name + prefix_len + 1, suffix, suffix_len);
+    name[prefix_len + 1 + suffix_len] = '\0';
+    pthread_setname_np(pthread_self(), name);
+}
+
+void wakeForeground(Pool* pool) {
+    pool->queued.fetch_add(1);
+    // Pairs with the sleepers increment in foregroundMain(): either the
+    // sleeper sees the job or we see the sleeper
+    if (pool->sleepers.load() != 0) {
+        { std::lock_guard<std::mutex> lock(pool->sleep_mutex); }
+        pool->sleep_cv.notify_one();
+    }
+}
+
+// Queue from outside the tier that serves priority. Returns false if
+// blocking is not allowed and the lane is full.
+bool inject(Pool* pool, Job&& job, bool may_block) {
+    size_t lane = static_cast<size_t>(job.priority);
+    bool bounded = t_pool != pool;       // Workers never block on their own pool
+    {
+        std::unique_lock<std::mutex> lock(pool->inject_mutex);
+        if (bounded) {
+            auto full = [&] {
+                return lane == static_cast<size_t>(TaskPriority::Background)
+                    ? pool->lanes[lane].size() >= pool->capacity
+                    : pool->foreground_injected >= pool->capacity;
+            };
+            if (full()) {
+                if (!may_block) return false;
+                pool->space_cv.wait(lock, [&] { return !full() || pool->stopping; });
+            }
+        }
+        pool->lanes[lane].push_back(std::move(job));
+        if (lane == static_cast<size_t>(TaskPriority::Background)) {
+            pool->background_cv.notify_one();
+            return true;
+        }
+        pool->foreground_injected++;
+    }
+    wakeForeground(pool);
+    return true;
+}
+
+bool push(Pool* pool, Job&& job, bool may_block) {
+    bool background = job.priority == TaskPriority::Background;
+    if (t_pool == pool && t_worker && !background) {
+        {
+            std::lock_guard<std::mutex> lock(t_worker->mutex);
+            t_worker->jobs.push_back(std::move(job));
+        }
+        wakeForeground(pool);
+        return true;
+    }
+    return inject(pool, std::move(job), may_block);
+}
+
+bool takeInjected(Pool* pool, Job& job) {
+    std::lock_guard<std::mutex> lock(pool->inject_mutex);
+    if (pool->foreground_injected == 0) return false;
+    for (size_t lane = 0; lane < static_cast<size_t>(TaskPriority::Background); lane++) {
+        if (!pool->lanes[lane].empty()) {
+            job = std::move(pool->lanes[lane].front());
+            pool->lanes[lane].pop_front();
+            pool->foreground_injected--;
+            pool->space_cv.notify_one();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool takeForeground(Pool* pool, Worker* self, size_t self_index, Job& job) {
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        if (!self->jobs.empty()) {
+            job = std::move(self->jobs.back());
+            self->jobs.pop_back();
+            return true;
+        }
+    }
+    if (takeInjected(pool, job)) return true;
+
+    size_t count = pool->workers.size();
+    for (size_t i = 1; i < count; i++) {
+        Worker* victim = pool->workers[(self_index + i) % count].get();
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->jobs.empty()) {
+            job = std::move(victim->jobs.front());
+            victim->jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void foregroundMain(Pool* pool, size_t index) {
+    Worker* self = pool->workers[index].get();
+    t_pool = pool;
+    t_worker = self;
+    char suffix[12];
+    snprintf(suffix, sizeof(suffix), "%zu", index);
+    setThreadName(pool->name, suffix);
+
+    for (;;) {
+        Job job;
+        if (takeForeground(pool, self, index, job)) {
+            pool->queued.fetch_sub(1);
+            job.fn();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(pool->sleep_mutex);
+        pool->sleepers.fetch_add(1);
+        pool->sleep_cv.wait(lock, [pool] {
+            return pool->queued.load() != 0 || pool->stopping;
+        });
+        pool->sleepers.fetch_sub(1);
+        if (pool->stopping && pool->queued.load() == 0) break;
+    }
+}
+
+void backgroundMain(Pool* pool) {
+    t_pool = pool;
+    t_worker = nullptr;
+    setThreadName(pool->name, "bg");
+    // Per-thread on Linux: only this worker is lowered
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), kBackgroundNice);
+
+    std::deque<Job>& lane = pool->lanes[static_cast<size_t>(TaskPriority::Background)];
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(pool->inject_mutex);
+            pool->background_cv.wait(lock, [&] { return !lane.empty() || pool->stopping; });
+            if (lane.empty()) break;
+            job = std::move(lane.front());
+            lane.pop_front();
+            pool->space_cv.notify_one();
+        }
+        job.fn();
+    }
+}
+
+void timerMain(Pool* pool) {
+    setThreadName(pool->name, "timer");
+    std::unique_lock<std::mutex> lock(pool->timer_mutex);
+    while (!pool->timer_stop) {
+        if (pool->timers.empty()) {
+            pool->timer_cv.wait(lock);
+            continue;
+        }
+        Clock::time_point due = pool->timers.top().due;
+        if (Clock::now() < due) {
+            pool->timer_cv.wait_until(lock, due);
+            continue;
+        }
+        std::shared_ptr<TimerState> state = pool->timers.top().state;
+        pool->timers.pop();
+        if (state->claimed.load(std::memory_order_relaxed)) continue;   // Cancelled
+
+        lock.unlock();
+        TaskPriority priority = state->priority;
+        push(pool, {[state]() {
+            if (!state->claimed.exchange(true)) state->task();
+        }, priority}, true);
+        lock.lock();
+    }
+}
+
+// Short library name ("libclient.so" -> "client") for worker names
+void defaultName(char* out, size_t size) {
+    const char* name = "pool";
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&common_pool_thread_count), &info) && info.dli_fname) {
+        const char* slash = strrchr(info.dli_fname, '/');
+        name = slash ? slash + 1 : info.dli_fname;
+        if (strncmp(name, "lib", 3) == 0) name += 3;
+    }
+    // Leave room for "-timer"
+    size_t length = strcspn(name, ".");
+    length = std::min(length, size - 7);
+    memcpy(out, name, length);
+    out[length] = '\0';
+}
+
+unsigned defaultThreads() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 1;
+}
+
+std::atomic<unsigned> g_shared_threads{0};
+std::atomic<bool> g_shared_started{false};
+
+unsigned configuredThreads() {
+    const char* value = getenv("COMMON_POOL_THREADS");
+#ifdef __ANDROID__
+    char property[PROP_VALUE_MAX] = {};
+    if (!value && __system_property_get("debug.common.pool_threads", property) > 0) {
+        value = property;
+    }
+#endif
+    return value ? static_cast<unsigned>(strtoul(value, nullptr, 10)) : 0;
+}
+
+// ParallelFor state outlives the call: helpers that start late still
+// touch the cursor after the caller has returned
+struct ForState {
+    const std::function<void(size_t)>* body;
+    size_t count;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+void runIndices(ForState& state) {
+    size_t finished = 0;
+    for (size_t i = state.next.fetch_add(1, std::memory_order_relaxed); i < state.count;
+         i = state.next.fetch_add(1, std::memory_order_relaxed)) {
+        (*state.body)(i);
+        finished++;
+    }
+    if (finished != 0 &&
+        state.done.fetch_add(finished, std::memory_order_acq_rel) + finished == state.count) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.cv.notify_all();
+    }
+}
+
+} // namespace
+
+} // namespace thread_pool_detail
+
+using namespace thread_pool_detail;
+
+// ============================================================================
+// DelayedTask
+// ============================================================================
+
+bool DelayedTask::cancel() noexcept {
+    if (!state_ || state_->claimed.exchange(true)) return false;
+    state_->task = nullptr;     // Release captures now rather than at the deadline
+    return true;
+}
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
+
+ThreadPool::ThreadPool(const Options& options) : pool_(new Pool) {
+    snprintf(pool_->name, sizeof(pool_->name), "%s", options.name ? options.name : "pool");
+    pool_->capacity = std::max<size_t>(options.queue_capacity, 1);
+
+    unsigned threads = options.threads ? options.threads : defaultThreads();
+    pool_->workers.reserve(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        pool_->workers.emplace_back(new Worker);
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        pool_->workers[i]->thread = std::thread(foregroundMain, pool_.get(), static_cast<size_t>(i));
+    }
+    pool_->background = std::thread(backgroundMain, pool_.get());
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(pool_->timer_mutex);
+        pool_->timer_stop = true;
+    }
+    pool_->timer_cv.notify_all();
+    if (pool_->timer_thread.joinable()) pool_->timer_thread.join();
+
+    {
+        std::lock_guard<std::mutex> inject_lock(pool_->inject_mutex);
+        std::lock_guard<std::mutex> sleep_lock(pool_->sleep_mutex);
+        pool_->stopping = true;
+    }
+    pool_->sleep_cv.notify_all();
+    pool_->background_cv.notify_all();
+    pool_->space_cv.notify_all();
+
+    for (auto& worker : pool_->workers) {
+        worker->thread.join();
+    }
+    pool_->background.join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool* instance = [] {
+        Options options;
+        char name[kNameMax];
+        defaultName(name, sizeof(name));
+        options.name = name;
+        options.threads = configuredThreads();
+        if (options.threads == 0) options.threads = g_shared_threads.load();
+        g_shared_started.store(true);
+        return new ThreadPool(options);
+    }();
+    return *instance;
+}
+
+unsigned ThreadPool::threadCount() const noexcept {
+    return static_cast<unsigned>(pool_->workers.size());
+}
+
+bool ThreadPool::isWorkerThread() const noexcept {
+    return t_pool == pool_.get();
+}
+
+void ThreadPool::post(Task task, TaskPriority priority) {
+    if (!task) return;
+    push(pool_.get(), {std::move(task), priority}, true);
+}
+
+bool ThreadPool::tryPost(Task task, TaskPriority priority) {
+    if (!task) return false;
+    return push(pool_.get(), {std::move(task), priority}, false);
+}
+
+DelayedTask ThreadPool::postAfter(std::chrono::milliseconds delay, Task task,
+                                  TaskPriority priority) {
+    auto state = std::make_shared<TimerState>();
+    state->task = std::move(task);
+    state->priority = priority;
+
+    if (delay.count() <= 0) {
+        post([state]() {
+            if (!state->claimed.exchange(true)) state->task();
+        }, priority);
+        return DelayedTask(state);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool_->timer_mutex);
+        if (!pool_->timer_thread.joinable()) {
+            pool_->timer_thread = std::thread(timerMain, pool_.get());
+        }
+        pool_->timers.push({Clock::now() + delay, pool_->timer_seq++, state});
+    }
+    pool_->timer_cv.notify_one();
+    return DelayedTask(state);
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body,
+                             unsigned max_workers) {
+    if (count == 0) return;
+
+    size_t helpers = count - 1;
+    helpers = std::min<size_t>(helpers, threadCount());
+    if (max_workers != 0) helpers = std::min<size_t>(helpers, max_workers - 1);
+    if (helpers == 0) {
+        for (size_t i = 0; i < count; i++) body(i);
+        return;
+    }
+
+    auto state = std::make_shared<ForState>();
+    state->body = &body;
+    state->count = count;
+    // Helpers run at the caller's tier, so a background caller keeps its
+    // work on the background worker
+    TaskPriority priority = isWorkerThread() && !t_worker ? TaskPriority::Background
+                                                           : TaskPriority::Normal;
+    for (size_t i = 0; i < helpers; i++) {
+        // A full queue just means the caller does more of the work itself
+        if (!tryPost([state]() { runIndices(*state); }, priority)) break;
+    }
+
+    runIndices(*state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] {
+        return state->done.load(std::memory_order_acquire) == count;
+    });
+}
+
+// ============================================================================
+// PeriodicTask
+// ============================================================================
+
+struct PeriodicTask::State {
+    std::mutex mutex;
+    std::condition_variable idle_cv;
+    std::function<void()> fn;
+    ThreadPool* pool = nullptr;
+    TaskPriority priority = TaskPriority::Background;
+    std::atomic<int64_t> interval_ms{0};
+    uint64_t generation = 0;             // Bumped by start() and stop(); stale runs bail out
+    bool active = false;
+    bool in_run = false;
+    std::thread::id runner;
+    DelayedTask next;
+};
+
+PeriodicTask::PeriodicTask() : state_(std::make_shared<State>()) {}
+
+void PeriodicTask::schedule(const std::shared_ptr<State>& state, uint64_t generation,
+                            std::chrono::milliseconds delay) {
+    state->next = state->pool->postAfter(delay, [state, generation]() {
+        run(state, generation);
+    }, state->priority);
+}
+
+void PeriodicTask::run(const std::shared_ptr<State>& state, uint64_t generation) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->active || state->generation != generation) return;
+        state->in_run = true;
+        state->runner = std::this_thread::get_id();
+    }
+
+    state->fn();
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->in_run = false;
+    state->runner = std::thread::id();
+    if (state->active && state->generation == generation) {
+        schedule(state, generation,
+                 std::chrono::milliseconds(state->interval_ms.load(std::memory_order_relaxed)));
+    }
+    state->idle_cv.notify_all();
+}
+
+void PeriodicTask::start(std::chrono::milliseconds interval, std::function<void()> fn,
+                         TaskPriority priority, ThreadPool& pool) {
+    stop();
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->fn = std::move(fn);
+        state_->pool = &pool;
+        state_->priority = priority;
+        state_->interval_ms.store(interval.count(), std::memory_order_relaxed);
+        state_->active = true;
+        generation = ++state_->generation;
+    }
+    // Posted unlocked: post() may block on a full queue whose worker is
+    // waiting for this lock. The first run needs no cancel handle, stale
+    // runs see the generation change.
+    std::shared_ptr<State> state = state_;
+    pool.post([state, generation]() { run(state, generation); }, priority);
+}
+
+void PeriodicTask::stop() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (!state_->active) return;
+    state_->active = false;
+    state_->generation++;
+    state_->next.cancel();
+    state_->next = DelayedTask();
+    if (state_->runner != std::this_thread::get_id()) {
+        state_->idle_cv.wait(lock, [this] { return !state_->in_run; });
+    }
+}
+
+void PeriodicTask::setInterval(std::chrono::milliseconds interval) noexcept {
+    state_->interval_ms.store(interval.count(), std::memory_order_relaxed);
+}
+
+bool PeriodicTask::running() const noexcept {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->active;
+}
+
+} // namespace common
+
+// ============================================================================
+// C Interface
+// ============================================================================
+
+using common::ThreadPool;
+using common::TaskPriority;
+
+int common_pool_set_threads(unsigned threads) {
+    if (common::thread_pool_detail::g_shared_started.load()) return -1;
+    common::thread_pool_detail::g_shared_threads.store(threads);
+    return 0;
+}
+
+unsigned common_pool_thread_count(void) {
+    return ThreadPool::shared().threadCount();
+}
+
+int common_pool_submit(common_pool_task_fn fn, void* ctx, common_pool_priority_t priority) {
+    if (!fn) return -1;
+    ThreadPool::shared().post([fn, ctx]() { fn(ctx); }, static_cast<TaskPriority>(priority));
+    return 0;
+}
+
+int common_pool_try_submit(common_pool_task_fn fn, void* ctx, common_pool_priority_t priority) {
+    if (!fn) return -1;
+    return ThreadPool::shared().tryPost([fn, ctx]() { fn(ctx); },
+                                        static_cast<TaskPriority>(priority)) ? 0 : -1;
+}
+
+void common_pool_parallel_for(size_t count, unsigned max_workers,
+                              common_pool_index_fn fn, void* ctx) {
+    if (!fn) return;
+    ThreadPool::shared().parallelFor(count, [fn, ctx](size_t i) { fn(ctx, i); }, max_workers);
+}
@@ -0,0 +1,287 @@
+/*
+ * common - Tracing
+ *
+ * Each recording thread owns a fixed buffer of complete ("X") events. The
+ * owner appends and publishes the count with a release store; the dumper
+ * reads up to the acquired count, so dumping never stops the recorders.
+ * Restarting bumps an epoch instead of touching other threads' buffers:
+ * each owner resets its own buffer on its next event.
+ */
+
+#include "common/trace.h"
+
+#include <atomic>
+#include <mutex>
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef __ANDROID__
+#include <sys/system_properties.h>
+#endif
+
+int common_trace_active_flag = 0;
+
+namespace common {
+namespace trace_detail {
+
+namespace {
+
+constexpr uint32_t kEventsPerThread = 16384;
+constexpr size_t kMaxPath = 512;
+constexpr size_t kDumpBuffer = 256 * 1024;
+
+struct Event {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;          // Equal to begin_ns for instant events
+};
+
+struct ThreadBuffer {
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<bool> owned{true};    // Cleared when the thread exits
+    uint32_t tid = 0;
+    char thread_name[16] = {};
+    ThreadBuffer* next = nullptr;
+    Event events[kEventsPerThread];
+};
+
+// Never destroyed: threads may still record while static destructors run
+struct Registry {
+    std::mutex mutex;
+    ThreadBuffer* buffers = nullptr;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+std::atomic<uint32_t> g_epoch{1};
+std::atomic<uint64_t> g_dropped{0};
+char g_auto_path[kMaxPath];
+
+pthread_once_t g_key_once = PTHREAD_ONCE_INIT;
+pthread_key_t g_buffer_key;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+void releaseBuffer(void* arg) {
+    static_cast<ThreadBuffer*>(arg)->owned.store(false, std::memory_order_release);
+    t_buffer = nullptr;
+}
+
+void createKey() {
+    pthread_key_create(&g_buffer_key, releaseBuffer);
+}
+
+// Claim a buffer for the calling thread, reusing one left by an exited
+// thread if its events belong to an earlier recording
+ThreadBuffer* claimBuffer(uint32_t epoch) {
+    pthread_once(&g_key_once, createKey);
+
+    Registry& reg = registry();
+    ThreadBuffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (ThreadBuffer* b = reg.buffers; b; b = b->next) {
+            if (!b->owned.load(std::memory_order_acquire) &&
+                b->epoch.load(std::memory_order_relaxed) != epoch) {
+                b->owned.store(true, std::memory_order_relaxed);
+                buffer = b;
+                break;
+            }
+        }
+    }
+    if (!buffer) {
+        buffer = new (std::nothrow) ThreadBuffer;
+        if (!buffer) return nullptr;
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer->next = reg.buffers;
+        reg.buffers = buffer;
+    }
+
+    buffer->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    prctl(PR_GET_NAME, buffer->thread_name, 0, 0, 0);
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->epoch.store(epoch, std::memory_order_release);
+    pthread_setspecific(g_buffer_key, buffer);
+    t_buffer = buffer;
+    return buffer;
+}
+
+void append(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+    uint32_t epoch = g_epoch.load(std::memory_order_relaxed);
+    ThreadBuffer* buffer = t_buffer;
+    if (!buffer) {
+        buffer = claimBuffer(epoch);
+        if (!buffer) return;
+    } else if (buffer->epoch.load(std::memory_order_relaxed) != epoch) {
+        // Restarted since this thread last recorded
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->epoch.store(epoch, std::memory_order_release);
+    }
+
+    uint32_t n = buffer->count.load(std::memory_order_relaxed);
+    if (n >= kEventsPerThread) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[n] = Event{name, begin_ns, end_ns};
+    buffer->count.store(n + 1, std::memory_order_release);
+}
+
+// ============================================================================
+// JSON Output
+// ============================================================================
+
+void writeString(FILE* out, const char* str) {
+    fputc('"', out);
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(str); *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', out);
+            fputc(*p, out);
+        } else if (*p < 0x20) {
+            fprintf(out, "\\u%04x", *p);
+        } else {
+            fputc(*p, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// Microseconds with nanosecond precision, as the format expects
+void writeMicros(FILE* out, uint64_t ns) {
+    fprintf(out, "%llu.%03u", static_cast<unsigned long long>(ns / 1000),
+            static_cast<unsigned>(ns % 1000));
+}
+
+// File name of the shared object this copy of the recorder lives in
+const char* libraryName() {
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&common_trace_dump), &info) && info.dli_fname) {
+        const char* slash = strrchr(info.dli_fname, '/');
+        return slash ? slash + 1 : info.dli_fname;
+    }
+    return "native";
+}
+
+int writeTrace(FILE* out) {
+    uint32_t epoch = g_epoch.load(std::memory_order_relaxed);
+    const char* category = libraryName();
+    unsigned pid = static_cast<unsigned>(getpid());
+    bool first = true;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for (ThreadBuffer* b = registry().buffers; b; b = b->next) {
+        if (b->epoch.load(std::memory_order_acquire) != epoch) continue;
+        uint32_t count = b->count.load(std::memory_order_acquire);
+        if (count == 0) continue;
+
+        fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",", pid, b->tid);
+        writeString(out, b->thread_name);
+        fputs("}}", out);
+        first = false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            const Event& e = b->events[i];
+            fputs(",\n{\"name\":", out);
+            writeString(out, e.name ? e.name : "?");
+            fputs(",\"cat\":", out);
+            writeString(out, category);
+            if (e.end_ns == e.begin_ns) {
+                fputs(",\"ph\":\"i\",\"s\":\"t\",\"ts\":", out);
+                writeMicros(out, e.begin_ns);
+            } else {
+                fputs(",\"ph\":\"X\",\"ts\":", out);
+                writeMicros(out, e.begin_ns);
+                fputs(",\"dur\":", out);
+                writeMicros(out, e.end_ns - e.begin_ns);
+            }
+            fprintf(out, ",\"pid\":%u,\"tid\":%u}", pid, b->tid);
+        }
+    }
+
+    fputs("\n]}\n", out);
+    return ferror(out) ? -1 : 0;
+}
+
+void dumpAtExit() {
+    common_trace_dump(nullptr);
+}
+
+// Start recording at load time when asked to, so cold start is covered
+__attribute__((constructor)) void autoStart() {
+    const char* prefix = getenv("COMMON_TRACE");
+#ifdef __ANDROID__
+    char value[PROP_VALUE_MAX] = {};
+    if (!prefix && __system_property_get("debug.common.trace", value) > 0) {
+        prefix = value;
+    }
+#endif
+    if (!prefix || !*prefix) return;
+
+    snprintf(g_auto_path, sizeof(g_auto_path), "%s.%s.json", prefix, libraryName());
+    atexit(dumpAtExit);
+    common_trace_start();
+}
+
+} // namespace
+
+} // namespace trace_detail
+} // namespace common
+
+using namespace common::trace_detail;
+
+// ============================================================================
+// C API
+// ============================================================================
+
+void common_trace_start(void) {
+    g_epoch.fetch_add(1, std::memory_order_relaxed);
+    g_dropped.store(0, std::memory_order_relaxed);
+    __atomic_store_n(&common_trace_active_flag, 1, __ATOMIC_RELEASE);
+}
+
+void common_trace_stop(void) {
+    __atomic_store_n(&common_trace_active_flag, 0, __ATOMIC_RELEASE);
+}
+
+void common_trace_record(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+    append(name, begin_ns, end_ns > begin_ns ? end_ns : begin_ns + 1);
+}
+
+void common_trace_instant(const char* name) {
+    if (!common_trace_enabled()) return;
+    uint64_t now = common_trace_now_ns();
+    append(name, now, now);
+}
+
+int common_trace_dump(const char* path) {
+    if (!path) path = g_auto_path;
+    if (!*path) return -1;
+
+    FILE* out = fopen(path, "we");
+    if (!out) return -1;
+    // Events are small writes; a large stdio buffer keeps the dump to a
+    // handful of syscalls
+    char* buffer = static_cast<char*>(malloc(kDumpBuffer));
+    if (buffer) setvbuf(out, buffer, _IOFBF, kDumpBuffer);
+    int ret = writeTrace(out);
+    if (fclose(out) != 0) ret = -1;
+    free(buffer);
+    return ret;
+}
+
+uint64_t common_trace_dropped(void) {
+    return g_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,114 @@
+// Allocation counting for the benchmarks.
+//
+// operator new/delete are replaced outright, which catches every C++
+// allocation wherever it happens. Direct malloc/calloc/realloc calls from
+// code linked into the benchmark are caught with the linker's --wrap
+// (see CMakeLists.txt); the C library's internal allocations are not.
+
+#include "bench.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+}
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_bytes{0};
+
+inline void count(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* allocate(size_t size) {
+    count(size);
+    void* ptr = __real_malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* allocateAligned(size_t size, std::align_val_t align) {
+    count(size);
+    size_t alignment = static_cast<size_t>(align);
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment < sizeof(void*) ? sizeof(void*) : alignment,
+                       size > 0 ? size : 1) != 0) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // namespace
+
+namespace bench {
+
+uint64_t allocationCount() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t allocatedBytes() {
+    return g_bytes.load(std::memory_order_relaxed);
+}
+
+} // namespace bench
+
+// ============================================================================
+// C Allocator (linker-wrapped)
+// ============================================================================
+
+extern "C" {
+
+void* __wrap_malloc(size_t size) {
+    count(size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count_, size_t size) {
+    count(count_ * size);
+    return __real_calloc(count_, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    count(size);
+    return __real_realloc(ptr, size);
+}
+
+} // extern "C"
+
+// ============================================================================
+// C++ Allocator (replaced)
+// ============================================================================
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t align) { return allocateAligned(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return allocateAligned(size, align); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    count(size);
+    return __real_malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    count(size);
+    return __real_malloc(size > 0 ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
@@ -0,0 +1,240 @@
+#include "bench.h"
+#include "internal/json.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+namespace bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double runLoop(const Registry::Fn& fn, uint64_t iterations) {
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        fn();
+        clobberMemory();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Iterations filling about min_time seconds
+uint64_t calibrate(const Registry::Fn& fn, double min_time) {
+    uint64_t iterations = 1;
+    while (true) {
+        double elapsed = runLoop(fn, iterations);
+        if (elapsed >= min_time / 10 || iterations >= (1ull << 40)) {
+            double per_op = elapsed / static_cast<double>(iterations);
+            return std::max<uint64_t>(1, static_cast<uint64_t>(min_time / std::max(per_op, 1e-12)));
+        }
+        iterations *= 10;
+    }
+}
+
+const char* buildType() {
+#ifdef NDEBUG
+    return "release";
+#else
+    return "debug";
+#endif
+}
+
+} // namespace
+
+std::string randomText(size_t size, uint32_t seed) {
+    static const char kAlphabet[] =
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ,.;:-_/";
+    std::mt19937 rng(seed);
+    std::string text(size, '\0');
+    for (char& c : text) {
+        c = kAlphabet[rng() % (sizeof(kAlphabet) - 1)];
+    }
+    return text;
+}
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+void Registry::add(std::string name, size_t bytes_per_op, Fn fn) {
+    benchmarks_.push_back(Benchmark{std::move(name), bytes_per_op, std::move(fn)});
+}
+
+std::vector<std::string> Registry::names() const {
+    std::vector<std::string> names;
+    for (const Benchmark& b : benchmarks_) names.push_back(b.name);
+    return names;
+}
+
+std::vector<Result> Registry::run(const Options& options, bool verbose) {
+    std::vector<Result> results;
+    if (verbose) {
+        std::printf("%-40s %14s %12s %12s %12s %14s\n",
+                    "benchmark", "iterations", "ns/op", "MB/s", "allocs/op", "alloc B/op");
+    }
+
+    for (const Benchmark& b : benchmarks_) {
+        if (!options.filter.empty() && b.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        b.fn();     // Warm caches and lazily built state
+        uint64_t iterations = calibrate(b.fn, options.min_time_s);
+
+        std::vector<double> samples;
+        uint64_t allocs = 0;
+        uint64_t alloc_bytes = 0;
+        for (int rep = 0; rep < std::max(options.repetitions, 1); rep++) {
+            uint64_t allocs_before = allocationCount();
+            uint64_t bytes_before = allocatedBytes();
+            double elapsed = runLoop(b.fn, iterations);
+            allocs += allocationCount() - allocs_before;
+            alloc_bytes += allocatedBytes() - bytes_before;
+            samples.push_back(elapsed * 1e9 / static_cast<double>(iterations));
+        }
+        std::sort(samples.begin(), samples.end());
+        double total_ops = static_cast<double>(iterations) * static_cast<double>(samples.size());
+
+        Result r;
+        r.name = b.name;
+        r.iterations = iterations;
+        r.ns_per_op = samples[samples.size() / 2];
+        r.ns_per_op_min = samples.front();
+        r.bytes_per_second = b.bytes_per_op > 0 ? static_cast<double>(b.bytes_per_op) * 1e9 / r.ns_per_op : 0;
+        r.allocs_per_op = static_cast<double>(allocs) / total_ops;
+        r.alloc_bytes_per_op = static_cast<double>(alloc_bytes) / total_ops;
+        results.push_back(r);
+
+        if (verbose) {
+            std::printf("%-40s %14llu %12.1f %12.1f %12.2f %14.1f\n", r.name.c_str(),
+                        static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                        r.bytes_per_second / 1e6, r.allocs_per_op, r.alloc_bytes_per_op);
+            std::fflush(stdout);
+        }
+    }
+    return results;
+}
+
+void Registry::cleanup() {
+    for (auto& fn : cleanups_) fn();
+    cleanups_.clear();
+}
+
+} // namespace bench
+
+// ============================================================================
+// Main
+// ============================================================================
+
+namespace {
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --filter=SUBSTR     only benchmarks whose name contains SUBSTR\n"
+        "  --min-time=SECONDS  per repetition (default 0.25)\n"
+        "  --repetitions=N     median over N runs (default 5)\n"
+        "  --json=PATH         write results as JSON\n"
+        "  --label=TEXT        stored in the JSON, e.g. a commit hash\n"
+        "  --fixtures=DIR      where FileSystem fixtures are generated (default $TMPDIR)\n"
+        "  --list              print benchmark names and exit\n",
+        argv0);
+}
+
+bool writeJson(const std::string& path, const std::string& label, const bench::Options& options,
+               const std::vector<bench::Result>& results) {
+    std::string out;
+    client::json::Writer w(out);
+    w.beginObject();
+    w.key("label").value(label);
+    w.key("timestamp").value(static_cast<long long>(std::time(nullptr)));
+    w.key("build_type").value(bench::buildType());
+    w.key("compiler").value(__VERSION__);
+    w.key("hardware_threads").value(std::thread::hardware_concurrency());
+    w.key("min_time_s").value(options.min_time_s);
+    w.key("repetitions").value(options.repetitions);
+    w.key("results").beginArray();
+    for (const bench::Result& r : results) {
+        w.beginObject();
+        w.key("name").value(r.name);
+        w.key("iterations").value(static_cast<unsigned long long>(r.iterations));
+        w.key("ns_per_op").value(r.ns_per_op);
+        w.key("ns_per_op_min").value(r.ns_per_op_min);
+        w.key("bytes_per_second").value(r.bytes_per_second);
+        w.key("allocs_per_op").value(r.allocs_per_op);
+        w.key("alloc_bytes_per_op").value(r.alloc_bytes_per_op);
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+    out.push_back('\n');
+
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    std::string json_path;
+    std::string label;
+    const char* tmp = std::getenv("TMPDIR");
+    std::string fixtures = tmp ? tmp : "/tmp";
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) -> const char* {
+            size_t len = std::strlen(prefix);
+            return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+        };
+        if (const char* v = value("--filter=")) {
+            options.filter = v;
+        } else if (const char* v = value("--min-time=")) {
+            options.min_time_s = std::atof(v);
+        } else if (const char* v = value("--repetitions=")) {
+            options.repetitions = std::atoi(v);
+        } else if (const char* v = value("--json=")) {
+            json_path = v;
+        } else if (const char* v = value("--label=")) {
+            label = v;
+        } else if (const char* v = value("--fixtures=")) {
+            fixtures = v;
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    bench::Registry registry;
+    bench::registerStringUtils(registry);
+    bench::registerCrypto(registry);
+    bench::registerFileSystem(registry, fixtures);
+
+    int status = 0;
+    if (list) {
+        for (const std::string& name : registry.names()) std::printf("%s\n", name.c_str());
+    } else {
+        std::vector<bench::Result> results = registry.run(options, true);
+        if (!json_path.empty() && !writeJson(json_path, label, options, results)) {
+            std::fprintf(stderr, "cannot write %s\n", json_path.c_str());
+            status = 1;
+        }
+    }
+    registry.cleanup();
+    return status;
+}
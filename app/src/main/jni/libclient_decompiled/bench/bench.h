@@ -0,0 +1,80 @@
+#ifndef LIBCLIENT_BENCH_H
+#define LIBCLIENT_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Totals from the interposed allocator (alloc_counter.cpp). Both count
+// every thread, so work handed to the shared pool is included.
+uint64_t allocationCount();
+uint64_t allocatedBytes();
+
+// Keep the compiler from discarding a result or hoisting work out of the
+// timing loop
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+struct Result {
+    std::string name;
+    uint64_t iterations;            // Per repetition
+    double ns_per_op;               // Median over repetitions
+    double ns_per_op_min;
+    double bytes_per_second;        // 0 when the benchmark has no byte count
+    double allocs_per_op;
+    double alloc_bytes_per_op;
+};
+
+struct Options {
+    double min_time_s = 0.25;       // Per repetition
+    int repetitions = 5;
+    std::string filter;             // Substring of the benchmark name
+};
+
+class Registry {
+public:
+    using Fn = std::function<void()>;
+
+    // fn runs one operation processing bytes_per_op bytes (0: not a
+    // throughput benchmark)
+    void add(std::string name, size_t bytes_per_op, Fn fn);
+
+    // Runs once after all benchmarks, e.g. to remove fixtures
+    void atExit(std::function<void()> fn) { cleanups_.push_back(std::move(fn)); }
+
+    std::vector<std::string> names() const;
+    std::vector<Result> run(const Options& options, bool verbose);
+    void cleanup();
+
+private:
+    struct Benchmark {
+        std::string name;
+        size_t bytes_per_op;
+        Fn fn;
+    };
+
+    std::vector<Benchmark> benchmarks_;
+    std::vector<std::function<void()>> cleanups_;
+};
+
+// Suites
+void registerStringUtils(Registry& registry);
+void registerCrypto(Registry& registry);
+void registerFileSystem(Registry& registry, const std::string& fixture_root);
+
+// Deterministic test data
+std::string randomText(size_t size, uint32_t seed);
+
+} // namespace bench
+
+#endif // LIBCLIENT_BENCH_H
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "internal/crypto_utils.h"
+#include <memory>
+#include <random>
+
+namespace bench {
+
+using namespace client::crypto;
+
+namespace {
+
+constexpr size_t kPayloadSize = 64 * 1024;
+
+std::vector<uint8_t> randomBytes(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& b : bytes) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return bytes;
+}
+
+} // namespace
+
+void registerCrypto(Registry& registry) {
+    auto payload = std::make_shared<const std::vector<uint8_t>>(randomBytes(kPayloadSize, 11));
+    auto base64 = std::make_shared<const std::string>(Base64::encode(payload->data(), payload->size()));
+    auto decoded = std::make_shared<std::vector<uint8_t>>();
+
+    // Base64
+    registry.add("Base64/encode/64KB", kPayloadSize, [payload] {
+        std::string encoded = Base64::encode(payload->data(), payload->size());
+        doNotOptimize(encoded.data());
+    });
+    registry.add("Base64/decode/64KB", kPayloadSize, [base64, decoded] {
+        doNotOptimize(Base64::decode(*base64, *decoded));
+    });
+
+    // Hex
+    registry.add("Hex/encode/64KB", kPayloadSize, [payload] {
+        std::string encoded = Hex::encode(payload->data(), payload->size());
+        doNotOptimize(encoded.data());
+    });
+
+    // CRC
+    registry.add("CRC/crc32/64KB", kPayloadSize, [payload] {
+        doNotOptimize(CRC::crc32(payload->data(), payload->size()));
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,151 @@
+#include "bench.h"
+#include "internal/platform_specific.h"
+#include <cstdio>
+#include <memory>
+#include <unistd.h>
+
+namespace bench {
+
+using client::platform::DirectoryEntry;
+using client::platform::DirectoryScanner;
+using client::platform::FileSystem;
+using client::platform::WriteMode;
+
+namespace {
+
+// FileSystem::combinePath and removeDirectory are declared but have no
+// implementation in this tree, so fixtures are laid out and removed here
+std::string joinPath(const std::string& directory, const std::string& name) {
+    return directory + "/" + name;
+}
+
+void removeFixtureDirectory(const std::string& directory) {
+    for (const std::string& name : FileSystem::listFiles(directory)) {
+        FileSystem::remove(joinPath(directory, name));
+    }
+    rmdir(directory.c_str());
+}
+
+constexpr size_t kSmallFileSize = 4 * 1024;
+constexpr size_t kSmallFileCount = 256;
+constexpr size_t kLargeFileSize = 8 * 1024 * 1024;
+constexpr size_t kListingEntries = 1000;
+
+// Generated once per run under fixture_root and removed by Registry::cleanup
+struct Fixtures {
+    std::string root;
+    std::string small_dir;          // kSmallFileCount files of kSmallFileSize
+    std::string large_file;         // kLargeFileSize
+    std::string listing_dir;        // kListingEntries empty files
+    std::string scratch_dir;        // Destination of write/copy benchmarks
+    std::vector<std::string> small_files;
+
+    bool create(const std::string& fixture_root) {
+        root = joinPath(fixture_root, "libclient_bench." + std::to_string(getpid()));
+        small_dir = joinPath(root, "small");
+        listing_dir = joinPath(root, "listing");
+        scratch_dir = joinPath(root, "scratch");
+        large_file = joinPath(root, "large.bin");
+
+        if (!FileSystem::createDirectory(small_dir) || !FileSystem::createDirectory(listing_dir) ||
+            !FileSystem::createDirectory(scratch_dir)) {
+            return false;
+        }
+
+        std::string small = randomText(kSmallFileSize, 21);
+        for (size_t i = 0; i < kSmallFileCount; i++) {
+            small_files.push_back(joinPath(small_dir, "f" + std::to_string(i) + ".dat"));
+            if (!FileSystem::writeFile(small_files.back(), small)) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < kListingEntries; i++) {
+            std::string path = joinPath(listing_dir, "entry_" + std::to_string(i));
+            if (!FileSystem::writeFile(path, std::string())) {
+                return false;
+            }
+        }
+        return FileSystem::writeFile(large_file, randomText(kLargeFileSize, 22));
+    }
+};
+
+} // namespace
+
+void registerFileSystem(Registry& registry, const std::string& fixture_root) {
+    auto fx = std::make_shared<Fixtures>();
+    registry.atExit([fx] {
+        if (fx->root.empty()) {
+            return;
+        }
+        removeFixtureDirectory(fx->small_dir);
+        removeFixtureDirectory(fx->listing_dir);
+        removeFixtureDirectory(fx->scratch_dir);
+        removeFixtureDirectory(fx->root);
+    });
+    if (!fx->create(fixture_root)) {
+        // Leave the suite out rather than report numbers for failed I/O;
+        // the partial fixture tree is removed by the cleanup above
+        std::fprintf(stderr, "FileSystem fixtures could not be created under %s\n",
+                     fixture_root.c_str());
+        return;
+    }
+
+    // read
+    auto data = std::make_shared<std::string>();
+    auto next = std::make_shared<size_t>(0);
+    registry.add("FileSystem/readFile/4KB", kSmallFileSize, [fx, data, next] {
+        const std::string& path = fx->small_files[(*next)++ % fx->small_files.size()];
+        doNotOptimize(FileSystem::readFile(path, *data));
+    });
+    registry.add("FileSystem/readFile/8MB", kLargeFileSize, [fx, data] {
+        doNotOptimize(FileSystem::readFile(fx->large_file, *data));
+    });
+    registry.add("FileSystem/mapFile/8MB", kLargeFileSize, [fx] {
+        common::MappedFile file;
+        doNotOptimize(FileSystem::mapFile(fx->large_file, file));
+    });
+
+    // write
+    auto small = std::make_shared<const std::string>(randomText(kSmallFileSize, 23));
+    auto medium = std::make_shared<const std::string>(randomText(1024 * 1024, 24));
+    auto small_target = std::make_shared<const std::string>(joinPath(fx->scratch_dir, "small.dat"));
+    auto medium_target = std::make_shared<const std::string>(joinPath(fx->scratch_dir, "medium.dat"));
+    registry.add("FileSystem/writeFile/InPlace/4KB", kSmallFileSize, [small, small_target] {
+        doNotOptimize(FileSystem::writeFile(*small_target, *small, WriteMode::InPlace));
+    });
+    registry.add("FileSystem/writeFile/Atomic/4KB", kSmallFileSize, [small, small_target] {
+        doNotOptimize(FileSystem::writeFile(*small_target, *small, WriteMode::Atomic));
+    });
+    registry.add("FileSystem/writeFile/InPlace/1MB", medium->size(), [medium, medium_target] {
+        doNotOptimize(FileSystem::writeFile(*medium_target, *medium, WriteMode::InPlace));
+    });
+    auto copy_target = std::make_shared<const std::string>(joinPath(fx->scratch_dir, "copy.bin"));
+    registry.add("FileSystem/copy/8MB", kLargeFileSize, [fx, copy_target] {
+        doNotOptimize(FileSystem::copy(fx->large_file, *copy_target));
+    });
+
+    // list
+    registry.add("FileSystem/listFiles/1000", 0, [fx] {
+        std::vector<std::string> files = FileSystem::listFiles(fx->listing_dir);
+        doNotOptimize(files.data());
+    });
+    auto scanner = std::make_shared<DirectoryScanner>();
+    registry.add("DirectoryScanner/scan/1000", 0, [fx, scanner] {
+        size_t files = 0;
+        scanner->scan(fx->listing_dir, [&files](const DirectoryEntry& entry) {
+            files += entry.type == DirectoryEntry::File;
+            return true;
+        });
+        doNotOptimize(files);
+    });
+    registry.add("DirectoryScanner/scan/1000/stat_size", 0, [fx, scanner] {
+        uint64_t bytes = 0;
+        scanner->scan(fx->listing_dir, [&bytes](const DirectoryEntry& entry) {
+            bytes += entry.size;
+            return true;
+        }, DirectoryScanner::kStatSize);
+        doNotOptimize(bytes);
+    });
+}
+
+} // namespace bench
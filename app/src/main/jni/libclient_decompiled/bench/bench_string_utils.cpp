@@ -0,0 +1,147 @@
+#include "bench.h"
+#include "internal/string_utils.h"
+#include <memory>
+#include <random>
+
+namespace bench {
+
+using client::utils::StringUtils;
+
+namespace {
+
+// Comma-separated record of short fields, about size bytes
+std::string csvLine(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::string line;
+    while (line.size() < size) {
+        if (!line.empty()) line.push_back(',');
+        line.append(randomText(1 + rng() % 12, rng()));
+    }
+    return line;
+}
+
+std::string mixedCase(size_t size) {
+    std::string text = randomText(size, 7);
+    for (size_t i = 0; i < text.size(); i += 3) {
+        text[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+    }
+    return text;
+}
+
+} // namespace
+
+void registerStringUtils(Registry& registry) {
+    // Inputs live as long as the registry's closures
+    auto csv = std::make_shared<const std::string>(csvLine(4096, 1));
+    auto text = std::make_shared<const std::string>(randomText(64 * 1024, 2));
+    auto upper = std::make_shared<const std::string>(mixedCase(64 * 1024));
+    auto padded = std::make_shared<const std::string>("  \t " + randomText(256, 3) + " \r\n  ");
+
+    // split
+    auto views = std::make_shared<std::vector<std::string_view>>();
+    registry.add("StringUtils/split/char_view/4KB", csv->size(), [csv, views] {
+        doNotOptimize(StringUtils::split(*csv, ',', *views));
+    });
+    registry.add("StringUtils/split/string_view_delim/4KB", csv->size(), [csv, views] {
+        doNotOptimize(StringUtils::split(*csv, std::string_view(",a"), *views));
+    });
+    registry.add("StringUtils/split/char_copy/4KB", csv->size(), [csv] {
+        std::vector<std::string> parts = StringUtils::split(*csv, ',');
+        doNotOptimize(parts.data());
+    });
+    registry.add("StringUtils/splitRange/4KB", csv->size(), [csv] {
+        size_t fields = 0;
+        for (std::string_view field : StringUtils::splitRange(*csv, ",")) {
+            fields += field.size() > 0;
+        }
+        doNotOptimize(fields);
+    });
+
+    // trim
+    registry.add("StringUtils/trimView/256B", padded->size(), [padded] {
+        doNotOptimize(StringUtils::trimView(*padded));
+    });
+    registry.add("StringUtils/trim/256B", padded->size(), [padded] {
+        std::string trimmed = StringUtils::trim(*padded);
+        doNotOptimize(trimmed.data());
+    });
+
+    // replaceAll
+    registry.add("StringUtils/replaceAll/grow/64KB", text->size(), [text] {
+        std::string out = StringUtils::replaceAll(*text, "ab", "xyz");
+        doNotOptimize(out.data());
+    });
+    registry.add("StringUtils/replaceAll/shrink/64KB", text->size(), [text] {
+        std::string out = StringUtils::replaceAll(*text, ", ", ",");
+        doNotOptimize(out.data());
+    });
+    registry.add("StringUtils/replaceAll/no_match/64KB", text->size(), [text] {
+        std::string out = StringUtils::replaceAll(*text, "#!", "--");
+        doNotOptimize(out.data());
+    });
+
+    // Case folding
+    registry.add("StringUtils/toLower/64KB", upper->size(), [upper] {
+        std::string lower = StringUtils::toLower(*upper);
+        doNotOptimize(lower.data());
+    });
+    auto scratch = std::make_shared<std::string>();
+    registry.add("StringUtils/toLowerInPlace/64KB", upper->size(), [upper, scratch] {
+        scratch->assign(*upper);
+        StringUtils::toLowerInPlace(*scratch);
+        doNotOptimize(scratch->data());
+    });
+    auto lower = std::make_shared<const std::string>(StringUtils::toLower(*upper));
+    registry.add("StringUtils/equalsIgnoreCase/64KB", upper->size(), [upper, lower] {
+        doNotOptimize(StringUtils::equalsIgnoreCase(*upper, *lower));
+    });
+    registry.add("StringUtils/hashIgnoreCase/64KB", upper->size(), [upper] {
+        doNotOptimize(StringUtils::hashIgnoreCase(*upper));
+    });
+
+    // Numeric conversion, 1024 values per op
+    auto ints = std::make_shared<std::vector<std::string>>();
+    auto doubles = std::make_shared<std::vector<std::string>>();
+    size_t int_bytes = 0, double_bytes = 0;
+    std::mt19937 rng(4);
+    for (int i = 0; i < 1024; i++) {
+        ints->push_back(std::to_string(static_cast<int>(rng()) / 7));
+        doubles->push_back(StringUtils::fromDouble(static_cast<double>(rng()) / 997.0));
+        int_bytes += ints->back().size();
+        double_bytes += doubles->back().size();
+    }
+    registry.add("StringUtils/toInt/x1024", int_bytes, [ints] {
+        long sum = 0;
+        for (const std::string& s : *ints) sum += StringUtils::toInt(s);
+        doNotOptimize(sum);
+    });
+    registry.add("StringUtils/toDouble/x1024", double_bytes, [doubles] {
+        double sum = 0;
+        for (const std::string& s : *doubles) sum += StringUtils::toDouble(s);
+        doNotOptimize(sum);
+    });
+    auto out = std::make_shared<std::string>();
+    registry.add("StringUtils/appendInt/x1024", 0, [out] {
+        out->clear();
+        for (int i = 0; i < 1024; i++) StringUtils::appendInt(*out, i * 7919 - 4000000);
+        doNotOptimize(out->data());
+    });
+    registry.add("StringUtils/appendDouble/x1024", 0, [out] {
+        out->clear();
+        for (int i = 0; i < 1024; i++) StringUtils::appendDouble(*out, i * 0.3183098861837907);
+        doNotOptimize(out->data());
+    });
+    registry.add("StringUtils/fromInt/x1024", 0, [] {
+        size_t total = 0;
+        for (int i = 0; i < 1024; i++) total += StringUtils::fromInt(i * 7919 - 4000000).size();
+        doNotOptimize(total);
+    });
+
+    // URL encoding
+    registry.add("StringUtils/urlEncode/4KB", csv->size(), [csv] {
+        std::string encoded = StringUtils::urlEncode(*csv);
+        doNotOptimize(encoded.data());
+    });
+}
+
+} // namespace bench
@@ -5,9 +5,10 @@
 #include <string>
 #include <functional>
 #include <atomic>
-#include <thread>
 #include <memory>
 
+#include "common/thread_pool.h"
+
 namespace client {
 
 class AntiTamper {
@@ -101,15 +102,13 @@ private:
     std::string getSystemProperty(const std::string& key);
     bool hasSystemProperty(const std::string& key);
     
-    // Monitoring thread
-    void monitoringThreadFunc();
+    // Monitoring (a background task on the shared pool)
     void performPeriodicChecks();
     void handleThreatDetected(const std::string& threat);
     
     // State
     std::atomic<bool> initialized_;
     std::atomic<bool> monitoring_;
-    std::atomic<bool> should_stop_;
     
     // Check configuration
     struct CheckConfig {
@@ -124,7 +123,7 @@ private:
     mutable std::mutex result_mutex_;
     
     // Monitoring
-    std::unique_ptr<std::thread> monitor_thread_;
+    common::PeriodicTask monitor_task_;
     int check_interval_ms_;
     
     // Callback
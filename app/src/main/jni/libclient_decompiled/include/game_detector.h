@@ -6,9 +6,10 @@
 #include <vector>
 #include <string>
 #include <map>
-#include <thread>
 #include <atomic>
 
+#include "common/thread_pool.h"
+
 namespace client {
 
 class GameDetector {
@@ -59,8 +60,7 @@ private:
     bool getGameVersion(const std::string& package_name, std::string& version_name, int& version_code);
     uint64_t getProcessStartTime(int pid);
     
-    // Detection thread
-    void detectionThreadFunc();
+    // Detection (a background task on the shared pool)
     void checkRunningGames();
     void notifyGameDetected(const GameInfo& info);
     void notifyGameStopped(const std::string& package_name);
@@ -77,7 +77,6 @@ private:
     // State
     std::atomic<bool> initialized_;
     std::atomic<bool> auto_detecting_;
-    std::atomic<bool> should_stop_;
     GameStatus game_status_;
     
     // Current game information
@@ -97,8 +96,8 @@ private:
     GameStoppedCallback game_stopped_callback_;
     std::mutex callback_mutex_;
     
-    // Detection thread
-    std::unique_ptr<std::thread> detection_thread_;
+    // Detection task
+    common::PeriodicTask detection_task_;
     int detection_interval_ms_;
     
     // Configuration
@@ -1,15 +1,49 @@
 #ifndef LIBCLIENT_CRYPTO_UTILS_H
 #define LIBCLIENT_CRYPTO_UTILS_H
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 
+#include "common/aes.h"
+#include "common/hash.h"
+#include "common/span.h"
+
 namespace client {
 namespace crypto {
 
+// Expanded AES key schedule; build once and reuse across calls.
+class AESKey {
+public:
+    AESKey();
+    explicit AESKey(common::ByteSpan key);
+    ~AESKey();
+
+    AESKey(const AESKey&) = delete;
+    AESKey& operator=(const AESKey&) = delete;
+
+    // Accepts 16, 24 or 32 byte keys
+    bool setKey(common::ByteSpan key);
+    bool valid() const { return valid_; }
+    const common_aes_key_t* schedule() const { return &schedule_; }
+
+private:
+    common_aes_key_t schedule_;
+    bool valid_;
+};
+
+// AES-CBC with PKCS#7 padding
 class AES {
 public:
+    static constexpr size_t kBlockSize = COMMON_AES_BLOCK_SIZE;
+
+    // Ciphertext size for a plaintext length (padding always adds 1..16 bytes)
+    static size_t encryptedSize(size_t plaintext_len) {
+        return common_pkcs7_padded_size(plaintext_len);
+    }
+
     static bool encrypt(const uint8_t* input, size_t input_len,
                        const uint8_t* key, size_t key_len,
                        const uint8_t* iv, size_t iv_len,
@@ -29,21 +63,125 @@ public:
                           const std::vector<uint8_t>& key,
                           const std::vector<uint8_t>& iv,
                           std::vector<uint8_t>& plaintext);
+
+    // Zero-copy variants. ciphertext must hold encryptedSize(plaintext.size())
+    // bytes; plaintext must hold ciphertext.size() bytes. Raw keys are
+    // expanded through a small per-thread schedule cache.
+    static bool encryptCBC(common::ByteSpan plaintext, common::ByteSpan key,
+                          common::ByteSpan iv, common::MutableByteSpan ciphertext,
+                          size_t& written);
+
+    static bool decryptCBC(common::ByteSpan ciphertext, common::ByteSpan key,
+                          common::ByteSpan iv, common::MutableByteSpan plaintext,
+                          size_t& written);
+
+    static bool encryptCBC(common::ByteSpan plaintext, const AESKey& key,
+                          common::ByteSpan iv, common::MutableByteSpan ciphertext,
+                          size_t& written);
+
+    static bool decryptCBC(common::ByteSpan ciphertext, const AESKey& key,
+                          common::ByteSpan iv, common::MutableByteSpan plaintext,
+                          size_t& written);
+
+    // In-place variants. For encryption the first data_len bytes of buffer
+    // are plaintext and buffer must hold encryptedSize(data_len) bytes.
+    static bool encryptCBCInPlace(common::MutableByteSpan buffer, size_t data_len,
+                                 common::ByteSpan key, common::ByteSpan iv,
+                                 size_t& written);
+
+    static bool decryptCBCInPlace(common::MutableByteSpan buffer,
+                                 common::ByteSpan key, common::ByteSpan iv,
+                                 size_t& written);
+
+    static bool encryptCBCInPlace(common::MutableByteSpan buffer, size_t data_len,
+                                 const AESKey& key, common::ByteSpan iv,
+                                 size_t& written);
+
+    static bool decryptCBCInPlace(common::MutableByteSpan buffer,
+                                 const AESKey& key, common::ByteSpan iv,
+                                 size_t& written);
+
+private:
+    static const AESKey* cachedKey(common::ByteSpan key);
+};
+
+enum class HashAlgorithm {
+    MD5 = COMMON_HASH_MD5,
+    SHA1 = COMMON_HASH_SHA1,
+    SHA256 = COMMON_HASH_SHA256,
+    SHA512 = COMMON_HASH_SHA512
+};
+
+typedef std::array<uint8_t, COMMON_MD5_DIGEST_SIZE> MD5Digest;
+typedef std::array<uint8_t, COMMON_SHA1_DIGEST_SIZE> SHA1Digest;
+typedef std::array<uint8_t, COMMON_SHA256_DIGEST_SIZE> SHA256Digest;
+typedef std::array<uint8_t, COMMON_SHA512_DIGEST_SIZE> SHA512Digest;
+
+// Streaming hash over the shared engine; copyable to snapshot a prefix.
+class HashContext {
+public:
+    explicit HashContext(HashAlgorithm algorithm);
+
+    void reset();
+
+    HashContext& update(const void* data, size_t length);
+    HashContext& update(std::string_view input);
+    HashContext& update(common::ByteSpan data);
+
+    HashAlgorithm algorithm() const { return algorithm_; }
+    size_t digestSize() const;
+
+    // Writes digestSize() bytes and resets the context for reuse.
+    size_t finish(common::MutableByteSpan digest);
+    std::string finishHex();
+
+private:
+    HashAlgorithm algorithm_;
+    common_hash_context_t ctx_;
+};
+
+// One result of Hash::directory
+struct FileDigest {
+    std::string path;
+    std::string hex;        // Empty if the file could not be read
 };
 
 class Hash {
 public:
     static std::string md5(const std::string& input);
     static std::string md5(const uint8_t* data, size_t length);
+    static void md5(std::string_view input, MD5Digest& digest);
+    static void md5(common::ByteSpan data, MD5Digest& digest);
     
     static std::string sha1(const std::string& input);
     static std::string sha1(const uint8_t* data, size_t length);
+    static void sha1(std::string_view input, SHA1Digest& digest);
+    static void sha1(common::ByteSpan data, SHA1Digest& digest);
     
     static std::string sha256(const std::string& input);
     static std::string sha256(const uint8_t* data, size_t length);
+    static void sha256(std::string_view input, SHA256Digest& digest);
+    static void sha256(common::ByteSpan data, SHA256Digest& digest);
     
     static std::string sha512(const std::string& input);
     static std::string sha512(const uint8_t* data, size_t length);
+    static void sha512(std::string_view input, SHA512Digest& digest);
+    static void sha512(common::ByteSpan data, SHA512Digest& digest);
+
+    // Hash a file without holding it in memory. Files over one 256 KiB
+    // chunk are double-buffered by a reader thread so reading overlaps
+    // hashing. Nothing is mapped, so a file truncated meanwhile cannot
+    // fault. Returns the digest length, or 0 if the file could not be read.
+    static size_t file(const std::string& path, HashAlgorithm algorithm, common::MutableByteSpan digest);
+    static std::string fileHex(const std::string& path, HashAlgorithm algorithm);
+
+    // Hash every regular file under directory, recursively, on up to
+    // max_threads workers. Results are sorted by path.
+    static std::vector<FileDigest> directory(const std::string& directory, HashAlgorithm algorithm,
+                                             unsigned max_threads = 4);
+
+    // Name of the backend in use ("armv8-ce", "sha-ni" or "c")
+    static const char* backend(HashAlgorithm algorithm);
 };
 
 class Base64 {
@@ -87,6 +225,12 @@ public:
     
     static bool decrypt(const std::vector<uint8_t>& ciphertext,
                        std::vector<uint8_t>& plaintext);
+
+    static bool encrypt(common::ByteSpan plaintext, common::MutableByteSpan ciphertext,
+                       size_t& written);
+
+    static bool decrypt(common::ByteSpan ciphertext, common::MutableByteSpan plaintext,
+                       size_t& written);
     
     static bool encryptFile(const std::string& input_path,
                            const std::string& output_path);
@@ -95,6 +239,8 @@ public:
                            const std::string& output_path);
     
 private:
+    static const AESKey& key();
+
     static const uint8_t kBurriKey[];
     static const uint8_t kBurriIV[];
     static constexpr size_t kKeySize = 32;
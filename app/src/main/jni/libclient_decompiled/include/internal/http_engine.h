@@ -0,0 +1,282 @@
+#ifndef LIBCLIENT_HTTP_ENGINE_H
+#define LIBCLIENT_HTTP_ENGINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace client {
+namespace http {
+
+// Hashed timing wheel (Varghese & Lauck). Timers are intrusive, so
+// scheduling, cancelling and expiring are O(1) and never allocate. A timer
+// further out than one revolution stays in its slot until its tick comes
+// round. Not thread-safe.
+class TimerWheel {
+public:
+    struct Timer {
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+        uint64_t tick = 0;          // Due tick
+        int tag = 0;                // Free for the owner, e.g. to tell timer kinds apart
+
+        bool armed() const { return next != nullptr; }
+    };
+
+    explicit TimerWheel(uint32_t tick_ms = 10, size_t slots = 1024);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // (Re)arm timer to fire delay_ms after now_ms
+    void schedule(Timer* timer, uint64_t now_ms, uint64_t delay_ms);
+    void cancel(Timer* timer);
+
+    // Unlink every timer due by now_ms and call fn(timer) for it. fn may
+    // schedule or cancel any timer, including the one it was given.
+    template <typename Fn>
+    void advance(uint64_t now_ms, Fn&& fn);
+
+    // Milliseconds until the next timer is due (0 if one already is), or
+    // -1 if none is armed. Suits epoll_wait().
+    int nextTimeout(uint64_t now_ms) const;
+
+    size_t size() const { return count_; }
+
+private:
+    static void insert(Timer* head, Timer* timer);     // At the tail of head's list
+    static void remove(Timer* timer);
+    void unlink(Timer* timer);
+
+    uint32_t tick_ms_;
+    std::vector<Timer> slots_;      // Sentinels of circular lists
+    uint64_t current_;              // Last tick processed
+    size_t count_;
+};
+
+template <typename Fn>
+void TimerWheel::advance(uint64_t now_ms, Fn&& fn) {
+    uint64_t target = now_ms / tick_ms_;
+    if (target <= current_) {
+        return;
+    }
+    // Collect everything due first, so fn can rearrange the slots freely.
+    // After a long stall one revolution visits every slot.
+    Timer expired;
+    expired.prev = expired.next = &expired;
+    uint64_t first = std::max(current_ + 1, target >= slots_.size() ? target - slots_.size() + 1 : 0);
+    current_ = target;
+    for (uint64_t t = first; t <= target && count_ > 0; t++) {
+        Timer* head = &slots_[t % slots_.size()];
+        for (Timer* timer = head->next; timer != head;) {
+            Timer* next = timer->next;
+            if (timer->tick <= target) {
+                remove(timer);
+                insert(&expired, timer);
+            }
+            timer = next;
+        }
+    }
+    while (expired.next != &expired) {
+        Timer* timer = expired.next;
+        unlink(timer);
+        fn(timer);
+    }
+}
+
+// Request body, referenced rather than copied. Memory bodies go out in
+// the same sendmsg() as the head; file bodies with sendfile(), which
+// leaves the file position alone.
+struct Body {
+    const char* data = nullptr;
+    size_t size = 0;
+    int fd = -1;                // If >= 0, size bytes of this file from offset
+    off_t offset = 0;
+    std::shared_ptr<const void> owner;      // Keeps data or fd alive, if set
+
+    static Body memory(const char* data, size_t size) {
+        Body body;
+        body.data = data;
+        body.size = size;
+        return body;
+    }
+    static Body file(int fd, off_t offset, size_t size) {
+        Body body;
+        body.fd = fd;
+        body.offset = offset;
+        body.size = size;
+        return body;
+    }
+};
+
+// One HTTP/1.1 exchange. head is the request line and header fields
+// including the blank line. The body must stay valid until the callback
+// runs (send() returning, for blocking calls); set owner to tie its
+// lifetime to the request instead.
+struct Request {
+    std::string method;         // Decides body framing of the response and retry safety
+    std::string host;
+    int port = 80;
+    std::string head;
+    Body body;
+    int timeout_ms = 0;         // Whole exchange, queueing included; 0: engine default
+};
+
+struct Response {
+    int status_code = 0;
+    std::string reason;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    int error = 0;              // errno value if the exchange failed
+    std::string error_message;
+
+    bool ok() const { return error == 0; }
+};
+
+// Non-blocking HTTP/1.1 client on a single epoll event loop thread.
+//
+// Connections:
+// - Each host:port has a pool of keep-alive connections. A request goes
+//   to an idle connection if there is one, else to a new connection while
+//   the host is under max_connections_per_host, else it is pipelined
+//   behind the shortest queue.
+// - Only idempotent requests (GET, HEAD, PUT, DELETE, OPTIONS) are
+//   pipelined, and only on connections that have already kept a response
+//   alive. Anything else waits for a connection of its own.
+// - If a connection closes before answering, idempotent requests on it
+//   are retried once on another connection.
+// - Idle connections close after idle_timeout_ms.
+//
+// Timeouts run off a timer wheel on the loop thread; each request has one
+// deadline covering queueing, connecting, sending and receiving.
+//
+// Requests are written straight from their head and body: pipelined
+// requests share one sendmsg() and file bodies use sendfile(), so the
+// payload is never copied in user space.
+//
+// Host names are resolved on the submitting thread (and cached), so the
+// loop itself never blocks. Plain TCP only.
+class Engine {
+public:
+    struct Options {
+        size_t max_connections_per_host = 6;
+        size_t max_pipeline_depth = 8;
+        int request_timeout_ms = 30000;
+        int idle_timeout_ms = 60000;
+    };
+
+    struct Stats {
+        uint64_t connections_opened = 0;
+        uint64_t requests_completed = 0;    // Got a response, whatever its status
+        uint64_t requests_failed = 0;
+        uint64_t requests_reused = 0;       // Sent on a connection that had already answered
+        uint64_t requests_pipelined = 0;    // Sent while another was in flight on the connection
+        uint64_t requests_retried = 0;
+    };
+
+    using Callback = std::function<void(Response&& response)>;
+
+    Engine();
+    explicit Engine(const Options& options);
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    bool start();
+
+    // Fails everything outstanding with ECANCELED and closes all
+    // connections. Safe to call twice; not from a callback.
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Queue a request. The callback runs exactly once on the loop thread,
+    // or on the calling thread before submit() returns if the request is
+    // rejected (engine stopped, host unresolvable). Callbacks must not
+    // block: the loop serves every connection.
+    void submit(Request request, Callback callback);
+
+    // Blocking submit(). Fails with EDEADLK on the loop thread.
+    Response send(Request request);
+
+    bool onLoopThread() const { return std::this_thread::get_id() == loop_id_; }
+
+    Stats stats() const;
+
+private:
+    struct Exchange;
+    struct Connection;
+    struct HostPool;
+
+    void loop();
+    void wake();
+    void drainSubmissions();
+    void process(Exchange* exchange);
+
+    void dispatch(HostPool* pool);
+    Connection* openConnection(HostPool* pool);
+    bool canPipeline(const Connection* conn, const Exchange* exchange) const;
+    void assign(Connection* conn, Exchange* exchange);
+    void updateEvents(Connection* conn);
+
+    void onEvent(Connection* conn, uint32_t events);
+    void onConnected(Connection* conn);
+    bool flush(Connection* conn);
+    void advanceSend(Connection* conn, size_t bytes);
+    void receive(Connection* conn);
+    bool completeResponses(Connection* conn);
+    void onTimer(TimerWheel::Timer* timer);
+
+    void closeConnection(Connection* conn, int error, const char* message, bool retry);
+    void becomeIdle(Connection* conn);
+    void complete(Exchange* exchange, Response&& response);
+    void fail(Exchange* exchange, int error, const char* message);
+
+    bool resolve(const std::string& host, int port, std::string& address);
+    static uint64_t nowMs();
+
+    Options options_;
+    int epoll_fd_;
+    int wake_fd_;
+    std::thread thread_;
+    std::thread::id loop_id_;
+    std::atomic<bool> running_;
+
+    // Handed over from submit() to the loop
+    std::mutex submit_mutex_;
+    std::vector<Exchange*> submissions_;
+    bool stopping_;
+
+    // Loop thread only
+    TimerWheel timers_;
+    std::unordered_map<std::string, std::unique_ptr<HostPool>> pools_;
+    std::vector<Connection*> closed_;       // Freed after the current batch of events
+
+    std::mutex resolve_mutex_;
+    std::unordered_map<std::string, std::string> resolved_;    // host:port -> sockaddr bytes
+
+    struct Counters {
+        std::atomic<uint64_t> connections_opened{0};
+        std::atomic<uint64_t> requests_completed{0};
+        std::atomic<uint64_t> requests_failed{0};
+        std::atomic<uint64_t> requests_reused{0};
+        std::atomic<uint64_t> requests_pipelined{0};
+        std::atomic<uint64_t> requests_retried{0};
+    } counters_;
+};
+
+} // namespace http
+} // namespace client
+
+#endif // LIBCLIENT_HTTP_ENGINE_H
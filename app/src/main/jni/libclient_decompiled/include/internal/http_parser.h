@@ -0,0 +1,163 @@
+#ifndef LIBCLIENT_HTTP_PARSER_H
+#define LIBCLIENT_HTTP_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace client {
+namespace http {
+
+// One header field. Both views point into the parser's receive buffer.
+struct Header {
+    std::string_view name;
+    std::string_view value;     // Leading and trailing whitespace removed
+};
+
+// Resumable HTTP/1.1 response parser (RFC 7230).
+//
+// Receiving and buffering:
+// - Bytes are received straight into the parser's buffer with
+//   prepare()/commit() and parsed as they arrive.
+// - The status line and header fields stay in that buffer, so reason(),
+//   headers() and header() return views into it. These views stay valid
+//   until the parser is fed again or reset.
+// - Body bytes are handed to the sink as they are decoded and then
+//   dropped. A large body never has to be held in memory.
+//
+// Body framing follows RFC 7230 3.3.3:
+// - HEAD responses and 1xx, 204 and 304 have no body.
+// - Otherwise the chunked transfer coding or Content-Length is used.
+// - Failing both, the body runs until the connection closes (finish()).
+// Interim 1xx responses other than 101 are skipped. Bytes received after a
+// complete response are kept for the next one, so pipelined responses
+// parse back to back.
+//
+// Not thread-safe; use one parser per connection.
+class ResponseParser {
+public:
+    enum class Result {
+        NeedMore,       // Everything received so far is consumed
+        Done,           // Response complete
+        Error           // Malformed or over a limit; see error()
+    };
+
+    // Called with each decoded piece of the body; return false to abort
+    using BodySink = std::function<bool(std::string_view data)>;
+
+    static constexpr size_t kMaxHeadBytes = 64 * 1024;     // Status line and header fields
+    static constexpr size_t kMaxHeaders = 128;
+
+    ResponseParser();
+
+    // Start the next response, keeping any bytes received past the last
+    // one (commit(0) parses them). head_request: the request was HEAD, so
+    // no body follows.
+    void reset(bool head_request = false);
+
+    // Without a sink the body is collected into body()
+    void setBodySink(BodySink sink) { sink_ = std::move(sink); }
+
+    // Zero-copy receive: write up to *capacity (>= min_capacity) bytes at
+    // the returned pointer, then commit() the number actually written
+    char* prepare(size_t min_capacity, size_t* capacity);
+    Result commit(size_t length);
+
+    // Copies data in and commits it, for bytes that already sit elsewhere
+    Result feed(const char* data, size_t length);
+
+    // The peer closed the connection. Completes a body delimited by the
+    // close; anything else unfinished is an error.
+    Result finish();
+
+    Result result() const { return result_; }
+    bool headersComplete() const { return state_ > State::Head; }
+    bool done() const { return result_ == Result::Done; }
+
+    // Response head; valid once headersComplete()
+    int statusCode() const { return status_code_; }
+    int versionMinor() const { return version_minor_; }
+    std::string_view reason() const { return reason_; }
+    const std::vector<Header>& headers() const { return headers_; }
+
+    // Value of the first field with this name (case-insensitive), or empty
+    std::string_view header(std::string_view name) const;
+    bool hasHeader(std::string_view name) const;
+
+    // Framing
+    bool chunked() const { return chunked_; }
+    int64_t contentLength() const { return content_length_; }     // -1 if not sent
+    uint64_t bodyBytes() const { return body_bytes_; }            // Decoded so far
+    bool keepAlive() const;     // Connection can carry another request
+
+    const std::string& body() const { return body_; }
+    std::string takeBody() { return std::move(body_); }
+
+    const char* error() const { return error_; }
+
+    // Bytes received past the current response (start of the next one)
+    size_t pendingBytes() const { return end_ - pos_; }
+
+private:
+    enum class State : uint8_t {
+        Head,
+        Identity,           // Content-Length body
+        UntilClose,
+        ChunkSize,
+        ChunkExtension,
+        ChunkSizeLF,
+        ChunkData,
+        ChunkDataCR,
+        ChunkDataLF,
+        TrailerStart,
+        TrailerLine,
+        TrailerLF,
+        Done
+    };
+
+    Result parse();
+    Result parseHead(size_t head_end);
+    bool parseStatusLine(std::string_view line);
+    bool parseHeaderLine(std::string_view line);
+    bool setupFraming();
+    size_t parseBody(const char* data, size_t length);
+    bool deliver(const char* data, size_t length);
+    void rebase(const char* old_base);
+    Result fail(const char* message);
+    Result complete();
+
+    std::vector<char> buf_;
+    size_t head_len_;           // Retained head bytes at the front of buf_
+    size_t pos_;                // Next unparsed byte
+    size_t end_;                // End of received bytes
+    size_t scan_pos_;           // Where the search for the end of the head resumes
+    size_t line_start_;
+
+    State state_;
+    Result result_;
+    const char* error_;
+    bool head_request_;
+
+    int status_code_;
+    int version_minor_;
+    std::string_view reason_;
+    std::vector<Header> headers_;
+
+    bool chunked_;
+    bool close_delimited_;
+    int64_t content_length_;
+    uint64_t remaining_;        // Of the Content-Length body or current chunk
+    uint64_t body_bytes_;
+    unsigned chunk_digits_;
+
+    BodySink sink_;
+    std::string body_;
+};
+
+} // namespace http
+} // namespace client
+
+#endif // LIBCLIENT_HTTP_PARSER_H
@@ -0,0 +1,226 @@
+#ifndef LIBCLIENT_JSON_H
+#define LIBCLIENT_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace client {
+namespace json {
+
+enum class Type : uint8_t {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+// Bump allocator for DOM nodes and unescaped strings. Everything is freed
+// at once by reset(), which keeps the memory for the next parse.
+class Arena {
+public:
+    explicit Arena(size_t block_size = 4096);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // Make sure the next size bytes come from a single block
+    void reserve(size_t size);
+
+    // Drop all allocations. Several blocks are merged into one so the
+    // next document of the same size needs no further allocation.
+    void reset();
+
+    size_t capacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void addBlock(size_t size);
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    char* cur_;
+    size_t left_;
+};
+
+class Value;
+struct Member;
+
+// Immutable DOM node, 16 bytes. Strings point into the parsed text when
+// they contain no escapes, otherwise into the document's arena; numbers
+// keep their literal text and convert on access. Lookups on a value of
+// the wrong type, a missing key or an index out of range give the shared
+// null value, so chains like doc.root()["a"]["b"][0].asInt64() are safe.
+class Value {
+public:
+    Value() : ptr_(nullptr), size_(0), type_(Type::Null), bool_(false) {}
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isBool() const { return type_ == Type::Bool; }
+    bool isNumber() const { return type_ == Type::Number; }
+    bool isString() const { return type_ == Type::String; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isObject() const { return type_ == Type::Object; }
+
+    bool asBool(bool default_value = false) const {
+        return type_ == Type::Bool ? bool_ : default_value;
+    }
+    int64_t asInt64(int64_t default_value = 0) const;
+    double asDouble(double default_value = 0.0) const;
+
+    // Decoded string, or the literal text of a number
+    std::string_view asString(std::string_view default_value = std::string_view()) const;
+
+    // Elements of an array or members of an object; 0 otherwise
+    size_t size() const { return (type_ == Type::Array || type_ == Type::Object) ? size_ : 0; }
+    bool empty() const { return size() == 0; }
+
+    const Value& operator[](size_t index) const;
+    const Value& operator[](int index) const {      // Keeps v[0] from meaning a null key
+        return index < 0 ? null() : (*this)[static_cast<size_t>(index)];
+    }
+    const Value& operator[](std::string_view key) const;
+    const Value& operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+    // First member with this key, or nullptr
+    const Value* find(std::string_view key) const;
+
+    // Array elements
+    const Value* begin() const { return type_ == Type::Array ? items() : nullptr; }
+    const Value* end() const { return type_ == Type::Array ? items() + size_ : nullptr; }
+
+    // Object members
+    const Member* memberBegin() const;
+    const Member* memberEnd() const;
+
+    static const Value& null();
+
+private:
+    friend class Document;
+
+    static Value makeString(const char* data, size_t size);
+    static Value makeNumber(const char* data, size_t size);
+    static Value makeBool(bool value);
+    static Value makeContainer(Type type, const void* items, size_t size);
+
+    const Value* items() const { return static_cast<const Value*>(ptr_); }
+
+    const void* ptr_;       // Text, elements, or key/value pairs
+    uint32_t size_;         // Bytes, elements or members
+    Type type_;
+    bool bool_;
+};
+
+static_assert(sizeof(void*) != 8 || sizeof(Value) == 16, "json::Value should stay 16 bytes");
+
+struct Member {
+    Value key;          // Always a string
+    Value value;
+};
+
+// Single-pass parser (RFC 8259) building a DOM in an arena.
+//
+// Memory:
+// - parse() references the text instead of copying it, so the text must
+//   outlive every use of the document.
+// - Containers are gathered on a scratch stack and copied into the arena
+//   in one piece when they close. Elements are contiguous and indexable.
+// - The arena is sized from the input. A Document reused for payloads of
+//   similar size does not allocate.
+//
+// String runs are scanned 16 bytes at a time for quotes, backslashes and
+// control characters (simd::findJsonSpecial). UTF-8 is passed through
+// unchecked.
+class Document {
+public:
+    static constexpr size_t kMaxDepth = 512;
+
+    Document();
+
+    // Replaces the previous contents. On failure root() is null and
+    // error()/errorOffset() describe the problem.
+    bool parse(std::string_view text);
+
+    const Value& root() const { return root_; }
+    const char* error() const { return error_; }
+    size_t errorOffset() const { return error_offset_; }
+
+    void clear();
+
+private:
+    struct Frame {
+        size_t base;        // Stack index of the first child
+        bool object;
+    };
+
+    bool parseString(const char*& p, const char* end, Value& out);
+    bool parseNumber(const char*& p, const char* end, Value& out);
+    bool closeContainer(bool object);
+    bool fail(const char* message, const char* at);
+
+    Arena arena_;
+    std::vector<Value> stack_;
+    std::vector<Frame> frames_;
+    Value root_;
+    const char* text_;
+    const char* error_;
+    size_t error_offset_;
+};
+
+// Streaming serializer appending straight to a caller-owned buffer, which
+// can be cleared and reused between messages. Commas and colons are
+// inserted automatically; the caller is responsible for balancing
+// begin/end calls and putting a key() before every value in an object.
+class Writer {
+public:
+    explicit Writer(std::string& out) : out_(out), need_comma_(false) {}
+
+    Writer& beginObject();
+    Writer& endObject();
+    Writer& beginArray();
+    Writer& endArray();
+
+    Writer& key(std::string_view name);
+
+    Writer& value(std::string_view str);
+    Writer& value(const char* str) { return value(std::string_view(str)); }
+    Writer& value(const std::string& str) { return value(std::string_view(str)); }
+    Writer& value(bool b);
+    Writer& value(int v) { return value(static_cast<long long>(v)); }
+    Writer& value(long v) { return value(static_cast<long long>(v)); }
+    Writer& value(long long v);
+    Writer& value(unsigned v) { return value(static_cast<unsigned long long>(v)); }
+    Writer& value(unsigned long v) { return value(static_cast<unsigned long long>(v)); }
+    Writer& value(unsigned long long v);
+    Writer& value(double v);        // Non-finite values are written as null
+    Writer& null();
+
+    // Serialize a parsed value (compact)
+    Writer& value(const Value& v);
+
+    // Escaped string body, without the quotes
+    static void appendEscaped(std::string& out, std::string_view str);
+
+private:
+    void separator();
+
+    std::string& out_;
+    bool need_comma_;
+};
+
+} // namespace json
+} // namespace client
+
+#endif // LIBCLIENT_JSON_H
@@ -2,13 +2,86 @@
 #define LIBCLIENT_PLATFORM_SPECIFIC_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
+#include <functional>
 #include <sys/types.h>
 
+#include "common/mapped_file.h"
+
 namespace client {
 namespace platform {
 
+// How writeFile replaces the destination
+enum class WriteMode {
+    InPlace,        // Truncate and write the existing file
+    Atomic,         // Write a temp file in the same directory, then rename
+    Durable         // Atomic, plus fdatasync before and a directory fsync after the rename
+};
+
+// One directory entry as reported by DirectoryScanner
+struct DirectoryEntry {
+    enum Type : uint8_t {
+        Unknown,        // Filesystem didn't say and kStatType wasn't requested
+        File,
+        Directory,
+        Symlink,
+        Other           // Devices, FIFOs, sockets
+    };
+
+    std::string_view name;      // Points into the scanner's arena; valid during the callback only
+    Type type;
+    uint64_t inode;
+    uint64_t size;              // Only filled with kStatSize
+    uint64_t mtime;             // Seconds since the epoch; only filled with kStatMtime
+};
+
+// Directory iteration on raw getdents64. Entries are read in large batches
+// into an arena that is reused across calls, so listing a directory costs
+// a few syscalls and no per-entry allocation. Types come from d_type;
+// stat data is fetched only for the fields asked for, with one statx per
+// entry that needs it.
+//
+// A scanner is not thread-safe; use one per thread.
+class DirectoryScanner {
+public:
+    // Per-entry fields to fetch with statx (fstatat on pre-4.11 kernels)
+    static constexpr uint32_t kStatNone  = 0;
+    static constexpr uint32_t kStatType  = 1u << 0;    // Resolve entries reported as Unknown
+    static constexpr uint32_t kStatSize  = 1u << 1;
+    static constexpr uint32_t kStatMtime = 1u << 2;
+
+    // Return false to stop the scan
+    using Visitor = std::function<bool(const DirectoryEntry& entry)>;
+    // Called with the directory path (relative to the root's parent, i.e.
+    // starting with root) and the entry; must be thread-safe when
+    // max_threads > 1
+    using RecursiveVisitor = std::function<void(const std::string& directory, const DirectoryEntry& entry)>;
+
+    explicit DirectoryScanner(size_t buffer_size = 32 * 1024);
+
+    /**
+     * Visit every entry of directory except "." and "..".
+     * Returns false if the directory could not be opened or read.
+     */
+    bool scan(const std::string& directory, const Visitor& visitor, uint32_t stat_fields = kStatNone);
+
+    /**
+     * Walk root and all subdirectories (symlinks are not followed) using
+     * up to max_threads workers (the caller plus shared pool threads).
+     * Directory order is unspecified.
+     */
+    static bool scanRecursive(const std::string& root, const RecursiveVisitor& visitor,
+                              uint32_t stat_fields = kStatNone, unsigned max_threads = 4);
+
+private:
+    bool scanFd(int dir_fd, const Visitor& visitor, uint32_t stat_fields);
+
+    std::vector<char> arena_;
+    std::vector<DirectoryEntry> batch_;
+};
+
 class FileSystem {
 public:
     static bool exists(const std::string& path);
@@ -21,7 +94,9 @@ public:
     static bool removeDirectory(const std::string& path, bool recursive = false);
     static bool remove(const std::string& path);
     
+    // Copies in the kernel (copy_file_range, then sendfile) where possible
     static bool copy(const std::string& source, const std::string& destination);
+    // rename(), falling back to copy + remove across filesystems
     static bool move(const std::string& source, const std::string& destination);
     
     static uint64_t getFileSize(const std::string& path);
@@ -30,10 +105,22 @@ public:
     static std::vector<std::string> listFiles(const std::string& directory);
     static std::vector<std::string> listDirectories(const std::string& directory);
     
+    // Zero-copy read: large files are mapped, small ones read with one
+    // pread. Prefer this over readFile when the bytes don't need to outlive
+    // the MappedFile.
+    static bool mapFile(const std::string& path, common::MappedFile& file,
+                        common::MappedFile::Access access = common::MappedFile::Access::Sequential);
+
+    // Read into data with pread, never mapped, so a file truncated while
+    // it is read comes back short instead of faulting
     static bool readFile(const std::string& path, std::vector<uint8_t>& data);
     static bool readFile(const std::string& path, std::string& data);
-    static bool writeFile(const std::string& path, const std::vector<uint8_t>& data);
-    static bool writeFile(const std::string& path, const std::string& data);
+    static bool writeFile(const std::string& path, const std::vector<uint8_t>& data,
+                          WriteMode mode = WriteMode::InPlace);
+    static bool writeFile(const std::string& path, const std::string& data,
+                          WriteMode mode = WriteMode::InPlace);
+    static bool writeFile(const std::string& path, const void* data, size_t size,
+                          WriteMode mode = WriteMode::InPlace);
     
     static std::string getFileName(const std::string& path);
     static std::string getFileExtension(const std::string& path);
@@ -48,6 +135,43 @@ public:
     static std::string getCurrentDirectory();
 };
 
+// Atomically replaces several files while paying for one sync per
+// filesystem instead of one fsync per file. Every file is written to a
+// temp sibling, the filesystems are synced once with syncfs(), and only
+// then are the temps renamed over their targets. commit() is all-or-
+// nothing up to the renames; a rename failure leaves earlier files
+// replaced.
+class FileWriteBatch {
+public:
+    FileWriteBatch() = default;
+    ~FileWriteBatch();
+
+    FileWriteBatch(const FileWriteBatch&) = delete;
+    FileWriteBatch& operator=(const FileWriteBatch&) = delete;
+
+    // Write the temp file now; false if it could not be created
+    bool add(const std::string& path, const void* data, size_t size);
+    bool add(const std::string& path, const std::string& data) {
+        return add(path, data.data(), data.size());
+    }
+
+    // Sync and rename everything added so far. With durable set the
+    // renames themselves are synced too.
+    bool commit(bool durable = true);
+
+    // Drop any temp files not yet committed
+    void abort();
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::string path;
+        std::string temp_path;
+    };
+    std::vector<Entry> entries_;
+};
+
 class Process {
 public:
     static pid_t getCurrentPid();
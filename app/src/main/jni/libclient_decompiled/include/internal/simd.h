@@ -0,0 +1,447 @@
+#ifndef LIBCLIENT_SIMD_H
+#define LIBCLIENT_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LIBCLIENT_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LIBCLIENT_SIMD_NEON 1
+#endif
+
+namespace client {
+namespace simd {
+
+// 16-byte block primitives shared by the string kernels. Both Android
+// 64-bit ABIs guarantee the baseline (SSE2 on x86_64, NEON on arm64), so
+// these are selected at compile time; the scalar build keeps armv7 and
+// host tools working.
+//
+// Match masks carry kMaskBitsPerByte bits per input byte: SSE2 movemask
+// produces one bit per byte, NEON has no movemask so a narrowing shift
+// produces a 4-bit nibble per byte instead.
+
+constexpr size_t kBlockSize = 16;
+
+#if defined(LIBCLIENT_SIMD_SSE2)
+
+constexpr unsigned kMaskBitsPerByte = 1;
+
+inline uint64_t eqMask(const char* p, char c) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+}
+
+inline uint64_t eqMask2(const char* p, char a, char b) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(a)),
+                               _mm_cmpeq_epi8(block, _mm_set1_epi8(b)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(hit));
+}
+
+// Bytes outside RFC 3986 unreserved (ALPHA / DIGIT / "-" / "." / "_" / "~")
+inline uint64_t urlReservedMask(const char* p) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // Unsigned range test: x in [lo, hi] iff clamping leaves it unchanged
+    auto in_range = [](__m128i x, char lo, char hi) {
+        __m128i clamped = _mm_min_epu8(_mm_max_epu8(x, _mm_set1_epi8(lo)), _mm_set1_epi8(hi));
+        return _mm_cmpeq_epi8(clamped, x);
+    };
+    __m128i ok = _mm_or_si128(in_range(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 'z'),
+                              in_range(block, '0', '9'));
+    ok = _mm_or_si128(ok, in_range(block, '-', '.'));
+    ok = _mm_or_si128(ok, _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+    ok = _mm_or_si128(ok, _mm_cmpeq_epi8(block, _mm_set1_epi8('~')));
+    return static_cast<uint32_t>(~_mm_movemask_epi8(ok)) & 0xFFFFu;
+}
+
+// Bytes that interrupt plain JSON string content: '"', '\\' and controls
+inline uint64_t jsonSpecialMask(const char* p) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')),
+                               _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+    // Unsigned x < 0x20 iff min(x, 0x1F) == x
+    hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(block, _mm_set1_epi8(0x1F)), block));
+    return static_cast<uint32_t>(_mm_movemask_epi8(hit));
+}
+
+// 0x20 in every byte that is ASCII 'A'..'Z' ('a'..'z' when upper is false).
+// Signed compares leave bytes >= 0x80 untouched.
+inline __m128i caseBit(__m128i block, char first) {
+    __m128i ge = _mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(first - 1)));
+    __m128i le = _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(first + 26)));
+    return _mm_and_si128(_mm_and_si128(ge, le), _mm_set1_epi8(0x20));
+}
+
+inline void lowerBlock(const char* src, char* dst) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(block, caseBit(block, 'A')));
+}
+
+inline void upperBlock(const char* src, char* dst) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_xor_si128(block, caseBit(block, 'a')));
+}
+
+// Bytes that differ after ASCII lower-casing both blocks
+inline uint64_t neIgnoreCaseMask(const char* a, const char* b) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    x = _mm_or_si128(x, caseBit(x, 'A'));
+    y = _mm_or_si128(y, caseBit(y, 'A'));
+    return static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFFu;
+}
+
+#elif defined(LIBCLIENT_SIMD_NEON)
+
+constexpr unsigned kMaskBitsPerByte = 4;
+
+inline uint64_t neonMask(uint8x16_t cmp) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+inline uint64_t eqMask(const char* p, char c) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    return neonMask(vceqq_u8(block, vdupq_n_u8(static_cast<uint8_t>(c))));
+}
+
+inline uint64_t eqMask2(const char* p, char a, char b) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    return neonMask(vorrq_u8(vceqq_u8(block, vdupq_n_u8(static_cast<uint8_t>(a))),
+                             vceqq_u8(block, vdupq_n_u8(static_cast<uint8_t>(b)))));
+}
+
+// Bytes outside RFC 3986 unreserved (ALPHA / DIGIT / "-" / "." / "_" / "~")
+inline uint64_t urlReservedMask(const char* p) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    auto in_range = [](uint8x16_t x, uint8_t lo, uint8_t hi) {
+        return vandq_u8(vcgeq_u8(x, vdupq_n_u8(lo)), vcleq_u8(x, vdupq_n_u8(hi)));
+    };
+    uint8x16_t ok = vorrq_u8(in_range(vorrq_u8(block, vdupq_n_u8(0x20)), 'a', 'z'),
+                             in_range(block, '0', '9'));
+    ok = vorrq_u8(ok, in_range(block, '-', '.'));
+    ok = vorrq_u8(ok, vceqq_u8(block, vdupq_n_u8('_')));
+    ok = vorrq_u8(ok, vceqq_u8(block, vdupq_n_u8('~')));
+    return neonMask(vmvnq_u8(ok));
+}
+
+// Bytes that interrupt plain JSON string content: '"', '\\' and controls
+inline uint64_t jsonSpecialMask(const char* p) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    uint8x16_t hit = vorrq_u8(vceqq_u8(block, vdupq_n_u8('"')), vceqq_u8(block, vdupq_n_u8('\\')));
+    return neonMask(vorrq_u8(hit, vcltq_u8(block, vdupq_n_u8(0x20))));
+}
+
+// 0x20 in every byte that is ASCII 'A'..'Z' ('a'..'z' when first is 'a')
+inline uint8x16_t caseBit(uint8x16_t block, char first) {
+    uint8x16_t offset = vsubq_u8(block, vdupq_n_u8(static_cast<uint8_t>(first)));
+    return vandq_u8(vcltq_u8(offset, vdupq_n_u8(26)), vdupq_n_u8(0x20));
+}
+
+inline void lowerBlock(const char* src, char* dst) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(src));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst), vorrq_u8(block, caseBit(block, 'A')));
+}
+
+inline void upperBlock(const char* src, char* dst) {
+    uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(src));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst), veorq_u8(block, caseBit(block, 'a')));
+}
+
+// Bytes that differ after ASCII lower-casing both blocks
+inline uint64_t neIgnoreCaseMask(const char* a, const char* b) {
+    uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(a));
+    uint8x16_t y = vld1q_u8(reinterpret_cast<const uint8_t*>(b));
+    x = vorrq_u8(x, caseBit(x, 'A'));
+    y = vorrq_u8(y, caseBit(y, 'A'));
+    return neonMask(vmvnq_u8(vceqq_u8(x, y)));
+}
+
+#else
+
+constexpr unsigned kMaskBitsPerByte = 1;
+
+inline uint64_t eqMask(const char* p, char c) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i++) {
+        mask |= static_cast<uint64_t>(p[i] == c) << i;
+    }
+    return mask;
+}
+
+inline uint64_t eqMask2(const char* p, char a, char b) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i++) {
+        mask |= static_cast<uint64_t>(p[i] == a || p[i] == b) << i;
+    }
+    return mask;
+}
+
+inline uint64_t urlReservedMask(const char* p) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i++) {
+        unsigned char c = static_cast<unsigned char>(p[i]);
+        unsigned char lower = c | 0x20;
+        bool ok = (lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') ||
+                  c == '-' || c == '.' || c == '_' || c == '~';
+        mask |= static_cast<uint64_t>(!ok) << i;
+    }
+    return mask;
+}
+
+inline uint64_t jsonSpecialMask(const char* p) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i++) {
+        unsigned char c = static_cast<unsigned char>(p[i]);
+        mask |= static_cast<uint64_t>(c == '"' || c == '\\' || c < 0x20) << i;
+    }
+    return mask;
+}
+
+inline char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+inline void lowerBlock(const char* src, char* dst) {
+    for (size_t i = 0; i < kBlockSize; i++) {
+        dst[i] = lowerAscii(src[i]);
+    }
+}
+
+inline void upperBlock(const char* src, char* dst) {
+    for (size_t i = 0; i < kBlockSize; i++) {
+        dst[i] = (src[i] >= 'a' && src[i] <= 'z') ? static_cast<char>(src[i] ^ 0x20) : src[i];
+    }
+}
+
+inline uint64_t neIgnoreCaseMask(const char* a, const char* b) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < kBlockSize; i++) {
+        mask |= static_cast<uint64_t>(lowerAscii(a[i]) != lowerAscii(b[i])) << i;
+    }
+    return mask;
+}
+
+#endif
+
+#if defined(LIBCLIENT_SIMD_SSE2) || defined(LIBCLIENT_SIMD_NEON)
+inline char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+#endif
+
+inline char upperAscii(char c) {
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c & ~0x20) : c;
+}
+
+// Byte offset of the lowest set match in a non-zero mask
+inline size_t maskFirst(uint64_t mask) {
+    return static_cast<size_t>(__builtin_ctzll(mask)) / kMaskBitsPerByte;
+}
+
+// Clear the lowest match from a mask
+inline uint64_t maskClearFirst(uint64_t mask) {
+    constexpr uint64_t kLane = (kMaskBitsPerByte == 1) ? 0x1ULL : 0xFULL;
+    return mask & ~(kLane << (__builtin_ctzll(mask) & ~(kMaskBitsPerByte - 1)));
+}
+
+/**
+ * Call fn(offset) for every occurrence of c in [data, data + len), in order.
+ * Two blocks are tested per iteration so sparse inputs run at load speed.
+ */
+template <typename Fn>
+inline void forEachByte(const char* data, size_t len, char c, Fn&& fn) {
+    size_t i = 0;
+    for (; i + 2 * kBlockSize <= len; i += 2 * kBlockSize) {
+        uint64_t lo = eqMask(data + i, c);
+        uint64_t hi = eqMask(data + i + kBlockSize, c);
+        if ((lo | hi) == 0) {
+            continue;
+        }
+        for (; lo != 0; lo = maskClearFirst(lo)) {
+            fn(i + maskFirst(lo));
+        }
+        for (; hi != 0; hi = maskClearFirst(hi)) {
+            fn(i + kBlockSize + maskFirst(hi));
+        }
+    }
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        for (uint64_t m = eqMask(data + i, c); m != 0; m = maskClearFirst(m)) {
+            fn(i + maskFirst(m));
+        }
+    }
+    for (; i < len; i++) {
+        if (data[i] == c) {
+            fn(i);
+        }
+    }
+}
+
+/**
+ * Offset of the first c at or after start, or len if there is none
+ */
+inline size_t findByte(const char* data, size_t len, char c, size_t start = 0) {
+    if (start >= len) {
+        return len;
+    }
+    const void* hit = std::memchr(data + start, static_cast<unsigned char>(c), len - start);
+    return hit ? static_cast<size_t>(static_cast<const char*>(hit) - data) : len;
+}
+
+/**
+ * Offset of the first a or b at or after start, or len if there is none
+ */
+inline size_t findEither(const char* data, size_t len, char a, char b, size_t start = 0) {
+    size_t i = start;
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        uint64_t m = eqMask2(data + i, a, b);
+        if (m != 0) {
+            return i + maskFirst(m);
+        }
+    }
+    for (; i < len; i++) {
+        if (data[i] == a || data[i] == b) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * Skip whole blocks of URL-unreserved bytes from start. Returns the first
+ * reserved byte, or the start of the final partial block; callers finish
+ * the tail with their own table lookups.
+ */
+inline size_t skipUrlUnreserved(const char* data, size_t len, size_t start = 0) {
+    size_t i = start;
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        uint64_t m = urlReservedMask(data + i);
+        if (m != 0) {
+            return i + maskFirst(m);
+        }
+    }
+    return i;
+}
+
+/**
+ * Offset of the first '"', '\\' or control character (< 0x20) at or after
+ * start, or len. Everything before it can be copied as-is in a JSON string.
+ */
+inline size_t findJsonSpecial(const char* data, size_t len, size_t start = 0) {
+    size_t i = start;
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        uint64_t m = jsonSpecialMask(data + i);
+        if (m != 0) {
+            return i + maskFirst(m);
+        }
+    }
+    for (; i < len; i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * ASCII case folding of len bytes from src to dst (which may be src).
+ * Bytes outside 'A'..'Z' / 'a'..'z', including UTF-8 sequences, are copied
+ * unchanged, matching tolower/toupper in the "C" locale.
+ */
+inline void toLowerAscii(const char* src, char* dst, size_t len) {
+    size_t i = 0;
+    for (; i + 2 * kBlockSize <= len; i += 2 * kBlockSize) {
+        lowerBlock(src + i, dst + i);
+        lowerBlock(src + i + kBlockSize, dst + i + kBlockSize);
+    }
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        lowerBlock(src + i, dst + i);
+    }
+    for (; i < len; i++) {
+        dst[i] = lowerAscii(src[i]);
+    }
+}
+
+inline void toUpperAscii(const char* src, char* dst, size_t len) {
+    size_t i = 0;
+    for (; i + 2 * kBlockSize <= len; i += 2 * kBlockSize) {
+        upperBlock(src + i, dst + i);
+        upperBlock(src + i + kBlockSize, dst + i + kBlockSize);
+    }
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        upperBlock(src + i, dst + i);
+    }
+    for (; i < len; i++) {
+        dst[i] = upperAscii(src[i]);
+    }
+}
+
+/**
+ * Offset of the first byte where a and b differ ignoring ASCII case, or len
+ */
+inline size_t mismatchIgnoreCase(const char* a, const char* b, size_t len) {
+    size_t i = 0;
+    for (; i + kBlockSize <= len; i += kBlockSize) {
+        uint64_t m = neIgnoreCaseMask(a + i, b + i);
+        if (m != 0) {
+            return i + maskFirst(m);
+        }
+    }
+    for (; i < len; i++) {
+        if (lowerAscii(a[i]) != lowerAscii(b[i])) {
+            return i;
+        }
+    }
+    return len;
+}
+
+/**
+ * Offset of the first occurrence of needle at or after start, or len.
+ * Candidates come from a vector scan for the first and last needle bytes;
+ * only positions where both match are verified with memcmp.
+ */
+inline size_t findSubstring(const char* data, size_t len,
+                            const char* needle, size_t needle_len, size_t start = 0) {
+    if (needle_len == 0) {
+        return start <= len ? start : len;
+    }
+    if (needle_len == 1) {
+        return findByte(data, len, needle[0], start);
+    }
+    if (start > len || len - start < needle_len) {
+        return len;
+    }
+
+    const char first = needle[0];
+    const char last = needle[needle_len - 1];
+    const size_t limit = len - needle_len + 1;   // Candidate start positions
+    size_t i = start;
+
+    for (; i + kBlockSize <= limit; i += kBlockSize) {
+        uint64_t m = eqMask(data + i, first) & eqMask(data + i + needle_len - 1, last);
+        for (; m != 0; m = maskClearFirst(m)) {
+            size_t pos = i + maskFirst(m);
+            if (std::memcmp(data + pos + 1, needle + 1, needle_len - 2) == 0) {
+                return pos;
+            }
+        }
+    }
+    for (; i < limit; i++) {
+        if (data[i] == first && data[i + needle_len - 1] == last &&
+            std::memcmp(data + i + 1, needle + 1, needle_len - 2) == 0) {
+            return i;
+        }
+    }
+    return len;
+}
+
+} // namespace simd
+} // namespace client
+
+#endif // LIBCLIENT_SIMD_H
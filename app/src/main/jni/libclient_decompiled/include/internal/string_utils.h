@@ -1,90 +1,269 @@
 #ifndef LIBCLIENT_STRING_UTILS_H
 #define LIBCLIENT_STRING_UTILS_H
 
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <sstream>
 
 namespace client {
 namespace utils {
 
+// Lazy split over a string_view; yields views into the source without
+// allocating. "a,,b" yields "a", "", "b"; an empty source yields one empty
+// field.
+class SplitRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() : range_(nullptr), pos_(0), done_(true) {}
+        iterator(const SplitRange* range, size_t pos);
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+        iterator& operator++();
+        iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+
+        bool operator==(const iterator& other) const {
+            return done_ == other.done_ && (done_ || pos_ == other.pos_);
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        void advance();
+
+        const SplitRange* range_;
+        size_t pos_;
+        std::string_view current_;
+        bool done_;
+    };
+
+    SplitRange(std::string_view str, std::string_view delimiter)
+        : str_(str), delimiter_(delimiter) {}
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view str_;
+    std::string_view delimiter_;
+};
+
+namespace detail {
+class FormatArg;
+}
+
 class StringUtils {
 public:
+    // Non-allocating views. Results point into the argument and are only
+    // valid while it is.
+    static std::string_view trimView(std::string_view str);
+    static std::string_view trimLeftView(std::string_view str);
+    static std::string_view trimRightView(std::string_view str);
+    static std::string_view substringView(std::string_view str, size_t start,
+                                          size_t length = std::string_view::npos);
+
+    // Split into views, reusing out's capacity; returns the field count.
+    // n delimiters always give n + 1 fields.
+    static size_t split(std::string_view str, char delimiter, std::vector<std::string_view>& out);
+    static size_t split(std::string_view str, std::string_view delimiter,
+                        std::vector<std::string_view>& out);
+
+    // Lazy split for single-pass parsing
+    static SplitRange splitRange(std::string_view str, std::string_view delimiter) {
+        return SplitRange(str, delimiter);
+    }
+
     // String manipulation
     static std::string trim(const std::string& str);
     static std::string trimLeft(const std::string& str);
     static std::string trimRight(const std::string& str);
     
-    static std::string toLower(const std::string& str);
-    static std::string toUpper(const std::string& str);
+    // Case conversion is ASCII-only, as in the "C" locale; other bytes are
+    // left unchanged.
+    static std::string toLower(std::string_view str);
+    static std::string toUpper(std::string_view str);
+    static void toLowerInPlace(std::string& str);
+    static void toUpperInPlace(std::string& str);
     
     static std::vector<std::string> split(const std::string& str, char delimiter);
     static std::vector<std::string> split(const std::string& str, const std::string& delimiter);
     
-    static std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
+    static std::string join(const std::vector<std::string>& strings, std::string_view delimiter);
     
-    static std::string replace(const std::string& str, const std::string& from, const std::string& to);
-    static std::string replaceAll(const std::string& str, const std::string& from, const std::string& to);
+    static std::string replace(std::string_view str, std::string_view from, std::string_view to);
+    static std::string replaceAll(std::string_view str, std::string_view from, std::string_view to);
     
-    static bool startsWith(const std::string& str, const std::string& prefix);
-    static bool endsWith(const std::string& str, const std::string& suffix);
-    static bool contains(const std::string& str, const std::string& substring);
+    static bool startsWith(std::string_view str, std::string_view prefix);
+    static bool endsWith(std::string_view str, std::string_view suffix);
+    static bool contains(std::string_view str, std::string_view substring);
     
-    static size_t count(const std::string& str, const std::string& substring);
+    static size_t count(std::string_view str, std::string_view substring);
     
     // String validation
-    static bool isNumeric(const std::string& str);
-    static bool isAlpha(const std::string& str);
-    static bool isAlphaNumeric(const std::string& str);
-    static bool isHex(const std::string& str);
-    
-    // String conversion
-    static int toInt(const std::string& str, int default_value = 0);
-    static long toLong(const std::string& str, long default_value = 0);
-    static float toFloat(const std::string& str, float default_value = 0.0f);
-    static double toDouble(const std::string& str, double default_value = 0.0);
-    static bool toBool(const std::string& str, bool default_value = false);
+    static bool isNumeric(std::string_view str);
+    static bool isAlpha(std::string_view str);
+    static bool isAlphaNumeric(std::string_view str);
+    static bool isHex(std::string_view str);
+    
+    // String conversion. Parsing skips leading whitespace and accepts a '+'
+    // sign; trailing characters are ignored. Floats format as the shortest
+    // string that round-trips unless a precision is given.
+    static int toInt(std::string_view str, int default_value = 0);
+    static long toLong(std::string_view str, long default_value = 0);
+    static float toFloat(std::string_view str, float default_value = 0.0f);
+    static double toDouble(std::string_view str, double default_value = 0.0);
+    static bool toBool(std::string_view str, bool default_value = false);
     
     static std::string fromInt(int value);
     static std::string fromLong(long value);
     static std::string fromFloat(float value, int precision = -1);
     static std::string fromDouble(double value, int precision = -1);
     static std::string fromBool(bool value);
+
+    // Append-to-buffer conversions
+    static void appendInt(std::string& out, long long value);
+    static void appendUnsigned(std::string& out, unsigned long long value);
+    static void appendFloat(std::string& out, float value, int precision = -1);
+    static void appendDouble(std::string& out, double value, int precision = -1);
+
+    // Raw buffer conversions; return characters written, 0 if it doesn't fit
+    static size_t writeInt(char* buf, size_t capacity, long long value);
+    static size_t writeUnsigned(char* buf, size_t capacity, unsigned long long value);
+    static size_t writeFloat(char* buf, size_t capacity, float value, int precision = -1);
+    static size_t writeDouble(char* buf, size_t capacity, double value, int precision = -1);
     
-    // String formatting
+    // printf-style formatting
     static std::string format(const char* fmt, ...);
     
     template<typename... Args>
     static std::string format(const std::string& fmt, Args... args) {
         return format(fmt.c_str(), args...);
     }
+
+    // Type-safe formatting: each "{}" takes the next argument, "{{" and "}}"
+    // are literal braces. The output is sized once and written in place.
+    template<typename... Args>
+    static void formatTo(std::string& out, std::string_view fmt, const Args&... args);
+
+    template<typename... Args>
+    static std::string formatArgs(std::string_view fmt, const Args&... args);
     
     // String obfuscation/deobfuscation
     static std::string obfuscate(const std::string& str, uint8_t key = 0x42);
     static std::string deobfuscate(const std::string& str, uint8_t key = 0x42);
     
-    // URL encoding/decoding
-    static std::string urlEncode(const std::string& str);
-    static std::string urlDecode(const std::string& str);
+    // URL encoding/decoding. Everything except RFC 3986 unreserved bytes
+    // is percent-encoded; decoding also maps '+' to a space and keeps
+    // malformed escapes as-is.
+    static std::string urlEncode(std::string_view str);
+    static std::string urlDecode(std::string_view str);
     
     // String padding
     static std::string padLeft(const std::string& str, size_t width, char pad = ' ');
     static std::string padRight(const std::string& str, size_t width, char pad = ' ');
     
     // String comparison
-    static bool equalsIgnoreCase(const std::string& str1, const std::string& str2);
-    static int compareIgnoreCase(const std::string& str1, const std::string& str2);
+    static bool equalsIgnoreCase(std::string_view str1, std::string_view str2);
+    static int compareIgnoreCase(std::string_view str1, std::string_view str2);
+
+    // Hash of the ASCII-lowercased bytes, without building the copy
+    static size_t hashIgnoreCase(std::string_view str);
     
     // Utility functions
-    static std::string repeat(const std::string& str, size_t count);
-    static std::string reverse(const std::string& str);
+    static std::string repeat(std::string_view str, size_t count);
+    static std::string reverse(std::string_view str);
     
     static std::string substring(const std::string& str, size_t start, size_t length = std::string::npos);
     
-    static size_t indexOf(const std::string& str, const std::string& substring, size_t start = 0);
-    static size_t lastIndexOf(const std::string& str, const std::string& substring);
+    static size_t indexOf(std::string_view str, std::string_view substring, size_t start = 0);
+    static size_t lastIndexOf(std::string_view str, std::string_view substring);
+};
+
+// Function objects for case-insensitive containers, e.g. HTTP header maps.
+// The less-than comparator is transparent, so std::map lookups can take a
+// string_view without allocating.
+struct CaseInsensitiveHash {
+    size_t operator()(std::string_view str) const { return StringUtils::hashIgnoreCase(str); }
+};
+
+struct CaseInsensitiveEqual {
+    bool operator()(std::string_view a, std::string_view b) const {
+        return StringUtils::equalsIgnoreCase(a, b);
+    }
 };
 
+struct CaseInsensitiveLess {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const {
+        return StringUtils::compareIgnoreCase(a, b) < 0;
+    }
+};
+
+namespace detail {
+
+// One formatted argument: numbers are rendered into the inline buffer,
+// strings are referenced in place.
+class FormatArg {
+public:
+    FormatArg(std::string_view value) : data_(value.data()), size_(value.size()) {}
+    FormatArg(const std::string& value) : data_(value.data()), size_(value.size()) {}
+    FormatArg(const char* value) : FormatArg(std::string_view(value ? value : "(null)")) {}
+    FormatArg(char value) : data_(buf_), size_(1) { buf_[0] = value; }
+    FormatArg(bool value) : FormatArg(std::string_view(value ? "true" : "false")) {}
+    FormatArg(float value) : data_(buf_), size_(StringUtils::writeFloat(buf_, sizeof(buf_), value)) {}
+    FormatArg(double value) : data_(buf_), size_(StringUtils::writeDouble(buf_, sizeof(buf_), value)) {}
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                                 !std::is_same<T, char>::value, int>::type = 0>
+    FormatArg(T value) : data_(buf_), size_(StringUtils::writeInt(buf_, sizeof(buf_), value)) {}
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                                 !std::is_same<T, bool>::value, int>::type = 0>
+    FormatArg(T value) : data_(buf_), size_(StringUtils::writeUnsigned(buf_, sizeof(buf_), value)) {}
+
+    FormatArg(const FormatArg&) = delete;
+    FormatArg& operator=(const FormatArg&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    char buf_[32];
+};
+
+void formatImpl(std::string& out, std::string_view fmt, const FormatArg* args, size_t count);
+
+} // namespace detail
+
+template<typename... Args>
+inline void StringUtils::formatTo(std::string& out, std::string_view fmt, const Args&... args) {
+    if constexpr (sizeof...(Args) == 0) {
+        detail::formatImpl(out, fmt, nullptr, 0);
+    } else {
+        const detail::FormatArg converted[] = {args...};
+        detail::formatImpl(out, fmt, converted, sizeof...(Args));
+    }
+}
+
+template<typename... Args>
+inline std::string StringUtils::formatArgs(std::string_view fmt, const Args&... args) {
+    std::string out;
+    formatTo(out, fmt, args...);
+    return out;
+}
+
 } // namespace utils
 } // namespace client
 
@@ -4,7 +4,7 @@
 #include <jni.h>
 #include <string>
 #include <vector>
-#include <android/log.h>
+#include "common/log.h"
 
 // JNI Helper macros
 #define JNI_METHOD(return_type, class_name, method_name) \
@@ -13,13 +13,14 @@
 #define JNI_COMPANION_METHOD(return_type, method_name) \
     JNIEXPORT return_type JNICALL Java_com_eternal_xdsdk_SuperJNI_00024Companion_##method_name
 
-// Logging macros
+// Logging macros (queued to the shared logging thread; levels below
+// COMMON_LOG_MIN_LEVEL compile away)
 #define LOG_TAG "libclient"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGV(...) __android_log_print(ANDROID_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) COMMON_LOGD(LOG_TAG, __VA_ARGS__)
+#define LOGI(...) COMMON_LOGI(LOG_TAG, __VA_ARGS__)
+#define LOGW(...) COMMON_LOGW(LOG_TAG, __VA_ARGS__)
+#define LOGE(...) COMMON_LOGE(LOG_TAG, __VA_ARGS__)
+#define LOGV(...) COMMON_LOGV(LOG_TAG, __VA_ARGS__)
 
 // JNI utility functions
 namespace client {
@@ -2,6 +2,9 @@
 #define LIBCLIENT_NETWORK_CLIENT_H
 
 #include "types.h"
+#include "internal/string_utils.h"
+#include "internal/http_engine.h"
+#include "internal/json.h"
 #include <memory>
 #include <string>
 #include <map>
@@ -12,6 +15,9 @@
 
 namespace client {
 
+// HTTP header names compare case-insensitively (RFC 7230 3.2)
+using HeaderMap = std::map<std::string, std::string, utils::CaseInsensitiveLess>;
+
 class NetworkClient {
 public:
     NetworkClient();
@@ -34,6 +40,12 @@ public:
     ServerResponse put(const std::string& endpoint, const std::string& data);
     ServerResponse del(const std::string& endpoint);
     
+    // Asynchronous requests. The callback runs on the HTTP engine thread
+    // and must not block; the blocking calls above wait on these.
+    using ResponseCallback = std::function<void(ServerResponse response)>;
+    void getAsync(const std::string& endpoint, ResponseCallback callback);
+    void postAsync(const std::string& endpoint, std::string data, ResponseCallback callback);
+    
     // Specific API calls
     bool checkLicense(const std::string& license_key);
     bool validateKey(const std::string& key);
@@ -47,6 +59,7 @@ public:
     // File operations
     bool downloadFile(const std::string& url, const std::string& output_path);
     bool downloadPlugin(const PluginMetadata& plugin, const std::string& output_path);
+    ServerResponse uploadFile(const std::string& endpoint, const std::string& file_path);
     
     // Configuration
     void setServerUrl(const std::string& url);
@@ -65,10 +78,21 @@ public:
     int getLastErrorCode() const { return last_error_code_; }
     
 private:
-    // HTTP operations
+    // HTTP operations. Bodies are referenced, not copied: the blocking
+    // call keeps data alive itself, the async one takes ownership.
     ServerResponse sendRequest(const std::string& method, 
                               const std::string& url,
                               const std::string& data = "");
+    void sendRequestAsync(const std::string& method,
+                          const std::string& url,
+                          std::string data,
+                          ResponseCallback callback);
+    bool prepareRequest(const std::string& method,
+                        const std::string& url,
+                        http::Body body,
+                        const char* content_type,
+                        http::Request& request,
+                        ServerResponse& failure);
     
     // SSL/TLS operations
     bool initSSL();
@@ -76,17 +100,18 @@ private:
     bool createSSLConnection(const std::string& host, int port);
     void closeSSLConnection();
     
-    // Request building
-    std::string buildRequest(const std::string& method,
-                            const std::string& path,
-                            const std::string& host,
-                            const std::string& data);
+    // Request building. Renders only the request head; the body goes out
+    // separately from wherever it lives.
+    void buildRequest(const std::string& method,
+                      const std::string& path,
+                      const std::string& host,
+                      const http::Body& body,
+                      const char* content_type,
+                      std::string& head);
+    void invalidateHeaderBlock();
     
-    // Response parsing
-    ServerResponse parseResponse(const std::string& raw_response);
-    int parseStatusCode(const std::string& status_line);
-    std::map<std::string, std::string> parseHeaders(const std::string& headers_text);
-    std::string parseBody(const std::string& response);
+    // Response conversion
+    ServerResponse parseResponse(http::Response&& response);
     
     // URL parsing
     bool parseUrl(const std::string& url, 
@@ -95,24 +120,14 @@ private:
                  int& port,
                  std::string& path);
     
-    // Socket operations
-    int createSocket(const std::string& host, int port);
-    void closeSocket(int socket_fd);
-    bool sendData(int socket_fd, const char* data, size_t length);
-    bool receiveData(int socket_fd, std::vector<char>& buffer);
-    
-    // Connection maintenance
-    void connectionMonitorFunc();
-    bool ping();
-    void attemptReconnect();
-    
     // Device information for requests
     void addDeviceHeaders();
     std::string getDeviceId() const;
     
-    // JSON utilities
+    // JSON utilities. The document references the text, so the response
+    // body must outlive it.
     std::string createJsonRequest(const std::map<std::string, std::string>& data);
-    std::map<std::string, std::string> parseJsonResponse(const std::string& json);
+    bool parseJsonResponse(std::string_view json, json::Document& doc);
     
     // Error handling
     void setError(const std::string& error, int code = 0);
@@ -129,14 +144,20 @@ private:
     
     // Connection state
     ConnectionState conn_state_;
-    int socket_fd_;
     void* ssl_context_;
     void* ssl_connection_;
     
     // Headers
-    std::map<std::string, std::string> custom_headers_;
+    HeaderMap custom_headers_;
     std::mutex headers_mutex_;
     
+    // User-Agent, Authorization and custom headers, rendered once and
+    // copied into each request head (guarded by headers_mutex_, as are
+    // config_.user_agent and config_.auth_token)
+    std::string header_block_;
+    bool header_block_valid_;
+    bool header_block_has_content_type_;
+    
     // Device information
     DeviceInfo device_info_;
     
@@ -144,9 +165,9 @@ private:
     ProgressCallback progress_callback_;
     std::mutex callback_mutex_;
     
-    // Connection monitoring
-    std::unique_ptr<std::thread> monitor_thread_;
-    std::atomic<bool> should_stop_monitor_;
+    // Event loop with the keep-alive connection pools; replaces the
+    // blocking socket and the reconnect monitor
+    std::unique_ptr<http::Engine> engine_;
     
     // Error tracking
     std::string last_error_;
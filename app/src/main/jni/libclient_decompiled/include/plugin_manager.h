@@ -8,7 +8,8 @@
 #include <map>
 #include <functional>
 #include <atomic>
-#include <thread>
+
+#include "common/thread_pool.h"
 
 namespace client {
 
@@ -81,7 +82,6 @@ private:
     bool writeMetadata(const std::string& plugin_path, const PluginMetadata& metadata);
     
     // Update checking
-    void updateCheckThreadFunc();
     void performUpdateCheck();
     std::vector<PluginMetadata> fetchPluginList();
     bool isUpdateAvailable(const std::string& plugin_name, const std::string& current_version);
@@ -115,7 +115,6 @@ private:
     // State
     std::atomic<bool> initialized_;
     std::atomic<bool> auto_update_enabled_;
-    std::atomic<bool> should_stop_;
     
     // Plugin tracking
     struct PluginInfo {
@@ -139,8 +138,8 @@ private:
     bool verify_signatures_;
     bool allow_downgrades_;
     
-    // Update checking thread
-    std::unique_ptr<std::thread> update_thread_;
+    // Update checking (a background task on the shared pool)
+    common::PeriodicTask update_task_;
     std::mutex update_mutex_;
     
     // Callbacks
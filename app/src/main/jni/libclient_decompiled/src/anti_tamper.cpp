@@ -4,7 +4,7 @@
 namespace client {
 
 AntiTamper::AntiTamper() 
-    : initialized_(false), monitoring_(false), should_stop_(false), check_interval_ms_(5000) {
+    : initialized_(false), monitoring_(false), check_interval_ms_(5000) {
 }
 
 AntiTamper::~AntiTamper() {
@@ -144,24 +144,21 @@ bool AntiTamper::checkMemoryTampering() {
 void AntiTamper::startMonitoring() {
     if (monitoring_) return;
     
-    should_stop_ = false;
     monitoring_ = true;
-    monitor_thread_ = std::make_unique<std::thread>(&AntiTamper::monitoringThreadFunc, this);
+    monitor_task_.start(std::chrono::milliseconds(check_interval_ms_),
+                        [this]() { performPeriodicChecks(); });
 }
 
 void AntiTamper::stopMonitoring() {
     if (!monitoring_) return;
     
-    should_stop_ = true;
-    if (monitor_thread_ && monitor_thread_->joinable()) {
-        monitor_thread_->join();
-    }
-    monitor_thread_.reset();
+    monitor_task_.stop();
     monitoring_ = false;
 }
 
 void AntiTamper::setCheckInterval(int interval_ms) {
     check_interval_ms_ = interval_ms;
+    monitor_task_.setInterval(std::chrono::milliseconds(interval_ms));
 }
 
 bool AntiTamper::isSafe() const {
@@ -169,13 +166,6 @@ bool AntiTamper::isSafe() const {
     return last_result_.isSafe();
 }
 
-void AntiTamper::monitoringThreadFunc() {
-    while (!should_stop_) {
-        performPeriodicChecks();
-        std::this_thread::sleep_for(std::chrono::milliseconds(check_interval_ms_));
-    }
-}
-
 void AntiTamper::performPeriodicChecks() {
     SecurityCheckResult result = performAllChecks();
     if (!result.isSafe()) {
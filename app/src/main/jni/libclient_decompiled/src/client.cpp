@@ -1,11 +1,6 @@
 #include "../include/client.h"
 #include "../include/jni_bridge.h"
-#include <android/log.h>
-
-#define LOG_TAG "libclient"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#include "common/trace.h"
 
 namespace client {
 
@@ -23,6 +18,7 @@ Client::~Client() {
 }
 
 bool Client::initialize() {
+    COMMON_TRACE_SCOPE("Client::initialize");
     if (initialized_) {
         return true;
     }
@@ -68,6 +64,7 @@ void Client::shutdown() {
 }
 
 bool Client::initializeComponents() {
+    COMMON_TRACE_SCOPE("Client::initializeComponents");
     // Initialize render engine
     render_engine_ = std::make_unique<RenderEngine>();
     if (!render_engine_->initialize()) {
@@ -135,6 +132,7 @@ void Client::shutdownComponents() {
 }
 
 bool Client::verifyIntegrity() {
+    COMMON_TRACE_SCOPE("Client::verifyIntegrity");
     if (!anti_tamper_) {
         return false;
     }
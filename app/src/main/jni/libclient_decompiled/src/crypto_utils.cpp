@@ -1,5 +1,17 @@
 #include "../include/internal/crypto_utils.h"
+#include "../include/internal/platform_specific.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace client {
 namespace crypto {
@@ -7,14 +19,185 @@ namespace crypto {
 const uint8_t BurriCrypto::kBurriKey[] = "Burri Burri Encryption Key v3.1";
 const uint8_t BurriCrypto::kBurriIV[] = "GameBlasterPro\0\0";
 
-// AES stub implementations
+// AESKey implementation
+AESKey::AESKey() : valid_(false) {
+    common_aes_clear_key(&schedule_);
+}
+
+AESKey::AESKey(common::ByteSpan key) : valid_(false) {
+    setKey(key);
+}
+
+AESKey::~AESKey() {
+    common_aes_clear_key(&schedule_);
+}
+
+bool AESKey::setKey(common::ByteSpan key) {
+    valid_ = common_aes_set_key(&schedule_, key.data(), key.size()) == 0;
+    return valid_;
+}
+
+// Small per-thread cache of expanded schedules so repeated calls with the
+// same raw key skip key expansion and never touch the heap.
+namespace {
+
+struct CachedAESKey {
+    uint8_t raw[32];
+    size_t length = 0;
+    AESKey key;
+
+    ~CachedAESKey() {
+        volatile uint8_t* p = raw;
+        for (size_t i = 0; i < sizeof(raw); i++) {
+            p[i] = 0;
+        }
+    }
+};
+
+constexpr size_t kKeyCacheSize = 4;
+
+} // namespace
+
+const AESKey* AES::cachedKey(common::ByteSpan key) {
+    thread_local CachedAESKey cache[kKeyCacheSize];
+    thread_local size_t next_slot = 0;
+
+    if (key.size() > sizeof(cache[0].raw)) {
+        return nullptr;
+    }
+
+    for (CachedAESKey& entry : cache) {
+        if (entry.length == key.size() && entry.key.valid() &&
+            std::memcmp(entry.raw, key.data(), key.size()) == 0) {
+            return &entry.key;
+        }
+    }
+
+    CachedAESKey& slot = cache[next_slot];
+    next_slot = (next_slot + 1) % kKeyCacheSize;
+    if (!slot.key.setKey(key)) {
+        slot.length = 0;
+        return nullptr;
+    }
+    std::memcpy(slot.raw, key.data(), key.size());
+    slot.length = key.size();
+    return &slot.key;
+}
+
+bool AES::encryptCBC(common::ByteSpan plaintext, const AESKey& key,
+                    common::ByteSpan iv, common::MutableByteSpan ciphertext,
+                    size_t& written) {
+    COMMON_TRACE_SCOPE("AES::encryptCBC");
+    size_t padded = encryptedSize(plaintext.size());
+    if (!key.valid() || iv.size() != kBlockSize || ciphertext.size() < padded) {
+        return false;
+    }
+
+    uint8_t chain[kBlockSize];
+    std::memcpy(chain, iv.data(), kBlockSize);
+
+    // Whole blocks go straight from input to output; only the padded tail
+    // is assembled on the stack.
+    size_t whole = plaintext.size() - plaintext.size() % kBlockSize;
+    common_aes_cbc_encrypt(key.schedule(), chain, plaintext.data(), ciphertext.data(), whole);
+
+    uint8_t tail[kBlockSize];
+    size_t remaining = plaintext.size() - whole;
+    if (remaining != 0) {
+        std::memcpy(tail, plaintext.data() + whole, remaining);
+    }
+    common_pkcs7_pad(tail, remaining);
+    common_aes_cbc_encrypt(key.schedule(), chain, tail, ciphertext.data() + whole, kBlockSize);
+
+    written = padded;
+    return true;
+}
+
+bool AES::decryptCBC(common::ByteSpan ciphertext, const AESKey& key,
+                    common::ByteSpan iv, common::MutableByteSpan plaintext,
+                    size_t& written) {
+    COMMON_TRACE_SCOPE("AES::decryptCBC");
+    if (!key.valid() || iv.size() != kBlockSize || ciphertext.empty() ||
+        ciphertext.size() % kBlockSize != 0 || plaintext.size() < ciphertext.size()) {
+        return false;
+    }
+
+    uint8_t chain[kBlockSize];
+    std::memcpy(chain, iv.data(), kBlockSize);
+    common_aes_cbc_decrypt(key.schedule(), chain, ciphertext.data(), plaintext.data(),
+                           ciphertext.size());
+
+    size_t unpadded = common_pkcs7_unpad(plaintext.data(), ciphertext.size());
+    if (unpadded == static_cast<size_t>(-1)) {
+        return false;
+    }
+    written = unpadded;
+    return true;
+}
+
+bool AES::encryptCBC(common::ByteSpan plaintext, common::ByteSpan key,
+                    common::ByteSpan iv, common::MutableByteSpan ciphertext,
+                    size_t& written) {
+    const AESKey* schedule = cachedKey(key);
+    return schedule && encryptCBC(plaintext, *schedule, iv, ciphertext, written);
+}
+
+bool AES::decryptCBC(common::ByteSpan ciphertext, common::ByteSpan key,
+                    common::ByteSpan iv, common::MutableByteSpan plaintext,
+                    size_t& written) {
+    const AESKey* schedule = cachedKey(key);
+    return schedule && decryptCBC(ciphertext, *schedule, iv, plaintext, written);
+}
+
+bool AES::encryptCBCInPlace(common::MutableByteSpan buffer, size_t data_len,
+                           const AESKey& key, common::ByteSpan iv,
+                           size_t& written) {
+    size_t padded = encryptedSize(data_len);
+    if (!key.valid() || iv.size() != kBlockSize || buffer.size() < padded) {
+        return false;
+    }
+
+    uint8_t chain[kBlockSize];
+    std::memcpy(chain, iv.data(), kBlockSize);
+    common_pkcs7_pad(buffer.data(), data_len);
+    common_aes_cbc_encrypt(key.schedule(), chain, buffer.data(), buffer.data(), padded);
+
+    written = padded;
+    return true;
+}
+
+bool AES::decryptCBCInPlace(common::MutableByteSpan buffer,
+                           const AESKey& key, common::ByteSpan iv,
+                           size_t& written) {
+    return decryptCBC(buffer, key, iv, buffer, written);
+}
+
+bool AES::encryptCBCInPlace(common::MutableByteSpan buffer, size_t data_len,
+                           common::ByteSpan key, common::ByteSpan iv,
+                           size_t& written) {
+    const AESKey* schedule = cachedKey(key);
+    return schedule && encryptCBCInPlace(buffer, data_len, *schedule, iv, written);
+}
+
+bool AES::decryptCBCInPlace(common::MutableByteSpan buffer,
+                           common::ByteSpan key, common::ByteSpan iv,
+                           size_t& written) {
+    const AESKey* schedule = cachedKey(key);
+    return schedule && decryptCBCInPlace(buffer, *schedule, iv, written);
+}
+
 bool AES::encrypt(const uint8_t* input, size_t input_len,
                  const uint8_t* key, size_t key_len,
                  const uint8_t* iv, size_t iv_len,
                  std::vector<uint8_t>& output) {
-    // Stub - would use OpenSSL EVP_EncryptInit_ex, EVP_EncryptUpdate, EVP_EncryptFinal_ex
-    output.resize(input_len);
-    std::memcpy(output.data(), input, input_len);
+    output.resize(encryptedSize(input_len));
+    size_t written = 0;
+    if (!encryptCBC(common::ByteSpan(input, input_len), common::ByteSpan(key, key_len),
+                    common::ByteSpan(iv, iv_len), output, written)) {
+        output.clear();
+        return false;
+    }
+    output.resize(written);
     return true;
 }
 
@@ -22,9 +205,14 @@ bool AES::decrypt(const uint8_t* input, size_t input_len,
                  const uint8_t* key, size_t key_len,
                  const uint8_t* iv, size_t iv_len,
                  std::vector<uint8_t>& output) {
-    // Stub - would use OpenSSL EVP_DecryptInit_ex, EVP_DecryptUpdate, EVP_DecryptFinal_ex
     output.resize(input_len);
-    std::memcpy(output.data(), input, input_len);
+    size_t written = 0;
+    if (!decryptCBC(common::ByteSpan(input, input_len), common::ByteSpan(key, key_len),
+                    common::ByteSpan(iv, iv_len), output, written)) {
+        output.clear();
+        return false;
+    }
+    output.resize(written);
     return true;
 }
 
@@ -48,14 +236,82 @@ bool AES::decryptCBC(const std::vector<uint8_t>& ciphertext,
                   plaintext);
 }
 
-// Hash stub implementations
+// HashContext implementation
+HashContext::HashContext(HashAlgorithm algorithm) : algorithm_(algorithm) {
+    reset();
+}
+
+void HashContext::reset() {
+    common_hash_init(&ctx_, static_cast<common_hash_algo_t>(algorithm_));
+}
+
+HashContext& HashContext::update(const void* data, size_t length) {
+    common_hash_update(&ctx_, data, length);
+    return *this;
+}
+
+HashContext& HashContext::update(std::string_view input) {
+    return update(input.data(), input.size());
+}
+
+HashContext& HashContext::update(common::ByteSpan data) {
+    return update(data.data(), data.size());
+}
+
+size_t HashContext::digestSize() const {
+    return common_hash_digest_size(static_cast<common_hash_algo_t>(algorithm_));
+}
+
+size_t HashContext::finish(common::MutableByteSpan digest) {
+    if (digest.size() < digestSize()) {
+        return 0;
+    }
+    size_t written = common_hash_final(&ctx_, digest.data());
+    reset();
+    return written;
+}
+
+std::string HashContext::finishHex() {
+    uint8_t digest[COMMON_HASH_MAX_DIGEST_SIZE];
+    size_t written = finish(common::MutableByteSpan(digest, sizeof(digest)));
+    return Hex::encode(digest, written);
+}
+
+// Hash implementations
 std::string Hash::md5(const std::string& input) {
     return md5(reinterpret_cast<const uint8_t*>(input.data()), input.size());
 }
 
 std::string Hash::md5(const uint8_t* data, size_t length) {
-    // Stub - would use OpenSSL MD5()
-    return "d41d8cd98f00b204e9800998ecf8427e"; // MD5 of empty string
+    MD5Digest digest;
+    common_md5(data, length, digest.data());
+    return Hex::encode(digest.data(), digest.size());
+}
+
+void Hash::md5(std::string_view input, MD5Digest& digest) {
+    common_md5(input.data(), input.size(), digest.data());
+}
+
+void Hash::md5(common::ByteSpan data, MD5Digest& digest) {
+    common_md5(data.data(), data.size(), digest.data());
+}
+
+std::string Hash::sha1(const std::string& input) {
+    return sha1(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+std::string Hash::sha1(const uint8_t* data, size_t length) {
+    SHA1Digest digest;
+    common_sha1(data, length, digest.data());
+    return Hex::encode(digest.data(), digest.size());
+}
+
+void Hash::sha1(std::string_view input, SHA1Digest& digest) {
+    common_sha1(input.data(), input.size(), digest.data());
+}
+
+void Hash::sha1(common::ByteSpan data, SHA1Digest& digest) {
+    common_sha1(data.data(), data.size(), digest.data());
 }
 
 std::string Hash::sha256(const std::string& input) {
@@ -63,8 +319,214 @@ std::string Hash::sha256(const std::string& input) {
 }
 
 std::string Hash::sha256(const uint8_t* data, size_t length) {
-    // Stub - would use OpenSSL SHA256()
-    return "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    SHA256Digest digest;
+    common_sha256(data, length, digest.data());
+    return Hex::encode(digest.data(), digest.size());
+}
+
+void Hash::sha256(std::string_view input, SHA256Digest& digest) {
+    common_sha256(input.data(), input.size(), digest.data());
+}
+
+void Hash::sha256(common::ByteSpan data, SHA256Digest& digest) {
+    common_sha256(data.data(), data.size(), digest.data());
+}
+
+std::string Hash::sha512(const std::string& input) {
+    return sha512(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+std::string Hash::sha512(const uint8_t* data, size_t length) {
+    SHA512Digest digest;
+    common_sha512(data, length, digest.data());
+    return Hex::encode(digest.data(), digest.size());
+}
+
+void Hash::sha512(std::string_view input, SHA512Digest& digest) {
+    common_sha512(input.data(), input.size(), digest.data());
+}
+
+void Hash::sha512(common::ByteSpan data, SHA512Digest& digest) {
+    common_sha512(data.data(), data.size(), digest.data());
+}
+
+namespace {
+
+// Read and hash granularity; keeps the working set cache-sized
+constexpr size_t kHashChunkSize = 256 * 1024;
+
+// Hash fd to EOF. A reader thread fills one buffer while this thread
+// hashes the other, so neither the disk nor the hash core sits idle.
+bool hashStream(int fd, HashContext& ctx) {
+    struct Slot {
+        std::vector<uint8_t> data;
+        size_t length = 0;
+        bool full = false;
+    };
+    Slot slots[2];
+    slots[0].data.resize(kHashChunkSize);
+    slots[1].data.resize(kHashChunkSize);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;          // Reader hit EOF or an error
+    bool failed = false;
+
+    std::thread reader([&]() {
+        for (size_t i = 0;; i ^= 1) {
+            Slot& slot = slots[i];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return !slot.full; });
+            }
+
+            size_t length = 0;
+            bool error = false;
+            while (length < slot.data.size()) {
+                ssize_t n = read(fd, slot.data.data() + length, slot.data.size() - length);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) error = true;
+                if (n <= 0) break;
+                length += static_cast<size_t>(n);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.length = length;
+            slot.full = length > 0;
+            if (error || length < slot.data.size()) {
+                done = true;
+                failed = error;
+            }
+            cv.notify_all();
+            if (done) return;
+        }
+    });
+
+    for (size_t i = 0;; i ^= 1) {
+        Slot& slot = slots[i];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return slot.full || done; });
+            if (!slot.full) break;          // Reader finished without filling this slot
+        }
+
+        ctx.update(slot.data.data(), slot.length);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        slot.full = false;
+        cv.notify_all();
+        if (failed) break;
+    }
+
+    reader.join();
+    return !failed;
+}
+
+// Files that fit one chunk are read and hashed on this thread; a reader
+// thread would cost more than it overlaps
+bool hashSmall(int fd, HashContext& ctx) {
+    thread_local std::vector<uint8_t> buffer(kHashChunkSize);
+    size_t length = 0;
+    while (length < buffer.size()) {
+        ssize_t n = read(fd, buffer.data() + length, buffer.size() - length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return false;
+        if (n == 0) break;
+        length += static_cast<size_t>(n);
+    }
+    ctx.update(buffer.data(), length);
+    // Grew since fstat: hash the rest as a stream
+    return length < buffer.size() || hashStream(fd, ctx);
+}
+
+// Everything is read with read(), never mapped: a file truncated while it
+// is hashed (a log being rotated, a download being rewritten) then just
+// ends early instead of raising SIGBUS
+bool hashPath(const std::string& path, HashContext& ctx) {
+    int fd;
+    do {
+        fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) return false;
+
+    // procfs reports regular files of size 0; those, pipes and character
+    // devices are streamed
+    struct stat st;
+    bool ok;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+        static_cast<uint64_t>(st.st_size) <= kHashChunkSize) {
+        ok = hashSmall(fd, ctx);
+    } else {
+        if (S_ISREG(st.st_mode)) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+        ok = hashStream(fd, ctx);
+    }
+    close(fd);
+    return ok;
+}
+
+} // namespace
+
+size_t Hash::file(const std::string& path, HashAlgorithm algorithm, common::MutableByteSpan digest) {
+    COMMON_TRACE_SCOPE("Hash::file");
+    HashContext ctx(algorithm);
+    if (digest.size() < ctx.digestSize() || !hashPath(path, ctx)) {
+        return 0;
+    }
+    return ctx.finish(digest);
+}
+
+std::string Hash::fileHex(const std::string& path, HashAlgorithm algorithm) {
+    HashContext ctx(algorithm);
+    return hashPath(path, ctx) ? ctx.finishHex() : std::string();
+}
+
+std::vector<FileDigest> Hash::directory(const std::string& directory, HashAlgorithm algorithm,
+                                        unsigned max_threads) {
+    COMMON_TRACE_SCOPE("Hash::directory");
+    std::vector<FileDigest> results;
+    std::mutex results_mutex;
+    platform::DirectoryScanner::scanRecursive(directory,
+        [&](const std::string& dir, const platform::DirectoryEntry& entry) {
+            if (entry.type != platform::DirectoryEntry::File) return;
+            FileDigest result;
+            result.path.reserve(dir.size() + 1 + entry.name.size());
+            result.path.append(dir);
+            if (result.path.back() != '/') result.path.push_back('/');
+            result.path.append(entry.name);
+            std::lock_guard<std::mutex> lock(results_mutex);
+            results.push_back(std::move(result));
+        }, platform::DirectoryScanner::kStatNone, max_threads);
+
+    // Files, not directories, are the unit of work: a flat directory of
+    // large files still spreads across every worker
+    common::ThreadPool::shared().parallelFor(results.size(), [&](size_t i) {
+        HashContext ctx(algorithm);
+        if (hashPath(results[i].path, ctx)) {
+            results[i].hex = ctx.finishHex();
+        }
+    }, std::max(1u, max_threads));
+
+    std::sort(results.begin(), results.end(),
+              [](const FileDigest& a, const FileDigest& b) { return a.path < b.path; });
+    return results;
+}
+
+const char* Hash::backend(HashAlgorithm algorithm) {
+    return common_hash_backend(static_cast<common_hash_algo_t>(algorithm));
+}
+
+// Hex implementations
+std::string Hex::encode(const uint8_t* data, size_t length) {
+    std::string hex(length * 2 + 1, '\0');
+    common_hex_encode(data, length, &hex[0]);
+    hex.pop_back();
+    return hex;
+}
+
+std::string Hex::encode(const std::vector<uint8_t>& data) {
+    return encode(data.data(), data.size());
 }
 
 // Base64 stub implementations
@@ -104,18 +566,45 @@ uint32_t CRC::crc32(const std::vector<uint8_t>& data) {
 }
 
 // BurriCrypto implementations
+const AESKey& BurriCrypto::key() {
+    static const AESKey schedule(common::ByteSpan(kBurriKey, kKeySize));
+    return schedule;
+}
+
+bool BurriCrypto::encrypt(common::ByteSpan plaintext, common::MutableByteSpan ciphertext,
+                         size_t& written) {
+    return AES::encryptCBC(plaintext, key(), common::ByteSpan(kBurriIV, kIVSize),
+                           ciphertext, written);
+}
+
+bool BurriCrypto::decrypt(common::ByteSpan ciphertext, common::MutableByteSpan plaintext,
+                         size_t& written) {
+    return AES::decryptCBC(ciphertext, key(), common::ByteSpan(kBurriIV, kIVSize),
+                           plaintext, written);
+}
+
 bool BurriCrypto::encrypt(const std::vector<uint8_t>& plaintext,
                          std::vector<uint8_t>& ciphertext) {
-    std::vector<uint8_t> key(kBurriKey, kBurriKey + kKeySize);
-    std::vector<uint8_t> iv(kBurriIV, kBurriIV + kIVSize);
-    return AES::encryptCBC(plaintext, key, iv, ciphertext);
+    ciphertext.resize(AES::encryptedSize(plaintext.size()));
+    size_t written = 0;
+    if (!encrypt(plaintext, ciphertext, written)) {
+        ciphertext.clear();
+        return false;
+    }
+    ciphertext.resize(written);
+    return true;
 }
 
 bool BurriCrypto::decrypt(const std::vector<uint8_t>& ciphertext,
                          std::vector<uint8_t>& plaintext) {
-    std::vector<uint8_t> key(kBurriKey, kBurriKey + kKeySize);
-    std::vector<uint8_t> iv(kBurriIV, kBurriIV + kIVSize);
-    return AES::decryptCBC(ciphertext, key, iv, plaintext);
+    plaintext.resize(ciphertext.size());
+    size_t written = 0;
+    if (!decrypt(ciphertext, plaintext, written)) {
+        plaintext.clear();
+        return false;
+    }
+    plaintext.resize(written);
+    return true;
 }
 
 bool BurriCrypto::encryptFile(const std::string& input_path,
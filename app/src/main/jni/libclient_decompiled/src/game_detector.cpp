@@ -1,14 +1,14 @@
 #include "../include/game_detector.h"
 #include "../include/internal/platform_specific.h"
-#include <android/log.h>
+#include "common/log.h"
 
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "GameDetector", __VA_ARGS__)
+#define LOGI(...) COMMON_LOGI("GameDetector", __VA_ARGS__)
 
 namespace client {
 
 GameDetector::GameDetector() 
-    : initialized_(false), auto_detecting_(false), should_stop_(false),
-      game_status_(GameStatus::NOT_DETECTED), enable_cache_(true), cache_timeout_ms_(5000) {
+    : initialized_(false), auto_detecting_(false),
+      game_status_(GameStatus::NOT_DETECTED), detection_interval_ms_(2000), enable_cache_(true), cache_timeout_ms_(5000) {
 }
 
 GameDetector::~GameDetector() {
@@ -50,18 +50,14 @@ GameInfo GameDetector::getGameInfo(const std::string& package_name) const {
 
 void GameDetector::startAutoDetection() {
     if (auto_detecting_) return;
-    should_stop_ = false;
     auto_detecting_ = true;
-    detection_thread_ = std::make_unique<std::thread>(&GameDetector::detectionThreadFunc, this);
+    detection_task_.start(std::chrono::milliseconds(detection_interval_ms_),
+                          [this]() { checkRunningGames(); });
 }
 
 void GameDetector::stopAutoDetection() {
     if (!auto_detecting_) return;
-    should_stop_ = true;
-    if (detection_thread_ && detection_thread_->joinable()) {
-        detection_thread_->join();
-    }
-    detection_thread_.reset();
+    detection_task_.stop();
     auto_detecting_ = false;
 }
 
@@ -98,13 +94,6 @@ bool GameDetector::hasGameDetected() const {
     return game_status_ == GameStatus::DETECTED || game_status_ == GameStatus::RUNNING;
 }
 
-void GameDetector::detectionThreadFunc() {
-    while (!should_stop_) {
-        checkRunningGames();
-        std::this_thread::sleep_for(std::chrono::milliseconds(2000));
-    }
-}
-
 void GameDetector::checkRunningGames() {
     std::lock_guard<std::mutex> lock(targets_mutex_);
     for (const auto& target : target_games_) {
@@ -0,0 +1,842 @@
+#include "../include/internal/http_engine.h"
+#include "../include/internal/http_parser.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace client {
+namespace http {
+
+namespace {
+
+constexpr int kTimerExchange = 1;       // Request deadline
+constexpr int kTimerIdle = 2;           // Keep-alive expiry of an idle connection
+constexpr int kMaxEvents = 64;
+constexpr int kMaxIov = 16;             // Segments per sendmsg()
+
+// RFC 7231 4.2.2; safe to send again if the connection dies
+bool isIdempotent(const std::string& method) {
+    return method == "GET" || method == "HEAD" || method == "PUT" ||
+           method == "DELETE" || method == "OPTIONS" || method == "TRACE";
+}
+
+} // namespace
+
+// ============================================================================
+// Timer Wheel
+// ============================================================================
+
+TimerWheel::TimerWheel(uint32_t tick_ms, size_t slots)
+    : tick_ms_(tick_ms > 0 ? tick_ms : 1), slots_(slots > 0 ? slots : 1), current_(0), count_(0) {
+    for (Timer& head : slots_) {
+        head.prev = head.next = &head;
+    }
+}
+
+void TimerWheel::insert(Timer* head, Timer* timer) {
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+void TimerWheel::remove(Timer* timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = nullptr;
+}
+
+void TimerWheel::unlink(Timer* timer) {
+    remove(timer);
+    count_--;
+}
+
+void TimerWheel::schedule(Timer* timer, uint64_t now_ms, uint64_t delay_ms) {
+    if (timer->armed()) {
+        unlink(timer);
+    }
+    // Round up so a timer never fires early
+    uint64_t tick = (now_ms + delay_ms + tick_ms_ - 1) / tick_ms_;
+    timer->tick = std::max(tick, current_ + 1);
+    insert(&slots_[timer->tick % slots_.size()], timer);
+    count_++;
+}
+
+void TimerWheel::cancel(Timer* timer) {
+    if (timer->armed()) {
+        unlink(timer);
+    }
+}
+
+int TimerWheel::nextTimeout(uint64_t now_ms) const {
+    if (count_ == 0) {
+        return -1;
+    }
+    uint64_t now_tick = now_ms / tick_ms_;
+    uint64_t last = current_ + slots_.size();
+    for (uint64_t t = current_ + 1; t <= last; t++) {
+        const Timer* head = &slots_[t % slots_.size()];
+        for (const Timer* timer = head->next; timer != head; timer = timer->next) {
+            if (timer->tick <= t) {
+                return t <= now_tick ? 0 : static_cast<int>(t * tick_ms_ - now_ms);
+            }
+        }
+    }
+    // Everything is at least a revolution away; look again then
+    return last <= now_tick ? 0 : static_cast<int>(last * tick_ms_ - now_ms);
+}
+
+// ============================================================================
+// Engine State
+// ============================================================================
+
+struct Engine::Exchange : TimerWheel::Timer {
+    Request request;
+    Callback callback;
+    std::string address;            // Resolved sockaddr bytes
+    HostPool* pool = nullptr;
+    Connection* conn = nullptr;     // Null while queued
+    bool idempotent = false;
+    bool head = false;
+    bool retried = false;
+};
+
+struct Engine::Connection : TimerWheel::Timer {
+    int fd = -1;
+    HostPool* pool = nullptr;
+    uint32_t events = 0;            // Registered with epoll
+    bool connecting = true;
+    bool closed = false;
+
+    ResponseParser parser;
+    std::deque<Exchange*> exchanges;    // Sent or queued to send; answered in order
+    bool got_bytes = false;             // Part of the front response has arrived
+    uint64_t served = 0;
+
+    // Send cursor: exchanges before `sent` are fully written, and
+    // send_offset bytes of the next one (head, then body)
+    size_t sent = 0;
+    size_t send_offset = 0;
+};
+
+struct Engine::HostPool {
+    std::string key;                // host:port
+    std::string address;
+    std::vector<Connection*> connections;
+    std::deque<Exchange*> queue;    // Waiting for a connection
+};
+
+Engine::Engine() : Engine(Options()) {}
+
+Engine::Engine(const Options& options)
+    : options_(options), epoll_fd_(-1), wake_fd_(-1), running_(false), stopping_(false) {
+    options_.max_connections_per_host = std::max<size_t>(options_.max_connections_per_host, 1);
+    options_.max_pipeline_depth = std::max<size_t>(options_.max_pipeline_depth, 1);
+}
+
+Engine::~Engine() {
+    stop();
+}
+
+uint64_t Engine::nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool Engine::start() {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    if (running_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;      // Marks the wake-up descriptor
+    if (epoll_fd_ < 0 || wake_fd_ < 0 || ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) < 0) {
+        if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        epoll_fd_ = wake_fd_ = -1;
+        return false;
+    }
+
+    stopping_ = false;
+    thread_ = std::thread(&Engine::loop, this);
+    loop_id_ = thread_.get_id();
+    running_.store(true, std::memory_order_release);
+    return true;
+}
+
+void Engine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        if (!running_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        running_.store(false, std::memory_order_release);
+        stopping_ = true;
+    }
+    wake();
+    thread_.join();
+
+    ::close(epoll_fd_);
+    ::close(wake_fd_);
+    epoll_fd_ = wake_fd_ = -1;
+}
+
+void Engine::wake() {
+    uint64_t one = 1;
+    ssize_t n;
+    do {
+        n = ::write(wake_fd_, &one, sizeof(one));
+    } while (n < 0 && errno == EINTR);
+}
+
+void Engine::loop() {
+    pthread_setname_np(pthread_self(), "libclient-http");
+
+    epoll_event events[kMaxEvents];
+    bool stopping = false;
+    while (!stopping) {
+        int n = ::epoll_wait(epoll_fd_, events, kMaxEvents, timers_.nextTimeout(nowMs()));
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t count;
+                while (::read(wake_fd_, &count, sizeof(count)) < 0 && errno == EINTR) {}
+                continue;
+            }
+            Connection* conn = static_cast<Connection*>(events[i].data.ptr);
+            if (!conn->closed) {
+                onEvent(conn, events[i].events);
+            }
+        }
+
+        // Submissions are checked every iteration, which also picks up
+        // requests queued from callbacks without another wake-up
+        {
+            std::lock_guard<std::mutex> lock(submit_mutex_);
+            stopping = stopping_;
+        }
+        drainSubmissions();
+        timers_.advance(nowMs(), [this](TimerWheel::Timer* timer) { onTimer(timer); });
+
+        for (Connection* conn : closed_) delete conn;
+        closed_.clear();
+    }
+
+    // Shutting down: fail whatever is still outstanding
+    drainSubmissions();
+    for (auto& entry : pools_) {
+        HostPool* pool = entry.second.get();
+        while (!pool->queue.empty()) {
+            Exchange* exchange = pool->queue.front();
+            pool->queue.pop_front();
+            fail(exchange, ECANCELED, "Engine stopped");
+        }
+        std::vector<Connection*> connections = pool->connections;
+        for (Connection* conn : connections) {
+            closeConnection(conn, ECANCELED, "Engine stopped", false);
+        }
+    }
+    for (Connection* conn : closed_) delete conn;
+    closed_.clear();
+    pools_.clear();
+}
+
+// ============================================================================
+// Submission
+// ============================================================================
+
+void Engine::submit(Request request, Callback callback) {
+    auto reject = [&callback](int error, std::string message) {
+        Response response;
+        response.error = error;
+        response.error_message = std::move(message);
+        callback(std::move(response));
+    };
+
+    std::string address;
+    if (!resolve(request.host, request.port, address)) {
+        counters_.requests_failed.fetch_add(1, std::memory_order_relaxed);
+        reject(EHOSTUNREACH, "Cannot resolve host " + request.host);
+        return;
+    }
+
+    auto exchange = std::make_unique<Exchange>();
+    exchange->tag = kTimerExchange;
+    exchange->idempotent = isIdempotent(request.method);
+    exchange->head = request.method == "HEAD";
+    if (request.body.size == 0) {
+        request.body.fd = -1;
+    }
+    exchange->request = std::move(request);
+    exchange->callback = std::move(callback);
+    exchange->address = std::move(address);
+
+    bool first = false;
+    bool accepted = false;
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        if (running_.load(std::memory_order_relaxed)) {
+            first = submissions_.empty();
+            submissions_.push_back(exchange.get());
+            accepted = true;
+        }
+    }
+    if (!accepted) {
+        callback = std::move(exchange->callback);
+        counters_.requests_failed.fetch_add(1, std::memory_order_relaxed);
+        reject(ECANCELED, "Engine not running");
+        return;
+    }
+    exchange.release();     // Owned by the loop now
+    // The loop drains the whole list, so only the first one needs waking it
+    if (first && !onLoopThread()) {
+        wake();
+    }
+}
+
+Response Engine::send(Request request) {
+    if (onLoopThread()) {
+        Response response;
+        response.error = EDEADLK;
+        response.error_message = "Blocking request on the engine thread";
+        return response;
+    }
+    // Shared with the callback so the state outlives whichever side finishes last
+    auto promise = std::make_shared<std::promise<Response>>();
+    std::future<Response> future = promise->get_future();
+    submit(std::move(request), [promise](Response&& response) {
+        promise->set_value(std::move(response));
+    });
+    return future.get();
+}
+
+void Engine::drainSubmissions() {
+    std::vector<Exchange*> batch;
+    bool stopping;
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        batch.swap(submissions_);
+        stopping = stopping_;
+    }
+    for (Exchange* exchange : batch) {
+        if (stopping) {
+            fail(exchange, ECANCELED, "Engine stopped");
+        } else {
+            process(exchange);
+        }
+    }
+}
+
+void Engine::process(Exchange* exchange) {
+    int timeout = exchange->request.timeout_ms > 0 ? exchange->request.timeout_ms
+                                                   : options_.request_timeout_ms;
+    timers_.schedule(exchange, nowMs(), static_cast<uint64_t>(timeout));
+
+    std::string key = exchange->request.host + ':' + std::to_string(exchange->request.port);
+    std::unique_ptr<HostPool>& pool = pools_[key];
+    if (!pool) {
+        pool = std::make_unique<HostPool>();
+        pool->key = std::move(key);
+    }
+    pool->address = exchange->address;      // Latest resolution wins for new connections
+    exchange->pool = pool.get();
+    pool->queue.push_back(exchange);
+    dispatch(pool.get());
+}
+
+bool Engine::resolve(const std::string& host, int port, std::string& address) {
+    std::string key = host + ':' + std::to_string(port);
+    {
+        std::lock_guard<std::mutex> lock(resolve_mutex_);
+        auto it = resolved_.find(key);
+        if (it != resolved_.end()) {
+            address = it->second;
+            return true;
+        }
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV | AI_ADDRCONFIG;
+    addrinfo* result = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 ||
+        result == nullptr) {
+        return false;
+    }
+    address.assign(reinterpret_cast<const char*>(result->ai_addr), result->ai_addrlen);
+    ::freeaddrinfo(result);
+
+    std::lock_guard<std::mutex> lock(resolve_mutex_);
+    resolved_[key] = address;
+    return true;
+}
+
+// ============================================================================
+// Connection Pool
+// ============================================================================
+
+void Engine::dispatch(HostPool* pool) {
+    while (!pool->queue.empty()) {
+        Exchange* exchange = pool->queue.front();
+
+        // An idle connection, else a new one, else the shortest pipeline
+        Connection* target = nullptr;
+        for (Connection* conn : pool->connections) {
+            if (conn->exchanges.empty()) {
+                target = conn;
+                break;
+            }
+        }
+        if (target == nullptr && pool->connections.size() < options_.max_connections_per_host) {
+            target = openConnection(pool);
+            if (target == nullptr) {
+                int error = errno;
+                pool->queue.pop_front();
+                fail(exchange, error, "Cannot open connection");
+                continue;
+            }
+        }
+        if (target == nullptr) {
+            for (Connection* conn : pool->connections) {
+                if (canPipeline(conn, exchange) &&
+                    (target == nullptr || conn->exchanges.size() < target->exchanges.size())) {
+                    target = conn;
+                }
+            }
+        }
+        if (target == nullptr) {
+            return;     // Everything busy; a completion calls back in here
+        }
+        pool->queue.pop_front();
+        assign(target, exchange);
+    }
+}
+
+Engine::Connection* Engine::openConnection(HostPool* pool) {
+    const sockaddr* addr = reinterpret_cast<const sockaddr*>(pool->address.data());
+    socklen_t addr_len = static_cast<socklen_t>(pool->address.size());
+
+    int fd = ::socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    int ret;
+    do {
+        ret = ::connect(fd, addr, addr_len);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0 && errno != EINPROGRESS) {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        return nullptr;
+    }
+
+    auto conn = std::make_unique<Connection>();
+    conn->tag = kTimerIdle;
+    conn->fd = fd;
+    conn->pool = pool;
+    conn->connecting = ret < 0;
+    conn->events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+
+    epoll_event ev = {};
+    ev.events = conn->events;
+    ev.data.ptr = conn.get();
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        return nullptr;
+    }
+
+    counters_.connections_opened.fetch_add(1, std::memory_order_relaxed);
+    pool->connections.push_back(conn.get());
+    return conn.release();
+}
+
+bool Engine::canPipeline(const Connection* conn, const Exchange* exchange) const {
+    // Only behind a response the server kept the connection open for, and
+    // only requests that are safe to repeat if the connection drops
+    if (!exchange->idempotent || conn->served == 0 ||
+        conn->exchanges.size() >= options_.max_pipeline_depth) {
+        return false;
+    }
+    for (const Exchange* in_flight : conn->exchanges) {
+        if (!in_flight->idempotent) return false;
+    }
+    return true;
+}
+
+void Engine::assign(Connection* conn, Exchange* exchange) {
+    timers_.cancel(conn);       // No longer idle
+    if (conn->served > 0) {
+        counters_.requests_reused.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (conn->exchanges.empty()) {
+        conn->parser.reset(exchange->head);
+        conn->got_bytes = false;
+    } else {
+        counters_.requests_pipelined.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    exchange->conn = conn;
+    conn->exchanges.push_back(exchange);
+    if (!conn->connecting && !flush(conn)) {
+        return;
+    }
+    updateEvents(conn);
+}
+
+void Engine::updateEvents(Connection* conn) {
+    uint32_t events = EPOLLIN | EPOLLRDHUP;
+    if (conn->connecting || conn->sent < conn->exchanges.size()) {
+        events |= EPOLLOUT;
+    }
+    if (events != conn->events) {
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.ptr = conn;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn->fd, &ev);
+        conn->events = events;
+    }
+}
+
+void Engine::becomeIdle(Connection* conn) {
+    timers_.schedule(conn, nowMs(), static_cast<uint64_t>(options_.idle_timeout_ms));
+}
+
+// ============================================================================
+// I/O
+// ============================================================================
+
+void Engine::onEvent(Connection* conn, uint32_t events) {
+    if (conn->connecting) {
+        if (!(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            return;
+        }
+        onConnected(conn);
+        if (conn->closed) return;
+    }
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        receive(conn);
+        if (conn->closed) return;
+    }
+    if (events & EPOLLOUT) {
+        if (!flush(conn)) return;
+        updateEvents(conn);
+    }
+}
+
+void Engine::onConnected(Connection* conn) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (::getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0) {
+        error = errno;
+    }
+    if (error != 0) {
+        // The cached address may be stale; resolve again next time
+        {
+            std::lock_guard<std::mutex> lock(resolve_mutex_);
+            resolved_.erase(conn->pool->key);
+        }
+        errno = error;
+        closeConnection(conn, error, "Connect failed", false);
+        return;
+    }
+    conn->connecting = false;
+    if (flush(conn)) {
+        updateEvents(conn);
+    }
+}
+
+bool Engine::flush(Connection* conn) {
+    while (conn->sent < conn->exchanges.size()) {
+        const Request& current = conn->exchanges[conn->sent]->request;
+        size_t head_size = current.head.size();
+        ssize_t n;
+
+        if (conn->send_offset >= head_size && current.body.fd >= 0) {
+            // File body: kernel to socket
+            size_t done = conn->send_offset - head_size;
+            off_t offset = current.body.offset + static_cast<off_t>(done);
+            n = ::sendfile(conn->fd, current.body.fd, &offset, current.body.size - done);
+            if (n == 0) {
+                closeConnection(conn, EIO, "Request body file is shorter than its size", false);
+                return false;
+            }
+        } else {
+            // Heads and memory bodies, across pipelined requests, up to the
+            // next file body
+            iovec iov[kMaxIov];
+            int count = 0;
+            size_t offset = conn->send_offset;
+            for (size_t i = conn->sent; i < conn->exchanges.size() && count < kMaxIov; i++, offset = 0) {
+                const Request& request = conn->exchanges[i]->request;
+                if (offset < request.head.size()) {
+                    iov[count].iov_base = const_cast<char*>(request.head.data() + offset);
+                    iov[count].iov_len = request.head.size() - offset;
+                    count++;
+                    offset = request.head.size();
+                }
+                if (request.body.fd >= 0 || count == kMaxIov) {
+                    break;
+                }
+                if (request.body.size > 0) {
+                    size_t done = offset - request.head.size();
+                    iov[count].iov_base = const_cast<char*>(request.body.data + done);
+                    iov[count].iov_len = request.body.size - done;
+                    count++;
+                }
+            }
+            msghdr msg = {};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            n = ::sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+        }
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            closeConnection(conn, errno, "Send failed", true);
+            return false;
+        }
+        advanceSend(conn, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+void Engine::advanceSend(Connection* conn, size_t bytes) {
+    while (bytes > 0) {
+        const Request& request = conn->exchanges[conn->sent]->request;
+        size_t left = request.head.size() + request.body.size - conn->send_offset;
+        if (bytes < left) {
+            conn->send_offset += bytes;
+            return;
+        }
+        bytes -= left;
+        conn->sent++;
+        conn->send_offset = 0;
+    }
+}
+
+void Engine::receive(Connection* conn) {
+    while (true) {
+        // Straight into the parser's buffer
+        size_t capacity = 0;
+        char* dst = conn->parser.prepare(0, &capacity);
+        ssize_t n = ::recv(conn->fd, dst, capacity, 0);
+        if (n > 0) {
+            if (conn->exchanges.empty()) {
+                closeConnection(conn, EPROTO, "Unsolicited data from server", false);
+                return;
+            }
+            conn->got_bytes = true;
+            conn->parser.commit(static_cast<size_t>(n));
+            if (!completeResponses(conn)) return;
+            if (static_cast<size_t>(n) < capacity) return;     // Drained
+            continue;
+        }
+        if (n == 0) {
+            if (!conn->exchanges.empty() &&
+                conn->parser.finish() == ResponseParser::Result::Done &&
+                !completeResponses(conn)) {
+                return;
+            }
+            closeConnection(conn, ECONNRESET, "Connection closed by server", true);
+            return;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+        closeConnection(conn, errno, "Receive failed", true);
+        return;
+    }
+}
+
+// Hand out every response the parser has finished. Returns false if the
+// connection was closed.
+bool Engine::completeResponses(Connection* conn) {
+    using Result = ResponseParser::Result;
+    ResponseParser& parser = conn->parser;
+    bool completed = false;
+
+    while (!conn->exchanges.empty() && parser.result() != Result::NeedMore) {
+        if (parser.result() == Result::Error) {
+            closeConnection(conn, EPROTO, parser.error(), true);
+            return false;
+        }
+
+        Exchange* exchange = conn->exchanges.front();
+        conn->exchanges.pop_front();
+        // got_bytes now describes the next exchange, which has received
+        // nothing yet; closing below must still retry it
+        conn->got_bytes = false;
+        // A response that arrived before its request was fully written
+        // leaves the stream mid-request; the connection cannot go on
+        bool fully_sent = conn->sent > 0;
+        if (fully_sent) {
+            conn->sent--;
+        } else {
+            conn->send_offset = 0;
+        }
+        Response response;
+        response.status_code = parser.statusCode();
+        response.reason.assign(parser.reason());
+        response.headers.reserve(parser.headers().size());
+        for (const Header& header : parser.headers()) {
+            response.headers.emplace_back(std::string(header.name), std::string(header.value));
+        }
+        response.body = parser.takeBody();
+        bool keep_alive = parser.keepAlive();
+        conn->served++;
+        completed = true;
+        complete(exchange, std::move(response));
+
+        if (!keep_alive || !fully_sent) {
+            closeConnection(conn, ECONNRESET, "Connection closed by server", true);
+            return false;
+        }
+
+        // Pipelined responses may already be buffered
+        Exchange* next = conn->exchanges.empty() ? nullptr : conn->exchanges.front();
+        parser.reset(next != nullptr && next->head);
+        conn->got_bytes = parser.pendingBytes() > 0;
+        if (conn->got_bytes) {
+            if (next == nullptr) {
+                closeConnection(conn, EPROTO, "Unsolicited data from server", false);
+                return false;
+            }
+            parser.commit(0);
+        }
+    }
+
+    if (completed) {
+        if (conn->exchanges.empty()) {
+            becomeIdle(conn);
+        }
+        dispatch(conn->pool);
+    }
+    return true;
+}
+
+// ============================================================================
+// Completion
+// ============================================================================
+
+void Engine::onTimer(TimerWheel::Timer* timer) {
+    if (timer->tag == kTimerIdle) {
+        closeConnection(static_cast<Connection*>(timer), 0, nullptr, false);
+        return;
+    }
+
+    Exchange* exchange = static_cast<Exchange*>(timer);
+    Connection* conn = exchange->conn;
+    if (conn == nullptr) {
+        std::deque<Exchange*>& queue = exchange->pool->queue;
+        queue.erase(std::find(queue.begin(), queue.end(), exchange));
+        fail(exchange, ETIMEDOUT, "Request timed out");
+        return;
+    }
+
+    // Responses come in order, so the connection is unusable past this one.
+    // Requests behind it did nothing wrong and are retried.
+    bool front = conn->exchanges.front() == exchange;
+    conn->sent = 0;             // Closed below; the cursor no longer matters
+    conn->exchanges.erase(std::find(conn->exchanges.begin(), conn->exchanges.end(), exchange));
+    if (front) {
+        conn->got_bytes = false;
+    }
+    fail(exchange, ETIMEDOUT, "Request timed out");
+    closeConnection(conn, ETIMEDOUT, "Request timed out", true);
+}
+
+void Engine::closeConnection(Connection* conn, int error, const char* message, bool retry) {
+    if (conn->closed) {
+        return;
+    }
+    conn->closed = true;
+    timers_.cancel(conn);
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, conn->fd, nullptr);
+    ::close(conn->fd);
+    conn->fd = -1;
+
+    HostPool* pool = conn->pool;
+    pool->connections.erase(std::find(pool->connections.begin(), pool->connections.end(), conn));
+    closed_.push_back(conn);
+
+    // Retry what the server never started answering, ahead of the queue
+    std::deque<Exchange*> exchanges;
+    exchanges.swap(conn->exchanges);
+    std::vector<Exchange*> requeue;
+    for (size_t i = 0; i < exchanges.size(); i++) {
+        Exchange* exchange = exchanges[i];
+        exchange->conn = nullptr;
+        bool answered = i == 0 && conn->got_bytes;
+        if (retry && exchange->idempotent && !exchange->retried && !answered) {
+            exchange->retried = true;
+            counters_.requests_retried.fetch_add(1, std::memory_order_relaxed);
+            requeue.push_back(exchange);
+        } else {
+            fail(exchange, error, message);
+        }
+    }
+    if (!requeue.empty()) {
+        pool->queue.insert(pool->queue.begin(), requeue.begin(), requeue.end());
+        dispatch(pool);
+    }
+}
+
+void Engine::complete(Exchange* exchange, Response&& response) {
+    timers_.cancel(exchange);
+    counters_.requests_completed.fetch_add(1, std::memory_order_relaxed);
+    exchange->callback(std::move(response));
+    delete exchange;
+}
+
+void Engine::fail(Exchange* exchange, int error, const char* message) {
+    timers_.cancel(exchange);
+    counters_.requests_failed.fetch_add(1, std::memory_order_relaxed);
+    Response response;
+    response.error = error != 0 ? error : EIO;
+    response.error_message = message ? message : "Request failed";
+    exchange->callback(std::move(response));
+    delete exchange;
+}
+
+Engine::Stats Engine::stats() const {
+    Stats stats;
+    stats.connections_opened = counters_.connections_opened.load(std::memory_order_relaxed);
+    stats.requests_completed = counters_.requests_completed.load(std::memory_order_relaxed);
+    stats.requests_failed = counters_.requests_failed.load(std::memory_order_relaxed);
+    stats.requests_reused = counters_.requests_reused.load(std::memory_order_relaxed);
+    stats.requests_pipelined = counters_.requests_pipelined.load(std::memory_order_relaxed);
+    stats.requests_retried = counters_.requests_retried.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace http
+} // namespace client
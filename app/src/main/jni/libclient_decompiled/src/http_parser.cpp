@@ -0,0 +1,534 @@
+#include "../include/internal/http_parser.h"
+#include "../include/internal/simd.h"
+#include "../include/internal/string_utils.h"
+#include <algorithm>
+#include <cstring>
+
+namespace client {
+namespace http {
+
+namespace {
+
+constexpr size_t kMinReceiveWindow = 16 * 1024;
+constexpr size_t kFeedStep = 64 * 1024;
+constexpr unsigned kMaxChunkDigits = 15;        // Keeps the size below 2^60
+
+bool isOws(char c) {
+    return c == ' ' || c == '\t';
+}
+
+std::string_view trimOws(std::string_view str) {
+    while (!str.empty() && isOws(str.front())) str.remove_prefix(1);
+    while (!str.empty() && isOws(str.back())) str.remove_suffix(1);
+    return str;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = simd::lowerAscii(c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Call fn(token) for each trimmed, non-empty element of a comma list
+template <typename Fn>
+void forEachToken(std::string_view list, Fn&& fn) {
+    for (std::string_view token : utils::StringUtils::splitRange(list, ",")) {
+        token = trimOws(token);
+        if (!token.empty()) fn(token);
+    }
+}
+
+} // namespace
+
+ResponseParser::ResponseParser()
+    : head_len_(0), pos_(0), end_(0), result_(Result::NeedMore) {
+    reset();
+}
+
+void ResponseParser::reset(bool head_request) {
+    // Whatever follows a complete response belongs to the next one; after
+    // an error the stream position is unknown, so nothing is kept
+    size_t pending = (result_ == Result::Error) ? 0 : end_ - pos_;
+    if (pending > 0 && pos_ > 0) {
+        std::memmove(buf_.data(), buf_.data() + pos_, pending);
+    }
+    head_len_ = 0;
+    pos_ = 0;
+    end_ = pending;
+    scan_pos_ = 0;
+    line_start_ = 0;
+
+    state_ = State::Head;
+    result_ = Result::NeedMore;
+    error_ = nullptr;
+    head_request_ = head_request;
+
+    status_code_ = 0;
+    version_minor_ = 0;
+    reason_ = std::string_view();
+    headers_.clear();
+
+    chunked_ = false;
+    close_delimited_ = false;
+    content_length_ = -1;
+    remaining_ = 0;
+    body_bytes_ = 0;
+    chunk_digits_ = 0;
+    body_.clear();
+}
+
+char* ResponseParser::prepare(size_t min_capacity, size_t* capacity) {
+    // Body bytes before pos_ have been delivered; reclaim their space
+    if (state_ != State::Head && pos_ > head_len_) {
+        std::memmove(buf_.data() + head_len_, buf_.data() + pos_, end_ - pos_);
+        end_ = head_len_ + (end_ - pos_);
+        pos_ = head_len_;
+    }
+
+    min_capacity = std::max(min_capacity, kMinReceiveWindow);
+    if (buf_.size() - end_ < min_capacity) {
+        const char* old_base = buf_.data();
+        buf_.resize(std::max(end_ + min_capacity, buf_.size() * 2));
+        if (buf_.data() != old_base) {
+            rebase(old_base);
+        }
+    }
+
+    if (capacity) {
+        *capacity = buf_.size() - end_;
+    }
+    return buf_.data() + end_;
+}
+
+ResponseParser::Result ResponseParser::commit(size_t length) {
+    end_ += std::min(length, buf_.size() - end_);
+    return parse();
+}
+
+ResponseParser::Result ResponseParser::feed(const char* data, size_t length) {
+    do {
+        size_t step = std::min(length, kFeedStep);
+        char* dst = prepare(step, nullptr);
+        std::memcpy(dst, data, step);
+        data += step;
+        length -= step;
+        if (commit(step) != Result::NeedMore && length > 0) {
+            // Keep the rest for the next response
+            std::memcpy(prepare(length, nullptr), data, length);
+            end_ += length;
+            break;
+        }
+    } while (length > 0);
+    return result_;
+}
+
+ResponseParser::Result ResponseParser::finish() {
+    if (result_ != Result::NeedMore) {
+        return result_;
+    }
+    if (state_ == State::UntilClose) {
+        return complete();
+    }
+    return fail(state_ == State::Head && end_ == 0 ? "connection closed before response"
+                                                   : "connection closed mid-response");
+}
+
+std::string_view ResponseParser::header(std::string_view name) const {
+    for (const Header& h : headers_) {
+        if (utils::StringUtils::equalsIgnoreCase(h.name, name)) {
+            return h.value;
+        }
+    }
+    return std::string_view();
+}
+
+bool ResponseParser::hasHeader(std::string_view name) const {
+    for (const Header& h : headers_) {
+        if (utils::StringUtils::equalsIgnoreCase(h.name, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ResponseParser::keepAlive() const {
+    if (result_ == Result::Error || !headersComplete() || close_delimited_ || status_code_ == 101) {
+        return false;
+    }
+    bool close = false;
+    bool keep_alive = false;
+    for (const Header& h : headers_) {
+        if (utils::StringUtils::equalsIgnoreCase(h.name, "Connection")) {
+            forEachToken(h.value, [&](std::string_view token) {
+                close |= utils::StringUtils::equalsIgnoreCase(token, "close");
+                keep_alive |= utils::StringUtils::equalsIgnoreCase(token, "keep-alive");
+            });
+        }
+    }
+    // HTTP/1.1 is persistent by default, HTTP/1.0 only on request
+    return !close && (version_minor_ >= 1 || keep_alive);
+}
+
+// ============================================================================
+// Head
+// ============================================================================
+
+ResponseParser::Result ResponseParser::parse() {
+    if (result_ != Result::NeedMore) {
+        return result_;
+    }
+
+    while (state_ == State::Head) {
+        size_t nl = simd::findByte(buf_.data(), end_, '\n', scan_pos_);
+        if (nl == end_) {
+            scan_pos_ = end_;
+            if (end_ > kMaxHeadBytes) {
+                return fail("response head too large");
+            }
+            return Result::NeedMore;
+        }
+
+        size_t line_len = nl - line_start_;
+        bool empty = line_len == 0 || (line_len == 1 && buf_[line_start_] == '\r');
+        if (empty && line_start_ == 0) {
+            // Stray CRLF before the status line (RFC 7230 3.5)
+            end_ -= nl + 1;
+            std::memmove(buf_.data(), buf_.data() + nl + 1, end_);
+            scan_pos_ = 0;
+            continue;
+        }
+        if (nl + 1 > kMaxHeadBytes) {
+            return fail("response head too large");
+        }
+        if (empty) {
+            Result r = parseHead(nl + 1);
+            if (r != Result::NeedMore || state_ != State::Head) {
+                break;
+            }
+            continue;       // Interim response skipped
+        }
+        line_start_ = nl + 1;
+        scan_pos_ = nl + 1;
+    }
+
+    if (result_ != Result::NeedMore) {
+        return result_;
+    }
+
+    while (pos_ < end_ && state_ != State::Done) {
+        pos_ += parseBody(buf_.data() + pos_, end_ - pos_);
+        if (result_ == Result::Error) {
+            return result_;
+        }
+    }
+    if (state_ == State::Done) {
+        return complete();
+    }
+    pos_ = end_ = head_len_;        // Body delivered; keep only the head
+    return Result::NeedMore;
+}
+
+ResponseParser::Result ResponseParser::parseHead(size_t head_end) {
+    headers_.clear();
+    bool first = true;
+    size_t start = 0;
+    while (true) {
+        size_t nl = simd::findByte(buf_.data(), head_end, '\n', start);
+        std::string_view line(buf_.data() + start, nl - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            break;
+        }
+        if (first ? !parseStatusLine(line) : !parseHeaderLine(line)) {
+            return result_;
+        }
+        first = false;
+        start = nl + 1;
+    }
+
+    if (status_code_ >= 100 && status_code_ < 200 && status_code_ != 101) {
+        // 100 Continue and friends; the real response follows
+        end_ -= head_end;
+        std::memmove(buf_.data(), buf_.data() + head_end, end_);
+        headers_.clear();
+        reason_ = std::string_view();
+        scan_pos_ = 0;
+        line_start_ = 0;
+        return Result::NeedMore;
+    }
+
+    head_len_ = head_end;
+    pos_ = head_end;
+    if (!setupFraming()) {
+        return result_;
+    }
+    return Result::NeedMore;
+}
+
+bool ResponseParser::parseStatusLine(std::string_view line) {
+    // HTTP/1.x SP 3DIGIT [SP reason-phrase]
+    if (line.size() < 12 || line.compare(0, 7, "HTTP/1.") != 0 ||
+        line[7] < '0' || line[7] > '9' || line[8] != ' ') {
+        fail("malformed status line");
+        return false;
+    }
+    int code = 0;
+    for (size_t i = 9; i < 12; i++) {
+        if (line[i] < '0' || line[i] > '9') {
+            fail("malformed status code");
+            return false;
+        }
+        code = code * 10 + (line[i] - '0');
+    }
+    if (line.size() > 12 && line[12] != ' ') {
+        fail("malformed status line");
+        return false;
+    }
+    version_minor_ = line[7] - '0';
+    status_code_ = code;
+    reason_ = line.size() > 13 ? line.substr(13) : std::string_view();
+    return true;
+}
+
+bool ResponseParser::parseHeaderLine(std::string_view line) {
+    if (isOws(line.front())) {
+        fail("obsolete header line folding");
+        return false;
+    }
+    size_t colon = line.find(':');
+    if (colon == std::string_view::npos || colon == 0 || isOws(line[colon - 1])) {
+        fail("malformed header field");
+        return false;
+    }
+    if (headers_.size() >= kMaxHeaders) {
+        fail("too many header fields");
+        return false;
+    }
+    headers_.push_back(Header{line.substr(0, colon), trimOws(line.substr(colon + 1))});
+    return true;
+}
+
+bool ResponseParser::setupFraming() {
+    if (head_request_ || status_code_ < 200 || status_code_ == 204 || status_code_ == 304) {
+        state_ = State::Done;
+        return true;
+    }
+
+    bool has_transfer_encoding = false;
+    for (const Header& h : headers_) {
+        if (utils::StringUtils::equalsIgnoreCase(h.name, "Transfer-Encoding")) {
+            // Only a final "chunked" coding frames the body
+            has_transfer_encoding = true;
+            forEachToken(h.value, [&](std::string_view token) {
+                chunked_ = utils::StringUtils::equalsIgnoreCase(token, "chunked");
+            });
+        } else if (utils::StringUtils::equalsIgnoreCase(h.name, "Content-Length")) {
+            bool valid = true;
+            forEachToken(h.value, [&](std::string_view token) {
+                int64_t value = 0;
+                valid &= token.size() <= 18;
+                for (char c : token) {
+                    valid &= c >= '0' && c <= '9';
+                    value = value * 10 + (c - '0');
+                }
+                // Repeated values are allowed only if they agree
+                valid &= content_length_ < 0 || content_length_ == value;
+                content_length_ = value;
+            });
+            if (!valid) {
+                fail("invalid Content-Length");
+                return false;
+            }
+        }
+    }
+
+    if (has_transfer_encoding) {
+        content_length_ = -1;       // Transfer-Encoding overrides it
+        if (chunked_) {
+            state_ = State::ChunkSize;
+        } else {
+            state_ = State::UntilClose;
+            close_delimited_ = true;
+        }
+    } else if (content_length_ >= 0) {
+        remaining_ = static_cast<uint64_t>(content_length_);
+        state_ = remaining_ > 0 ? State::Identity : State::Done;
+    } else {
+        state_ = State::UntilClose;
+        close_delimited_ = true;
+    }
+    return true;
+}
+
+// ============================================================================
+// Body
+// ============================================================================
+
+size_t ResponseParser::parseBody(const char* data, size_t length) {
+    size_t i = 0;
+    while (i < length && state_ != State::Done) {
+        switch (state_) {
+            case State::Identity:
+            case State::ChunkData: {
+                size_t take = static_cast<size_t>(std::min<uint64_t>(remaining_, length - i));
+                if (!deliver(data + i, take)) return i;
+                i += take;
+                remaining_ -= take;
+                if (remaining_ == 0) {
+                    state_ = (state_ == State::Identity) ? State::Done : State::ChunkDataCR;
+                }
+                break;
+            }
+
+            case State::UntilClose:
+                if (!deliver(data + i, length - i)) return i;
+                i = length;
+                break;
+
+            case State::ChunkSize: {
+                int digit = hexValue(data[i]);
+                if (digit >= 0) {
+                    if (++chunk_digits_ > kMaxChunkDigits) {
+                        fail("chunk size too large");
+                        return i;
+                    }
+                    remaining_ = (remaining_ << 4) | static_cast<uint64_t>(digit);
+                    i++;
+                    break;
+                }
+                if (chunk_digits_ == 0) {
+                    fail("malformed chunk size");
+                    return i;
+                }
+                char c = data[i++];
+                if (c == ';' || isOws(c)) {
+                    state_ = State::ChunkExtension;
+                } else if (c == '\r') {
+                    state_ = State::ChunkSizeLF;
+                } else if (c == '\n') {
+                    state_ = remaining_ > 0 ? State::ChunkData : State::TrailerStart;
+                } else {
+                    fail("malformed chunk size");
+                    return i;
+                }
+                break;
+            }
+
+            case State::ChunkExtension: {
+                // Extensions are ignored up to the end of the size line
+                size_t nl = simd::findByte(data, length, '\n', i);
+                if (nl == length) return length;
+                i = nl + 1;
+                state_ = remaining_ > 0 ? State::ChunkData : State::TrailerStart;
+                break;
+            }
+
+            case State::ChunkSizeLF:
+                if (data[i++] != '\n') {
+                    fail("malformed chunk size line");
+                    return i;
+                }
+                state_ = remaining_ > 0 ? State::ChunkData : State::TrailerStart;
+                break;
+
+            case State::ChunkDataCR:
+            case State::ChunkDataLF: {
+                char c = data[i++];
+                if (c == '\r' && state_ == State::ChunkDataCR) {
+                    state_ = State::ChunkDataLF;
+                    break;
+                }
+                if (c != '\n') {
+                    fail("missing CRLF after chunk data");
+                    return i;
+                }
+                state_ = State::ChunkSize;
+                chunk_digits_ = 0;
+                remaining_ = 0;
+                break;
+            }
+
+            case State::TrailerStart: {
+                char c = data[i++];
+                if (c == '\r') {
+                    state_ = State::TrailerLF;
+                } else if (c == '\n') {
+                    state_ = State::Done;
+                } else {
+                    state_ = State::TrailerLine;
+                }
+                break;
+            }
+
+            case State::TrailerLine: {
+                // Trailer fields are read past, not kept
+                size_t nl = simd::findByte(data, length, '\n', i);
+                if (nl == length) return length;
+                i = nl + 1;
+                state_ = State::TrailerStart;
+                break;
+            }
+
+            case State::TrailerLF:
+                if (data[i++] != '\n') {
+                    fail("malformed chunked trailer");
+                    return i;
+                }
+                state_ = State::Done;
+                break;
+
+            case State::Head:
+            case State::Done:
+                return i;
+        }
+    }
+    return i;
+}
+
+bool ResponseParser::deliver(const char* data, size_t length) {
+    if (length == 0) {
+        return true;
+    }
+    body_bytes_ += length;
+    if (!sink_) {
+        body_.append(data, length);
+        return true;
+    }
+    if (!sink_(std::string_view(data, length))) {
+        fail("body rejected by sink");
+        return false;
+    }
+    return true;
+}
+
+// The head lives in buf_; move its views along when the buffer reallocates
+void ResponseParser::rebase(const char* old_base) {
+    const char* new_base = buf_.data();
+    auto move = [&](std::string_view view) {
+        return view.data() ? std::string_view(new_base + (view.data() - old_base), view.size())
+                           : view;
+    };
+    reason_ = move(reason_);
+    for (Header& h : headers_) {
+        h.name = move(h.name);
+        h.value = move(h.value);
+    }
+}
+
+ResponseParser::Result ResponseParser::fail(const char* message) {
+    error_ = message;
+    result_ = Result::Error;
+    return result_;
+}
+
+ResponseParser::Result ResponseParser::complete() {
+    state_ = State::Done;
+    result_ = Result::Done;
+    return result_;
+}
+
+} // namespace http
+} // namespace client
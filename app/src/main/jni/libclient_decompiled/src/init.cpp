@@ -1,6 +1,7 @@
 #include "../include/client.h"
 #include "../include/jni_bridge.h"
 #include "../include/constants.h"
+#include "common/jni_string.h"
 
 namespace client {
 namespace jni {
@@ -48,13 +49,10 @@ std::string JNIHelper::JavaStringToStdString(JNIEnv* env, jstring jstr) {
         return "";
     }
     
-    const char* chars = env->GetStringUTFChars(jstr, nullptr);
-    if (chars == nullptr) {
-        return "";
-    }
-    
-    std::string result(chars);
-    env->ReleaseStringUTFChars(jstr, chars);
+    // Copy straight into the result instead of through a VM-allocated buffer
+    jsize length = env->GetStringUTFLength(jstr);
+    std::string result(static_cast<size_t>(length), '\0');
+    env->GetStringUTFRegion(jstr, 0, env->GetStringLength(jstr), &result[0]);
     
     return result;
 }
@@ -64,7 +62,7 @@ jstring JNIHelper::StdStringToJavaString(JNIEnv* env, const std::string& str) {
         return nullptr;
     }
     
-    return env->NewStringUTF(str.c_str());
+    return common::newStringUtf(env, str);
 }
 
 bool JNIHelper::CheckException(JNIEnv* env) {
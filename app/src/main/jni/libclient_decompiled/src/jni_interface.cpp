@@ -1,6 +1,7 @@
 #include "../include/jni_bridge.h"
 #include "../include/client.h"
 #include "../include/constants.h"
+#include "common/jni_string.h"
 #include <android/native_window_jni.h>
 
 using namespace client;
@@ -38,6 +39,7 @@ JNIEXPORT void JNICALL JNI_OnUnload(JavaVM* vm, void* reserved) {
     Client::getInstance().shutdown();
     
     g_java_vm = nullptr;
+    common_log_flush();
 }
 
 // FloaterService JNI methods
@@ -213,7 +215,7 @@ JNI_COMPANION_METHOD(jboolean, update)(JNIEnv* env, jobject thiz, jstring versio
         return JNI_FALSE;
     }
     
-    std::string version_str = JNIHelper::JavaStringToStdString(env, version);
+    common::JniUtf8 version_str(env, version);
     LOGI("Checking update for version: %s", version_str.c_str());
     
     Client& client = Client::getInstance();
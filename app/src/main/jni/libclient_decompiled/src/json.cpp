@@ -0,0 +1,655 @@
+#include "../include/internal/json.h"
+#include "../include/internal/simd.h"
+#include "../include/internal/string_utils.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace client {
+namespace json {
+
+namespace {
+
+inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline const char* skipWhitespace(const char* p, const char* end) {
+    while (p < end && isWhitespace(*p)) p++;
+    return p;
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = simd::lowerAscii(c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Four hex digits at p, or -1
+int hexQuad(const char* p) {
+    int value = 0;
+    for (int i = 0; i < 4; i++) {
+        int d = hexDigit(p[i]);
+        if (d < 0) return -1;
+        value = (value << 4) | d;
+    }
+    return value;
+}
+
+char* appendUtf8(char* out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+const char kHexDigits[] = "0123456789abcdef";
+
+} // namespace
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size), cur_(nullptr), left_(0) {}
+
+void Arena::addBlock(size_t size) {
+    size = std::max(size, block_size_);
+    blocks_.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+    cur_ = blocks_.back().data.get();
+    left_ = size;
+    block_size_ = std::max(block_size_, size);     // Grow geometrically with use
+}
+
+void* Arena::allocate(size_t size, size_t align) {
+    size_t pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+    if (cur_ == nullptr || pad + size > left_) {
+        addBlock(std::max(size + align, block_size_ * 2));
+        pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+    }
+    char* p = cur_ + pad;
+    cur_ += pad + size;
+    left_ -= pad + size;
+    return p;
+}
+
+void Arena::reserve(size_t size) {
+    if (cur_ == nullptr || left_ < size) {
+        addBlock(size);
+    }
+}
+
+void Arena::reset() {
+    if (blocks_.size() > 1) {
+        size_t total = capacity();
+        blocks_.clear();
+        addBlock(total);
+        return;
+    }
+    if (!blocks_.empty()) {
+        cur_ = blocks_.front().data.get();
+        left_ = blocks_.front().size;
+    }
+}
+
+size_t Arena::capacity() const {
+    size_t total = 0;
+    for (const Block& b : blocks_) total += b.size;
+    return total;
+}
+
+// ============================================================================
+// Value
+// ============================================================================
+
+Value Value::makeString(const char* data, size_t size) {
+    Value v;
+    v.ptr_ = data;
+    v.size_ = static_cast<uint32_t>(size);
+    v.type_ = Type::String;
+    return v;
+}
+
+Value Value::makeNumber(const char* data, size_t size) {
+    Value v = makeString(data, size);
+    v.type_ = Type::Number;
+    return v;
+}
+
+Value Value::makeBool(bool value) {
+    Value v;
+    v.type_ = Type::Bool;
+    v.bool_ = value;
+    return v;
+}
+
+Value Value::makeContainer(Type type, const void* items, size_t size) {
+    Value v;
+    v.ptr_ = items;
+    v.size_ = static_cast<uint32_t>(size);
+    v.type_ = type;
+    return v;
+}
+
+const Value& Value::null() {
+    static const Value kNull;
+    return kNull;
+}
+
+int64_t Value::asInt64(int64_t default_value) const {
+    if (type_ != Type::Number) {
+        return default_value;
+    }
+    const char* text = static_cast<const char*>(ptr_);
+    int64_t value = 0;
+    std::from_chars_result r = std::from_chars(text, text + size_, value);
+    if (r.ec == std::errc() && r.ptr == text + size_) {
+        return value;
+    }
+    // Fractions, exponents and overflow go through double
+    double d = asDouble(0.0);
+    if (std::isfinite(d) && d >= -9.2233720368547758e18 && d < 9.2233720368547758e18) {
+        return static_cast<int64_t>(d);
+    }
+    return default_value;
+}
+
+double Value::asDouble(double default_value) const {
+    if (type_ != Type::Number) {
+        return default_value;
+    }
+    return utils::StringUtils::toDouble(
+        std::string_view(static_cast<const char*>(ptr_), size_), default_value);
+}
+
+std::string_view Value::asString(std::string_view default_value) const {
+    if (type_ != Type::String && type_ != Type::Number) {
+        return default_value;
+    }
+    return std::string_view(static_cast<const char*>(ptr_), size_);
+}
+
+const Value& Value::operator[](size_t index) const {
+    return (type_ == Type::Array && index < size_) ? items()[index] : null();
+}
+
+const Value& Value::operator[](std::string_view key) const {
+    const Value* v = find(key);
+    return v ? *v : null();
+}
+
+const Value* Value::find(std::string_view key) const {
+    for (const Member* m = memberBegin(); m != memberEnd(); ++m) {
+        if (m->key.asString() == key) {
+            return &m->value;
+        }
+    }
+    return nullptr;
+}
+
+const Member* Value::memberBegin() const {
+    return type_ == Type::Object ? static_cast<const Member*>(ptr_) : nullptr;
+}
+
+const Member* Value::memberEnd() const {
+    return type_ == Type::Object ? static_cast<const Member*>(ptr_) + size_ : nullptr;
+}
+
+// ============================================================================
+// Document
+// ============================================================================
+
+Document::Document()
+    : text_(nullptr), error_(nullptr), error_offset_(0) {}
+
+void Document::clear() {
+    arena_.reset();
+    stack_.clear();
+    frames_.clear();
+    root_ = Value();
+    text_ = nullptr;
+    error_ = nullptr;
+    error_offset_ = 0;
+}
+
+bool Document::fail(const char* message, const char* at) {
+    error_ = message;
+    error_offset_ = static_cast<size_t>(at - text_);
+    root_ = Value();
+    return false;
+}
+
+bool Document::parse(std::string_view text) {
+    clear();
+    text_ = text.data();
+    if (text.size() > UINT32_MAX) {
+        return fail("document too large", text_);
+    }
+
+    // Every value costs a 16-byte node (an object member 32), so two bytes
+    // per input byte covers payloads averaging 8 or more bytes of text per
+    // value, as keyed objects with string values do. Denser input such as
+    // arrays of small numbers spills into more blocks, which reset() merges
+    // so a reused Document still allocates once.
+    arena_.reserve(text.size() * 2 + 256);
+
+    const char* p = text.data();
+    const char* const end = p + text.size();
+
+    while (true) {
+        // A value is expected here
+        p = skipWhitespace(p, end);
+        if (p == end) {
+            return fail("unexpected end of input", p);
+        }
+
+        bool scalar = true;
+        switch (*p) {
+            case '{':
+            case '[': {
+                if (frames_.size() >= kMaxDepth) {
+                    return fail("nesting too deep", p);
+                }
+                bool object = *p++ == '{';
+                frames_.push_back(Frame{stack_.size(), object});
+                p = skipWhitespace(p, end);
+                if (p < end && *p == (object ? '}' : ']')) {
+                    p++;
+                    closeContainer(object);
+                    break;
+                }
+                if (object) {
+                    // First key
+                    Value key;
+                    if (p == end || *p != '"') return fail("expected object key", p);
+                    if (!parseString(p, end, key)) return false;
+                    stack_.push_back(key);
+                    p = skipWhitespace(p, end);
+                    if (p == end || *p != ':') return fail("expected ':'", p);
+                    p++;
+                }
+                scalar = false;
+                break;
+            }
+
+            case '"': {
+                Value v;
+                if (!parseString(p, end, v)) return false;
+                stack_.push_back(v);
+                break;
+            }
+
+            case 't':
+                if (end - p < 4 || std::memcmp(p, "true", 4) != 0) return fail("invalid literal", p);
+                stack_.push_back(Value::makeBool(true));
+                p += 4;
+                break;
+
+            case 'f':
+                if (end - p < 5 || std::memcmp(p, "false", 5) != 0) return fail("invalid literal", p);
+                stack_.push_back(Value::makeBool(false));
+                p += 5;
+                break;
+
+            case 'n':
+                if (end - p < 4 || std::memcmp(p, "null", 4) != 0) return fail("invalid literal", p);
+                stack_.push_back(Value());
+                p += 4;
+                break;
+
+            default: {
+                Value v;
+                if (!parseNumber(p, end, v)) return false;
+                stack_.push_back(v);
+                break;
+            }
+        }
+        if (!scalar) {
+            continue;
+        }
+
+        // After a value: separators and closing brackets
+        while (true) {
+            if (frames_.empty()) {
+                p = skipWhitespace(p, end);
+                if (p != end) {
+                    return fail("trailing characters after document", p);
+                }
+                root_ = stack_.back();
+                return true;
+            }
+
+            p = skipWhitespace(p, end);
+            if (p == end) {
+                return fail("unexpected end of input", p);
+            }
+            bool object = frames_.back().object;
+            if (*p == ',') {
+                p++;
+                if (object) {
+                    Value key;
+                    p = skipWhitespace(p, end);
+                    if (p == end || *p != '"') return fail("expected object key", p);
+                    if (!parseString(p, end, key)) return false;
+                    stack_.push_back(key);
+                    p = skipWhitespace(p, end);
+                    if (p == end || *p != ':') return fail("expected ':'", p);
+                    p++;
+                }
+                break;
+            }
+            if (*p != (object ? '}' : ']')) {
+                return fail(object ? "expected ',' or '}'" : "expected ',' or ']'", p);
+            }
+            p++;
+            closeContainer(object);
+        }
+    }
+}
+
+// Move the open container's children from the stack into the arena
+bool Document::closeContainer(bool object) {
+    size_t base = frames_.back().base;
+    frames_.pop_back();
+    size_t count = stack_.size() - base;
+    const Value* children = stack_.data() + base;
+
+    Value container;
+    if (object) {
+        size_t members = count / 2;
+        Member* out = static_cast<Member*>(arena_.allocate(members * sizeof(Member), alignof(Member)));
+        for (size_t i = 0; i < members; i++) {
+            out[i].key = children[2 * i];
+            out[i].value = children[2 * i + 1];
+        }
+        container = Value::makeContainer(Type::Object, out, members);
+    } else {
+        Value* out = static_cast<Value*>(arena_.allocate(count * sizeof(Value), alignof(Value)));
+        std::copy(children, children + count, out);
+        container = Value::makeContainer(Type::Array, out, count);
+    }
+    stack_.resize(base);
+    stack_.push_back(container);
+    return true;
+}
+
+bool Document::parseString(const char*& p, const char* end, Value& out) {
+    const char* start = ++p;      // Past the opening quote
+    size_t len = static_cast<size_t>(end - start);
+
+    // Fast path: find the closing quote; stop at the first escape
+    size_t i = simd::findJsonSpecial(start, len);
+    if (i < len && start[i] == '"') {
+        out = Value::makeString(start, i);
+        p = start + i + 1;
+        return true;
+    }
+
+    // Find the end, skipping escaped characters
+    size_t escapes_from = i;
+    while (i < len && start[i] != '"') {
+        if (start[i] != '\\') {
+            return fail("control character in string", start + i);
+        }
+        i += 2;
+        if (i > len) break;
+        i = simd::findJsonSpecial(start, len, i);
+    }
+    if (i >= len) {
+        return fail("unterminated string", start - 1);
+    }
+
+    // Unescaped text is never longer than the source
+    char* dst = static_cast<char*>(arena_.allocate(i, 1));
+    std::memcpy(dst, start, escapes_from);
+    char* o = dst + escapes_from;
+    for (size_t j = escapes_from; j < i;) {
+        char c = start[j];
+        if (c != '\\') {
+            size_t run = simd::findJsonSpecial(start, i, j) - j;
+            std::memcpy(o, start + j, run);
+            o += run;
+            j += run;
+            continue;
+        }
+        char e = start[j + 1];
+        j += 2;
+        switch (e) {
+            case '"':  *o++ = '"'; break;
+            case '\\': *o++ = '\\'; break;
+            case '/':  *o++ = '/'; break;
+            case 'b':  *o++ = '\b'; break;
+            case 'f':  *o++ = '\f'; break;
+            case 'n':  *o++ = '\n'; break;
+            case 'r':  *o++ = '\r'; break;
+            case 't':  *o++ = '\t'; break;
+            case 'u': {
+                int cp = (i - j >= 4) ? hexQuad(start + j) : -1;
+                if (cp < 0) return fail("invalid \\u escape", start + j - 2);
+                j += 4;
+                uint32_t code = static_cast<uint32_t>(cp);
+                if (code >= 0xD800 && code < 0xDC00) {
+                    // High surrogate; a low one must follow
+                    int low = (i - j >= 6 && start[j] == '\\' && start[j + 1] == 'u')
+                        ? hexQuad(start + j + 2) : -1;
+                    if (low < 0xDC00 || low >= 0xE000) {
+                        return fail("unpaired surrogate", start + j - 6);
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (static_cast<uint32_t>(low) - 0xDC00);
+                    j += 6;
+                } else if (code >= 0xDC00 && code < 0xE000) {
+                    return fail("unpaired surrogate", start + j - 6);
+                }
+                o = appendUtf8(o, code);
+                break;
+            }
+            default:
+                return fail("invalid escape", start + j - 2);
+        }
+    }
+
+    out = Value::makeString(dst, static_cast<size_t>(o - dst));
+    p = start + i + 1;
+    return true;
+}
+
+bool Document::parseNumber(const char*& p, const char* end, Value& out) {
+    // -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)?
+    const char* start = p;
+    const char* q = p;
+    if (q < end && *q == '-') q++;
+    if (q == end || !isDigit(*q)) {
+        return fail(q == start ? "unexpected character" : "invalid number", start);
+    }
+    if (*q == '0') {
+        q++;
+    } else {
+        while (q < end && isDigit(*q)) q++;
+    }
+    if (q < end && *q == '.') {
+        q++;
+        if (q == end || !isDigit(*q)) return fail("invalid number", start);
+        while (q < end && isDigit(*q)) q++;
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        q++;
+        if (q < end && (*q == '+' || *q == '-')) q++;
+        if (q == end || !isDigit(*q)) return fail("invalid number", start);
+        while (q < end && isDigit(*q)) q++;
+    }
+    out = Value::makeNumber(start, static_cast<size_t>(q - start));
+    p = q;
+    return true;
+}
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+void Writer::separator() {
+    if (need_comma_) {
+        out_.push_back(',');
+    }
+}
+
+Writer& Writer::beginObject() {
+    separator();
+    out_.push_back('{');
+    need_comma_ = false;
+    return *this;
+}
+
+Writer& Writer::endObject() {
+    out_.push_back('}');
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::beginArray() {
+    separator();
+    out_.push_back('[');
+    need_comma_ = false;
+    return *this;
+}
+
+Writer& Writer::endArray() {
+    out_.push_back(']');
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::key(std::string_view name) {
+    separator();
+    out_.push_back('"');
+    appendEscaped(out_, name);
+    out_.append("\":", 2);
+    need_comma_ = false;
+    return *this;
+}
+
+Writer& Writer::value(std::string_view str) {
+    separator();
+    out_.push_back('"');
+    appendEscaped(out_, str);
+    out_.push_back('"');
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::value(bool b) {
+    separator();
+    out_.append(b ? "true" : "false");
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::value(long long v) {
+    separator();
+    utils::StringUtils::appendInt(out_, v);
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::value(unsigned long long v) {
+    separator();
+    utils::StringUtils::appendUnsigned(out_, v);
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::value(double v) {
+    if (!std::isfinite(v)) {
+        return null();
+    }
+    separator();
+    utils::StringUtils::appendDouble(out_, v);
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::null() {
+    separator();
+    out_.append("null", 4);
+    need_comma_ = true;
+    return *this;
+}
+
+Writer& Writer::value(const Value& v) {
+    switch (v.type()) {
+        case Type::Null:
+            return null();
+        case Type::Bool:
+            return value(v.asBool());
+        case Type::Number:
+            // Already valid JSON; copy the literal
+            separator();
+            out_.append(v.asString());
+            need_comma_ = true;
+            return *this;
+        case Type::String:
+            return value(v.asString());
+        case Type::Array:
+            beginArray();
+            for (const Value& item : v) value(item);
+            return endArray();
+        case Type::Object:
+            beginObject();
+            for (const Member* m = v.memberBegin(); m != v.memberEnd(); ++m) {
+                key(m->key.asString());
+                value(m->value);
+            }
+            return endObject();
+    }
+    return *this;
+}
+
+void Writer::appendEscaped(std::string& out, std::string_view str) {
+    const char* data = str.data();
+    size_t len = str.size();
+    size_t i = 0;
+    while (i < len) {
+        size_t next = simd::findJsonSpecial(data, len, i);
+        out.append(data + i, next - i);
+        if (next == len) {
+            break;
+        }
+        unsigned char c = static_cast<unsigned char>(data[next]);
+        switch (c) {
+            case '"':  out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            default: {
+                const char esc[6] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF]};
+                out.append(esc, sizeof(esc));
+                break;
+            }
+        }
+        i = next + 1;
+    }
+}
+
+} // namespace json
+} // namespace client
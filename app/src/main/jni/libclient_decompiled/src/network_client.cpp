@@ -1,25 +1,45 @@
 #include "../include/network_client.h"
 #include "../include/device_info.h"
 #include <android/log.h>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace client {
 
 NetworkClient::NetworkClient() : initialized_(false), connected_(false), 
-    connection_status_(ConnectionStatus::DISCONNECTED), socket_fd_(-1), 
-    ssl_context_(nullptr), ssl_connection_(nullptr), max_retry_attempts_(3), retry_delay_ms_(1000) {}
+    connection_status_(ConnectionStatus::DISCONNECTED), 
+    ssl_context_(nullptr), ssl_connection_(nullptr), header_block_valid_(false), 
+    header_block_has_content_type_(false), max_retry_attempts_(3), retry_delay_ms_(1000) {}
 
 NetworkClient::~NetworkClient() { shutdown(); }
 
 bool NetworkClient::initialize(const NetworkConfig& config) {
     if (initialized_) return true;
     config_ = config;
+    invalidateHeaderBlock();
     device_info_.populate();
+    
+    http::Engine::Options options;
+    if (config_.timeout_ms > 0) options.request_timeout_ms = config_.timeout_ms;
+    engine_ = std::make_unique<http::Engine>(options);
+    if (!engine_->start()) {
+        setError("Cannot start HTTP engine", errno);
+        engine_.reset();
+        return false;
+    }
     initialized_ = true;
     return true;
 }
 
 void NetworkClient::shutdown() {
     disconnect();
+    if (engine_) {
+        engine_->stop();    // Fails outstanding requests
+        engine_.reset();
+    }
     initialized_ = false;
 }
 
@@ -44,6 +64,22 @@ ServerResponse NetworkClient::post(const std::string& endpoint, const std::strin
     return sendRequest("POST", config_.server_url + endpoint, data);
 }
 
+ServerResponse NetworkClient::put(const std::string& endpoint, const std::string& data) {
+    return sendRequest("PUT", config_.server_url + endpoint, data);
+}
+
+ServerResponse NetworkClient::del(const std::string& endpoint) {
+    return sendRequest("DELETE", config_.server_url + endpoint);
+}
+
+void NetworkClient::getAsync(const std::string& endpoint, ResponseCallback callback) {
+    sendRequestAsync("GET", config_.server_url + endpoint, "", std::move(callback));
+}
+
+void NetworkClient::postAsync(const std::string& endpoint, std::string data, ResponseCallback callback) {
+    sendRequestAsync("POST", config_.server_url + endpoint, std::move(data), std::move(callback));
+}
+
 bool NetworkClient::checkLicense(const std::string& license_key) {
     return true; // Stub
 }
@@ -64,15 +100,243 @@ std::string NetworkClient::getGameVersion() { return "3.1.0"; }
 std::string NetworkClient::getTelegramUrl() { return "https://t.me/example"; }
 uint64_t NetworkClient::getServerTime() { return 0; }
 
-ServerResponse NetworkClient::sendRequest(const std::string& method, const std::string& url, const std::string& data) {
+ServerResponse NetworkClient::uploadFile(const std::string& endpoint, const std::string& file_path) {
+    int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        int error = errno;
+        if (fd >= 0) ::close(fd);
+        setError("Cannot open " + file_path, error);
+        ServerResponse failure;
+        failure.error_message = "Cannot open " + file_path;
+        return failure;
+    }
+
+    // Sent from the page cache with sendfile()
+    http::Request request;
     ServerResponse response;
-    response.status_code = 200;
-    response.success = true;
+    http::Body body = http::Body::file(fd, 0, static_cast<size_t>(st.st_size));
+    if (prepareRequest("POST", config_.server_url + endpoint, std::move(body),
+                       "application/octet-stream", request, response)) {
+        response = parseResponse(engine_->send(std::move(request)));
+    }
+    ::close(fd);
     return response;
 }
 
+ServerResponse NetworkClient::sendRequest(const std::string& method, const std::string& url, const std::string& data) {
+    http::Request request;
+    ServerResponse failure;
+    if (!prepareRequest(method, url, http::Body::memory(data.data(), data.size()),
+                        nullptr, request, failure)) {
+        return failure;
+    }
+    return parseResponse(engine_->send(std::move(request)));
+}
+
+void NetworkClient::sendRequestAsync(const std::string& method, const std::string& url,
+                                     std::string data, ResponseCallback callback) {
+    // The request owns the body until the engine is done with it
+    auto owned = std::make_shared<const std::string>(std::move(data));
+    http::Body body = http::Body::memory(owned->data(), owned->size());
+    body.owner = owned;
+
+    http::Request request;
+    ServerResponse failure;
+    if (!prepareRequest(method, url, std::move(body), nullptr, request, failure)) {
+        callback(std::move(failure));
+        return;
+    }
+    engine_->submit(std::move(request), [this, callback = std::move(callback)](http::Response&& response) {
+        callback(parseResponse(std::move(response)));
+    });
+}
+
+bool NetworkClient::prepareRequest(const std::string& method, const std::string& url,
+                                   http::Body body, const char* content_type,
+                                   http::Request& request, ServerResponse& failure) {
+    std::string protocol, host, path;
+    int port = 0;
+    const char* error = nullptr;
+    if (!engine_) {
+        error = "Network client not initialized";
+    } else if (!parseUrl(url, protocol, host, port, path)) {
+        error = "Invalid URL";
+    } else if (protocol != "http") {
+        error = "TLS transport not available";
+    }
+    if (error) {
+        setError(error, EINVAL);
+        failure.error_message = error;
+        return false;
+    }
+
+    std::string host_header = (port == 80) ? host : host + ':' + std::to_string(port);
+    request.method = method;
+    request.host = std::move(host);
+    request.port = port;
+    buildRequest(method, path, host_header, body, content_type, request.head);
+    request.body = std::move(body);
+    request.timeout_ms = config_.timeout_ms;
+    return true;
+}
+
+void NetworkClient::buildRequest(const std::string& method, const std::string& path,
+                                 const std::string& host, const http::Body& body,
+                                 const char* content_type, std::string& head) {
+    std::lock_guard<std::mutex> lock(headers_mutex_);
+    if (!header_block_valid_) {
+        header_block_.clear();
+        header_block_.append("User-Agent: ")
+                     .append(config_.user_agent.empty() ? constants::DEFAULT_USER_AGENT : config_.user_agent)
+                     .append("\r\n");
+        if (!config_.auth_token.empty()) {
+            header_block_.append("Authorization: Bearer ").append(config_.auth_token).append("\r\n");
+        }
+        for (const auto& header : custom_headers_) {
+            header_block_.append(header.first).append(": ").append(header.second).append("\r\n");
+        }
+        header_block_has_content_type_ = custom_headers_.count("Content-Type") > 0;
+        header_block_valid_ = true;
+    }
+
+    bool framed = body.size > 0 || method == "POST" || method == "PUT";
+    head.clear();
+    head.reserve(method.size() + path.size() + host.size() + header_block_.size() + 96);
+    head.append(method).append(" ").append(path).append(" HTTP/1.1\r\n");
+    head.append("Host: ").append(host).append("\r\n");
+    head.append(header_block_);
+    if (framed) {
+        if (!header_block_has_content_type_) {
+            head.append("Content-Type: ").append(content_type ? content_type : "application/json").append("\r\n");
+        }
+        head.append("Content-Length: ");
+        utils::StringUtils::appendUnsigned(head, body.size);
+        head.append("\r\n");
+    }
+    head.append("\r\n");
+}
+
+void NetworkClient::invalidateHeaderBlock() {
+    std::lock_guard<std::mutex> lock(headers_mutex_);
+    header_block_valid_ = false;
+}
+
+bool NetworkClient::parseUrl(const std::string& url, std::string& protocol,
+                             std::string& host, int& port, std::string& path) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        return false;
+    }
+    protocol = utils::StringUtils::toLower(url.substr(0, scheme_end));
+
+    size_t host_start = scheme_end + 3;
+    size_t path_start = url.find_first_of("/?#", host_start);
+    std::string authority = url.substr(host_start, path_start - host_start);
+    path = (path_start == std::string::npos) ? "/" : url.substr(path_start);
+    if (path[0] != '/') {
+        path.insert(0, 1, '/');
+    }
+    path = path.substr(0, path.find('#'));
+
+    port = (protocol == "https") ? 443 : 80;
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos && authority.find(']', colon) == std::string::npos) {
+        int parsed = utils::StringUtils::toInt(std::string_view(authority).substr(colon + 1), -1);
+        if (parsed <= 0 || parsed > 65535) {
+            return false;
+        }
+        port = parsed;
+        authority.resize(colon);
+    }
+    // Bracketed IPv6 literal
+    if (authority.size() >= 2 && authority.front() == '[' && authority.back() == ']') {
+        authority = authority.substr(1, authority.size() - 2);
+    }
+    host = std::move(authority);
+    return !host.empty();
+}
+
+ServerResponse NetworkClient::parseResponse(http::Response&& response) {
+    ServerResponse result;
+    if (!response.ok()) {
+        setError(response.error_message, response.error);
+        result.error_message = std::move(response.error_message);
+    } else {
+        result.status_code = response.status_code;
+        result.success = response.status_code >= 200 && response.status_code < 300;
+        if (!result.success) {
+            result.error_message = std::move(response.reason);
+        }
+        result.body = std::move(response.body);
+    }
+    result.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    return result;
+}
+
+std::string NetworkClient::createJsonRequest(const std::map<std::string, std::string>& data) {
+    std::string out;
+    out.reserve(2 + data.size() * 32);
+    json::Writer writer(out);
+    writer.beginObject();
+    for (const auto& entry : data) {
+        writer.key(entry.first).value(entry.second);
+    }
+    writer.endObject();
+    return out;
+}
+
+bool NetworkClient::parseJsonResponse(std::string_view json, json::Document& doc) {
+    if (!doc.parse(json)) {
+        setError(std::string("Invalid JSON at offset ") + std::to_string(doc.errorOffset()) +
+                 ": " + doc.error());
+        return false;
+    }
+    return true;
+}
+
+void NetworkClient::setError(const std::string& error, int code) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = error;
+    last_error_code_ = code;
+}
+
+void NetworkClient::clearError() {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_.clear();
+    last_error_code_ = 0;
+}
+
 void NetworkClient::setServerUrl(const std::string& url) { config_.server_url = url; }
 void NetworkClient::setTimeout(int timeout_ms) { config_.timeout_ms = timeout_ms; }
-void NetworkClient::setAuthToken(const std::string& token) { config_.auth_token = token; }
+// Both are rendered into header_block_ by buildRequest() on submitting
+// threads, so they change under the same lock
+void NetworkClient::setAuthToken(const std::string& token) {
+    std::lock_guard<std::mutex> lock(headers_mutex_);
+    config_.auth_token = token;
+    header_block_valid_ = false;
+}
+
+void NetworkClient::setUserAgent(const std::string& user_agent) {
+    std::lock_guard<std::mutex> lock(headers_mutex_);
+    config_.user_agent = user_agent;
+    header_block_valid_ = false;
+}
+
+void NetworkClient::addHeader(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(headers_mutex_);
+    custom_headers_[key] = value;
+    header_block_valid_ = false;
+}
+
+void NetworkClient::removeHeader(const std::string& key) {
+    std::lock_guard<std::mutex> lock(headers_mutex_);
+    auto it = custom_headers_.find(std::string_view(key));
+    if (it != custom_headers_.end()) {
+        custom_headers_.erase(it);
+        header_block_valid_ = false;
+    }
+}
 
 } // namespace client
@@ -1,11 +1,25 @@
 #include "../include/internal/platform_specific.h"
-#include <fstream>
+#include "common/thread_pool.h"
+#include "common/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <cstring>
 #include <chrono>
 #include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <linux/stat.h>
 
 namespace client {
 namespace platform {
@@ -52,6 +66,211 @@ bool FileSystem::createDirectory(const std::string& path, bool recursive) {
     return mkdir(path.c_str(), 0755) == 0;
 }
 
+namespace {
+
+// Buffer for the userspace copy fallback; large enough that syscall
+// overhead is negligible next to the memcpy
+constexpr size_t kCopyBufferSize = 256 * 1024;
+
+int openRetry(const char* path, int flags, mode_t mode = 0) {
+    int fd;
+    do {
+        fd = open(path, flags | O_CLOEXEC, mode);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Whole-file read straight into data: sized from fstat for regular files
+// (plus a spare byte so the read that sees EOF needs no grow), grown until
+// EOF for files that report no size (procfs, sysfs, pipes). No mapping, so
+// a file truncated underneath just reads short.
+template <typename Container>
+bool readAll(const std::string& path, Container& data) {
+    int fd = openRetry(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    size_t capacity = 4096;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        capacity = static_cast<size_t>(st.st_size) + 1;
+    }
+    data.resize(capacity);
+
+    size_t length = 0;
+    for (;;) {
+        if (length == data.size()) {
+            data.resize(data.size() * 2);
+        }
+        ssize_t n = pread(fd, &data[length], data.size() - length, static_cast<off_t>(length));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            close(fd);
+            data.clear();
+            return false;
+        }
+        if (n == 0) break;
+        length += static_cast<size_t>(n);
+    }
+    close(fd);
+    data.resize(length);
+    return true;
+}
+
+// copy_file_range is called through syscall(): bionic only exports the
+// wrapper from API 34, but the kernel has had it since 4.5
+ssize_t copyFileRange(int in_fd, off_t* in_off, int out_fd, off_t* out_off, size_t len) {
+#if defined(__NR_copy_file_range)
+    return syscall(__NR_copy_file_range, in_fd, in_off, out_fd, out_off, len, 0u);
+#else
+    (void)in_fd; (void)in_off; (void)out_fd; (void)out_off; (void)len;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+bool copyFd(int in_fd, int out_fd, uint64_t size) {
+    off_t offset = 0;
+    const off_t end = static_cast<off_t>(size);
+
+    // 1. Entirely in the kernel; may share extents on reflink filesystems
+    while (offset < end) {
+        off_t out_off = offset;
+        ssize_t n = copyFileRange(in_fd, &offset, out_fd, &out_off, static_cast<size_t>(end - offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;  // Unsupported (ENOSYS/EXDEV/EINVAL) or EOF
+    }
+    if (offset >= end) return true;
+
+    // 2. sendfile: still no userspace copy. It writes at the current file
+    // position, so line that up with what copy_file_range already wrote.
+    if (lseek(out_fd, offset, SEEK_SET) < 0) return false;
+    while (offset < end) {
+        ssize_t n = sendfile(out_fd, in_fd, &offset, static_cast<size_t>(end - offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+    }
+    if (offset >= end) return true;
+
+    // 3. Plain read/write for anything left (e.g. sources that shrank, or
+    // file types neither syscall supports)
+    if (lseek(out_fd, offset, SEEK_SET) < 0) return false;
+    std::vector<uint8_t> buffer(kCopyBufferSize);
+    for (;;) {
+        ssize_t n = pread(in_fd, buffer.data(), buffer.size(), offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return false;
+        if (n == 0) return true;
+        if (!writeAll(out_fd, buffer.data(), static_cast<size_t>(n))) return false;
+        offset += n;
+    }
+}
+
+// Temp sibling of path: same directory so rename() stays atomic
+std::string tempPathFor(const std::string& path) {
+    static std::atomic<uint32_t> counter(0);
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), ".tmp.%d.%u", static_cast<int>(getpid()),
+             counter.fetch_add(1, std::memory_order_relaxed));
+    return path + suffix;
+}
+
+// Create temp_path with data, carrying over the permissions of the file it
+// will replace (new files get 0644); the fd is returned open for syncing
+int writeTemp(const std::string& path, const std::string& temp_path, const void* data, size_t size) {
+    struct stat st;
+    bool replacing = stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+    mode_t mode = replacing ? (st.st_mode & 07777) : 0644;
+
+    int fd = openRetry(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, mode);
+    if (fd < 0) return -1;
+    // open() applies the umask; the replaced file's mode must survive as is
+    if ((replacing && fchmod(fd, mode) != 0) || !writeAll(fd, data, size)) {
+        close(fd);
+        unlink(temp_path.c_str());
+        return -1;
+    }
+    return fd;
+}
+
+bool syncDirectoryOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = openRetry(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+bool syncFilesystem(int fd) {
+#if defined(__NR_syncfs)
+    return syscall(__NR_syncfs, fd) == 0;
+#else
+    sync();
+    (void)fd;
+    return true;
+#endif
+}
+
+} // namespace
+
+bool FileSystem::copy(const std::string& source, const std::string& destination) {
+    COMMON_TRACE_SCOPE("FileSystem::copy");
+    int in_fd = openRetry(source.c_str(), O_RDONLY);
+    if (in_fd < 0) return false;
+
+    struct stat st;
+    if (fstat(in_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(in_fd);
+        return false;
+    }
+
+    // Truncate only after checking the destination isn't the source itself
+    // (same path, hard link or another alias), which would empty it first
+    int out_fd = openRetry(destination.c_str(), O_WRONLY | O_CREAT, st.st_mode & 0777);
+    if (out_fd < 0) {
+        close(in_fd);
+        return false;
+    }
+    struct stat out_st;
+    bool ok = fstat(out_fd, &out_st) == 0;
+    if (ok && out_st.st_dev == st.st_dev && out_st.st_ino == st.st_ino) {
+        errno = EINVAL;
+        ok = false;
+    }
+    if (!ok || ftruncate(out_fd, 0) != 0) {
+        int saved_errno = errno;
+        close(out_fd);
+        close(in_fd);
+        errno = saved_errno;
+        return false;
+    }
+
+    ok = copyFd(in_fd, out_fd, static_cast<uint64_t>(st.st_size));
+    close(in_fd);
+    if (close(out_fd) != 0) ok = false;
+    return ok;
+}
+
+bool FileSystem::move(const std::string& source, const std::string& destination) {
+    COMMON_TRACE_SCOPE("FileSystem::move");
+    if (rename(source.c_str(), destination.c_str()) == 0) return true;
+    if (errno != EXDEV) return false;
+    return copy(source, destination) && ::unlink(source.c_str()) == 0;
+}
+
 bool FileSystem::remove(const std::string& path) {
     return ::remove(path.c_str()) == 0;
 }
@@ -66,66 +285,326 @@ uint64_t FileSystem::getModificationTime(const std::string& path) {
     return stat(path.c_str(), &st) == 0 ? st.st_mtime : 0;
 }
 
+bool FileSystem::mapFile(const std::string& path, common::MappedFile& file,
+                         common::MappedFile::Access access) {
+    return file.open(path.c_str(), access);
+}
+
 bool FileSystem::readFile(const std::string& path, std::string& data) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) return false;
-    
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    data.resize(size);
-    file.read(&data[0], size);
-    
-    return file.good();
+    COMMON_TRACE_SCOPE("FileSystem::readFile");
+    return readAll(path, data);
 }
 
 bool FileSystem::readFile(const std::string& path, std::vector<uint8_t>& data) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) return false;
-    
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    data.resize(size);
-    file.read(reinterpret_cast<char*>(data.data()), size);
-    
-    return file.good();
+    COMMON_TRACE_SCOPE("FileSystem::readFile");
+    return readAll(path, data);
 }
 
-bool FileSystem::writeFile(const std::string& path, const std::string& data) {
-    std::ofstream file(path, std::ios::binary);
-    if (!file) return false;
-    
-    file.write(data.data(), data.size());
-    return file.good();
+bool FileSystem::writeFile(const std::string& path, const std::string& data, WriteMode mode) {
+    return writeFile(path, data.data(), data.size(), mode);
 }
 
-bool FileSystem::writeFile(const std::string& path, const std::vector<uint8_t>& data) {
-    std::ofstream file(path, std::ios::binary);
-    if (!file) return false;
-    
-    file.write(reinterpret_cast<const char*>(data.data()), data.size());
-    return file.good();
+bool FileSystem::writeFile(const std::string& path, const std::vector<uint8_t>& data, WriteMode mode) {
+    return writeFile(path, data.data(), data.size(), mode);
+}
+
+bool FileSystem::writeFile(const std::string& path, const void* data, size_t size, WriteMode mode) {
+    COMMON_TRACE_SCOPE("FileSystem::writeFile");
+    if (mode == WriteMode::InPlace) {
+        int fd = openRetry(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        bool ok = writeAll(fd, data, size);
+        return close(fd) == 0 && ok;
+    }
+
+    std::string temp_path = tempPathFor(path);
+    int fd = writeTemp(path, temp_path, data, size);
+    if (fd < 0) return false;
+
+    // Without the data sync a crash after the rename can leave an empty
+    // file under the final name
+    bool ok = mode != WriteMode::Durable || fdatasync(fd) == 0;
+    if (close(fd) != 0) ok = false;
+    if (!ok || rename(temp_path.c_str(), path.c_str()) != 0) {
+        unlink(temp_path.c_str());
+        return false;
+    }
+    return mode != WriteMode::Durable || syncDirectoryOf(path);
 }
 
 std::vector<std::string> FileSystem::listFiles(const std::string& directory) {
     std::vector<std::string> files;
-    DIR* dir = opendir(directory.c_str());
-    if (!dir) return files;
-    
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_type == DT_REG) {
-            files.push_back(entry->d_name);
+    DirectoryScanner scanner;
+    scanner.scan(directory, [&](const DirectoryEntry& entry) {
+        if (entry.type == DirectoryEntry::File) {
+            files.emplace_back(entry.name);
         }
-    }
-    closedir(dir);
-    
+        return true;
+    }, DirectoryScanner::kStatType);
     return files;
 }
 
+std::vector<std::string> FileSystem::listDirectories(const std::string& directory) {
+    std::vector<std::string> directories;
+    DirectoryScanner scanner;
+    scanner.scan(directory, [&](const DirectoryEntry& entry) {
+        if (entry.type == DirectoryEntry::Directory) {
+            directories.emplace_back(entry.name);
+        }
+        return true;
+    }, DirectoryScanner::kStatType);
+    return directories;
+}
+
+// DirectoryScanner implementations
+namespace {
+
+// Kernel record layout for getdents64; not exported by bionic or glibc
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    uint16_t d_reclen;
+    uint8_t d_type;
+    char d_name[1];
+};
+
+DirectoryEntry::Type typeFromDirent(uint8_t d_type) {
+    switch (d_type) {
+        case DT_REG: return DirectoryEntry::File;
+        case DT_DIR: return DirectoryEntry::Directory;
+        case DT_LNK: return DirectoryEntry::Symlink;
+        case DT_UNKNOWN: return DirectoryEntry::Unknown;
+        default: return DirectoryEntry::Other;
+    }
+}
+
+DirectoryEntry::Type typeFromMode(uint32_t mode) {
+    if (S_ISREG(mode)) return DirectoryEntry::File;
+    if (S_ISDIR(mode)) return DirectoryEntry::Directory;
+    if (S_ISLNK(mode)) return DirectoryEntry::Symlink;
+    return DirectoryEntry::Other;
+}
+
+// Cleared on the first ENOSYS so older kernels go straight to fstatat
+std::atomic<bool> g_statx_supported(true);
+
+// Fill the requested fields of entry; name must be NUL-terminated
+void statEntry(int dir_fd, const char* name, DirectoryEntry& entry, uint32_t stat_fields) {
+    bool need_type = (stat_fields & DirectoryScanner::kStatType) && entry.type == DirectoryEntry::Unknown;
+
+#if defined(__NR_statx) && defined(STATX_BASIC_STATS)
+    if (g_statx_supported.load(std::memory_order_relaxed)) {
+        unsigned int mask = 0;
+        if (need_type) mask |= STATX_TYPE;
+        if (stat_fields & DirectoryScanner::kStatSize) mask |= STATX_SIZE;
+        if (stat_fields & DirectoryScanner::kStatMtime) mask |= STATX_MTIME;
+
+        struct statx stx;
+        if (syscall(__NR_statx, dir_fd, name, AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC, mask, &stx) == 0) {
+            if (need_type) entry.type = typeFromMode(stx.stx_mode);
+            entry.size = stx.stx_size;
+            entry.mtime = static_cast<uint64_t>(stx.stx_mtime.tv_sec);
+            return;
+        }
+        if (errno != ENOSYS) return;
+        g_statx_supported.store(false, std::memory_order_relaxed);
+    }
+#endif
+
+    struct stat st;
+    if (fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+        if (need_type) entry.type = typeFromMode(st.st_mode);
+        entry.size = static_cast<uint64_t>(st.st_size);
+        entry.mtime = static_cast<uint64_t>(st.st_mtime);
+    }
+}
+
+bool isDotOrDotDot(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+} // namespace
+
+DirectoryScanner::DirectoryScanner(size_t buffer_size)
+    : arena_(std::max<size_t>(buffer_size, 4096)) {}
+
+bool DirectoryScanner::scan(const std::string& directory, const Visitor& visitor, uint32_t stat_fields) {
+    COMMON_TRACE_SCOPE("DirectoryScanner::scan");
+    int fd = openRetry(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = scanFd(fd, visitor, stat_fields);
+    close(fd);
+    return ok;
+}
+
+bool DirectoryScanner::scanFd(int dir_fd, const Visitor& visitor, uint32_t stat_fields) {
+    for (;;) {
+        long n = syscall(__NR_getdents64, dir_fd, arena_.data(), arena_.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return false;
+        if (n == 0) return true;
+
+        // Decode the whole getdents batch first so the stat calls for it run
+        // back to back. That is still one statx (or fstatat) per entry that
+        // needs one; there is no multi-entry stat syscall to batch them into
+        batch_.clear();
+        for (long off = 0; off < n;) {
+            const LinuxDirent64* d = reinterpret_cast<const LinuxDirent64*>(arena_.data() + off);
+            off += d->d_reclen;
+            if (isDotOrDotDot(d->d_name)) continue;
+
+            DirectoryEntry entry;
+            entry.name = std::string_view(d->d_name);
+            entry.type = typeFromDirent(d->d_type);
+            entry.inode = d->d_ino;
+            entry.size = 0;
+            entry.mtime = 0;
+            batch_.push_back(entry);
+        }
+
+        uint32_t fields = stat_fields & ~kStatType;
+        for (DirectoryEntry& entry : batch_) {
+            if (fields != 0 || ((stat_fields & kStatType) && entry.type == DirectoryEntry::Unknown)) {
+                // Names in the arena are NUL-terminated by the kernel
+                statEntry(dir_fd, entry.name.data(), entry, stat_fields);
+            }
+        }
+
+        for (const DirectoryEntry& entry : batch_) {
+            if (!visitor(entry)) return true;
+        }
+    }
+}
+
+bool DirectoryScanner::scanRecursive(const std::string& root, const RecursiveVisitor& visitor,
+                                     uint32_t stat_fields, unsigned max_threads) {
+    COMMON_TRACE_SCOPE("DirectoryScanner::scanRecursive");
+    // Subdirectories need a type even on filesystems without d_type
+    stat_fields |= kStatType;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> pending{root};
+    size_t active = 0;
+    bool root_ok = true;
+
+    auto worker = [&]() {
+        DirectoryScanner scanner;
+        std::vector<std::string> subdirs;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [&] { return !pending.empty() || active == 0; });
+            if (pending.empty()) break;  // Nothing queued and nobody left to queue more
+
+            std::string dir = std::move(pending.front());
+            pending.pop_front();
+            ++active;
+            lock.unlock();
+
+            subdirs.clear();
+            bool ok = scanner.scan(dir, [&](const DirectoryEntry& entry) {
+                visitor(dir, entry);
+                if (entry.type == DirectoryEntry::Directory) {
+                    std::string child;
+                    child.reserve(dir.size() + 1 + entry.name.size());
+                    child.append(dir);
+                    if (child.empty() || child.back() != '/') child.push_back('/');
+                    child.append(entry.name);
+                    subdirs.push_back(std::move(child));
+                }
+                return true;
+            }, stat_fields);
+
+            lock.lock();
+            if (!ok && dir == root) root_ok = false;
+            for (std::string& sub : subdirs) {
+                pending.push_back(std::move(sub));
+            }
+            --active;
+            cv.notify_all();
+        }
+    };
+
+    // Each index is a whole worker loop; one that starts after the scan has
+    // drained finds nothing pending and returns at once
+    unsigned threads = std::max(1u, max_threads);
+    common::ThreadPool::shared().parallelFor(threads, [&](size_t) { worker(); }, threads);
+    return root_ok;
+}
+
+// FileWriteBatch implementations
+FileWriteBatch::~FileWriteBatch() {
+    abort();
+}
+
+bool FileWriteBatch::add(const std::string& path, const void* data, size_t size) {
+    std::string temp_path = tempPathFor(path);
+    int fd = writeTemp(path, temp_path, data, size);
+    if (fd < 0) return false;
+    close(fd);
+    entries_.push_back({path, std::move(temp_path)});
+    return true;
+}
+
+bool FileWriteBatch::commit(bool durable) {
+    COMMON_TRACE_SCOPE("FileWriteBatch::commit");
+    if (entries_.empty()) return true;
+
+    // One syncfs per filesystem flushes every temp file's data, standing
+    // in for an fdatasync on each
+    std::set<dev_t> synced;
+    for (const Entry& entry : entries_) {
+        struct stat st;
+        if (stat(entry.temp_path.c_str(), &st) != 0) {
+            abort();
+            return false;
+        }
+        if (synced.insert(st.st_dev).second) {
+            int fd = openRetry(entry.temp_path.c_str(), O_RDONLY);
+            bool ok = fd >= 0 && syncFilesystem(fd);
+            if (fd >= 0) close(fd);
+            if (!ok) {
+                abort();
+                return false;
+            }
+        }
+    }
+
+    bool ok = true;
+    size_t renamed = 0;
+    for (; renamed < entries_.size(); ++renamed) {
+        const Entry& entry = entries_[renamed];
+        if (rename(entry.temp_path.c_str(), entry.path.c_str()) != 0) {
+            ok = false;
+            break;
+        }
+    }
+
+    // Second round persists the directory entries the renames changed
+    if (ok && durable) {
+        synced.clear();
+        for (const Entry& entry : entries_) {
+            struct stat st;
+            if (stat(entry.path.c_str(), &st) == 0 && synced.insert(st.st_dev).second) {
+                int fd = openRetry(entry.path.c_str(), O_RDONLY);
+                if (fd < 0 || !syncFilesystem(fd)) ok = false;
+                if (fd >= 0) close(fd);
+            }
+        }
+    }
+
+    entries_.erase(entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(renamed));
+    abort();
+    return ok;
+}
+
+void FileWriteBatch::abort() {
+    for (const Entry& entry : entries_) {
+        unlink(entry.temp_path.c_str());
+    }
+    entries_.clear();
+}
+
 // Process implementations
 pid_t Process::getCurrentPid() {
     return getpid();
@@ -155,20 +634,18 @@ bool Process::isProcessRunning(const std::string& process_name) {
 
 std::vector<pid_t> Process::getAllProcesses() {
     std::vector<pid_t> pids;
-    DIR* dir = opendir("/proc");
-    if (!dir) return pids;
-    
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_type == DT_DIR) {
-            pid_t pid = atoi(entry->d_name);
-            if (pid > 0) {
-                pids.push_back(pid);
+    DirectoryScanner scanner;
+    scanner.scan("/proc", [&](const DirectoryEntry& entry) {
+        if (entry.type == DirectoryEntry::Directory && entry.name[0] >= '1' && entry.name[0] <= '9') {
+            pid_t pid = 0;
+            for (char c : entry.name) {
+                if (c < '0' || c > '9') return true;
+                pid = pid * 10 + (c - '0');
             }
+            pids.push_back(pid);
         }
-    }
-    closedir(dir);
-    
+        return true;
+    });
     return pids;
 }
 
@@ -1,12 +1,12 @@
 #include "../include/plugin_manager.h"
-#include <android/log.h>
+#include "common/log.h"
 
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "PluginManager", __VA_ARGS__)
+#define LOGI(...) COMMON_LOGI("PluginManager", __VA_ARGS__)
 
 namespace client {
 
 PluginManager::PluginManager() 
-    : initialized_(false), auto_update_enabled_(false), should_stop_(false),
+    : initialized_(false), auto_update_enabled_(false),
       network_client_(nullptr), update_check_interval_ms_(300000), 
       verify_signatures_(true), allow_downgrades_(false) {
 }
@@ -84,19 +84,15 @@ bool PluginManager::isPluginLoaded(const std::string& plugin_name) const {
 void PluginManager::enableAutoUpdate(bool enable) {
     auto_update_enabled_ = enable;
     if (enable) {
-        should_stop_ = false;
-        update_thread_ = std::make_unique<std::thread>(&PluginManager::updateCheckThreadFunc, this);
+        update_task_.start(std::chrono::milliseconds(update_check_interval_ms_),
+                           [this]() { performUpdateCheck(); });
     } else {
         stopAutoUpdate();
     }
 }
 
 void PluginManager::stopAutoUpdate() {
-    should_stop_ = true;
-    if (update_thread_ && update_thread_->joinable()) {
-        update_thread_->join();
-    }
-    update_thread_.reset();
+    update_task_.stop();
 }
 
 void PluginManager::checkForUpdates() {
@@ -155,13 +151,6 @@ bool PluginManager::validatePlugin(const std::string& plugin_path) {
     return true; // Stub
 }
 
-void PluginManager::updateCheckThreadFunc() {
-    while (!should_stop_) {
-        performUpdateCheck();
-        std::this_thread::sleep_for(std::chrono::milliseconds(update_check_interval_ms_));
-    }
-}
-
 void PluginManager::performUpdateCheck() {
     // Stub implementation
 }
@@ -1,9 +1,9 @@
 #include "../include/render_engine.h"
-#include <android/log.h>
+#include "common/log.h"
 #include <thread>
 
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "RenderEngine", __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "RenderEngine", __VA_ARGS__)
+#define LOGI(...) COMMON_LOGI("RenderEngine", __VA_ARGS__)
+#define LOGE(...) COMMON_LOGE("RenderEngine", __VA_ARGS__)
 
 namespace client {
 
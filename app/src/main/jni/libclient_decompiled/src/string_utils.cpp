@@ -1,196 +1,510 @@
 #include "../include/internal/string_utils.h"
+#include "../include/internal/simd.h"
 #include <algorithm>
 #include <cctype>
-#include <sstream>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
 #include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 namespace client {
 namespace utils {
 
+static const char kWhitespace[] = " \t\n\r";
+
+// SplitRange implementation
+SplitRange::iterator::iterator(const SplitRange* range, size_t pos)
+    : range_(range), pos_(pos), done_(false) {
+    advance();
+}
+
+SplitRange::iterator& SplitRange::iterator::operator++() {
+    if (pos_ > range_->str_.size()) {
+        done_ = true;
+    } else {
+        advance();
+    }
+    return *this;
+}
+
+void SplitRange::iterator::advance() {
+    std::string_view str = range_->str_;
+    std::string_view delimiter = range_->delimiter_;
+
+    size_t end = delimiter.empty()
+        ? str.size()
+        : simd::findSubstring(str.data(), str.size(), delimiter.data(), delimiter.size(), pos_);
+    if (end == str.size()) {
+        current_ = str.substr(pos_);
+        pos_ = str.size() + 1;   // Past the end: next increment finishes
+    } else {
+        current_ = str.substr(pos_, end - pos_);
+        pos_ = end + delimiter.size();
+    }
+}
+
+std::string_view StringUtils::trimView(std::string_view str) {
+    return trimRightView(trimLeftView(str));
+}
+
+std::string_view StringUtils::trimLeftView(std::string_view str) {
+    size_t first = str.find_first_not_of(kWhitespace);
+    return first == std::string_view::npos ? std::string_view() : str.substr(first);
+}
+
+std::string_view StringUtils::trimRightView(std::string_view str) {
+    size_t last = str.find_last_not_of(kWhitespace);
+    return last == std::string_view::npos ? std::string_view() : str.substr(0, last + 1);
+}
+
+std::string_view StringUtils::substringView(std::string_view str, size_t start, size_t length) {
+    if (start >= str.size()) {
+        return std::string_view();
+    }
+    return str.substr(start, length);
+}
+
+size_t StringUtils::split(std::string_view str, char delimiter, std::vector<std::string_view>& out) {
+    out.clear();
+    size_t start = 0;
+    simd::forEachByte(str.data(), str.size(), delimiter, [&](size_t pos) {
+        out.emplace_back(str.data() + start, pos - start);
+        start = pos + 1;
+    });
+    out.emplace_back(str.data() + start, str.size() - start);
+    return out.size();
+}
+
+size_t StringUtils::split(std::string_view str, std::string_view delimiter,
+                          std::vector<std::string_view>& out) {
+    if (delimiter.size() == 1) {
+        return split(str, delimiter[0], out);
+    }
+
+    out.clear();
+    if (delimiter.empty()) {
+        out.push_back(str);
+        return out.size();
+    }
+
+    size_t start = 0;
+    size_t end;
+    while ((end = simd::findSubstring(str.data(), str.size(), delimiter.data(),
+                                      delimiter.size(), start)) != str.size()) {
+        out.emplace_back(str.data() + start, end - start);
+        start = end + delimiter.size();
+    }
+    out.emplace_back(str.data() + start, str.size() - start);
+    return out.size();
+}
+
 std::string StringUtils::trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\n\r");
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(" \t\n\r");
-    return str.substr(first, last - first + 1);
+    return std::string(trimView(str));
 }
 
 std::string StringUtils::trimLeft(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\n\r");
-    return first == std::string::npos ? "" : str.substr(first);
+    return std::string(trimLeftView(str));
 }
 
 std::string StringUtils::trimRight(const std::string& str) {
-    size_t last = str.find_last_not_of(" \t\n\r");
-    return last == std::string::npos ? "" : str.substr(0, last + 1);
+    return std::string(trimRightView(str));
 }
 
-std::string StringUtils::toLower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                  [](unsigned char c){ return std::tolower(c); });
+std::string StringUtils::substring(const std::string& str, size_t start, size_t length) {
+    return std::string(substringView(str, start, length));
+}
+
+std::string StringUtils::toLower(std::string_view str) {
+    std::string result(str.size(), '\0');
+    simd::toLowerAscii(str.data(), &result[0], str.size());
     return result;
 }
 
-std::string StringUtils::toUpper(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                  [](unsigned char c){ return std::toupper(c); });
+std::string StringUtils::toUpper(std::string_view str) {
+    std::string result(str.size(), '\0');
+    simd::toUpperAscii(str.data(), &result[0], str.size());
     return result;
 }
 
+void StringUtils::toLowerInPlace(std::string& str) {
+    simd::toLowerAscii(str.data(), &str[0], str.size());
+}
+
+void StringUtils::toUpperInPlace(std::string& str) {
+    simd::toUpperAscii(str.data(), &str[0], str.size());
+}
+
 std::vector<std::string> StringUtils::split(const std::string& str, char delimiter) {
-    std::vector<std::string> tokens;
-    std::stringstream ss(str);
-    std::string token;
-    while (std::getline(ss, token, delimiter)) {
-        tokens.push_back(token);
+    std::vector<std::string_view> fields;
+    split(str, delimiter, fields);
+
+    // Keep the historical getline() behaviour: no trailing empty field
+    if (!fields.empty() && fields.back().empty()) {
+        fields.pop_back();
     }
-    return tokens;
+    return std::vector<std::string>(fields.begin(), fields.end());
 }
 
 std::vector<std::string> StringUtils::split(const std::string& str, const std::string& delimiter) {
     std::vector<std::string> tokens;
-    size_t start = 0;
-    size_t end = str.find(delimiter);
-    
-    while (end != std::string::npos) {
-        tokens.push_back(str.substr(start, end - start));
-        start = end + delimiter.length();
-        end = str.find(delimiter, start);
-    }
-    tokens.push_back(str.substr(start));
-    
+    for (std::string_view field : SplitRange(str, delimiter)) {
+        tokens.emplace_back(field);
+    }
     return tokens;
 }
 
-std::string StringUtils::join(const std::vector<std::string>& strings, const std::string& delimiter) {
+std::string StringUtils::join(const std::vector<std::string>& strings, std::string_view delimiter) {
     if (strings.empty()) return "";
-    
-    std::ostringstream oss;
-    oss << strings[0];
+
+    size_t total = delimiter.size() * (strings.size() - 1);
+    for (const std::string& s : strings) {
+        total += s.size();
+    }
+
+    std::string result;
+    result.reserve(total);
+    result += strings[0];
     for (size_t i = 1; i < strings.size(); ++i) {
-        oss << delimiter << strings[i];
+        result += delimiter;
+        result += strings[i];
     }
-    return oss.str();
+    return result;
 }
 
-std::string StringUtils::replace(const std::string& str, const std::string& from, const std::string& to) {
-    std::string result = str;
-    size_t pos = result.find(from);
+std::string StringUtils::replace(std::string_view str, std::string_view from, std::string_view to) {
+    std::string result(str);
+    size_t pos = from.empty() ? std::string::npos : str.find(from);
     if (pos != std::string::npos) {
         result.replace(pos, from.length(), to);
     }
     return result;
 }
 
-std::string StringUtils::replaceAll(const std::string& str, const std::string& from, const std::string& to) {
-    std::string result = str;
-    size_t pos = 0;
-    while ((pos = result.find(from, pos)) != std::string::npos) {
-        result.replace(pos, from.length(), to);
-        pos += to.length();
+std::string StringUtils::replaceAll(std::string_view str, std::string_view from, std::string_view to) {
+    if (from.empty()) {
+        return std::string(str);
+    }
+
+    // Pass 1: count matches so the result is allocated exactly once
+    const char* data = str.data();
+    const size_t len = str.size();
+    size_t matches = 0;
+    for (size_t pos = simd::findSubstring(data, len, from.data(), from.size());
+         pos < len;
+         pos = simd::findSubstring(data, len, from.data(), from.size(), pos + from.size())) {
+        ++matches;
+    }
+    if (matches == 0) {
+        return std::string(str);
     }
+
+    // Pass 2: copy the gaps and replacements straight into place
+    std::string result(len - matches * from.size() + matches * to.size(), '\0');
+    char* out = &result[0];
+    size_t last = 0;
+    for (size_t pos = simd::findSubstring(data, len, from.data(), from.size());
+         pos < len;
+         pos = simd::findSubstring(data, len, from.data(), from.size(), last)) {
+        std::memcpy(out, data + last, pos - last);
+        out += pos - last;
+        std::memcpy(out, to.data(), to.size());
+        out += to.size();
+        last = pos + from.size();
+    }
+    std::memcpy(out, data + last, len - last);
     return result;
 }
 
-bool StringUtils::startsWith(const std::string& str, const std::string& prefix) {
+bool StringUtils::startsWith(std::string_view str, std::string_view prefix) {
     return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
 }
 
-bool StringUtils::endsWith(const std::string& str, const std::string& suffix) {
+bool StringUtils::endsWith(std::string_view str, std::string_view suffix) {
     return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
 }
 
-bool StringUtils::contains(const std::string& str, const std::string& substring) {
-    return str.find(substring) != std::string::npos;
+bool StringUtils::contains(std::string_view str, std::string_view substring) {
+    return str.find(substring) != std::string_view::npos;
 }
 
-size_t StringUtils::count(const std::string& str, const std::string& substring) {
+size_t StringUtils::count(std::string_view str, std::string_view substring) {
+    if (substring.empty()) return 0;
     size_t count = 0;
     size_t pos = 0;
-    while ((pos = str.find(substring, pos)) != std::string::npos) {
+    while ((pos = str.find(substring, pos)) != std::string_view::npos) {
         ++count;
         pos += substring.length();
     }
     return count;
 }
 
-bool StringUtils::isNumeric(const std::string& str) {
-    return !str.empty() && std::all_of(str.begin(), str.end(), ::isdigit);
+bool StringUtils::isNumeric(std::string_view str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(),
+                                       [](unsigned char c) { return std::isdigit(c) != 0; });
 }
 
-bool StringUtils::isAlpha(const std::string& str) {
-    return !str.empty() && std::all_of(str.begin(), str.end(), ::isalpha);
+bool StringUtils::isAlpha(std::string_view str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(),
+                                       [](unsigned char c) { return std::isalpha(c) != 0; });
 }
 
-bool StringUtils::isAlphaNumeric(const std::string& str) {
-    return !str.empty() && std::all_of(str.begin(), str.end(), ::isalnum);
+bool StringUtils::isAlphaNumeric(std::string_view str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(),
+                                       [](unsigned char c) { return std::isalnum(c) != 0; });
 }
 
-int StringUtils::toInt(const std::string& str, int default_value) {
-    try {
-        return std::stoi(str);
-    } catch (...) {
-        return default_value;
-    }
+bool StringUtils::isHex(std::string_view str) {
+    return !str.empty() && std::all_of(str.begin(), str.end(),
+                                       [](unsigned char c) { return std::isxdigit(c) != 0; });
 }
 
-long StringUtils::toLong(const std::string& str, long default_value) {
-    try {
-        return std::stol(str);
-    } catch (...) {
-        return default_value;
+// ============================================================================
+// Numeric conversion
+// ============================================================================
+
+// Floating-point <charconv> is incomplete in older libc++ (the NDK's in
+// particular); fall back to a shortest-round-trip printf search there.
+#ifndef LIBCLIENT_HAS_FLOAT_CHARCONV
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define LIBCLIENT_HAS_FLOAT_CHARCONV 1
+#else
+#define LIBCLIENT_HAS_FLOAT_CHARCONV 0
+#endif
+#endif
+
+namespace {
+
+// Strip the prefix stoi/stod would have accepted but from_chars does not
+std::string_view numericPrefix(std::string_view str) {
+    size_t i = 0;
+    while (i < str.size() && std::isspace(static_cast<unsigned char>(str[i]))) {
+        ++i;
+    }
+    if (i + 1 < str.size() && str[i] == '+' && str[i + 1] != '-' && str[i + 1] != '+') {
+        ++i;
+    }
+    return str.substr(i);
+}
+
+template<typename T>
+bool parseInteger(std::string_view str, T& value) {
+    str = numericPrefix(str);
+    std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc();
+}
+
+template<typename T>
+bool parseFloating(std::string_view str, T& value) {
+    str = numericPrefix(str);
+#if LIBCLIENT_HAS_FLOAT_CHARCONV
+    std::from_chars_result result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc();
+#else
+    // strtod needs a terminated string; numbers longer than this are junk
+    char buf[128];
+    size_t len = std::min(str.size(), sizeof(buf) - 1);
+    std::memcpy(buf, str.data(), len);
+    buf[len] = '\0';
+
+    char* end = nullptr;
+    errno = 0;
+    T parsed = std::is_same<T, float>::value ? std::strtof(buf, &end) : std::strtod(buf, &end);
+    if (end == buf) {
+        return false;
+    }
+    // ERANGE is also raised for subnormals, which are valid; only reject
+    // overflow to infinity and a non-zero literal that underflowed to 0
+    if (errno == ERANGE && (std::isinf(parsed) || parsed == 0)) {
+        return false;
     }
+    value = parsed;
+    return true;
+#endif
+}
+
+#if !LIBCLIENT_HAS_FLOAT_CHARCONV
+size_t copyOut(char* buf, size_t capacity, const char* text, size_t len) {
+    if (len > capacity) return 0;
+    std::memcpy(buf, text, len);
+    return len;
+}
+
+// Shortest "%.*e" precision that reads back to the same value. Round-trip
+// success is monotonic in the digit count, so a binary search is enough.
+template<typename T>
+int shortestDigits(T value, int max_digits) {
+    char tmp[48];
+    int lo = 1;
+    int hi = max_digits;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        snprintf(tmp, sizeof(tmp), "%.*e", mid - 1, static_cast<double>(value));
+        T back = std::is_same<T, float>::value ? std::strtof(tmp, nullptr) : std::strtod(tmp, nullptr);
+        if (back == value) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
 }
 
-float StringUtils::toFloat(const std::string& str, float default_value) {
-    try {
-        return std::stof(str);
-    } catch (...) {
-        return default_value;
+// Mirror std::to_chars(value): shortest digits, in whichever of fixed or
+// scientific notation is shorter (fixed on a tie).
+template<typename T>
+size_t writeShortest(char* buf, size_t capacity, T value, int max_digits) {
+    if (std::isnan(value)) {
+        return copyOut(buf, capacity, std::signbit(value) ? "-nan" : "nan", std::signbit(value) ? 4 : 3);
+    }
+    if (std::isinf(value)) {
+        return copyOut(buf, capacity, value < 0 ? "-inf" : "inf", value < 0 ? 4 : 3);
     }
-}
 
-double StringUtils::toDouble(const std::string& str, double default_value) {
-    try {
-        return std::stod(str);
-    } catch (...) {
-        return default_value;
+    int digits = shortestDigits(value, max_digits);
+    char sci[48];
+    int sci_len = snprintf(sci, sizeof(sci), "%.*e", digits - 1, static_cast<double>(value));
+    int exponent = std::atoi(std::strchr(sci, 'e') + 1);
+
+    // Fixed notation can't win once it needs more characters than the
+    // longest scientific form, so only try it in a bounded exponent range.
+    char fixed[64];
+    int fixed_len = -1;
+    if (exponent > -24 && exponent < 24) {
+        int decimals = std::max(0, digits - 1 - exponent);
+        fixed_len = snprintf(fixed, sizeof(fixed), "%.*f", decimals, static_cast<double>(value));
     }
+
+    if (fixed_len >= 0 && fixed_len <= sci_len) {
+        return copyOut(buf, capacity, fixed, static_cast<size_t>(fixed_len));
+    }
+    return copyOut(buf, capacity, sci, static_cast<size_t>(sci_len));
+}
+#endif
+
+template<typename T>
+size_t writeFloating(char* buf, size_t capacity, T value, int precision) {
+#if LIBCLIENT_HAS_FLOAT_CHARCONV
+    std::to_chars_result result = precision >= 0
+        ? std::to_chars(buf, buf + capacity, value, std::chars_format::fixed, precision)
+        : std::to_chars(buf, buf + capacity, value);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buf) : 0;
+#else
+    if (precision < 0) {
+        return writeShortest(buf, capacity, value, std::is_same<T, float>::value ? 9 : 17);
+    }
+    int len = snprintf(buf, capacity, "%.*f", precision, static_cast<double>(value));
+    return (len >= 0 && static_cast<size_t>(len) < capacity) ? static_cast<size_t>(len) : 0;
+#endif
+}
+
+// Floating-point output with a fixed precision can be arbitrarily long
+// (1e300 with "%.2f"); grow the stack buffer into the string if needed.
+template<typename T>
+void appendFloating(std::string& out, T value, int precision) {
+    char buf[64];
+    size_t len = writeFloating(buf, sizeof(buf), value, precision);
+    if (len != 0) {
+        out.append(buf, len);
+        return;
+    }
+
+    size_t base = out.size();
+    size_t capacity = 512 + static_cast<size_t>(std::max(precision, 0));
+    out.resize(base + capacity);
+    len = writeFloating(&out[base], capacity, value, precision);
+    out.resize(base + len);
+}
+
+} // namespace
+
+size_t StringUtils::writeInt(char* buf, size_t capacity, long long value) {
+    std::to_chars_result result = std::to_chars(buf, buf + capacity, value);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buf) : 0;
+}
+
+size_t StringUtils::writeUnsigned(char* buf, size_t capacity, unsigned long long value) {
+    std::to_chars_result result = std::to_chars(buf, buf + capacity, value);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buf) : 0;
+}
+
+size_t StringUtils::writeFloat(char* buf, size_t capacity, float value, int precision) {
+    return writeFloating(buf, capacity, value, precision);
+}
+
+size_t StringUtils::writeDouble(char* buf, size_t capacity, double value, int precision) {
+    return writeFloating(buf, capacity, value, precision);
+}
+
+void StringUtils::appendInt(std::string& out, long long value) {
+    char buf[24];
+    out.append(buf, writeInt(buf, sizeof(buf), value));
+}
+
+void StringUtils::appendUnsigned(std::string& out, unsigned long long value) {
+    char buf[24];
+    out.append(buf, writeUnsigned(buf, sizeof(buf), value));
+}
+
+void StringUtils::appendFloat(std::string& out, float value, int precision) {
+    appendFloating(out, value, precision);
+}
+
+void StringUtils::appendDouble(std::string& out, double value, int precision) {
+    appendFloating(out, value, precision);
+}
+
+int StringUtils::toInt(std::string_view str, int default_value) {
+    int value;
+    return parseInteger(str, value) ? value : default_value;
+}
+
+long StringUtils::toLong(std::string_view str, long default_value) {
+    long value;
+    return parseInteger(str, value) ? value : default_value;
+}
+
+float StringUtils::toFloat(std::string_view str, float default_value) {
+    float value;
+    return parseFloating(str, value) ? value : default_value;
+}
+
+double StringUtils::toDouble(std::string_view str, double default_value) {
+    double value;
+    return parseFloating(str, value) ? value : default_value;
 }
 
-bool StringUtils::toBool(const std::string& str, bool default_value) {
-    std::string lower = toLower(trim(str));
-    if (lower == "true" || lower == "1" || lower == "yes") return true;
-    if (lower == "false" || lower == "0" || lower == "no") return false;
+bool StringUtils::toBool(std::string_view str, bool default_value) {
+    std::string_view value = trimView(str);
+    if (equalsIgnoreCase(value, "true") || value == "1" || equalsIgnoreCase(value, "yes")) return true;
+    if (equalsIgnoreCase(value, "false") || value == "0" || equalsIgnoreCase(value, "no")) return false;
     return default_value;
 }
 
 std::string StringUtils::fromInt(int value) {
-    return std::to_string(value);
+    std::string out;
+    appendInt(out, value);
+    return out;
 }
 
 std::string StringUtils::fromLong(long value) {
-    return std::to_string(value);
+    std::string out;
+    appendInt(out, value);
+    return out;
 }
 
 std::string StringUtils::fromFloat(float value, int precision) {
-    if (precision >= 0) {
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
-        return std::string(buffer);
-    }
-    return std::to_string(value);
+    std::string out;
+    appendFloat(out, value, precision);
+    return out;
 }
 
 std::string StringUtils::fromDouble(double value, int precision) {
-    if (precision >= 0) {
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
-        return std::string(buffer);
-    }
-    return std::to_string(value);
+    std::string out;
+    appendDouble(out, value, precision);
+    return out;
 }
 
 std::string StringUtils::fromBool(bool value) {
@@ -198,14 +512,80 @@ std::string StringUtils::fromBool(bool value) {
 }
 
 std::string StringUtils::format(const char* fmt, ...) {
-    char buffer[2048];
+    // Format straight into the result; a second pass is only needed when
+    // the first guess is too small, and nothing is truncated.
+    std::string result(256, '\0');
+
     va_list args;
     va_start(args, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_list retry;
+    va_copy(retry, args);
+    int len = vsnprintf(&result[0], result.size(), fmt, args);
     va_end(args);
-    return std::string(buffer);
+
+    if (len < 0) {
+        va_end(retry);
+        return std::string();
+    }
+    if (static_cast<size_t>(len) >= result.size()) {
+        result.resize(static_cast<size_t>(len) + 1);
+        vsnprintf(&result[0], result.size(), fmt, retry);
+    }
+    va_end(retry);
+
+    result.resize(static_cast<size_t>(len));
+    return result;
 }
 
+namespace detail {
+
+void formatImpl(std::string& out, std::string_view fmt, const FormatArg* args, size_t count) {
+    // Pass 1: exact output length
+    size_t length = 0;
+    size_t next = 0;
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        char c = fmt[i];
+        if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+            ++length;
+            ++i;
+        } else if (c == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}') {
+            length += next < count ? args[next].size() : 2;
+            ++next;
+            ++i;
+        } else {
+            ++length;
+        }
+    }
+
+    // Pass 2: write in place
+    size_t base = out.size();
+    out.resize(base + length);
+    char* dst = &out[base];
+    next = 0;
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        char c = fmt[i];
+        if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+            *dst++ = c;
+            ++i;
+        } else if (c == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}') {
+            if (next < count) {
+                std::memcpy(dst, args[next].data(), args[next].size());
+                dst += args[next].size();
+            } else {
+                // Missing argument: keep the placeholder visible
+                *dst++ = '{';
+                *dst++ = '}';
+            }
+            ++next;
+            ++i;
+        } else {
+            *dst++ = c;
+        }
+    }
+}
+
+} // namespace detail
+
 std::string StringUtils::obfuscate(const std::string& str, uint8_t key) {
     std::string result = str;
     for (size_t i = 0; i < result.length(); ++i) {
@@ -218,15 +598,174 @@ std::string StringUtils::deobfuscate(const std::string& str, uint8_t key) {
     return obfuscate(str, key); // XOR is symmetric
 }
 
-bool StringUtils::equalsIgnoreCase(const std::string& str1, const std::string& str2) {
-    return toLower(str1) == toLower(str2);
+namespace {
+
+constexpr char kHexUpper[] = "0123456789ABCDEF";
+
+struct UrlTables {
+    bool unreserved[256];
+    int8_t hex_value[256];   // -1 for non-hex bytes
+
+    constexpr UrlTables() : unreserved(), hex_value() {
+        for (int c = 0; c < 256; ++c) {
+            unreserved[c] = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                            (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' || c == '~';
+            hex_value[c] = (c >= '0' && c <= '9') ? static_cast<int8_t>(c - '0')
+                         : (c >= 'a' && c <= 'f') ? static_cast<int8_t>(c - 'a' + 10)
+                         : (c >= 'A' && c <= 'F') ? static_cast<int8_t>(c - 'A' + 10)
+                         : static_cast<int8_t>(-1);
+        }
+    }
+};
+
+constexpr UrlTables kUrlTables;
+
+inline bool isUnreserved(char c) {
+    return kUrlTables.unreserved[static_cast<unsigned char>(c)];
+}
+
+// End of the unreserved run starting at pos
+inline size_t unreservedRunEnd(const char* data, size_t len, size_t pos) {
+    pos = simd::skipUrlUnreserved(data, len, pos);
+    while (pos < len && isUnreserved(data[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+} // namespace
+
+std::string StringUtils::urlEncode(std::string_view str) {
+    const char* data = str.data();
+    const size_t len = str.size();
+
+    // Pass 1: every reserved byte grows by two characters
+    size_t escaped = 0;
+    for (size_t i = unreservedRunEnd(data, len, 0); i < len; i = unreservedRunEnd(data, len, i)) {
+        for (; i < len && !isUnreserved(data[i]); ++i) {
+            ++escaped;
+        }
+    }
+    if (escaped == 0) {
+        return std::string(str);
+    }
+
+    // Pass 2: bulk-copy unreserved runs, escape the rest
+    std::string result(len + escaped * 2, '\0');
+    char* out = &result[0];
+    size_t i = 0;
+    while (i < len) {
+        size_t run_end = unreservedRunEnd(data, len, i);
+        std::memcpy(out, data + i, run_end - i);
+        out += run_end - i;
+        for (i = run_end; i < len && !isUnreserved(data[i]); ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            out[0] = '%';
+            out[1] = kHexUpper[c >> 4];
+            out[2] = kHexUpper[c & 0x0F];
+            out += 3;
+        }
+    }
+    return result;
 }
 
-int StringUtils::compareIgnoreCase(const std::string& str1, const std::string& str2) {
-    return toLower(str1).compare(toLower(str2));
+std::string StringUtils::urlDecode(std::string_view str) {
+    const char* data = str.data();
+    const size_t len = str.size();
+
+    // Decoding never grows the input; trim to the written size at the end
+    std::string result(len, '\0');
+    char* out = &result[0];
+    size_t i = 0;
+    while (i < len) {
+        size_t special = simd::findEither(data, len, '%', '+', i);
+        std::memcpy(out, data + i, special - i);
+        out += special - i;
+        i = special;
+        if (i >= len) {
+            break;
+        }
+
+        if (data[i] == '+') {
+            *out++ = ' ';
+            ++i;
+            continue;
+        }
+
+        int hi = i + 2 < len ? kUrlTables.hex_value[static_cast<unsigned char>(data[i + 1])] : -1;
+        int lo = i + 2 < len ? kUrlTables.hex_value[static_cast<unsigned char>(data[i + 2])] : -1;
+        if (hi >= 0 && lo >= 0) {
+            *out++ = static_cast<char>((hi << 4) | lo);
+            i += 3;
+        } else {
+            *out++ = '%';
+            ++i;
+        }
+    }
+    result.resize(static_cast<size_t>(out - result.data()));
+    return result;
+}
+
+bool StringUtils::equalsIgnoreCase(std::string_view str1, std::string_view str2) {
+    return str1.size() == str2.size() &&
+           simd::mismatchIgnoreCase(str1.data(), str2.data(), str1.size()) == str1.size();
+}
+
+int StringUtils::compareIgnoreCase(std::string_view str1, std::string_view str2) {
+    size_t n = std::min(str1.size(), str2.size());
+    size_t i = simd::mismatchIgnoreCase(str1.data(), str2.data(), n);
+    if (i < n) {
+        unsigned char a = static_cast<unsigned char>(simd::lowerAscii(str1[i]));
+        unsigned char b = static_cast<unsigned char>(simd::lowerAscii(str2[i]));
+        return a < b ? -1 : 1;
+    }
+    if (str1.size() == str2.size()) return 0;
+    return str1.size() < str2.size() ? -1 : 1;
+}
+
+namespace {
+
+// Lower-case the ASCII letters in eight bytes at once. A byte is upper
+// case when it is ASCII (top bit clear), >= 'A' and not > 'Z'; the adds
+// below carry into bit 7 of each byte without crossing byte lanes.
+inline uint64_t lowerWord(uint64_t word) {
+    constexpr uint64_t kOnes = 0x0101010101010101ULL;
+    constexpr uint64_t kHigh = 0x8080808080808080ULL;
+    uint64_t low7 = word & ~kHigh;
+    uint64_t ge_a = low7 + kOnes * (0x80 - 'A');
+    uint64_t gt_z = low7 + kOnes * (0x7F - 'Z');
+    uint64_t upper = ~word & (ge_a ^ gt_z) & kHigh;
+    return word | (upper >> 2);
+}
+
+inline uint64_t mixWord(uint64_t h, uint64_t word) {
+    h ^= word;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+}
+
+} // namespace
+
+size_t StringUtils::hashIgnoreCase(std::string_view str) {
+    const char* data = str.data();
+    size_t len = str.size();
+    uint64_t h = 0x243F6A8885A308D3ULL ^ len;
+
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = mixWord(h, lowerWord(word));
+    }
+    if (i < len) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, len - i);
+        h = mixWord(h, lowerWord(word));
+    }
+    return static_cast<size_t>(h);
 }
 
-std::string StringUtils::repeat(const std::string& str, size_t count) {
+std::string StringUtils::repeat(std::string_view str, size_t count) {
     std::string result;
     result.reserve(str.length() * count);
     for (size_t i = 0; i < count; ++i) {
@@ -235,15 +774,15 @@ std::string StringUtils::repeat(const std::string& str, size_t count) {
     return result;
 }
 
-std::string StringUtils::reverse(const std::string& str) {
+std::string StringUtils::reverse(std::string_view str) {
     return std::string(str.rbegin(), str.rend());
 }
 
-size_t StringUtils::indexOf(const std::string& str, const std::string& substring, size_t start) {
+size_t StringUtils::indexOf(std::string_view str, std::string_view substring, size_t start) {
     return str.find(substring, start);
 }
 
-size_t StringUtils::lastIndexOf(const std::string& str, const std::string& substring) {
+size_t StringUtils::lastIndexOf(std::string_view str, std::string_view substring) {
     return str.rfind(substring);
 }
 
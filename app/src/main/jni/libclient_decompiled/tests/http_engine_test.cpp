@@ -0,0 +1,345 @@
+#include "test.h"
+#include "loopback_server.h"
+#include "internal/http_engine.h"
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+
+using namespace client::http;
+using test::LoopbackServer;
+using test::ReceivedRequest;
+using test::Reply;
+
+namespace {
+
+// Answers "METHOD path body-size", which tells each response apart
+Reply echo(const ReceivedRequest& request) {
+    return Reply::ok(request.method + " " + request.path + " " + std::to_string(request.body.size()));
+}
+
+std::string echoed(const std::string& method, const std::string& path, size_t body_size = 0) {
+    return method + " " + path + " " + std::to_string(body_size);
+}
+
+Request makeRequest(int port, const std::string& method, const std::string& path,
+                    const std::string& body = std::string(), int timeout_ms = 0) {
+    Request request;
+    request.method = method;
+    request.host = "127.0.0.1";
+    request.port = port;
+    request.timeout_ms = timeout_ms;
+    request.head = method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\n";
+    if (!body.empty()) {
+        request.head += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    request.head += "\r\n";
+    auto owned = std::make_shared<const std::string>(body);
+    request.body = Body::memory(owned->data(), owned->size());
+    request.body.owner = owned;
+    return request;
+}
+
+// Collects asynchronous responses in completion order
+class Collector {
+public:
+    Engine::Callback callback(size_t index) {
+        return [this, index](Response&& response) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            order_.push_back(index);
+            responses_.emplace_back(index, std::move(response));
+            cv_.notify_all();
+        };
+    }
+
+    // Responses indexed by submission, once count have arrived
+    std::vector<Response> wait(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, std::chrono::seconds(10), [&] { return responses_.size() >= count; });
+        std::vector<Response> sorted(count);
+        for (auto& entry : responses_) {
+            if (entry.first < count) sorted[entry.first] = std::move(entry.second);
+        }
+        return sorted;
+    }
+
+    std::vector<size_t> order() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::pair<size_t, Response>> responses_;
+    std::vector<size_t> order_;
+};
+
+} // namespace
+
+TEST(EngineKeepAlive) {
+    LoopbackServer server(echo);
+    CHECK(server.start());
+    Engine engine;
+    CHECK(engine.start());
+
+    for (int i = 0; i < 20; i++) {
+        std::string path = "/seq" + std::to_string(i);
+        Response response = engine.send(makeRequest(server.port(), "GET", path));
+        CHECK(response.ok());
+        CHECK_EQ(response.status_code, 200);
+        CHECK_EQ(response.body, echoed("GET", path));
+    }
+
+    Engine::Stats stats = engine.stats();
+    CHECK_EQ(stats.connections_opened, 1u);
+    CHECK_EQ(stats.requests_reused, 19u);
+    CHECK_EQ(server.accepted(), 1);
+}
+
+TEST(EnginePipelinesIdempotentRequests) {
+    // The first pipelined request is held back, so the rest queue behind it
+    LoopbackServer server([](const ReceivedRequest& request) {
+        Reply reply = echo(request);
+        if (request.path == "/p0") reply.delay_ms = 200;
+        return reply;
+    });
+    CHECK(server.start());
+    Engine::Options options;
+    options.max_connections_per_host = 1;
+    Engine engine(options);
+    CHECK(engine.start());
+
+    // Pipelining waits until the connection has kept a response alive
+    CHECK(engine.send(makeRequest(server.port(), "GET", "/warm")).ok());
+
+    Collector collector;
+    const size_t kCount = 5;
+    for (size_t i = 0; i < kCount; i++) {
+        engine.submit(makeRequest(server.port(), "GET", "/p" + std::to_string(i)), collector.callback(i));
+    }
+    std::vector<Response> responses = collector.wait(kCount);
+    for (size_t i = 0; i < kCount; i++) {
+        CHECK(responses[i].ok());
+        CHECK_EQ(responses[i].body, echoed("GET", "/p" + std::to_string(i)));
+    }
+    CHECK(collector.order() == std::vector<size_t>({0, 1, 2, 3, 4}));
+
+    Engine::Stats stats = engine.stats();
+    CHECK_EQ(stats.connections_opened, 1u);
+    CHECK_EQ(stats.requests_pipelined, kCount - 1);
+    CHECK(server.pipelined() > 0);
+}
+
+TEST(EngineDoesNotPipelinePost) {
+    LoopbackServer server([](const ReceivedRequest& request) {
+        Reply reply = echo(request);
+        if (request.path == "/slow") reply.delay_ms = 150;
+        return reply;
+    });
+    CHECK(server.start());
+    Engine::Options options;
+    options.max_connections_per_host = 1;
+    Engine engine(options);
+    CHECK(engine.start());
+    CHECK(engine.send(makeRequest(server.port(), "GET", "/warm")).ok());
+
+    Collector collector;
+    engine.submit(makeRequest(server.port(), "GET", "/slow"), collector.callback(0));
+    engine.submit(makeRequest(server.port(), "POST", "/post", "payload"), collector.callback(1));
+    std::vector<Response> responses = collector.wait(2);
+    CHECK_EQ(responses[0].body, echoed("GET", "/slow"));
+    CHECK_EQ(responses[1].body, echoed("POST", "/post", 7));
+    CHECK_EQ(engine.stats().requests_pipelined, 0u);
+    CHECK_EQ(server.pipelined(), 0);
+}
+
+TEST(EngineRetriesIdempotentRequestOnDrop) {
+    std::atomic<int> drops{0};
+    LoopbackServer server([&drops](const ReceivedRequest& request) {
+        if (request.path == "/drop-once" && drops.fetch_add(1) == 0) return Reply::drop();
+        if (request.path == "/drop-always") return Reply::drop();
+        return echo(request);
+    });
+    CHECK(server.start());
+    Engine engine;
+    CHECK(engine.start());
+
+    Response response = engine.send(makeRequest(server.port(), "GET", "/drop-once"));
+    CHECK(response.ok());
+    CHECK_EQ(response.body, echoed("GET", "/drop-once"));
+    CHECK_EQ(engine.stats().requests_retried, 1u);
+
+    // Retried once only
+    response = engine.send(makeRequest(server.port(), "GET", "/drop-always"));
+    CHECK_EQ(response.error, ECONNRESET);
+    CHECK_EQ(engine.stats().requests_retried, 2u);
+
+    // Not idempotent: never retried
+    response = engine.send(makeRequest(server.port(), "POST", "/drop-always", "x"));
+    CHECK_EQ(response.error, ECONNRESET);
+    CHECK_EQ(engine.stats().requests_retried, 2u);
+
+    int posts = 0;
+    for (const ReceivedRequest& request : server.requests()) {
+        posts += request.method == "POST";
+    }
+    CHECK_EQ(posts, 1);
+}
+
+TEST(EngineRetriesRequestPipelinedBehindClose) {
+    // The first pipelined answer ends the connection, once with
+    // Connection: close and once by delimiting its body with the close. It
+    // is held back so the second request queues behind it.
+    LoopbackServer server([](const ReceivedRequest& request) {
+        Reply reply = echo(request);
+        if (request.path == "/close") {
+            reply = Reply::raw("HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: 3\r\n\r\nbye",
+                               Reply::RespondAndClose);
+            reply.delay_ms = 100;
+        } else if (request.path == "/until-close") {
+            reply = Reply::raw("HTTP/1.1 200 OK\r\n\r\nbye", Reply::RespondAndClose);
+            reply.delay_ms = 100;
+        }
+        return reply;
+    });
+    CHECK(server.start());
+    Engine::Options options;
+    options.max_connections_per_host = 1;
+    Engine engine(options);
+    CHECK(engine.start());
+
+    uint64_t retried = 0;
+    for (const char* closing : {"/close", "/until-close"}) {
+        CHECK(engine.send(makeRequest(server.port(), "GET", "/warm")).ok());
+
+        Collector collector;
+        engine.submit(makeRequest(server.port(), "GET", closing), collector.callback(0));
+        engine.submit(makeRequest(server.port(), "GET", "/next"), collector.callback(1));
+        std::vector<Response> responses = collector.wait(2);
+        CHECK(responses[0].ok());
+        CHECK(responses[1].ok());
+        CHECK_EQ(responses[1].body, echoed("GET", "/next"));
+        CHECK_EQ(engine.stats().requests_retried, ++retried);
+    }
+}
+
+TEST(EngineTimesOutStalledRequest) {
+    LoopbackServer server([](const ReceivedRequest& request) {
+        return request.path == "/stall" ? Reply::hold() : echo(request);
+    });
+    CHECK(server.start());
+    Engine engine;
+    CHECK(engine.start());
+
+    auto start = std::chrono::steady_clock::now();
+    Response response = engine.send(makeRequest(server.port(), "GET", "/stall", std::string(), 150));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK_EQ(response.error, ETIMEDOUT);
+    CHECK(elapsed >= std::chrono::milliseconds(100));
+    CHECK(elapsed < std::chrono::seconds(2));
+
+    // The stalled connection is gone; the next request gets a fresh one
+    response = engine.send(makeRequest(server.port(), "GET", "/after"));
+    CHECK(response.ok());
+    CHECK_EQ(response.body, echoed("GET", "/after"));
+    CHECK_EQ(server.accepted(), 2);
+    server.stop();
+}
+
+TEST(EngineClosesIdleConnections) {
+    LoopbackServer server(echo);
+    CHECK(server.start());
+    Engine::Options options;
+    options.idle_timeout_ms = 100;
+    Engine engine(options);
+    CHECK(engine.start());
+
+    CHECK(engine.send(makeRequest(server.port(), "GET", "/a")).ok());
+    usleep(300 * 1000);
+    CHECK(engine.send(makeRequest(server.port(), "GET", "/b")).ok());
+    CHECK_EQ(server.accepted(), 2);
+}
+
+TEST(EngineSendsFileBodyWithSendfile) {
+    LoopbackServer server(echo);
+    CHECK(server.start());
+    Engine engine;
+    CHECK(engine.start());
+
+    const char* tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp ? tmp : "/tmp") + "/libclient_engine_test.XXXXXX";
+    int fd = mkstemp(&path[0]);
+    CHECK(fd >= 0);
+    std::string content;
+    for (size_t i = 0; i < 3 * 1024 * 1024; i++) {
+        content.push_back(static_cast<char>('a' + i % 26));
+    }
+    CHECK_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+
+    const off_t kOffset = 1000;
+    const size_t kSize = 2000000;
+    Request request = makeRequest(server.port(), "POST", "/upload");
+    request.head = "POST /upload HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: " +
+                   std::to_string(kSize) + "\r\n\r\n";
+    request.body = Body::file(fd, kOffset, kSize);
+    Response response = engine.send(std::move(request));
+    CHECK(response.ok());
+    CHECK_EQ(response.body, echoed("POST", "/upload", kSize));
+
+    std::vector<ReceivedRequest> received = server.requests();
+    CHECK(!received.empty() && received.back().body == content.substr(kOffset, kSize));
+    // sendfile() with an explicit offset leaves the file position alone
+    CHECK_EQ(lseek(fd, 0, SEEK_CUR), static_cast<off_t>(content.size()));
+    close(fd);
+    unlink(path.c_str());
+}
+
+TEST(EngineGathersPipelinedBodies) {
+    LoopbackServer server(echo);
+    CHECK(server.start());
+    Engine::Options options;
+    options.max_connections_per_host = 2;
+    Engine engine(options);
+    CHECK(engine.start());
+
+    Collector collector;
+    const size_t kCount = 100;
+    for (size_t i = 0; i < kCount; i++) {
+        std::string body(i * 37, static_cast<char>('A' + i % 26));
+        engine.submit(makeRequest(server.port(), "PUT", "/u" + std::to_string(i), body),
+                      collector.callback(i));
+    }
+    std::vector<Response> responses = collector.wait(kCount);
+    for (size_t i = 0; i < kCount; i++) {
+        CHECK_EQ(responses[i].body, echoed("PUT", "/u" + std::to_string(i), i * 37));
+    }
+    for (const ReceivedRequest& request : server.requests()) {
+        size_t i = std::strtoul(request.path.c_str() + 2, nullptr, 10);
+        CHECK(request.body == std::string(i * 37, static_cast<char>('A' + i % 26)));
+    }
+}
+
+TEST(EngineStopCancelsOutstanding) {
+    LoopbackServer server([](const ReceivedRequest&) { return Reply::hold(); });
+    CHECK(server.start());
+    Engine engine;
+    CHECK(engine.start());
+
+    Collector collector;
+    for (size_t i = 0; i < 3; i++) {
+        engine.submit(makeRequest(server.port(), "GET", "/held"), collector.callback(i));
+    }
+    usleep(50 * 1000);
+    engine.stop();
+    for (const Response& response : collector.wait(3)) {
+        CHECK_EQ(response.error, ECANCELED);
+    }
+
+    Response response = engine.send(makeRequest(server.port(), "GET", "/late"));
+    CHECK_EQ(response.error, ECANCELED);
+    server.stop();
+}
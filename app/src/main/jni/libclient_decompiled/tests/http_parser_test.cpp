@@ -0,0 +1,166 @@
+#include "test.h"
+#include "internal/http_parser.h"
+#include <string>
+#include <vector>
+
+using client::http::ResponseParser;
+
+namespace {
+
+// One response of a canned stream and the request it answers
+struct Expected {
+    bool head_request;
+    int status;
+    std::string body;
+    std::string header;         // Name of a field that must be present, if any
+};
+
+struct Parsed {
+    int status = 0;
+    std::string body;
+    bool has_header = false;
+    bool keep_alive = false;
+};
+
+// Pipelined responses as a server would send them back to back: an interim
+// 100 before a 200, a chunked body with extensions and trailers, 204 and
+// 304 without bodies (the 304 advertises a length it never sends), a HEAD
+// answer with a Content-Length, and finally a body delimited by the close
+const std::string kStream =
+    "HTTP/1.1 100 Continue\r\n\r\n"
+    "HTTP/1.1 200 OK\r\nContent-Length: 5\r\nX-First: 1\r\n\r\nhello"
+    "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "4;name=value\r\nWiki\r\n5\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n"
+        "0\r\nExpires: never\r\nX-Trailer: 1\r\n\r\n"
+    "HTTP/1.1 204 No Content\r\nX-Empty: 1\r\n\r\n"
+    "HTTP/1.1 304 Not Modified\r\nContent-Length: 10\r\n\r\n"
+    "HTTP/1.1 200 OK\r\nContent-Length: 1234\r\n\r\n"
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n\r\nuntil the connection closes";
+
+const std::vector<Expected> kExpected = {
+    {false, 200, "hello", "X-First"},
+    {false, 200, "Wikipedia in\r\n\r\nchunks.", "Transfer-Encoding"},
+    {false, 204, "", "X-Empty"},
+    {false, 304, "", "Content-Length"},
+    {true, 200, "", "Content-Length"},
+    {false, 200, "until the connection closes", "Content-Type"},
+};
+
+// Drive the parser the way http::Engine does: after each response, reset
+// for the next request and parse whatever is already buffered
+class StreamDriver {
+public:
+    explicit StreamDriver(const std::vector<Expected>& expected) : expected_(expected) {
+        parser_.reset(expected_[0].head_request);
+    }
+
+    bool feed(const char* data, size_t length) {
+        return drain(parser_.feed(data, length));
+    }
+
+    bool finish() {
+        return drain(parser_.finish());
+    }
+
+    const std::vector<Parsed>& parsed() const { return parsed_; }
+    const char* error() const { return parser_.error(); }
+
+private:
+    bool drain(ResponseParser::Result result) {
+        while (result == ResponseParser::Result::Done) {
+            Parsed parsed;
+            parsed.status = parser_.statusCode();
+            parsed.body = parser_.takeBody();
+            parsed.has_header = parser_.hasHeader(expected_[parsed_.size()].header);
+            parsed.keep_alive = parser_.keepAlive();
+            parsed_.push_back(parsed);
+            if (parsed_.size() == expected_.size()) {
+                return parser_.pendingBytes() == 0;
+            }
+            parser_.reset(expected_[parsed_.size()].head_request);
+            result = parser_.pendingBytes() > 0 ? parser_.commit(0) : ResponseParser::Result::NeedMore;
+        }
+        return result != ResponseParser::Result::Error;
+    }
+
+    const std::vector<Expected>& expected_;
+    ResponseParser parser_;
+    std::vector<Parsed> parsed_;
+};
+
+void checkParsed(const StreamDriver& driver, size_t split) {
+    const std::vector<Parsed>& parsed = driver.parsed();
+    if (parsed.size() != kExpected.size()) {
+        test::fail(__FILE__, __LINE__, "split at " + std::to_string(split) + ": " +
+                   std::to_string(parsed.size()) + " responses" +
+                   (driver.error() ? std::string(", ") + driver.error() : std::string()));
+        return;
+    }
+    for (size_t i = 0; i < parsed.size(); i++) {
+        if (parsed[i].status != kExpected[i].status || parsed[i].body != kExpected[i].body ||
+            !parsed[i].has_header) {
+            test::fail(__FILE__, __LINE__, "split at " + std::to_string(split) +
+                       ": response " + std::to_string(i) + " is " +
+                       std::to_string(parsed[i].status) + " \"" + parsed[i].body + "\"");
+        }
+    }
+    // All but the close-delimited last one leave the connection reusable
+    for (size_t i = 0; i + 1 < parsed.size(); i++) {
+        CHECK(parsed[i].keep_alive);
+    }
+    CHECK(!parsed.back().keep_alive);
+}
+
+} // namespace
+
+TEST(ParserPipelinedStreamSplitAtEveryByte) {
+    for (size_t split = 0; split <= kStream.size(); split++) {
+        StreamDriver driver(kExpected);
+        bool ok = driver.feed(kStream.data(), split) &&
+                  driver.feed(kStream.data() + split, kStream.size() - split) &&
+                  driver.finish();
+        CHECK(ok);
+        checkParsed(driver, split);
+    }
+}
+
+TEST(ParserPipelinedStreamByteAtATime) {
+    StreamDriver driver(kExpected);
+    bool ok = true;
+    for (size_t i = 0; i < kStream.size() && ok; i++) {
+        ok = driver.feed(&kStream[i], 1);
+    }
+    CHECK(ok && driver.finish());
+    checkParsed(driver, 1);
+}
+
+TEST(ParserChunkedBodyToSink) {
+    const std::string stream =
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "3\r\nabc\r\n10\r\n0123456789abcdef\r\n0\r\nX-Checksum: 1\r\n\r\n";
+    for (size_t split = 0; split <= stream.size(); split++) {
+        ResponseParser parser;
+        std::string sunk;
+        parser.setBodySink([&sunk](std::string_view data) {
+            sunk.append(data);
+            return true;
+        });
+        parser.feed(stream.data(), split);
+        CHECK(parser.feed(stream.data() + split, stream.size() - split) == ResponseParser::Result::Done);
+        CHECK_EQ(sunk, std::string("abc0123456789abcdef"));
+        CHECK(parser.body().empty());
+        CHECK_EQ(parser.bodyBytes(), 19u);
+        CHECK_EQ(parser.pendingBytes(), 0u);
+    }
+}
+
+TEST(ParserRejectsTruncatedBodies) {
+    ResponseParser parser;
+    parser.feed("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nshort", 44);
+    CHECK(parser.finish() == ResponseParser::Result::Error);
+
+    ResponseParser chunked;
+    const std::string partial = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nab";
+    chunked.feed(partial.data(), partial.size());
+    CHECK(chunked.finish() == ResponseParser::Result::Error);
+}
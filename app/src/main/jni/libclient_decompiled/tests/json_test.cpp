@@ -0,0 +1,200 @@
+#include "test.h"
+#include "internal/json.h"
+#include <cstring>
+#include <string>
+
+using client::json::Document;
+using client::json::Type;
+using client::json::Value;
+using client::json::Writer;
+
+namespace {
+
+// Every value type, escapes that need unescaping into the arena, a
+// surrogate pair, nesting, and whitespace in all the places it is allowed
+const std::string kDocument =
+    " {\n"
+    "  \"name\": \"plain\",\n"
+    "  \"escaped\": \"tab\\there \\\"quoted\\\" \\\\ \\/ \\u00e9 \\ud83d\\ude00\",\n"
+    "  \"numbers\": [0, -12, 3.25, 1e3, -2.5E-2, 9007199254740993],\n"
+    "  \"flags\": {\"on\": true, \"off\": false, \"none\": null},\n"
+    "  \"nested\": [[], {}, [[1]], {\"a\": {\"b\": [\"deep\"]}}],\n"
+    "  \"empty\": \"\"\n"
+    "} ";
+
+// Input, error message, offset of the error
+struct Rejected {
+    const char* text;
+    const char* error;
+    size_t offset;
+};
+
+const Rejected kRejected[] = {
+    {"", "unexpected end of input", 0},
+    {"   ", "unexpected end of input", 3},
+    {"{\"a\":1", "unexpected end of input", 6},
+    {"[1,]", "unexpected character", 3},
+    {"[1 2]", "expected ',' or ']'", 3},
+    {"{\"a\" 1}", "expected ':'", 5},
+    {"{1:2}", "expected object key", 1},
+    {"{\"a\":1,}", "expected object key", 7},
+    {"tru", "invalid literal", 0},
+    {"nul", "invalid literal", 0},
+    {"01", "trailing characters after document", 1},
+    {"-", "invalid number", 0},
+    {"1.", "invalid number", 0},
+    {"1e+", "invalid number", 0},
+    {"\"abc", "unterminated string", 0},
+    {"\"a\nb\"", "control character in string", 2},
+    {"\"\\x\"", "invalid escape", 1},
+    {"\"\\u12g4\"", "invalid \\u escape", 1},
+    {"\"\\ud83d\"", "unpaired surrogate", 1},
+    {"{} {}", "trailing characters after document", 3},
+};
+
+std::string write(const Value& value) {
+    std::string out;
+    Writer(out).value(value);
+    return out;
+}
+
+} // namespace
+
+TEST(JsonParsesCannedDocument) {
+    Document doc;
+    CHECK(doc.parse(kDocument));
+    CHECK(doc.error() == nullptr);
+
+    const Value& root = doc.root();
+    CHECK(root.isObject());
+    CHECK_EQ(root.size(), 6u);
+    CHECK_EQ(root["name"].asString(), std::string_view("plain"));
+    CHECK_EQ(root["escaped"].asString(),
+             std::string_view("tab\there \"quoted\" \\ / \xc3\xa9 \xf0\x9f\x98\x80"));
+    CHECK(root["empty"].isString());
+    CHECK(root["empty"].asString().empty());
+
+    const Value& numbers = root["numbers"];
+    CHECK_EQ(numbers.size(), 6u);
+    CHECK_EQ(numbers[0].asInt64(-1), 0);
+    CHECK_EQ(numbers[1].asInt64(), -12);
+    CHECK_EQ(numbers[2].asDouble(), 3.25);
+    CHECK_EQ(numbers[3].asDouble(), 1000.0);
+    CHECK_EQ(numbers[4].asDouble(), -0.025);
+    CHECK_EQ(numbers[5].asInt64(), 9007199254740993);       // Not rounded through a double
+    CHECK_EQ(numbers[4].asString(), std::string_view("-2.5E-2"));
+
+    const Value& flags = root["flags"];
+    CHECK(flags["on"].asBool());
+    CHECK(!flags["off"].asBool(true));
+    CHECK(flags["none"].isNull());
+    CHECK(flags.find("none") != nullptr);
+    CHECK(flags.find("missing") == nullptr);
+
+    const Value& nested = root["nested"];
+    CHECK(nested[0].isArray() && nested[0].empty());
+    CHECK(nested[1].isObject() && nested[1].empty());
+    CHECK_EQ(nested[2][0][0].asInt64(), 1);
+    CHECK_EQ(nested[3]["a"]["b"][0].asString(), std::string_view("deep"));
+
+    // Wrong types, missing keys and out-of-range indexes give null
+    CHECK(root["missing"]["x"][3].isNull());
+    CHECK(root["name"][0].isNull());
+    CHECK(numbers[6].isNull());
+    CHECK(numbers[-1].isNull());
+    CHECK_EQ(root["name"].asInt64(7), 7);
+}
+
+TEST(JsonRejectsMalformedInput) {
+    Document doc;
+    for (const Rejected& r : kRejected) {
+        bool ok = doc.parse(r.text);
+        if (ok || doc.error() == nullptr || std::strcmp(doc.error(), r.error) != 0 ||
+            doc.errorOffset() != r.offset) {
+            test::fail(__FILE__, __LINE__, std::string("\"") + r.text + "\" gave " +
+                       (ok ? "success" : doc.error() ? doc.error() : "no error") +
+                       " at " + std::to_string(doc.errorOffset()));
+        }
+        CHECK(doc.root().isNull());
+    }
+}
+
+TEST(JsonRejectsDeepNesting) {
+    std::string deep(Document::kMaxDepth, '[');
+    deep.append(Document::kMaxDepth, ']');
+    Document doc;
+    CHECK(doc.parse(deep));
+
+    deep.insert(0, "[");
+    deep.push_back(']');
+    CHECK(!doc.parse(deep));
+    CHECK_EQ(std::string(doc.error()), std::string("nesting too deep"));
+    CHECK_EQ(doc.errorOffset(), Document::kMaxDepth);
+}
+
+TEST(JsonReusedDocumentKeepsNoStaleState) {
+    Document doc;
+    CHECK(doc.parse(kDocument));
+    CHECK(!doc.parse("[1,"));
+    CHECK(doc.parse("[true]"));
+    CHECK(doc.error() == nullptr);
+    CHECK_EQ(doc.root().size(), 1u);
+    CHECK(doc.root()[0].asBool());
+}
+
+TEST(JsonDenseArraySpillsIntoMoreBlocks) {
+    // Two bytes of text per 16-byte node: more than the initial reserve
+    std::string dense = "[0";
+    for (int i = 1; i < 10000; i++) dense.append(",0");
+    dense.push_back(']');
+
+    Document doc;
+    for (int pass = 0; pass < 2; pass++) {
+        CHECK(doc.parse(dense));
+        CHECK_EQ(doc.root().size(), 10000u);
+        CHECK_EQ(doc.root()[9999].asInt64(-1), 0);
+    }
+}
+
+TEST(JsonWriterRoundTrip) {
+    std::string out;
+    Writer w(out);
+    w.beginObject();
+    w.key("text").value("line\nbreak \"q\" \\ \x01 \xc3\xa9");
+    w.key("int").value(-42);
+    w.key("big").value(18446744073709551615ull);
+    w.key("real").value(0.1);
+    w.key("inf").value(1.0 / 0.0);
+    w.key("flag").value(false);
+    w.key("nothing").null();
+    w.key("list").beginArray().value(1).beginArray().endArray().beginObject().endObject().endArray();
+    w.key("key \"escaped\"").value("");
+    w.endObject();
+
+    CHECK_EQ(out, std::string(
+        "{\"text\":\"line\\nbreak \\\"q\\\" \\\\ \\u0001 \xc3\xa9\",\"int\":-42,"
+        "\"big\":18446744073709551615,\"real\":0.1,\"inf\":null,\"flag\":false,"
+        "\"nothing\":null,\"list\":[1,[],{}],\"key \\\"escaped\\\"\":\"\"}"));
+
+    Document doc;
+    CHECK(doc.parse(out));
+    const Value& root = doc.root();
+    CHECK_EQ(root["text"].asString(), std::string_view("line\nbreak \"q\" \\ \x01 \xc3\xa9"));
+    CHECK_EQ(root["int"].asInt64(), -42);
+    CHECK_EQ(root["big"].asString(), std::string_view("18446744073709551615"));
+    CHECK_EQ(root["real"].asDouble(), 0.1);
+    CHECK(root["inf"].isNull());
+    CHECK(root["key \"escaped\""].isString());
+
+    // Writing a parsed value reproduces compact input exactly
+    CHECK_EQ(write(root), out);
+
+    // and is stable for the canned document once whitespace is dropped
+    Document canned;
+    CHECK(canned.parse(kDocument));
+    std::string compact = write(canned.root());
+    Document reparsed;
+    CHECK(reparsed.parse(compact));
+    CHECK_EQ(write(reparsed.root()), compact);
+    CHECK_EQ(reparsed.root()["escaped"].asString(), canned.root()["escaped"].asString());
+}
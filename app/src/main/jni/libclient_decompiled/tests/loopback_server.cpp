@@ -0,0 +1,184 @@
+#include "loopback_server.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace test {
+
+namespace {
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+size_t contentLength(const std::string& head) {
+    size_t pos = head.find("\r\nContent-Length:");
+    if (pos == std::string::npos) {
+        pos = head.find("\r\ncontent-length:");
+    }
+    return pos == std::string::npos ? 0 : std::strtoul(head.c_str() + pos + 17, nullptr, 10);
+}
+
+} // namespace
+
+Reply Reply::ok(const std::string& body) {
+    return raw("HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body);
+}
+
+Reply Reply::raw(std::string bytes, Action action) {
+    Reply reply;
+    reply.action = action;
+    reply.bytes = std::move(bytes);
+    return reply;
+}
+
+LoopbackServer::LoopbackServer(Handler handler)
+    : handler_(std::move(handler)), listen_fd_(-1), port_(0),
+      accepted_(0), pipelined_(0), stopping_(false) {}
+
+LoopbackServer::~LoopbackServer() {
+    stop();
+}
+
+bool LoopbackServer::start() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return false;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 64) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    acceptor_ = std::thread(&LoopbackServer::acceptLoop, this);
+    return true;
+}
+
+void LoopbackServer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || listen_fd_ < 0) return;
+        stopping_ = true;
+        // Unblocks accept() and every recv()
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        for (int fd : fds_) ::shutdown(fd, SHUT_RDWR);
+    }
+    stop_cv_.notify_all();
+    acceptor_.join();
+    for (std::thread& thread : threads_) thread.join();
+    for (int fd : fds_) ::close(fd);
+    ::close(listen_fd_);
+}
+
+std::vector<ReceivedRequest> LoopbackServer::requests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+}
+
+void LoopbackServer::acceptLoop() {
+    while (true) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            ::close(fd);
+            return;
+        }
+        int connection = ++accepted_;
+        fds_.push_back(fd);
+        threads_.emplace_back(&LoopbackServer::serve, this, fd, connection);
+    }
+}
+
+bool LoopbackServer::waitUntilStopped(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (timeout_ms < 0) {
+        stop_cv_.wait(lock, [this] { return stopping_; });
+        return true;
+    }
+    return stop_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return stopping_; });
+}
+
+void LoopbackServer::serve(int fd, int connection) {
+    std::string buffer;
+    char chunk[16 * 1024];
+    auto receive = [&]() {
+        ssize_t n;
+        do {
+            n = ::recv(fd, chunk, sizeof(chunk), 0);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+        return true;
+    };
+
+    while (true) {
+        size_t head_end;
+        while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!receive()) return;
+        }
+        ReceivedRequest request;
+        request.connection = connection;
+        request.head = buffer.substr(0, head_end);
+        size_t body_size = contentLength(request.head);
+        while (buffer.size() < head_end + 4 + body_size) {
+            if (!receive()) return;
+        }
+        request.body = buffer.substr(head_end + 4, body_size);
+        buffer.erase(0, head_end + 4 + body_size);
+
+        size_t method_end = request.head.find(' ');
+        size_t path_end = request.head.find(' ', method_end + 1);
+        request.method = request.head.substr(0, method_end);
+        request.path = request.head.substr(method_end + 1, path_end - method_end - 1);
+        if (buffer.find("\r\n\r\n") != std::string::npos) {
+            pipelined_++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            requests_.push_back(request);
+        }
+
+        Reply reply = handler_(request);
+        if (reply.delay_ms > 0 && waitUntilStopped(reply.delay_ms)) {
+            return;
+        }
+        switch (reply.action) {
+            case Reply::Respond:
+                if (!sendAll(fd, reply.bytes)) return;
+                break;
+            case Reply::RespondAndClose:
+                sendAll(fd, reply.bytes);
+                ::shutdown(fd, SHUT_RDWR);
+                return;
+            case Reply::Drop:
+                ::shutdown(fd, SHUT_RDWR);
+                return;
+            case Reply::Hold:
+                waitUntilStopped(-1);
+                return;
+        }
+    }
+}
+
+} // namespace test
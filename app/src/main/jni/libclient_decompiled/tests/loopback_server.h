@@ -0,0 +1,91 @@
+#ifndef LIBCLIENT_LOOPBACK_SERVER_H
+#define LIBCLIENT_LOOPBACK_SERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace test {
+
+// A request as the server parsed it off the wire
+struct ReceivedRequest {
+    std::string method;
+    std::string path;
+    std::string head;           // Request line and fields, without the blank line
+    std::string body;           // Content-Length framed
+    int connection = 0;         // 1 for the first accepted connection, and so on
+};
+
+// What the server does with one request
+struct Reply {
+    enum Action {
+        Respond,                // Send bytes, keep the connection
+        RespondAndClose,        // Send bytes, then close
+        Drop,                   // Close without answering
+        Hold                    // Never answer; the connection stays open until stop()
+    };
+
+    Action action = Respond;
+    std::string bytes;          // Complete raw response
+    int delay_ms = 0;           // Before acting
+
+    // 200 with a Content-Length body
+    static Reply ok(const std::string& body);
+    static Reply raw(std::string bytes, Action action = Respond);
+    static Reply drop() { return raw(std::string(), Drop); }
+    static Reply hold() { return raw(std::string(), Hold); }
+};
+
+// Stand-in HTTP/1.1 server on 127.0.0.1 for driving http::Engine. Every
+// connection gets a thread that reads requests in order and answers each
+// with what the handler returns, so keep-alive, pipelining, drops and
+// stalls can be scripted per request.
+class LoopbackServer {
+public:
+    using Handler = std::function<Reply(const ReceivedRequest& request)>;
+
+    explicit LoopbackServer(Handler handler);
+    ~LoopbackServer();
+
+    LoopbackServer(const LoopbackServer&) = delete;
+    LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+    // Listen on an ephemeral port
+    bool start();
+    // Close the listener and every connection, and join the threads
+    void stop();
+
+    int port() const { return port_; }
+    int accepted() const { return accepted_.load(); }
+    // Requests that were already fully buffered behind another one, i.e.
+    // arrived pipelined
+    int pipelined() const { return pipelined_.load(); }
+    std::vector<ReceivedRequest> requests() const;
+
+private:
+    void acceptLoop();
+    void serve(int fd, int connection);
+    bool waitUntilStopped(int timeout_ms);
+
+    Handler handler_;
+    int listen_fd_;
+    int port_;
+    std::thread acceptor_;
+    std::atomic<int> accepted_;
+    std::atomic<int> pipelined_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_;
+    std::vector<int> fds_;
+    std::vector<std::thread> threads_;
+    std::vector<ReceivedRequest> requests_;
+};
+
+} // namespace test
+
+#endif // LIBCLIENT_LOOPBACK_SERVER_H
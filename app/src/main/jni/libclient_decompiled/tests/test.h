@@ -0,0 +1,72 @@
+#ifndef LIBCLIENT_TEST_H
+#define LIBCLIENT_TEST_H
+
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal self-registering test harness. A failed CHECK reports and lets
+// the test carry on; the run exits non-zero if any check failed.
+
+namespace test {
+
+struct Case {
+    const char* name;
+    std::function<void()> fn;
+};
+
+inline std::vector<Case>& registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> fn) {
+        registry().push_back(Case{name, std::move(fn)});
+    }
+};
+
+inline void fail(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+    failures()++;
+}
+
+template <typename A, typename B>
+std::string describe(const char* a_expr, const char* b_expr, const A& a, const B& b) {
+    std::ostringstream out;
+    out << a_expr << " == " << b_expr << " (" << a << " vs " << b << ")";
+    return out.str();
+}
+
+} // namespace test
+
+#define TEST_CONCAT_(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_(a, b)
+
+#define TEST(name)                                                              \
+    static void name();                                                         \
+    static test::Registrar TEST_CONCAT(name, _registrar)(#name, name);          \
+    static void name()
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) test::fail(__FILE__, __LINE__, #cond);                     \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                          \
+    do {                                                                        \
+        const auto& test_a_ = (a);                                              \
+        const auto& test_b_ = (b);                                              \
+        if (!(test_a_ == test_b_)) {                                            \
+            test::fail(__FILE__, __LINE__, test::describe(#a, #b, test_a_, test_b_)); \
+        }                                                                       \
+    } while (0)
+
+#endif // LIBCLIENT_TEST_H
@@ -0,0 +1,19 @@
+#include "test.h"
+#include <cstring>
+
+// Runs every registered test, or those whose name contains argv[1]
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    for (const test::Case& c : test::registry()) {
+        if (filter != nullptr && std::strstr(c.name, filter) == nullptr) {
+            continue;
+        }
+        int before = test::failures();
+        c.fn();
+        std::printf("%-48s %s\n", c.name, test::failures() == before ? "ok" : "FAILED");
+        run++;
+    }
+    std::printf("%d tests, %d failed checks\n", run, test::failures());
+    return test::failures() == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/*
+ * libe6bmfqax5v - Asynchronous Jobs
+ *
+ * Submit/poll/wait variants of the AES, hash and zlib entry points. Jobs
+ * run on the library's shared thread pool (common/thread_pool.h) and work
+ * on the caller's buffers in place: nothing is copied at submission, so
+ * the buffers must stay valid until the job has finished or been released.
+ */
+
+#ifndef E6BMFQAX5V_ASYNC_JOB_H
+#define E6BMFQAX5V_ASYNC_JOB_H
+
+#include "e6bmfqax5v.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// Job Description
+// ============================================================================
+
+// Opaque job handle
+typedef struct e6bm_job e6bm_job_t;
+
+typedef enum {
+    E6BM_JOB_AES256_ENCRYPT = 0,   // CBC, no padding; input_len multiple of 16
+    E6BM_JOB_AES256_DECRYPT,
+    E6BM_JOB_MD5,                  // output holds 16 bytes
+    E6BM_JOB_SHA256,               // output holds 32 bytes
+    E6BM_JOB_ZLIB_COMPRESS,
+    E6BM_JOB_ZLIB_DECOMPRESS
+} e6bm_job_type_t;
+
+// Input is processed in chunks of this size; cancellation is checked and
+// progress reported between chunks
+#define E6BM_JOB_CHUNK_SIZE (256 * 1024)
+
+typedef struct {
+    e6bm_job_type_t type;
+    const uint8_t* input;          // Borrowed until the job finishes
+    size_t input_len;
+    uint8_t* output;               // Borrowed; may equal input for AES
+    size_t output_size;            // Capacity of output
+    const uint8_t* key;            // AES: 32 bytes, copied at submission
+    const uint8_t* iv;             // AES: 16 bytes, copied at submission
+    int level;                     // ZLIB_COMPRESS: 0-9, or -1 for the default
+
+    // Called on the worker thread. on_progress(done, input_len) follows
+    // each chunk of inputs larger than one chunk, and once with
+    // done == input_len when the job succeeds (the completion callback).
+    // on_error(code, message) is called instead when it fails or is
+    // cancelled. Either may be NULL.
+    e6bm_progress_callback_t on_progress;
+    e6bm_error_callback_t on_error;
+    void* userdata;
+} e6bm_job_desc_t;
+
+// ============================================================================
+// Job Control
+// ============================================================================
+
+/**
+ * Validate desc and queue the job. On success *job receives a handle that
+ * must be passed to e6bm_job_release(). Never blocks: if the thread pool's
+ * queue is full the job is dropped and E6BM_ERROR_BUSY returned.
+ *
+ * @return Error code (the job is not queued on failure)
+ */
+int e6bm_job_submit(const e6bm_job_desc_t* desc, e6bm_job_t** job);
+
+/**
+ * Non-blocking status check
+ *
+ * @param output_len Receives the bytes written to output once finished (may be NULL)
+ * @return E6BM_ERROR_IN_PROGRESS while queued or running, else the job's result
+ */
+int e6bm_job_poll(e6bm_job_t* job, size_t* output_len);
+
+/**
+ * Block until the job finishes or timeout_ms elapses (< 0: no limit).
+ * Callbacks have returned by the time a finished job is reported.
+ *
+ * @return E6BM_ERROR_IN_PROGRESS on timeout, else the job's result
+ */
+int e6bm_job_wait(e6bm_job_t* job, int timeout_ms, size_t* output_len);
+
+/**
+ * Ask the job to stop. A queued job never starts; a running one stops at
+ * its next chunk boundary. Either way it finishes with E6BM_ERROR_CANCELLED
+ * unless it had already completed.
+ */
+int e6bm_job_cancel(e6bm_job_t* job);
+
+/**
+ * Release the handle. An unfinished job is cancelled and waited for, so
+ * the borrowed buffers may be freed once this returns. Must not be called
+ * from the job's own callbacks.
+ */
+void e6bm_job_release(e6bm_job_t* job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // E6BMFQAX5V_ASYNC_JOB_H
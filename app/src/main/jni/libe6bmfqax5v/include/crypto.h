@@ -113,19 +113,6 @@ void e6bm_md5_final(e6bm_md5_context_t* ctx, uint8_t* hash);
  */
 int e6bm_md5_compute(const uint8_t* input, size_t input_len, uint8_t* output);
 
-// MD5 internal functions
-void e6bm_md5_transform(uint32_t state[4], const uint8_t block[64]);
-void e6bm_md5_encode(uint8_t* output, const uint32_t* input, size_t len);
-void e6bm_md5_decode(uint32_t* output, const uint8_t* input, size_t len);
-
-// MD5 round functions
-#define E6BM_MD5_F(x, y, z) (((x) & (y)) | ((~x) & (z)))
-#define E6BM_MD5_G(x, y, z) (((x) & (z)) | ((y) & (~z)))
-#define E6BM_MD5_H(x, y, z) ((x) ^ (y) ^ (z))
-#define E6BM_MD5_I(x, y, z) ((y) ^ ((x) | (~z)))
-
-#define E6BM_MD5_ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
-
 // ============================================================================
 // SHA-256 Implementation
 // ============================================================================
@@ -150,19 +137,111 @@ void e6bm_sha256_final(e6bm_sha256_context_t* ctx, uint8_t* hash);
  */
 int e6bm_sha256_compute(const uint8_t* input, size_t input_len, uint8_t* output);
 
-// SHA-256 internal functions
-void e6bm_sha256_transform(uint32_t state[8], const uint8_t block[64]);
+// ============================================================================
+// SHA-256 Tree Hash
+// ============================================================================
+
+// A separate, versioned digest: it does NOT equal SHA-256 of the input.
+//
+// Version 1:
+//   leaf[i] = SHA-256(input[i * 64K .. (i + 1) * 64K))   (empty input: one empty leaf)
+//   node    = SHA-256(0x01 || left || right); an odd last node moves up unchanged
+//   root    = SHA-256("E6BM-TREE" || version:u8 || leaf_size:le32 || total_len:le64 || top)
+//
+// Leaves are hashed in parallel, four at a time per core with the
+// multi-buffer kernel when the CPU has no SHA instructions.
+
+#define E6BM_TREE_VERSION    1
+#define E6BM_TREE_LEAF_SIZE  (64 * 1024)
+
+/**
+ * Compute the version 1 tree root of a buffer (no tree retained).
+ * Leaves are spread over the library's shared thread pool; threads caps
+ * how many workers take part (1: the calling thread only, <= 0: all).
+ */
+int e6bm_tree_hash_compute(const uint8_t* input, size_t input_len, uint8_t* root, int threads);
+
+/**
+ * Build and keep the whole tree for later range verification/updates
+ */
+int e6bm_tree_hash_build(e6bm_tree_hash_t* tree, const uint8_t* input, size_t input_len, int threads);
+
+/**
+ * Release a tree built by e6bm_tree_hash_build
+ */
+void e6bm_tree_hash_free(e6bm_tree_hash_t* tree);
+
+/**
+ * Re-hash only the leaves covering [offset, offset + len) of input (the
+ * whole buffer the tree was built from) and compare them with the tree.
+ * Returns E6BM_SUCCESS if they match, E6BM_ERROR_CRYPTO if not.
+ */
+int e6bm_tree_hash_verify_range(const e6bm_tree_hash_t* tree, const uint8_t* input,
+                                size_t offset, size_t len);
+
+/**
+ * Refresh the tree after [offset, offset + len) of input changed in place:
+ * re-hashes the affected leaves and their paths up to the root.
+ */
+int e6bm_tree_hash_update_range(e6bm_tree_hash_t* tree, const uint8_t* input,
+                                size_t offset, size_t len);
+
+// ============================================================================
+// Shared Keys
+// ============================================================================
 
-// SHA-256 constants
-extern const uint32_t e6bm_sha256_k[64];
+// An e6bm_key_t is expanded once and then only read, so threads share it
+// by reference instead of serializing on a locked context. Everything an
+// operation mutates (IV, partial block, hash state) lives in a stream or
+// HMAC object owned by the calling thread.
 
-// SHA-256 logical functions
-#define E6BM_SHA256_CH(x, y, z)  (((x) & (y)) ^ (~(x) & (z)))
-#define E6BM_SHA256_MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
-#define E6BM_SHA256_EP0(x) (e6bm_rotr32(x, 2) ^ e6bm_rotr32(x, 13) ^ e6bm_rotr32(x, 22))
-#define E6BM_SHA256_EP1(x) (e6bm_rotr32(x, 6) ^ e6bm_rotr32(x, 11) ^ e6bm_rotr32(x, 25))
-#define E6BM_SHA256_SIG0(x) (e6bm_rotr32(x, 7) ^ e6bm_rotr32(x, 18) ^ ((x) >> 3))
-#define E6BM_SHA256_SIG1(x) (e6bm_rotr32(x, 17) ^ e6bm_rotr32(x, 19) ^ ((x) >> 10))
+/**
+ * Expand key into a new shared key with one reference. The AES schedules
+ * are built for 16, 24 or 32 byte keys; HMAC accepts any length.
+ */
+int e6bm_key_create(const uint8_t* key, size_t key_len, e6bm_key_t** out);
+
+/**
+ * Take another reference; returns key
+ */
+e6bm_key_t* e6bm_key_retain(e6bm_key_t* key);
+
+/**
+ * Drop a reference; the last one wipes and frees the key
+ */
+void e6bm_key_release(e6bm_key_t* key);
+
+/**
+ * Start a CBC stream (no padding) over a shared AES key
+ */
+int e6bm_cbc_begin(e6bm_cbc_stream_t* stream, const e6bm_key_t* key,
+                   const uint8_t* iv, bool encrypt);
+
+/**
+ * Process input, writing every block that is complete so far. Decryption
+ * holds back the last whole block until more input or final arrives.
+ * output must have room for input_len + 16 bytes and must not overlap input.
+ */
+int e6bm_cbc_update(e6bm_cbc_stream_t* stream, const uint8_t* input, size_t input_len,
+                    uint8_t* output, size_t* output_len);
+
+/**
+ * Finish the stream: encryption writes the PKCS#7 padded last block,
+ * decryption writes the unpadded remainder (up to 16 bytes).
+ */
+int e6bm_cbc_final(e6bm_cbc_stream_t* stream, uint8_t* output, size_t* output_len);
+
+/**
+ * Start an HMAC-SHA256 over a shared key (copies the inner pad state)
+ */
+void e6bm_hmac_begin(e6bm_hmac_t* hmac, const e6bm_key_t* key);
+
+void e6bm_hmac_update(e6bm_hmac_t* hmac, const uint8_t* data, size_t len);
+
+/**
+ * Write the 32 byte MAC and wipe the state
+ */
+void e6bm_hmac_final(e6bm_hmac_t* hmac, uint8_t* mac);
 
 // ============================================================================
 // Utility Functions
@@ -250,7 +329,8 @@ int e6bm_hw_crypto_init(void);
 // ============================================================================
 
 /**
- * PBKDF2-HMAC-SHA256 key derivation
+ * PBKDF2-HMAC-SHA256 key derivation. The password's pad states are
+ * computed once, so each iteration costs two compressions.
  */
 int e6bm_pbkdf2_hmac_sha256(const uint8_t* password, size_t password_len,
                             const uint8_t* salt, size_t salt_len,
@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <pthread.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,7 +48,10 @@ typedef enum {
     E6BM_ERROR_COMPRESSION = -4,
     E6BM_ERROR_IO = -5,
     E6BM_ERROR_NOT_INITIALIZED = -6,
-    E6BM_ERROR_ALREADY_INITIALIZED = -7
+    E6BM_ERROR_ALREADY_INITIALIZED = -7,
+    E6BM_ERROR_CANCELLED = -8,
+    E6BM_ERROR_IN_PROGRESS = -9,
+    E6BM_ERROR_BUSY = -10
 } e6bm_error_t;
 
 // Crypto algorithm types
@@ -29,8 +29,7 @@ extern "C" {
 // Common JNI error checking
 #define JNI_CHECK_NULL(env, obj, ret) \
     if (!(obj)) { \
-        jclass exc = (*env)->FindClass(env, "java/lang/NullPointerException"); \
-        if (exc) (*env)->ThrowNew(env, exc, "Null pointer argument"); \
+        e6bm_jni_throw_exception(env, JNI_EXC_NULL_POINTER, "Null pointer argument"); \
         return (ret); \
     }
 
@@ -95,12 +94,14 @@ jbyteArray e6bm_jni_buffer_to_byte_array(JNIEnv* env,
                                          const uint8_t* buffer, size_t size);
 
 /**
- * Convert jstring to native string
+ * Convert jstring to native string (malloc'd; release with e6bm_jni_free_cstr).
+ * For strings only needed within a call, common::JniUtf8 avoids the allocation.
  */
 char* e6bm_jni_string_to_cstr(JNIEnv* env, jstring jstr);
 
 /**
- * Convert native string to jstring
+ * Convert native string to jstring; input that is not modified UTF-8 is
+ * re-encoded rather than handed to the VM as is
  */
 jstring e6bm_jni_cstr_to_string(JNIEnv* env, const char* cstr);
 
@@ -110,7 +111,13 @@ jstring e6bm_jni_cstr_to_string(JNIEnv* env, const char* cstr);
 void e6bm_jni_free_cstr(JNIEnv* env, jstring jstr, const char* cstr);
 
 /**
- * Throw Java exception
+ * Resolve the JNI_EXC_* exception classes as global refs (from JNI_OnLoad)
+ */
+int e6bm_jni_cache_classes(JNIEnv* env);
+
+/**
+ * Throw Java exception. The JNI_EXC_* classes come from the load-time cache;
+ * other names fall back to FindClass.
  */
 void e6bm_jni_throw_exception(JNIEnv* env, const char* class_name,
                               const char* message);
@@ -164,6 +171,60 @@ jobject e6bm_jni_new_global_ref(JNIEnv* env, jobject obj);
  */
 void e6bm_jni_delete_global_ref(JNIEnv* env, jobject obj);
 
+// ============================================================================
+// Zero-Copy Buffer Access
+// ============================================================================
+
+// Memory behind a direct java.nio.ByteBuffer. Valid for as long as the
+// buffer object is reachable; position and limit are not applied.
+typedef struct {
+    uint8_t* data;
+    size_t capacity;
+} e6bm_jni_direct_buffer_t;
+
+// A byte[] pinned with GetPrimitiveArrayCritical. No JNI call may be made
+// and the thread must not block until it is released.
+typedef struct {
+    jbyteArray array;
+    uint8_t* data;
+    size_t size;
+} e6bm_jni_critical_array_t;
+
+/**
+ * Resolve a direct ByteBuffer and check it holds at least min_size bytes.
+ * Fails for heap buffers, which have no stable native address.
+ */
+int e6bm_jni_get_direct_buffer(JNIEnv* env, jobject buffer, size_t min_size,
+                               e6bm_jni_direct_buffer_t* out);
+
+/**
+ * Check a byte[] holds at least min_size bytes and record its length,
+ * without pinning it. Prepare every array of a call before pinning any:
+ * GetArrayLength is itself a JNI call and not allowed in a critical region.
+ */
+int e6bm_jni_critical_prepare(JNIEnv* env, jbyteArray array, size_t min_size,
+                              e6bm_jni_critical_array_t* out);
+
+/**
+ * Pin a prepared byte[] without copying. Makes no other JNI call, so
+ * several arrays can be pinned back to back. Every successful pin must be
+ * paired with e6bm_jni_critical_release().
+ */
+int e6bm_jni_critical_pin(JNIEnv* env, e6bm_jni_critical_array_t* array);
+
+/**
+ * Unpin a byte[]. mode is 0 to keep writes or JNI_ABORT for read-only use
+ * (avoids the copy-back on VMs that returned a copy).
+ */
+void e6bm_jni_critical_release(JNIEnv* env, e6bm_jni_critical_array_t* array, jint mode);
+
+/**
+ * Copy a small byte[] (key, IV) into caller storage; no allocation.
+ * Fails unless the array holds exactly size bytes.
+ */
+int e6bm_jni_read_byte_array(JNIEnv* env, jbyteArray array,
+                             uint8_t* out, size_t size);
+
 // ============================================================================
 // Exported JNI Functions
 // ============================================================================
@@ -248,6 +309,61 @@ JAVA_METHOD(jbyteArray, com_eternal_xdsdk_Crypto, nativeCompress)
 JAVA_METHOD(jbyteArray, com_eternal_xdsdk_Crypto, nativeDecompress)
     (JNIEnv* env, jobject thiz, jbyteArray input);
 
+/*
+ * Zero-copy variants. The Direct methods take direct ByteBuffers and the
+ * Critical methods pin byte[]s; both run on the Java memory in place, so
+ * input and output may be the same buffer. length is in bytes (a multiple
+ * of 16 for AES, no padding is applied). They return the number of bytes
+ * written or a negative e6bm_error_t.
+ */
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeEncryptDirect)
+    (JNIEnv* env, jobject thiz, jobject input, jobject output, jint length,
+     jbyteArray key, jbyteArray iv);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeDecryptDirect)
+    (JNIEnv* env, jobject thiz, jobject input, jobject output, jint length,
+     jbyteArray key, jbyteArray iv);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeSHA256Direct)
+    (JNIEnv* env, jobject thiz, jobject input, jint length, jobject output);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeEncryptCritical)
+    (JNIEnv* env, jobject thiz, jbyteArray input, jbyteArray output, jint length,
+     jbyteArray key, jbyteArray iv);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeDecryptCritical)
+    (JNIEnv* env, jobject thiz, jbyteArray input, jbyteArray output, jint length,
+     jbyteArray key, jbyteArray iv);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeSHA256Critical)
+    (JNIEnv* env, jobject thiz, jbyteArray input, jint length, jbyteArray output);
+
+/*
+ * Asynchronous jobs (async_job.h) over direct ByteBuffers. The buffers are
+ * held by global references, not copied, until nativeJobRelease. type is an
+ * e6bm_job_type_t; key and iv are only read for AES and level only for
+ * compression. nativeJobSubmit returns a handle (0 on failure); poll and
+ * wait return bytes written, E6BM_ERROR_IN_PROGRESS or a negative
+ * e6bm_error_t.
+ */
+
+JAVA_METHOD(jlong, com_eternal_xdsdk_Crypto, nativeJobSubmit)
+    (JNIEnv* env, jobject thiz, jint type, jobject input, jint length,
+     jobject output, jbyteArray key, jbyteArray iv, jint level);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeJobPoll)
+    (JNIEnv* env, jobject thiz, jlong handle);
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeJobWait)
+    (JNIEnv* env, jobject thiz, jlong handle, jint timeout_ms);
+
+JAVA_METHOD(void, com_eternal_xdsdk_Crypto, nativeJobCancel)
+    (JNIEnv* env, jobject thiz, jlong handle);
+
+JAVA_METHOD(void, com_eternal_xdsdk_Crypto, nativeJobRelease)
+    (JNIEnv* env, jobject thiz, jlong handle);
+
 // ============================================================================
 // Method Registration
 // ============================================================================
@@ -12,6 +12,10 @@
 #include <stdbool.h>
 #include <pthread.h>
 
+#include "e6bmfqax5v.h"     // e6bm_error_t for the callback types
+#include "common/hash.h"
+#include "common/aes.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,19 +34,26 @@ typedef struct {
     bool is_encrypt;              // Encryption or decryption mode
 } e6bm_aes_context_t;
 
-// MD5 context
-typedef struct {
-    uint32_t state[4];            // Hash state (A, B, C, D)
-    uint64_t count;               // Number of bits processed
-    uint8_t buffer[64];           // Input buffer
-} e6bm_md5_context_t;
+// MD5 context (shared hash engine; count is in bytes)
+typedef common_md5_context_t e6bm_md5_context_t;
+
+// SHA-256 context (shared hash engine; count is in bytes)
+typedef common_sha256_context_t e6bm_sha256_context_t;
+
+// SHA-256 Merkle tree over fixed-size leaves (see e6bm_tree_hash_build).
+// nodes holds every level back to back, leaves first.
+#define E6BM_TREE_MAX_LEVELS 64
 
-// SHA-256 context
 typedef struct {
-    uint32_t state[8];            // Hash state (H0-H7)
-    uint64_t count;               // Number of bits processed
-    uint8_t buffer[64];           // Input buffer
-} e6bm_sha256_context_t;
+    uint32_t version;             // Tree format version (E6BM_TREE_VERSION)
+    uint32_t leaf_size;           // Bytes per leaf
+    uint64_t total_len;           // Length of the hashed input
+    uint32_t level_count;         // Levels including leaves and the top node
+    size_t level_offset[E6BM_TREE_MAX_LEVELS];  // Index of each level's first node
+    size_t level_size[E6BM_TREE_MAX_LEVELS];    // Node count per level
+    uint8_t (*nodes)[32];         // All node digests
+    uint8_t root[32];             // Versioned root digest
+} e6bm_tree_hash_t;
 
 // Zlib compression context
 typedef struct {
@@ -51,14 +62,42 @@ typedef struct {
     bool initialized;             // Initialization flag
 } e6bm_zlib_context_t;
 
-// Main cryptographic context
+// Keyed material: AES schedules and HMAC-SHA256 pad states. Built once by
+// e6bm_key_create() and never written again, so any number of threads can
+// use one key at the same time without locking. Only refs changes; it sits
+// on its own cache line so retain/release does not evict the schedules
+// from other cores.
+typedef struct {
+    uint32_t refs;                          // Atomic reference count
+    bool has_aes;                           // Key length was 16, 24 or 32 bytes
+    common_aes_key_t aes __attribute__((aligned(64)));  // Encrypt and decrypt schedules
+    e6bm_sha256_context_t hmac_inner;       // SHA-256 state after absorbing key ^ ipad
+    e6bm_sha256_context_t hmac_outer;       // SHA-256 state after absorbing key ^ opad
+} e6bm_key_t;
+
+// Per-operation CBC state over a shared key; lives on the caller's stack
+typedef struct {
+    const e6bm_key_t* key;
+    uint8_t iv[16];               // Chaining value, advanced by every update
+    uint8_t partial[16];          // Bytes not yet forming a whole block
+    size_t partial_len;
+    bool encrypt;
+} e6bm_cbc_stream_t;
+
+// Per-operation HMAC-SHA256 state over a shared key
+typedef struct {
+    const e6bm_key_t* key;
+    e6bm_sha256_context_t inner;  // Copy of the key's inner pad state
+} e6bm_hmac_t;
+
+// Main cryptographic context. Immutable once e6bm_crypto_init() has run:
+// threads that share it share the key by reference and keep their own
+// IV and hash state in e6bm_cbc_stream_t / e6bm_hmac_t.
 struct e6bm_context {
-    e6bm_aes_context_t* aes_ctx;
-    e6bm_md5_context_t* md5_ctx;
-    e6bm_sha256_context_t* sha256_ctx;
-    e6bm_zlib_context_t* zlib_ctx;
+    e6bm_key_t* key;              // Shared key (NULL until initialized)
+    e6bm_crypto_algo_t algo;
+    uint8_t iv[16];               // Default IV for new streams
     uint32_t flags;
-    pthread_mutex_t mutex;
 };
 
 // ============================================================================
@@ -187,6 +226,7 @@ typedef struct {
     uint32_t flags;
     uint8_t global_key[32];       // Global encryption key
     uint8_t global_iv[16];        // Global IV
+    e6bm_key_t* global_key_ref;   // global_key expanded once, shared by every thread
     
     // Statistics
     uint64_t total_encrypted;
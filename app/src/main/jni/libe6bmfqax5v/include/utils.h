@@ -8,6 +8,7 @@
 #define E6BMFQAX5V_UTILS_H
 
 #include "types.h"
+#include "common/log.h"
 #include <zlib.h>
 
 #ifdef __cplusplus
@@ -178,16 +179,25 @@ void e6bm_set_log_level(e6bm_log_level_t level);
 e6bm_log_level_t e6bm_get_log_level(void);
 
 /**
- * Log message
+ * Log message. Queued to the shared logging thread (common/log.h), so fmt
+ * must be a string literal.
  */
-void e6bm_log(e6bm_log_level_t level, const char* fmt, ...);
+void e6bm_log(e6bm_log_level_t level, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
 
-// Logging macros
-#define E6BM_LOG_ERROR(fmt, ...) e6bm_log(E6BM_LOG_LEVEL_ERROR, "[ERROR] " fmt, ##__VA_ARGS__)
-#define E6BM_LOG_WARN(fmt, ...)  e6bm_log(E6BM_LOG_LEVEL_WARN,  "[WARN]  " fmt, ##__VA_ARGS__)
-#define E6BM_LOG_INFO(fmt, ...)  e6bm_log(E6BM_LOG_LEVEL_INFO,  "[INFO]  " fmt, ##__VA_ARGS__)
-#define E6BM_LOG_DEBUG(fmt, ...) e6bm_log(E6BM_LOG_LEVEL_DEBUG, "[DEBUG] " fmt, ##__VA_ARGS__)
-#define E6BM_LOG_TRACE(fmt, ...) e6bm_log(E6BM_LOG_LEVEL_TRACE, "[TRACE] " fmt, ##__VA_ARGS__)
+// Logging macros; levels below COMMON_LOG_MIN_LEVEL compile away
+#define E6BM_LOG_AT(common_level, level, fmt, ...)              \
+    do {                                                        \
+        if (COMMON_LOG_COMPILED(common_level)) {                \
+            e6bm_log(level, fmt, ##__VA_ARGS__);                \
+        }                                                       \
+    } while (0)
+
+#define E6BM_LOG_ERROR(fmt, ...) E6BM_LOG_AT(COMMON_LOG_ERROR,   E6BM_LOG_LEVEL_ERROR, "[ERROR] " fmt, ##__VA_ARGS__)
+#define E6BM_LOG_WARN(fmt, ...)  E6BM_LOG_AT(COMMON_LOG_WARN,    E6BM_LOG_LEVEL_WARN,  "[WARN]  " fmt, ##__VA_ARGS__)
+#define E6BM_LOG_INFO(fmt, ...)  E6BM_LOG_AT(COMMON_LOG_INFO,    E6BM_LOG_LEVEL_INFO,  "[INFO]  " fmt, ##__VA_ARGS__)
+#define E6BM_LOG_DEBUG(fmt, ...) E6BM_LOG_AT(COMMON_LOG_DEBUG,   E6BM_LOG_LEVEL_DEBUG, "[DEBUG] " fmt, ##__VA_ARGS__)
+#define E6BM_LOG_TRACE(fmt, ...) E6BM_LOG_AT(COMMON_LOG_VERBOSE, E6BM_LOG_LEVEL_TRACE, "[TRACE] " fmt, ##__VA_ARGS__)
 
 /**
  * Hex dump for debugging
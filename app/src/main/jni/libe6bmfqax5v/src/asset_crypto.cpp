@@ -6,6 +6,7 @@
 #include "../include/e6bmfqax5v.h"
 #include "../include/crypto.h"
 #include "../include/utils.h"
+#include "common/trace.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -16,6 +17,7 @@
 int e6bm_encrypt_asset(const uint8_t* plain_data, size_t plain_len,
                        uint8_t** encrypted_data, size_t* encrypted_len,
                        bool compress) {
+    COMMON_TRACE_FUNCTION();
     if (plain_data == NULL || encrypted_data == NULL || encrypted_len == NULL) {
         return E6BM_ERROR_INVALID_PARAM;
     }
@@ -128,6 +130,7 @@ int e6bm_encrypt_asset(const uint8_t* plain_data, size_t plain_len,
 int e6bm_decrypt_asset(const uint8_t* encrypted_data, size_t encrypted_len,
                        uint8_t** plain_data, size_t* plain_len,
                        bool decompress) {
+    COMMON_TRACE_FUNCTION();
     if (encrypted_data == NULL || plain_data == NULL || plain_len == NULL) {
         return E6BM_ERROR_INVALID_PARAM;
     }
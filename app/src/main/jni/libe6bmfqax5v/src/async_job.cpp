@@ -0,0 +1,353 @@
+/*
+ * libe6bmfqax5v - Asynchronous Jobs Implementation
+ *
+ * Each job is one pool task that walks its input in E6BM_JOB_CHUNK_SIZE
+ * steps, carrying the CBC chain, hash state or zlib stream across chunks.
+ * The handle is shared by the caller and the running task and freed when
+ * both have let go of it.
+ */
+
+#include "../include/async_job.h"
+#include "../include/crypto.h"
+#include "../include/utils.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define E6BM_JOB_QUEUED    0
+#define E6BM_JOB_RUNNING   1
+#define E6BM_JOB_FINISHED  2
+
+struct e6bm_job {
+    e6bm_job_desc_t desc;
+    e6bm_aes_context_t aes;        // Expanded at submission; iv advances per chunk
+
+    int refs;                      // Caller and pool task
+    int cancel_requested;
+    int state;                     // E6BM_JOB_*; guarded by mutex
+    int result;
+    size_t output_len;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;       // CLOCK_MONOTONIC for timed waits
+};
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static void e6bm_job_unref(e6bm_job_t* job) {
+    if (__atomic_sub_fetch(&job->refs, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    e6bm_secure_memzero(&job->aes, sizeof(job->aes));
+    pthread_cond_destroy(&job->finished);
+    pthread_mutex_destroy(&job->mutex);
+    free(job);
+}
+
+static bool e6bm_job_cancelled(const e6bm_job_t* job) {
+    return __atomic_load_n(&job->cancel_requested, __ATOMIC_RELAXED) != 0;
+}
+
+// Progress after a chunk; only large inputs report intermediate steps
+static void e6bm_job_progress(const e6bm_job_t* job, size_t done) {
+    if (job->desc.on_progress && done < job->desc.input_len &&
+        job->desc.input_len > E6BM_JOB_CHUNK_SIZE) {
+        job->desc.on_progress(done, job->desc.input_len, job->desc.userdata);
+    }
+}
+
+static size_t e6bm_job_chunk(size_t remaining) {
+    return remaining < E6BM_JOB_CHUNK_SIZE ? remaining : E6BM_JOB_CHUNK_SIZE;
+}
+
+// ============================================================================
+// Operations
+// ============================================================================
+
+static int e6bm_job_run_aes(e6bm_job_t* job, bool encrypt) {
+    const uint8_t* input = job->desc.input;
+    uint8_t* output = job->desc.output;
+    size_t total = job->desc.input_len;
+
+    for (size_t offset = 0; offset < total;) {
+        if (e6bm_job_cancelled(job)) return E6BM_ERROR_CANCELLED;
+
+        size_t len = e6bm_job_chunk(total - offset);
+        size_t out_len = len;
+        uint8_t next_iv[E6BM_AES_BLOCK_SIZE];
+        if (!encrypt) {
+            // In place, the last ciphertext block is overwritten by the chunk
+            memcpy(next_iv, input + offset + len - E6BM_AES_BLOCK_SIZE, E6BM_AES_BLOCK_SIZE);
+        }
+
+        int ret = encrypt
+            ? e6bm_aes_cbc_encrypt(&job->aes, input + offset, len, output + offset, &out_len)
+            : e6bm_aes_cbc_decrypt(&job->aes, input + offset, len, output + offset, &out_len);
+        if (ret != E6BM_SUCCESS) return ret;
+
+        memcpy(job->aes.iv, encrypt ? output + offset + len - E6BM_AES_BLOCK_SIZE : next_iv,
+               E6BM_AES_BLOCK_SIZE);
+        offset += len;
+        e6bm_job_progress(job, offset);
+    }
+
+    job->output_len = total;
+    return E6BM_SUCCESS;
+}
+
+static int e6bm_job_run_hash(e6bm_job_t* job, common_hash_algo_t algo) {
+    common_hash_context_t ctx;
+    if (common_hash_init(&ctx, algo) != 0) return E6BM_ERROR_CRYPTO;
+
+    size_t total = job->desc.input_len;
+    for (size_t offset = 0; offset < total;) {
+        if (e6bm_job_cancelled(job)) return E6BM_ERROR_CANCELLED;
+
+        size_t len = e6bm_job_chunk(total - offset);
+        common_hash_update(&ctx, job->desc.input + offset, len);
+        offset += len;
+        e6bm_job_progress(job, offset);
+    }
+
+    job->output_len = common_hash_final(&ctx, job->desc.output);
+    return E6BM_SUCCESS;
+}
+
+// Deflate or inflate chunk by chunk into the caller's output buffer
+static int e6bm_job_run_zlib(e6bm_job_t* job, bool compress) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    int ret = compress ? deflateInit(&stream, job->desc.level) : inflateInit(&stream);
+    if (ret != Z_OK) return E6BM_ERROR_COMPRESSION;
+
+    const uint8_t* input = job->desc.input;
+    size_t total = job->desc.input_len;
+    size_t offset = 0;
+    size_t out_offset = 0;
+    int result = E6BM_ERROR_COMPRESSION;
+
+    for (;;) {
+        if (e6bm_job_cancelled(job)) {
+            result = E6BM_ERROR_CANCELLED;
+            break;
+        }
+
+        size_t len = e6bm_job_chunk(total - offset);
+        bool last = offset + len == total;
+        stream.next_in = (Bytef*)(input + offset);
+        stream.avail_in = (uInt)len;
+
+        // Drain this chunk; output is handed to zlib in uInt-sized windows
+        do {
+            size_t out_room = job->desc.output_size - out_offset;
+            stream.next_out = job->desc.output + out_offset;
+            stream.avail_out = out_room > UINT_MAX ? UINT_MAX : (uInt)out_room;
+            uInt before = stream.avail_out;
+
+            ret = compress ? deflate(&stream, last ? Z_FINISH : Z_NO_FLUSH)
+                           : inflate(&stream, Z_NO_FLUSH);
+            out_offset += before - stream.avail_out;
+
+            if (ret == Z_STREAM_END || (ret != Z_OK && ret != Z_BUF_ERROR)) break;
+            if (stream.avail_out == 0 && out_offset == job->desc.output_size) {
+                ret = Z_BUF_ERROR;     // Output buffer too small
+                break;
+            }
+        } while (stream.avail_in != 0 || (compress && last));
+
+        offset += len - stream.avail_in;
+        if (ret == Z_STREAM_END) {
+            result = E6BM_SUCCESS;
+            break;
+        }
+        if ((ret != Z_OK && ret != Z_BUF_ERROR) || stream.avail_out == 0 || last) {
+            break;                     // Corrupt, truncated or out of room
+        }
+        e6bm_job_progress(job, offset);
+    }
+
+    if (compress) {
+        deflateEnd(&stream);
+    } else {
+        inflateEnd(&stream);
+    }
+    job->output_len = out_offset;
+    return result;
+}
+
+static int e6bm_job_execute(e6bm_job_t* job) {
+    switch (job->desc.type) {
+        case E6BM_JOB_AES256_ENCRYPT: return e6bm_job_run_aes(job, true);
+        case E6BM_JOB_AES256_DECRYPT: return e6bm_job_run_aes(job, false);
+        case E6BM_JOB_MD5:            return e6bm_job_run_hash(job, COMMON_HASH_MD5);
+        case E6BM_JOB_SHA256:         return e6bm_job_run_hash(job, COMMON_HASH_SHA256);
+        case E6BM_JOB_ZLIB_COMPRESS:  return e6bm_job_run_zlib(job, true);
+        case E6BM_JOB_ZLIB_DECOMPRESS: return e6bm_job_run_zlib(job, false);
+    }
+    return E6BM_ERROR_INVALID_PARAM;
+}
+
+static void e6bm_job_task(void* arg) {
+    COMMON_TRACE_FUNCTION();
+    e6bm_job_t* job = (e6bm_job_t*)arg;
+
+    pthread_mutex_lock(&job->mutex);
+    job->state = E6BM_JOB_RUNNING;
+    pthread_mutex_unlock(&job->mutex);
+
+    int result = e6bm_job_execute(job);
+    if (result == E6BM_SUCCESS) {
+        if (job->desc.on_progress) {
+            job->desc.on_progress(job->desc.input_len, job->desc.input_len, job->desc.userdata);
+        }
+    } else {
+        job->output_len = 0;
+        if (job->desc.on_error) {
+            job->desc.on_error((e6bm_error_t)result, e6bm_get_error_string((e6bm_error_t)result),
+                               job->desc.userdata);
+        }
+    }
+
+    pthread_mutex_lock(&job->mutex);
+    job->result = result;
+    job->state = E6BM_JOB_FINISHED;
+    pthread_cond_broadcast(&job->finished);
+    pthread_mutex_unlock(&job->mutex);
+
+    e6bm_job_unref(job);
+}
+
+static int e6bm_job_validate(const e6bm_job_desc_t* desc) {
+    if ((desc->input == NULL && desc->input_len > 0) || desc->output == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    switch (desc->type) {
+        case E6BM_JOB_AES256_ENCRYPT:
+        case E6BM_JOB_AES256_DECRYPT:
+            if (desc->key == NULL || desc->iv == NULL ||
+                desc->input_len % E6BM_AES_BLOCK_SIZE != 0 ||
+                desc->output_size < desc->input_len) {
+                return E6BM_ERROR_INVALID_PARAM;
+            }
+            return E6BM_SUCCESS;
+        case E6BM_JOB_MD5:
+            return desc->output_size >= COMMON_MD5_DIGEST_SIZE ? E6BM_SUCCESS : E6BM_ERROR_INVALID_PARAM;
+        case E6BM_JOB_SHA256:
+            return desc->output_size >= COMMON_SHA256_DIGEST_SIZE ? E6BM_SUCCESS : E6BM_ERROR_INVALID_PARAM;
+        case E6BM_JOB_ZLIB_COMPRESS:
+            return desc->level >= -1 && desc->level <= 9 ? E6BM_SUCCESS : E6BM_ERROR_INVALID_PARAM;
+        case E6BM_JOB_ZLIB_DECOMPRESS:
+            return E6BM_SUCCESS;
+    }
+    return E6BM_ERROR_INVALID_PARAM;
+}
+
+// ============================================================================
+// Job Control
+// ============================================================================
+
+int e6bm_job_submit(const e6bm_job_desc_t* desc, e6bm_job_t** job) {
+    if (desc == NULL || job == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    *job = NULL;
+
+    int ret = e6bm_job_validate(desc);
+    if (ret != E6BM_SUCCESS) {
+        return ret;
+    }
+
+    e6bm_job_t* j = (e6bm_job_t*)calloc(1, sizeof(e6bm_job_t));
+    if (j == NULL) {
+        return E6BM_ERROR_MEMORY;
+    }
+    j->desc = *desc;
+    j->desc.key = NULL;            // Copied into the key schedule below
+    j->desc.iv = NULL;
+    j->refs = 2;
+    j->state = E6BM_JOB_QUEUED;
+
+    if (desc->type == E6BM_JOB_AES256_ENCRYPT || desc->type == E6BM_JOB_AES256_DECRYPT) {
+        ret = e6bm_aes_init(&j->aes, desc->key, 256, desc->iv);
+        if (ret != E6BM_SUCCESS) {
+            free(j);
+            return ret;
+        }
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&j->finished, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&j->mutex, NULL);
+
+    // Callers are often UI or JNI threads; refuse rather than wait for room
+    if (common_pool_try_submit(e6bm_job_task, j, COMMON_POOL_PRIORITY_NORMAL) != 0) {
+        j->refs = 1;               // The task never ran
+        e6bm_job_unref(j);
+        return E6BM_ERROR_BUSY;
+    }
+    *job = j;
+    return E6BM_SUCCESS;
+}
+
+int e6bm_job_poll(e6bm_job_t* job, size_t* output_len) {
+    return e6bm_job_wait(job, 0, output_len);
+}
+
+int e6bm_job_wait(e6bm_job_t* job, int timeout_ms, size_t* output_len) {
+    if (job == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    struct timespec deadline;
+    if (timeout_ms > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&job->mutex);
+    while (job->state != E6BM_JOB_FINISHED && timeout_ms != 0) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&job->finished, &job->mutex);
+        } else if (pthread_cond_timedwait(&job->finished, &job->mutex, &deadline) != 0) {
+            break;                     // Timed out
+        }
+    }
+    int ret = job->state == E6BM_JOB_FINISHED ? job->result : E6BM_ERROR_IN_PROGRESS;
+    if (output_len != NULL) {
+        *output_len = job->state == E6BM_JOB_FINISHED ? job->output_len : 0;
+    }
+    pthread_mutex_unlock(&job->mutex);
+    return ret;
+}
+
+int e6bm_job_cancel(e6bm_job_t* job) {
+    if (job == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    __atomic_store_n(&job->cancel_requested, 1, __ATOMIC_RELAXED);
+    return E6BM_SUCCESS;
+}
+
+void e6bm_job_release(e6bm_job_t* job) {
+    if (job == NULL) {
+        return;
+    }
+    e6bm_job_cancel(job);
+    e6bm_job_wait(job, -1, NULL);
+    e6bm_job_unref(job);
+}
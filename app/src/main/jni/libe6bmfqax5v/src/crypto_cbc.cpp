@@ -3,6 +3,7 @@
  */
 
 #include "../include/crypto.h"
+#include "common/trace.h"
 #include <string.h>
 
 // ============================================================================
@@ -80,6 +81,7 @@ int e6bm_pkcs7_unpad(const uint8_t* input, size_t input_len,
 int e6bm_aes_cbc_encrypt(const e6bm_aes_context_t* ctx,
                          const uint8_t* input, size_t input_len,
                          uint8_t* output, size_t* output_len) {
+    COMMON_TRACE_FUNCTION();
     if (ctx == NULL || input == NULL || output == NULL || output_len == NULL) {
         return E6BM_ERROR_INVALID_PARAM;
     }
@@ -122,6 +124,7 @@ int e6bm_aes_cbc_encrypt(const e6bm_aes_context_t* ctx,
 int e6bm_aes_cbc_decrypt(const e6bm_aes_context_t* ctx,
                          const uint8_t* input, size_t input_len,
                          uint8_t* output, size_t* output_len) {
+    COMMON_TRACE_FUNCTION();
     if (ctx == NULL || input == NULL || output == NULL || output_len == NULL) {
         return E6BM_ERROR_INVALID_PARAM;
     }
@@ -0,0 +1,271 @@
+/*
+ * libe6bmfqax5v - Shared Keys, CBC Streams and HMAC-SHA256
+ *
+ * A key is expanded once (AES schedules through the shared AES engine,
+ * HMAC pads through the shared hash engine) and then only read. Streams
+ * and HMAC objects copy what they mutate, so operations on one key never
+ * contend with each other.
+ */
+
+#include "../include/e6bmfqax5v.h"
+#include "../include/crypto.h"
+#include "common/trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// HMAC Pads
+// ============================================================================
+
+// SHA-256 states after absorbing key ^ ipad and key ^ opad (RFC 2104)
+static void e6bm_hmac_pads(const uint8_t* key, size_t key_len,
+                           e6bm_sha256_context_t* inner, e6bm_sha256_context_t* outer) {
+    uint8_t block[COMMON_SHA256_BLOCK_SIZE] = {0};
+    if (key_len > sizeof(block)) {
+        common_sha256(key, key_len, block);
+    } else if (key_len > 0) {
+        memcpy(block, key, key_len);
+    }
+
+    for (size_t i = 0; i < sizeof(block); i++) block[i] ^= 0x36;
+    e6bm_sha256_init(inner);
+    e6bm_sha256_update(inner, block, sizeof(block));
+
+    for (size_t i = 0; i < sizeof(block); i++) block[i] ^= 0x36 ^ 0x5c;
+    e6bm_sha256_init(outer);
+    e6bm_sha256_update(outer, block, sizeof(block));
+
+    e6bm_secure_memzero(block, sizeof(block));
+}
+
+// Finish the inner hash and run it through a copy of the outer state
+static void e6bm_hmac_finish(e6bm_sha256_context_t* inner, const e6bm_sha256_context_t* outer,
+                             uint8_t* mac) {
+    uint8_t digest[COMMON_SHA256_DIGEST_SIZE];
+    e6bm_sha256_final(inner, digest);
+
+    e6bm_sha256_context_t ctx = *outer;
+    e6bm_sha256_update(&ctx, digest, sizeof(digest));
+    e6bm_sha256_final(&ctx, mac);
+
+    e6bm_secure_memzero(digest, sizeof(digest));
+    e6bm_secure_memzero(&ctx, sizeof(ctx));
+}
+
+// ============================================================================
+// Shared Keys
+// ============================================================================
+
+int e6bm_key_create(const uint8_t* key, size_t key_len, e6bm_key_t** out) {
+    if (out == NULL || (key == NULL && key_len > 0)) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    void* mem = NULL;
+    if (posix_memalign(&mem, 64, sizeof(e6bm_key_t)) != 0) {
+        return E6BM_ERROR_MEMORY;
+    }
+    e6bm_key_t* k = (e6bm_key_t*)mem;
+    memset(k, 0, sizeof(*k));
+
+    k->has_aes = common_aes_set_key(&k->aes, key, key_len) == 0;
+    e6bm_hmac_pads(key, key_len, &k->hmac_inner, &k->hmac_outer);
+
+    // Publishes the fully built key to whichever thread is handed it
+    __atomic_store_n(&k->refs, 1, __ATOMIC_RELEASE);
+    *out = k;
+    return E6BM_SUCCESS;
+}
+
+e6bm_key_t* e6bm_key_retain(e6bm_key_t* key) {
+    if (key) {
+        __atomic_add_fetch(&key->refs, 1, __ATOMIC_RELAXED);
+    }
+    return key;
+}
+
+void e6bm_key_release(e6bm_key_t* key) {
+    if (key == NULL || __atomic_sub_fetch(&key->refs, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    e6bm_secure_memzero(key, sizeof(*key));
+    free(key);
+}
+
+// ============================================================================
+// CBC Streams
+// ============================================================================
+
+int e6bm_cbc_begin(e6bm_cbc_stream_t* stream, const e6bm_key_t* key,
+                   const uint8_t* iv, bool encrypt) {
+    if (stream == NULL || key == NULL || iv == NULL || !key->has_aes) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    stream->key = key;
+    memcpy(stream->iv, iv, E6BM_AES_BLOCK_SIZE);
+    stream->partial_len = 0;
+    stream->encrypt = encrypt;
+    return E6BM_SUCCESS;
+}
+
+static void e6bm_cbc_blocks(e6bm_cbc_stream_t* stream, const uint8_t* input,
+                            uint8_t* output, size_t len) {
+    if (stream->encrypt) {
+        common_aes_cbc_encrypt(&stream->key->aes, stream->iv, input, output, len);
+    } else {
+        common_aes_cbc_decrypt(&stream->key->aes, stream->iv, input, output, len);
+    }
+}
+
+int e6bm_cbc_update(e6bm_cbc_stream_t* stream, const uint8_t* input, size_t input_len,
+                    uint8_t* output, size_t* output_len) {
+    if (stream == NULL || stream->key == NULL || output == NULL || output_len == NULL ||
+        (input == NULL && input_len > 0)) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    // Decryption always keeps at least one byte back, i.e. the last whole
+    // block, because only final() knows whether it carries the padding
+    size_t total = stream->partial_len + input_len;
+    size_t blocks = stream->encrypt ? total / E6BM_AES_BLOCK_SIZE
+                                    : (total > 0 ? (total - 1) / E6BM_AES_BLOCK_SIZE : 0);
+    size_t written = 0;
+
+    if (blocks > 0 && stream->partial_len > 0) {
+        size_t fill = E6BM_AES_BLOCK_SIZE - stream->partial_len;
+        memcpy(stream->partial + stream->partial_len, input, fill);
+        e6bm_cbc_blocks(stream, stream->partial, output, E6BM_AES_BLOCK_SIZE);
+        stream->partial_len = 0;
+        input += fill;
+        input_len -= fill;
+        written = E6BM_AES_BLOCK_SIZE;
+        blocks--;
+    }
+
+    if (blocks > 0) {
+        size_t len = blocks * E6BM_AES_BLOCK_SIZE;
+        e6bm_cbc_blocks(stream, input, output + written, len);
+        input += len;
+        input_len -= len;
+        written += len;
+    }
+
+    memcpy(stream->partial + stream->partial_len, input, input_len);
+    stream->partial_len += input_len;
+
+    *output_len = written;
+    return E6BM_SUCCESS;
+}
+
+int e6bm_cbc_final(e6bm_cbc_stream_t* stream, uint8_t* output, size_t* output_len) {
+    if (stream == NULL || stream->key == NULL || output == NULL || output_len == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    int ret = E6BM_SUCCESS;
+    if (stream->encrypt) {
+        uint8_t pad = (uint8_t)(E6BM_AES_BLOCK_SIZE - stream->partial_len);
+        memset(stream->partial + stream->partial_len, pad, pad);
+        e6bm_cbc_blocks(stream, stream->partial, output, E6BM_AES_BLOCK_SIZE);
+        *output_len = E6BM_AES_BLOCK_SIZE;
+    } else if (stream->partial_len != E6BM_AES_BLOCK_SIZE) {
+        ret = E6BM_ERROR_CRYPTO;    // Ciphertext was not a whole number of blocks
+    } else {
+        uint8_t block[E6BM_AES_BLOCK_SIZE];
+        e6bm_cbc_blocks(stream, stream->partial, block, E6BM_AES_BLOCK_SIZE);
+        *output_len = E6BM_AES_BLOCK_SIZE;
+        ret = e6bm_pkcs7_unpad(block, sizeof(block), output, output_len);
+        e6bm_secure_memzero(block, sizeof(block));
+    }
+
+    e6bm_secure_memzero(stream, sizeof(*stream));
+    return ret;
+}
+
+// ============================================================================
+// HMAC-SHA256
+// ============================================================================
+
+void e6bm_hmac_begin(e6bm_hmac_t* hmac, const e6bm_key_t* key) {
+    hmac->key = key;
+    hmac->inner = key->hmac_inner;
+}
+
+void e6bm_hmac_update(e6bm_hmac_t* hmac, const uint8_t* data, size_t len) {
+    e6bm_sha256_update(&hmac->inner, data, len);
+}
+
+void e6bm_hmac_final(e6bm_hmac_t* hmac, uint8_t* mac) {
+    e6bm_hmac_finish(&hmac->inner, &hmac->key->hmac_outer, mac);
+    e6bm_secure_memzero(hmac, sizeof(*hmac));
+}
+
+int e6bm_hmac_sha256(const uint8_t* key, size_t key_len,
+                     const uint8_t* data, size_t data_len,
+                     uint8_t* output) {
+    COMMON_TRACE_FUNCTION();
+    if (output == NULL || (key == NULL && key_len > 0) || (data == NULL && data_len > 0)) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    e6bm_sha256_context_t inner, outer;
+    e6bm_hmac_pads(key, key_len, &inner, &outer);
+    e6bm_sha256_update(&inner, data, data_len);
+    e6bm_hmac_finish(&inner, &outer, output);
+
+    e6bm_secure_memzero(&outer, sizeof(outer));
+    return E6BM_SUCCESS;
+}
+
+// ============================================================================
+// PBKDF2
+// ============================================================================
+
+int e6bm_pbkdf2_hmac_sha256(const uint8_t* password, size_t password_len,
+                            const uint8_t* salt, size_t salt_len,
+                            uint32_t iterations,
+                            uint8_t* output, size_t output_len) {
+    COMMON_TRACE_FUNCTION();
+    if (output == NULL || output_len == 0 || iterations == 0 ||
+        (password == NULL && password_len > 0) || (salt == NULL && salt_len > 0)) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    e6bm_sha256_context_t inner, outer, ctx;
+    e6bm_hmac_pads(password, password_len, &inner, &outer);
+
+    uint8_t u[COMMON_SHA256_DIGEST_SIZE];
+    uint8_t t[COMMON_SHA256_DIGEST_SIZE];
+    for (uint32_t block = 1; output_len > 0; block++) {
+        const uint8_t index[4] = {
+            (uint8_t)(block >> 24), (uint8_t)(block >> 16), (uint8_t)(block >> 8), (uint8_t)block
+        };
+
+        // U1 = HMAC(password, salt || INT(block))
+        ctx = inner;
+        e6bm_sha256_update(&ctx, salt, salt_len);
+        e6bm_sha256_update(&ctx, index, sizeof(index));
+        e6bm_hmac_finish(&ctx, &outer, u);
+        memcpy(t, u, sizeof(t));
+
+        // Un = HMAC(password, Un-1), starting from the saved pad states
+        for (uint32_t i = 1; i < iterations; i++) {
+            ctx = inner;
+            e6bm_sha256_update(&ctx, u, sizeof(u));
+            e6bm_hmac_finish(&ctx, &outer, u);
+            for (size_t j = 0; j < sizeof(t); j++) t[j] ^= u[j];
+        }
+
+        size_t len = output_len < sizeof(t) ? output_len : sizeof(t);
+        memcpy(output, t, len);
+        output += len;
+        output_len -= len;
+    }
+
+    e6bm_secure_memzero(&inner, sizeof(inner));
+    e6bm_secure_memzero(&outer, sizeof(outer));
+    e6bm_secure_memzero(&ctx, sizeof(ctx));
+    e6bm_secure_memzero(u, sizeof(u));
+    e6bm_secure_memzero(t, sizeof(t));
+    return E6BM_SUCCESS;
+}
@@ -0,0 +1,252 @@
+/*
+ * libe6bmfqax5v - SHA-256 Tree Hash
+ *
+ * Versioned Merkle tree over fixed-size leaves. Plain SHA-256 of a large
+ * buffer is one serial chain; the tree lets every core hash its own leaves
+ * and lets callers re-check or refresh a byte range without rehashing the
+ * rest. The layout is documented in crypto.h and must not change without
+ * bumping E6BM_TREE_VERSION.
+ */
+
+#include "../include/e6bmfqax5v.h"
+#include "../include/crypto.h"
+#include "../include/utils.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Leaves claimed per worker step; a multiple of the 4-lane kernel width
+#define E6BM_TREE_LEAF_BATCH 16
+
+static const uint8_t kTreeDomain[] = { 'E', '6', 'B', 'M', '-', 'T', 'R', 'E', 'E' };
+
+// ============================================================================
+// Leaf Hashing
+// ============================================================================
+
+typedef struct {
+    const uint8_t* input;
+    size_t input_len;
+    size_t first_leaf;            // Leaf range to hash
+    size_t end_leaf;
+    uint8_t (*digests)[32];       // digests[0] belongs to first_leaf
+} e6bm_leaf_job_t;
+
+static size_t e6bm_leaf_count(size_t input_len) {
+    return input_len == 0 ? 1 : (input_len + E6BM_TREE_LEAF_SIZE - 1) / E6BM_TREE_LEAF_SIZE;
+}
+
+// Hash leaves [first, end) into digests[0..); full leaves go through the
+// multi-buffer path
+static void e6bm_hash_leaves(const uint8_t* input, size_t input_len,
+                             size_t first, size_t end, uint8_t (*digests)[32]) {
+    const uint8_t* batch[E6BM_TREE_LEAF_BATCH];
+    size_t full_end = end;
+    if ((end - 1) * (size_t)E6BM_TREE_LEAF_SIZE + E6BM_TREE_LEAF_SIZE > input_len) {
+        full_end = end - 1;       // Last leaf is partial (or the empty leaf)
+    }
+
+    for (size_t leaf = first; leaf < full_end; leaf += E6BM_TREE_LEAF_BATCH) {
+        size_t count = full_end - leaf < E6BM_TREE_LEAF_BATCH ? full_end - leaf : E6BM_TREE_LEAF_BATCH;
+        for (size_t i = 0; i < count; i++) {
+            batch[i] = input + (leaf + i) * E6BM_TREE_LEAF_SIZE;
+        }
+        common_sha256_multi(batch, E6BM_TREE_LEAF_SIZE, digests + (leaf - first), count);
+    }
+
+    if (full_end < end) {
+        size_t offset = full_end * E6BM_TREE_LEAF_SIZE;
+        common_sha256(input + offset, input_len - offset, digests[full_end - first]);
+    }
+}
+
+// Hash one batch of leaves; index is the batch number
+static void e6bm_leaf_batch(void* arg, size_t index) {
+    e6bm_leaf_job_t* job = (e6bm_leaf_job_t*)arg;
+    size_t offset = index * E6BM_TREE_LEAF_BATCH;
+    size_t start = job->first_leaf + offset;
+    size_t end = start + E6BM_TREE_LEAF_BATCH < job->end_leaf ? start + E6BM_TREE_LEAF_BATCH : job->end_leaf;
+    e6bm_hash_leaves(job->input, job->input_len, start, end, job->digests + offset);
+}
+
+// Hash leaves [first, end) into digests[0..) on up to threads workers of
+// the shared pool (the caller is one of them)
+static void e6bm_hash_leaves_parallel(const uint8_t* input, size_t input_len,
+                                      size_t first, size_t end, uint8_t (*digests)[32], int threads) {
+    size_t batches = (end - first + E6BM_TREE_LEAF_BATCH - 1) / E6BM_TREE_LEAF_BATCH;
+    if (threads == 1 || batches <= 1) {
+        e6bm_hash_leaves(input, input_len, first, end, digests);
+        return;
+    }
+
+    e6bm_leaf_job_t job = { input, input_len, first, end, digests };
+    common_pool_parallel_for(batches, threads > 0 ? (unsigned)threads : 0, e6bm_leaf_batch, &job);
+}
+
+// ============================================================================
+// Interior Nodes
+// ============================================================================
+
+// Recompute node index of level (> 0) from its children
+static void e6bm_tree_node(e6bm_tree_hash_t* tree, uint32_t level, size_t index) {
+    uint8_t (*children)[32] = tree->nodes + tree->level_offset[level - 1];
+    uint8_t* out = tree->nodes[tree->level_offset[level] + index];
+    size_t left = index * 2;
+
+    if (left + 1 >= tree->level_size[level - 1]) {
+        memcpy(out, children[left], 32);      // Odd node carried up
+        return;
+    }
+
+    static const uint8_t kNodePrefix = 0x01;
+    e6bm_sha256_context_t ctx;
+    common_sha256_init(&ctx);
+    common_sha256_update(&ctx, &kNodePrefix, 1);
+    common_sha256_update(&ctx, children[left], 64);
+    common_sha256_final(&ctx, out);
+}
+
+static void e6bm_tree_root(e6bm_tree_hash_t* tree) {
+    uint8_t header[sizeof(kTreeDomain) + 1 + 4 + 8];
+    uint8_t* p = header;
+    memcpy(p, kTreeDomain, sizeof(kTreeDomain));
+    p += sizeof(kTreeDomain);
+    *p++ = (uint8_t)tree->version;
+    for (int i = 0; i < 4; i++) *p++ = (uint8_t)(tree->leaf_size >> (8 * i));
+    for (int i = 0; i < 8; i++) *p++ = (uint8_t)(tree->total_len >> (8 * i));
+
+    e6bm_sha256_context_t ctx;
+    common_sha256_init(&ctx);
+    common_sha256_update(&ctx, header, sizeof(header));
+    common_sha256_update(&ctx, tree->nodes[tree->level_offset[tree->level_count - 1]], 32);
+    common_sha256_final(&ctx, tree->root);
+}
+
+// Leaf range covered by a byte range; false if it lies outside the input
+static bool e6bm_tree_leaf_range(const e6bm_tree_hash_t* tree, size_t offset, size_t len,
+                                 size_t* first, size_t* end) {
+    if (offset > tree->total_len || len > tree->total_len - offset) {
+        return false;
+    }
+    *first = offset / tree->leaf_size;
+    *end = len == 0 ? *first : (offset + len - 1) / tree->leaf_size + 1;
+    if (*first >= tree->level_size[0]) {
+        *first = tree->level_size[0] - 1;     // offset == total_len
+    }
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+int e6bm_tree_hash_build(e6bm_tree_hash_t* tree, const uint8_t* input, size_t input_len, int threads) {
+    COMMON_TRACE_FUNCTION();
+    if (!tree) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    memset(tree, 0, sizeof(*tree));
+    if (!input && input_len > 0) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+
+    tree->version = E6BM_TREE_VERSION;
+    tree->leaf_size = E6BM_TREE_LEAF_SIZE;
+    tree->total_len = input_len;
+
+    size_t total_nodes = 0;
+    for (size_t count = e6bm_leaf_count(input_len);; count = (count + 1) / 2) {
+        tree->level_offset[tree->level_count] = total_nodes;
+        tree->level_size[tree->level_count] = count;
+        tree->level_count++;
+        total_nodes += count;
+        if (count == 1) break;
+    }
+
+    tree->nodes = (uint8_t (*)[32])malloc(total_nodes * 32);
+    if (!tree->nodes) {
+        return E6BM_ERROR_MEMORY;
+    }
+
+    e6bm_hash_leaves_parallel(input, input_len, 0, tree->level_size[0], tree->nodes, threads);
+    for (uint32_t level = 1; level < tree->level_count; level++) {
+        for (size_t i = 0; i < tree->level_size[level]; i++) {
+            e6bm_tree_node(tree, level, i);
+        }
+    }
+    e6bm_tree_root(tree);
+    return E6BM_SUCCESS;
+}
+
+void e6bm_tree_hash_free(e6bm_tree_hash_t* tree) {
+    if (tree) {
+        free(tree->nodes);
+        memset(tree, 0, sizeof(*tree));
+    }
+}
+
+int e6bm_tree_hash_compute(const uint8_t* input, size_t input_len, uint8_t* root, int threads) {
+    if (!root) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    e6bm_tree_hash_t tree;
+    int ret = e6bm_tree_hash_build(&tree, input, input_len, threads);
+    if (ret == E6BM_SUCCESS) {
+        memcpy(root, tree.root, 32);
+    }
+    e6bm_tree_hash_free(&tree);
+    return ret;
+}
+
+int e6bm_tree_hash_verify_range(const e6bm_tree_hash_t* tree, const uint8_t* input,
+                                size_t offset, size_t len) {
+    COMMON_TRACE_FUNCTION();
+    size_t first, end;
+    if (!tree || !tree->nodes || (!input && tree->total_len > 0) ||
+        tree->version != E6BM_TREE_VERSION ||
+        !e6bm_tree_leaf_range(tree, offset, len, &first, &end)) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    if (first == end) {
+        return E6BM_SUCCESS;
+    }
+
+    uint8_t (*digests)[32] = (uint8_t (*)[32])malloc((end - first) * 32);
+    if (!digests) {
+        return E6BM_ERROR_MEMORY;
+    }
+    e6bm_hash_leaves_parallel(input, (size_t)tree->total_len, first, end, digests, 0);
+    int ret = e6bm_secure_memcmp(digests, tree->nodes[first], (end - first) * 32) == 0
+        ? E6BM_SUCCESS : E6BM_ERROR_CRYPTO;
+    free(digests);
+    return ret;
+}
+
+int e6bm_tree_hash_update_range(e6bm_tree_hash_t* tree, const uint8_t* input,
+                                size_t offset, size_t len) {
+    COMMON_TRACE_FUNCTION();
+    size_t first, end;
+    if (!tree || !tree->nodes || (!input && tree->total_len > 0) ||
+        tree->version != E6BM_TREE_VERSION ||
+        !e6bm_tree_leaf_range(tree, offset, len, &first, &end)) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    if (first == end) {
+        return E6BM_SUCCESS;
+    }
+
+    e6bm_hash_leaves_parallel(input, (size_t)tree->total_len, first, end, tree->nodes + first, 0);
+
+    // Only the ancestors of the touched leaves change
+    for (uint32_t level = 1; level < tree->level_count; level++) {
+        first /= 2;
+        end = (end + 1) / 2;
+        for (size_t i = first; i < end; i++) {
+            e6bm_tree_node(tree, level, i);
+        }
+    }
+    e6bm_tree_root(tree);
+    return E6BM_SUCCESS;
+}
@@ -57,7 +57,6 @@ int e6bm_crypto_context_init(void** ctx) {
         return E6BM_ERROR_MEMORY;
     }
     
-    pthread_mutex_init(&context->mutex, NULL);
     context->flags = E6BM_FLAG_INITIALIZED;
     
     *ctx = context;
@@ -71,23 +70,46 @@ void e6bm_crypto_context_free(void* ctx) {
     
     e6bm_context_t* context = (e6bm_context_t*)ctx;
     
-    if (context->aes_ctx) {
-        e6bm_secure_memzero(context->aes_ctx, sizeof(e6bm_aes_context_t));
-        free(context->aes_ctx);
+    e6bm_key_release(context->key);
+    e6bm_secure_memzero(context, sizeof(*context));
+    free(context);
+}
+
+int e6bm_crypto_init(e6bm_context_t* ctx, e6bm_crypto_algo_t algo,
+                     const uint8_t* key, size_t key_len,
+                     const uint8_t* iv, size_t iv_len) {
+    if (ctx == NULL || (key == NULL && key_len > 0)) {
+        return E6BM_ERROR_INVALID_PARAM;
     }
     
-    if (context->md5_ctx) {
-        free(context->md5_ctx);
+    if (ctx->key != NULL) {
+        return E6BM_ERROR_ALREADY_INITIALIZED;
     }
     
-    if (context->sha256_ctx) {
-        free(context->sha256_ctx);
+    // AES needs a matching key and a full IV; for the hashes the key is
+    // optional and only used for HMAC
+    switch (algo) {
+        case E6BM_ALGO_AES_256_CBC:
+        case E6BM_ALGO_AES_128_CBC:
+            if (key_len != (algo == E6BM_ALGO_AES_256_CBC ? 32u : 16u) ||
+                iv == NULL || iv_len != E6BM_AES_IV_SIZE) {
+                return E6BM_ERROR_INVALID_PARAM;
+            }
+            memcpy(ctx->iv, iv, E6BM_AES_IV_SIZE);
+            break;
+        case E6BM_ALGO_MD5:
+        case E6BM_ALGO_SHA256:
+            break;
+        default:
+            return E6BM_ERROR_INVALID_PARAM;
     }
     
-    if (context->zlib_ctx) {
-        free(context->zlib_ctx);
+    int ret = e6bm_key_create(key, key_len, &ctx->key);
+    if (ret != E6BM_SUCCESS) {
+        return ret;
     }
     
-    pthread_mutex_destroy(&context->mutex);
-    free(context);
+    ctx->algo = algo;
+    ctx->flags |= E6BM_FLAG_INITIALIZED | E6BM_FLAG_THREAD_SAFE;
+    return E6BM_SUCCESS;
 }
@@ -10,22 +10,42 @@
 #include "../include/types.h"
 #include "../include/crypto.h"
 #include "../include/utils.h"
+#include "../include/async_job.h"
+#include "common/trace.h"
+#include "common/jni_string.h"
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
-#include <android/log.h>
 #include <stdarg.h>
 
 #define TAG "libe6bmfqax5v"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, TAG, __VA_ARGS__)
+#define LOGD(...) COMMON_LOGD(TAG, __VA_ARGS__)
+#define LOGI(...) COMMON_LOGI(TAG, __VA_ARGS__)
+#define LOGE(...) COMMON_LOGE(TAG, __VA_ARGS__)
 
 // Global JNI state
 static e6bm_jni_state_t g_jni_state = {0};
 e6bm_global_state_t g_state = {0};
 pthread_once_t g_init_once = PTHREAD_ONCE_INIT;
 
+// Exception classes resolved once in JNI_OnLoad so throwing needs no FindClass
+typedef struct {
+    const char* name;
+    jclass clazz;
+} e6bm_jni_class_entry_t;
+
+static e6bm_jni_class_entry_t g_exception_classes[] = {
+    { JNI_EXC_NULL_POINTER, NULL },
+    { JNI_EXC_ILLEGAL_ARGUMENT, NULL },
+    { JNI_EXC_ILLEGAL_STATE, NULL },
+    { JNI_EXC_OUT_OF_MEMORY, NULL },
+    { JNI_EXC_RUNTIME, NULL },
+    { JNI_EXC_IO, NULL },
+};
+
+#define E6BM_JNI_EXCEPTION_CLASS_COUNT \
+    (sizeof(g_exception_classes) / sizeof(g_exception_classes[0]))
+
 // ============================================================================
 // Internal Helper Functions
 // ============================================================================
@@ -108,6 +128,7 @@ static void* e6bm_resolve_internal_function(uint64_t offset_magic) {
 // ============================================================================
 
 JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    COMMON_TRACE_FUNCTION();
     LOGI("JNI_OnLoad called - initializing libe6bmfqax5v");
     
     JNIEnv* env = NULL;
@@ -129,6 +150,11 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
         return -1;
     }
     
+    // Missing classes are reported once here; throwing then falls back to FindClass
+    if (e6bm_jni_cache_classes(env) != E6BM_SUCCESS) {
+        LOGE("Failed to resolve exception classes");
+    }
+    
     // Get thread-local storage
     e6bm_thread_local_t* tls = e6bm_get_tls_data();
     if (tls == NULL) {
@@ -185,6 +211,7 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
 
 JNIEXPORT jint JNICALL Mundo_Activate_SDK(JNIEnv* env, jobject thiz,
                                           jlong param1, jlong param2) {
+    COMMON_TRACE_FUNCTION();
     LOGI("Mundo_Activate_SDK called with params: 0x%llx, 0x%llx",
          (unsigned long long)param1, (unsigned long long)param2);
     
@@ -223,6 +250,18 @@ JNIEXPORT jint JNICALL Mundo_Activate_SDK(JNIEnv* env, jobject thiz,
     
     // 4. Initialize crypto context if not already done
     if (tls->crypto_context == NULL) {
+        // The global key is expanded once; every thread's context shares
+        // it by reference and keeps its own IV and hash state per call
+        if (g_state.global_key_ref == NULL) {
+            int ret = e6bm_key_create(g_state.global_key, E6BM_AES_KEY_SIZE,
+                                      &g_state.global_key_ref);
+            if (ret != E6BM_SUCCESS) {
+                pthread_mutex_unlock(&g_state.global_mutex);
+                LOGE("Failed to expand global key");
+                return ret;
+            }
+        }
+        
         e6bm_context_t* ctx = (e6bm_context_t*)calloc(1, sizeof(e6bm_context_t));
         if (ctx == NULL) {
             pthread_mutex_unlock(&g_state.global_mutex);
@@ -230,20 +269,10 @@ JNIEXPORT jint JNICALL Mundo_Activate_SDK(JNIEnv* env, jobject thiz,
             return E6BM_ERROR_MEMORY;
         }
         
-        // Initialize AES context with global key
-        ctx->aes_ctx = (e6bm_aes_context_t*)calloc(1, sizeof(e6bm_aes_context_t));
-        if (ctx->aes_ctx == NULL) {
-            free(ctx);
-            pthread_mutex_unlock(&g_state.global_mutex);
-            LOGE("Failed to allocate AES context");
-            return E6BM_ERROR_MEMORY;
-        }
-        
-        // Initialize with default key
-        e6bm_aes_init(ctx->aes_ctx, g_state.global_key, 256, g_state.global_iv);
-        
-        pthread_mutex_init(&ctx->mutex, NULL);
-        ctx->flags = E6BM_FLAG_INITIALIZED;
+        ctx->key = e6bm_key_retain(g_state.global_key_ref);
+        ctx->algo = E6BM_ALGO_AES_256_CBC;
+        memcpy(ctx->iv, g_state.global_iv, E6BM_AES_IV_SIZE);
+        ctx->flags = E6BM_FLAG_INITIALIZED | E6BM_FLAG_THREAD_SAFE;
         
         tls->crypto_context = ctx;
     }
@@ -288,6 +317,14 @@ void e6bm_jni_cleanup(void) {
         g_jni_state.global_context = NULL;
     }
     
+    JNIEnv* env = e6bm_jni_get_env();
+    for (size_t i = 0; i < E6BM_JNI_EXCEPTION_CLASS_COUNT; i++) {
+        if (g_exception_classes[i].clazz && env) {
+            (*env)->DeleteGlobalRef(env, g_exception_classes[i].clazz);
+        }
+        g_exception_classes[i].clazz = NULL;
+    }
+    
     g_jni_state.initialized = false;
 }
 
@@ -378,13 +415,15 @@ char* e6bm_jni_string_to_cstr(JNIEnv* env, jstring jstr) {
         return NULL;
     }
     
-    const char* utf = (*env)->GetStringUTFChars(env, jstr, NULL);
-    if (utf == NULL) {
+    // One copy into the returned buffer instead of a VM copy plus strdup
+    jsize len = (*env)->GetStringUTFLength(env, jstr);
+    char* cstr = (char*)malloc((size_t)len + 1);
+    if (cstr == NULL) {
         return NULL;
     }
     
-    char* cstr = strdup(utf);
-    (*env)->ReleaseStringUTFChars(env, jstr, utf);
+    (*env)->GetStringUTFRegion(env, jstr, 0, (*env)->GetStringLength(env, jstr), cstr);
+    cstr[len] = '\0';
     
     return cstr;
 }
@@ -394,19 +433,405 @@ jstring e6bm_jni_cstr_to_string(JNIEnv* env, const char* cstr) {
         return NULL;
     }
     
-    return (*env)->NewStringUTF(env, cstr);
+    return common::newStringUtf(env, cstr);
 }
 
 void e6bm_jni_free_cstr(JNIEnv* env, jstring jstr, const char* cstr) {
-    if (jstr && cstr) {
-        (*env)->ReleaseStringUTFChars(env, jstr, cstr);
+    // Strings from e6bm_jni_string_to_cstr are our own allocation, not
+    // GetStringUTFChars memory, so they go back to free()
+    free((void*)cstr);
+}
+
+int e6bm_jni_cache_classes(JNIEnv* env) {
+    int ret = E6BM_SUCCESS;
+    
+    for (size_t i = 0; i < E6BM_JNI_EXCEPTION_CLASS_COUNT; i++) {
+        if (g_exception_classes[i].clazz) {
+            continue;
+        }
+        
+        jclass local = (*env)->FindClass(env, g_exception_classes[i].name);
+        if (local == NULL) {
+            (*env)->ExceptionClear(env);
+            LOGE("Exception class not found: %s", g_exception_classes[i].name);
+            ret = E6BM_ERROR_NOT_INITIALIZED;
+            continue;
+        }
+        
+        g_exception_classes[i].clazz = (jclass)(*env)->NewGlobalRef(env, local);
+        (*env)->DeleteLocalRef(env, local);
     }
+    
+    return ret;
 }
 
 void e6bm_jni_throw_exception(JNIEnv* env, const char* class_name,
                               const char* message) {
+    for (size_t i = 0; i < E6BM_JNI_EXCEPTION_CLASS_COUNT; i++) {
+        // Callers pass the JNI_EXC_* literals, so the pointer usually matches
+        if (g_exception_classes[i].clazz &&
+            (class_name == g_exception_classes[i].name ||
+             strcmp(class_name, g_exception_classes[i].name) == 0)) {
+            (*env)->ThrowNew(env, g_exception_classes[i].clazz, message);
+            return;
+        }
+    }
+    
     jclass exc_class = (*env)->FindClass(env, class_name);
     if (exc_class) {
         (*env)->ThrowNew(env, exc_class, message);
+        (*env)->DeleteLocalRef(env, exc_class);
+    }
+}
+
+// ============================================================================
+// Zero-Copy Buffer Access
+// ============================================================================
+
+int e6bm_jni_get_direct_buffer(JNIEnv* env, jobject buffer, size_t min_size,
+                               e6bm_jni_direct_buffer_t* out) {
+    if (buffer == NULL || out == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    void* address = (*env)->GetDirectBufferAddress(env, buffer);
+    jlong capacity = (*env)->GetDirectBufferCapacity(env, buffer);
+    if (address == NULL || capacity < 0 || (uint64_t)capacity < min_size) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    out->data = (uint8_t*)address;
+    out->capacity = (size_t)capacity;
+    return E6BM_SUCCESS;
+}
+
+int e6bm_jni_critical_prepare(JNIEnv* env, jbyteArray array, size_t min_size,
+                              e6bm_jni_critical_array_t* out) {
+    if (array == NULL || out == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    // Length must be read before entering the critical region
+    jsize len = (*env)->GetArrayLength(env, array);
+    if ((size_t)len < min_size) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    out->array = array;
+    out->data = NULL;
+    out->size = (size_t)len;
+    return E6BM_SUCCESS;
+}
+
+int e6bm_jni_critical_pin(JNIEnv* env, e6bm_jni_critical_array_t* array) {
+    if (array == NULL || array->array == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    void* data = (*env)->GetPrimitiveArrayCritical(env, array->array, NULL);
+    if (data == NULL) {
+        return E6BM_ERROR_MEMORY;
+    }
+    
+    array->data = (uint8_t*)data;
+    return E6BM_SUCCESS;
+}
+
+void e6bm_jni_critical_release(JNIEnv* env, e6bm_jni_critical_array_t* array, jint mode) {
+    if (array == NULL || array->data == NULL) {
+        return;
+    }
+    
+    (*env)->ReleasePrimitiveArrayCritical(env, array->array, array->data, mode);
+    array->data = NULL;
+}
+
+int e6bm_jni_read_byte_array(JNIEnv* env, jbyteArray array,
+                             uint8_t* out, size_t size) {
+    if (array == NULL || out == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    if ((size_t)(*env)->GetArrayLength(env, array) != size) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    (*env)->GetByteArrayRegion(env, array, 0, (jsize)size, (jbyte*)out);
+    return E6BM_SUCCESS;
+}
+
+// ============================================================================
+// Zero-Copy Native Methods
+// ============================================================================
+
+/**
+ * Key and IV are copied to the stack up front: no JNI call is allowed once
+ * a critical region is entered.
+ */
+static int e6bm_jni_read_key_iv(JNIEnv* env, jbyteArray key, jbyteArray iv,
+                                uint8_t* key_out, uint8_t* iv_out) {
+    int ret = e6bm_jni_read_byte_array(env, key, key_out, E6BM_AES_KEY_SIZE);
+    if (ret != E6BM_SUCCESS) {
+        return ret;
+    }
+    return e6bm_jni_read_byte_array(env, iv, iv_out, E6BM_AES_IV_SIZE);
+}
+
+static jint e6bm_jni_cbc_direct(JNIEnv* env, jobject input, jobject output, jint length,
+                                jbyteArray key, jbyteArray iv, bool encrypt) {
+    if (length < 0) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    uint8_t key_bytes[E6BM_AES_KEY_SIZE];
+    uint8_t iv_bytes[E6BM_AES_IV_SIZE];
+    int ret = e6bm_jni_read_key_iv(env, key, iv, key_bytes, iv_bytes);
+    if (ret != E6BM_SUCCESS) {
+        return ret;
+    }
+    
+    e6bm_jni_direct_buffer_t in, out;
+    ret = e6bm_jni_get_direct_buffer(env, input, (size_t)length, &in);
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_get_direct_buffer(env, output, (size_t)length, &out);
+    }
+    
+    if (ret == E6BM_SUCCESS) {
+        size_t out_len = out.capacity;
+        ret = encrypt
+            ? e6bm_aes256_encrypt(in.data, (size_t)length, out.data, &out_len, key_bytes, iv_bytes)
+            : e6bm_aes256_decrypt(in.data, (size_t)length, out.data, &out_len, key_bytes, iv_bytes);
+        if (ret == E6BM_SUCCESS) {
+            ret = (int)out_len;
+        }
+    }
+    
+    e6bm_secure_memzero(key_bytes, sizeof(key_bytes));
+    return ret;
+}
+
+static jint e6bm_jni_cbc_critical(JNIEnv* env, jbyteArray input, jbyteArray output, jint length,
+                                  jbyteArray key, jbyteArray iv, bool encrypt) {
+    if (length < 0) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    uint8_t key_bytes[E6BM_AES_KEY_SIZE];
+    uint8_t iv_bytes[E6BM_AES_IV_SIZE];
+    int ret = e6bm_jni_read_key_iv(env, key, iv, key_bytes, iv_bytes);
+    if (ret != E6BM_SUCCESS) {
+        return ret;
+    }
+    
+    // Both lengths are checked before either array is pinned. Pinning the
+    // same array twice is allowed; if the VM hands out copies, input is
+    // discarded and output committed, so in-place calls still work
+    e6bm_jni_critical_array_t in = {0}, out = {0};
+    ret = e6bm_jni_critical_prepare(env, input, (size_t)length, &in);
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_critical_prepare(env, output, (size_t)length, &out);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_critical_pin(env, &in);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_critical_pin(env, &out);
+    }
+    
+    if (ret == E6BM_SUCCESS) {
+        size_t out_len = out.size;
+        ret = encrypt
+            ? e6bm_aes256_encrypt(in.data, (size_t)length, out.data, &out_len, key_bytes, iv_bytes)
+            : e6bm_aes256_decrypt(in.data, (size_t)length, out.data, &out_len, key_bytes, iv_bytes);
+        if (ret == E6BM_SUCCESS) {
+            ret = (int)out_len;
+        }
+    }
+    
+    e6bm_jni_critical_release(env, &out, ret >= 0 ? 0 : JNI_ABORT);
+    e6bm_jni_critical_release(env, &in, JNI_ABORT);
+    e6bm_secure_memzero(key_bytes, sizeof(key_bytes));
+    return ret;
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeEncryptDirect)
+    (JNIEnv* env, jobject thiz, jobject input, jobject output, jint length,
+     jbyteArray key, jbyteArray iv) {
+    return e6bm_jni_cbc_direct(env, input, output, length, key, iv, true);
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeDecryptDirect)
+    (JNIEnv* env, jobject thiz, jobject input, jobject output, jint length,
+     jbyteArray key, jbyteArray iv) {
+    return e6bm_jni_cbc_direct(env, input, output, length, key, iv, false);
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeSHA256Direct)
+    (JNIEnv* env, jobject thiz, jobject input, jint length, jobject output) {
+    if (length < 0) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    e6bm_jni_direct_buffer_t in, out;
+    int ret = e6bm_jni_get_direct_buffer(env, input, (size_t)length, &in);
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_get_direct_buffer(env, output, COMMON_SHA256_DIGEST_SIZE, &out);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_sha256_hash(in.data, (size_t)length, out.data);
+    }
+    
+    return ret == E6BM_SUCCESS ? COMMON_SHA256_DIGEST_SIZE : ret;
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeEncryptCritical)
+    (JNIEnv* env, jobject thiz, jbyteArray input, jbyteArray output, jint length,
+     jbyteArray key, jbyteArray iv) {
+    return e6bm_jni_cbc_critical(env, input, output, length, key, iv, true);
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeDecryptCritical)
+    (JNIEnv* env, jobject thiz, jbyteArray input, jbyteArray output, jint length,
+     jbyteArray key, jbyteArray iv) {
+    return e6bm_jni_cbc_critical(env, input, output, length, key, iv, false);
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeSHA256Critical)
+    (JNIEnv* env, jobject thiz, jbyteArray input, jint length, jbyteArray output) {
+    if (length < 0) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    
+    // Hashing large arrays holds the critical region (and with it GC) for
+    // the whole digest; callers with multi-megabyte inputs should use the
+    // Direct variant instead
+    e6bm_jni_critical_array_t in = {0}, out = {0};
+    int ret = e6bm_jni_critical_prepare(env, input, (size_t)length, &in);
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_critical_prepare(env, output, COMMON_SHA256_DIGEST_SIZE, &out);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_critical_pin(env, &in);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_critical_pin(env, &out);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_sha256_hash(in.data, (size_t)length, out.data);
+    }
+    
+    e6bm_jni_critical_release(env, &out, ret == E6BM_SUCCESS ? 0 : JNI_ABORT);
+    e6bm_jni_critical_release(env, &in, JNI_ABORT);
+    return ret == E6BM_SUCCESS ? COMMON_SHA256_DIGEST_SIZE : ret;
+}
+
+// ============================================================================
+// Asynchronous Jobs
+// ============================================================================
+
+// Handle returned to Java: the job plus the global references that keep
+// its direct buffers (and so their native memory) alive
+typedef struct {
+    e6bm_job_t* job;
+    jobject input;
+    jobject output;
+} e6bm_jni_job_t;
+
+static jint e6bm_jni_job_result(e6bm_jni_job_t* handle, int timeout_ms) {
+    if (handle == NULL) {
+        return E6BM_ERROR_INVALID_PARAM;
+    }
+    size_t output_len = 0;
+    int ret = e6bm_job_wait(handle->job, timeout_ms, &output_len);
+    return ret == E6BM_SUCCESS ? (jint)output_len : ret;
+}
+
+JAVA_METHOD(jlong, com_eternal_xdsdk_Crypto, nativeJobSubmit)
+    (JNIEnv* env, jobject thiz, jint type, jobject input, jint length,
+     jobject output, jbyteArray key, jbyteArray iv, jint level) {
+    if (length < 0) {
+        return 0;
+    }
+
+    e6bm_job_desc_t desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.type = (e6bm_job_type_t)type;
+    desc.input_len = (size_t)length;
+    desc.level = level;
+
+    uint8_t key_bytes[E6BM_AES_KEY_SIZE];
+    uint8_t iv_bytes[E6BM_AES_IV_SIZE];
+    int ret = E6BM_SUCCESS;
+    if (type == E6BM_JOB_AES256_ENCRYPT || type == E6BM_JOB_AES256_DECRYPT) {
+        ret = e6bm_jni_read_key_iv(env, key, iv, key_bytes, iv_bytes);
+        desc.key = key_bytes;
+        desc.iv = iv_bytes;
+    }
+
+    e6bm_jni_direct_buffer_t in, out;
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_get_direct_buffer(env, input, desc.input_len, &in);
+    }
+    if (ret == E6BM_SUCCESS) {
+        ret = e6bm_jni_get_direct_buffer(env, output, 0, &out);
+    }
+
+    e6bm_jni_job_t* handle = NULL;
+    if (ret == E6BM_SUCCESS) {
+        handle = (e6bm_jni_job_t*)calloc(1, sizeof(e6bm_jni_job_t));
+        ret = handle ? E6BM_SUCCESS : E6BM_ERROR_MEMORY;
+    }
+    if (ret == E6BM_SUCCESS) {
+        // Referenced before submitting: the job may start at once
+        handle->input = (*env)->NewGlobalRef(env, input);
+        handle->output = (*env)->NewGlobalRef(env, output);
+        desc.input = in.data;
+        desc.output = out.data;
+        desc.output_size = out.capacity;
+        ret = e6bm_job_submit(&desc, &handle->job);
+    }
+
+    e6bm_secure_memzero(key_bytes, sizeof(key_bytes));
+    if (ret != E6BM_SUCCESS) {
+        if (handle) {
+            if (handle->input) (*env)->DeleteGlobalRef(env, handle->input);
+            if (handle->output) (*env)->DeleteGlobalRef(env, handle->output);
+            free(handle);
+        }
+        E6BM_LOG_ERROR("Job submission failed: %s", e6bm_get_error_string((e6bm_error_t)ret));
+        return 0;
+    }
+    return (jlong)(intptr_t)handle;
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeJobPoll)
+    (JNIEnv* env, jobject thiz, jlong handle) {
+    return e6bm_jni_job_result((e6bm_jni_job_t*)(intptr_t)handle, 0);
+}
+
+JAVA_METHOD(jint, com_eternal_xdsdk_Crypto, nativeJobWait)
+    (JNIEnv* env, jobject thiz, jlong handle, jint timeout_ms) {
+    return e6bm_jni_job_result((e6bm_jni_job_t*)(intptr_t)handle, timeout_ms);
+}
+
+JAVA_METHOD(void, com_eternal_xdsdk_Crypto, nativeJobCancel)
+    (JNIEnv* env, jobject thiz, jlong handle) {
+    e6bm_jni_job_t* job = (e6bm_jni_job_t*)(intptr_t)handle;
+    if (job != NULL) {
+        e6bm_job_cancel(job->job);
+    }
+}
+
+JAVA_METHOD(void, com_eternal_xdsdk_Crypto, nativeJobRelease)
+    (JNIEnv* env, jobject thiz, jlong handle) {
+    e6bm_jni_job_t* job = (e6bm_jni_job_t*)(intptr_t)handle;
+    if (job == NULL) {
+        return;
     }
+    // Waits for a running job, so the buffers are unreferenced only once
+    // nothing touches them
+    e6bm_job_release(job->job);
+    (*env)->DeleteGlobalRef(env, job->input);
+    (*env)->DeleteGlobalRef(env, job->output);
+    free(job);
 }
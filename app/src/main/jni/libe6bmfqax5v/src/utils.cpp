@@ -4,13 +4,13 @@
 
 #include "../include/utils.h"
 #include "../include/e6bmfqax5v.h"
+#include "common/trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
 #include <sys/time.h>
 #include <unistd.h>
-#include <android/log.h>
 
 #define TAG "libe6bmfqax5v-utils"
 
@@ -24,6 +24,7 @@ static e6bm_log_level_t g_log_level = E6BM_LOG_LEVEL_INFO;
 int e6bm_zlib_compress_data(const uint8_t* input, size_t input_len,
                             uint8_t* output, size_t* output_len,
                             int level) {
+    COMMON_TRACE_FUNCTION();
     if (input == NULL || output == NULL || output_len == NULL) {
         return E6BM_ERROR_INVALID_PARAM;
     }
@@ -53,6 +54,7 @@ int e6bm_zlib_compress_data(const uint8_t* input, size_t input_len,
 
 int e6bm_zlib_decompress_data(const uint8_t* input, size_t input_len,
                               uint8_t* output, size_t* output_len) {
+    COMMON_TRACE_FUNCTION();
     if (input == NULL || output == NULL || output_len == NULL) {
         return E6BM_ERROR_INVALID_PARAM;
     }
@@ -144,40 +146,25 @@ void e6bm_log(e6bm_log_level_t level, const char* fmt, ...) {
         return;
     }
     
-    va_list args;
-    va_start(args, fmt);
-    
     int priority;
     switch (level) {
-        case E6BM_LOG_LEVEL_ERROR: priority = ANDROID_LOG_ERROR; break;
-        case E6BM_LOG_LEVEL_WARN:  priority = ANDROID_LOG_WARN;  break;
-        case E6BM_LOG_LEVEL_INFO:  priority = ANDROID_LOG_INFO;  break;
-        case E6BM_LOG_LEVEL_DEBUG: priority = ANDROID_LOG_DEBUG; break;
-        case E6BM_LOG_LEVEL_TRACE: priority = ANDROID_LOG_VERBOSE; break;
-        default: priority = ANDROID_LOG_INFO; break;
+        case E6BM_LOG_LEVEL_ERROR: priority = COMMON_LOG_ERROR; break;
+        case E6BM_LOG_LEVEL_WARN:  priority = COMMON_LOG_WARN;  break;
+        case E6BM_LOG_LEVEL_INFO:  priority = COMMON_LOG_INFO;  break;
+        case E6BM_LOG_LEVEL_DEBUG: priority = COMMON_LOG_DEBUG; break;
+        case E6BM_LOG_LEVEL_TRACE: priority = COMMON_LOG_VERBOSE; break;
+        default: priority = COMMON_LOG_INFO; break;
     }
     
-    __android_log_vprint(priority, TAG, fmt, args);
+    va_list args;
+    va_start(args, fmt);
+    common_logv(priority, TAG, fmt, args);
     va_end(args);
 }
 
 void e6bm_hexdump(const void* data, size_t size, const char* label) {
-    const uint8_t* bytes = (const uint8_t*)data;
-    
-    __android_log_print(ANDROID_LOG_DEBUG, TAG, "=== %s (%zu bytes) ===", label, size);
-    
-    for (size_t i = 0; i < size; i += 16) {
-        char line[128];
-        char* p = line;
-        
-        p += sprintf(p, "%04zx: ", i);
-        
-        for (size_t j = 0; j < 16 && i + j < size; j++) {
-            p += sprintf(p, "%02x ", bytes[i + j]);
-        }
-        
-        __android_log_print(ANDROID_LOG_DEBUG, TAG, "%s", line);
-    }
+    // Bytes are copied now and formatted on the logging thread
+    common_log_hexdump(COMMON_LOG_DEBUG, TAG, label, data, size);
 }
 
 // ============================================================================
@@ -228,6 +215,9 @@ const char* e6bm_get_error_string(e6bm_error_t error) {
         case E6BM_ERROR_IO: return "I/O error";
         case E6BM_ERROR_NOT_INITIALIZED: return "Library not initialized";
         case E6BM_ERROR_ALREADY_INITIALIZED: return "Already initialized";
+        case E6BM_ERROR_CANCELLED: return "Operation cancelled";
+        case E6BM_ERROR_IN_PROGRESS: return "Operation still in progress";
+        case E6BM_ERROR_BUSY: return "Job queue full";
         default: return "Unknown error";
     }
 }
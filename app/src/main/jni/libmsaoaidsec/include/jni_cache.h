@@ -0,0 +1,62 @@
+#ifndef LIBMSAOAIDSEC_JNI_CACHE_H
+#define LIBMSAOAIDSEC_JNI_CACHE_H
+
+#include <jni.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Classes (global refs) and member IDs resolved once in JNI_OnLoad.
+// Vendor OAID SDK entries are optional and stay null when the SDK is absent.
+typedef struct JniCache {
+    jclass activity_thread;
+    jmethodID activity_thread_current;
+    jmethodID activity_thread_get_application;
+
+    jclass context;
+    jmethodID context_get_content_resolver;
+    jmethodID context_get_package_manager;
+
+    jclass package_manager;
+    jmethodID package_manager_get_package_info;
+
+    jclass settings_secure;
+    jmethodID settings_secure_get_string;
+
+    jclass build;
+    jfieldID build_serial;
+
+    jclass xiaomi_id_provider;
+    jmethodID xiaomi_get_oaid;
+
+    jclass huawei_ad_client;
+    jmethodID huawei_get_info;
+    jclass huawei_info;
+    jmethodID huawei_info_get_id;
+
+    jclass oppo_id_manager;
+    jmethodID oppo_get_oaid;
+
+    jclass vivo_id_manager;
+    jmethodID vivo_get_oaid;
+
+    jclass google_ad_client;
+    jmethodID google_get_info;
+    jclass google_info;
+    jmethodID google_info_get_id;
+} JniCache;
+
+// Returns false if a required (framework) entry could not be resolved;
+// every missing entry is logged once here rather than on each use
+bool jni_cache_init(JNIEnv* env);
+void jni_cache_release(JNIEnv* env);
+
+const JniCache* jni_cache();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBMSAOAIDSEC_JNI_CACHE_H
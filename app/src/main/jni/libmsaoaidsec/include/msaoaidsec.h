@@ -12,6 +12,7 @@
 #include "device_id.h"
 #include "oaid_interface.h"
 #include "jni_interface.h"
+#include "jni_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -6,6 +6,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "common/log.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,10 +65,19 @@ jstring get_static_string_field_safe(JNIEnv* env, jclass clazz, jfieldID field);
 uint64_t get_current_timestamp_ms();
 void sleep_ms(uint32_t ms);
 
-void log_debug(const char* tag, const char* fmt, ...);
-void log_info(const char* tag, const char* fmt, ...);
-void log_warn(const char* tag, const char* fmt, ...);
-void log_error(const char* tag, const char* fmt, ...);
+// Queued to the shared logging thread (common/log.h); fmt must be a literal
+void log_debug(const char* tag, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+void log_info(const char* tag, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+void log_warn(const char* tag, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+void log_error(const char* tag, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// Calls below COMMON_LOG_MIN_LEVEL compile away, arguments included
+#define MSA_LOG_AT(level, fn, ...) \
+    do { if (COMMON_LOG_COMPILED(level)) (fn)(__VA_ARGS__); } while (0)
+#define log_debug(...) MSA_LOG_AT(COMMON_LOG_DEBUG, log_debug, __VA_ARGS__)
+#define log_info(...)  MSA_LOG_AT(COMMON_LOG_INFO, log_info, __VA_ARGS__)
+#define log_warn(...)  MSA_LOG_AT(COMMON_LOG_WARN, log_warn, __VA_ARGS__)
+#define log_error(...) MSA_LOG_AT(COMMON_LOG_ERROR, log_error, __VA_ARGS__)
 
 char* trim_whitespace(char* str);
 void to_lowercase(char* str);
@@ -7,51 +7,25 @@ static DeviceInfo* g_cached_device_info = nullptr;
 char* get_android_id(JNIEnv* env, jobject context) {
     if (!env || !context) return nullptr;
     
-    jclass settings_secure_class = find_class_safe(env, SETTINGS_SECURE_CLASS);
-    if (!settings_secure_class) {
-        log_error(LOG_TAG, "Failed to find Settings.Secure class");
+    const JniCache* cache = jni_cache();
+    if (!cache->settings_secure_get_string || !cache->context_get_content_resolver) {
         return nullptr;
     }
     
-    jmethodID get_string_method = get_static_method_id_safe(env, settings_secure_class,
-                                                             JAVA_METHOD_GET_STRING,
-                                                             "(Landroid/content/ContentResolver;Ljava/lang/String;)Ljava/lang/String;");
-    if (!get_string_method) {
-        log_error(LOG_TAG, "Failed to find getString method");
-        env->DeleteLocalRef(settings_secure_class);
-        return nullptr;
-    }
-    
-    jclass context_class = env->GetObjectClass(context);
-    jmethodID get_content_resolver = get_method_id_safe(env, context_class,
-                                                         "getContentResolver",
-                                                         "()Landroid/content/ContentResolver;");
-    
-    if (!get_content_resolver) {
-        log_error(LOG_TAG, "Failed to find getContentResolver method");
-        env->DeleteLocalRef(settings_secure_class);
-        env->DeleteLocalRef(context_class);
-        return nullptr;
-    }
-    
-    jobject content_resolver = env->CallObjectMethod(context, get_content_resolver);
+    jobject content_resolver = env->CallObjectMethod(context, cache->context_get_content_resolver);
     if (!content_resolver) {
         log_error(LOG_TAG, "Failed to get ContentResolver");
-        env->DeleteLocalRef(settings_secure_class);
-        env->DeleteLocalRef(context_class);
         return nullptr;
     }
     
     jstring android_id_key = env->NewStringUTF(ANDROID_ID_SECURE_SETTINGS);
-    jstring android_id_jstr = (jstring)env->CallStaticObjectMethod(settings_secure_class,
-                                                                     get_string_method,
+    jstring android_id_jstr = (jstring)env->CallStaticObjectMethod(cache->settings_secure,
+                                                                     cache->settings_secure_get_string,
                                                                      content_resolver,
                                                                      android_id_key);
     
     env->DeleteLocalRef(android_id_key);
     env->DeleteLocalRef(content_resolver);
-    env->DeleteLocalRef(context_class);
-    env->DeleteLocalRef(settings_secure_class);
     
     if (!android_id_jstr) {
         log_error(LOG_TAG, "Failed to get Android ID");
@@ -90,18 +64,10 @@ char* get_imei(JNIEnv* env, jobject context) {
 }
 
 char* get_serial_number(JNIEnv* env, jobject context) {
-    jclass build_class = find_class_safe(env, JAVA_CLASS_BUILD);
-    if (!build_class) return nullptr;
-    
-    jfieldID serial_field = get_static_field_id_safe(env, build_class, "SERIAL", "Ljava/lang/String;");
-    if (!serial_field) {
-        env->DeleteLocalRef(build_class);
-        return nullptr;
-    }
-    
-    jstring serial_jstr = (jstring)env->GetStaticObjectField(build_class, serial_field);
-    env->DeleteLocalRef(build_class);
+    const JniCache* cache = jni_cache();
+    if (!env || !cache->build_serial) return nullptr;
     
+    jstring serial_jstr = (jstring)env->GetStaticObjectField(cache->build, cache->build_serial);
     if (!serial_jstr) return nullptr;
     
     char* serial = jstring_to_string(env, serial_jstr);
@@ -0,0 +1,169 @@
+#include "msaoaidsec.h"
+#include <stddef.h>
+#include <string.h>
+
+// Resolved from JNI_OnLoad on purpose: FindClass there searches the class
+// loader of the class that loaded the library, so SDK classes bundled in
+// the APK are visible. From other native threads only the boot class path
+// would be searched.
+
+static JniCache g_cache;
+
+namespace {
+
+enum MemberKind {
+    MEMBER_METHOD,
+    MEMBER_STATIC_METHOD,
+    MEMBER_STATIC_FIELD
+};
+
+struct ClassEntry {
+    size_t offset;
+    const char* name;
+    bool optional;
+};
+
+struct MemberEntry {
+    size_t offset;
+    size_t class_offset;
+    MemberKind kind;
+    const char* name;
+    const char* signature;
+};
+
+#define CACHE_CLASS(field, name, optional) { offsetof(JniCache, field), name, optional }
+#define CACHE_MEMBER(field, owner, kind, name, signature) \
+    { offsetof(JniCache, field), offsetof(JniCache, owner), kind, name, signature }
+
+const ClassEntry kClasses[] = {
+    CACHE_CLASS(activity_thread, JAVA_CLASS_ACTIVITY_THREAD, false),
+    CACHE_CLASS(context, JAVA_CLASS_CONTEXT, false),
+    CACHE_CLASS(package_manager, "android/content/pm/PackageManager", false),
+    CACHE_CLASS(settings_secure, SETTINGS_SECURE_CLASS, false),
+    CACHE_CLASS(build, JAVA_CLASS_BUILD, false),
+    CACHE_CLASS(xiaomi_id_provider, "com/android/id/impl/IdProviderImpl", true),
+    CACHE_CLASS(huawei_ad_client, "com/huawei/hms/ads/identifier/AdvertisingIdClient", true),
+    CACHE_CLASS(huawei_info, "com/huawei/hms/ads/identifier/AdvertisingIdClient$Info", true),
+    CACHE_CLASS(oppo_id_manager, "com/heytap/openid/sdk/IdentifierManager", true),
+    CACHE_CLASS(vivo_id_manager, "com/vivo/identifier/IdentifierManager", true),
+    CACHE_CLASS(google_ad_client, "com/google/android/gms/ads/identifier/AdvertisingIdClient", true),
+    CACHE_CLASS(google_info, "com/google/android/gms/ads/identifier/AdvertisingIdClient$Info", true),
+};
+
+const MemberEntry kMembers[] = {
+    CACHE_MEMBER(activity_thread_current, activity_thread, MEMBER_STATIC_METHOD,
+                 JAVA_METHOD_CURRENT_APPLICATION_THREAD, JAVA_SIGNATURE_CURRENT_ACTIVITY_THREAD),
+    CACHE_MEMBER(activity_thread_get_application, activity_thread, MEMBER_METHOD,
+                 JAVA_METHOD_GET_APPLICATION, JAVA_SIGNATURE_GET_APPLICATION),
+    CACHE_MEMBER(context_get_content_resolver, context, MEMBER_METHOD,
+                 "getContentResolver", "()Landroid/content/ContentResolver;"),
+    CACHE_MEMBER(context_get_package_manager, context, MEMBER_METHOD,
+                 "getPackageManager", "()Landroid/content/pm/PackageManager;"),
+    CACHE_MEMBER(package_manager_get_package_info, package_manager, MEMBER_METHOD,
+                 "getPackageInfo", "(Ljava/lang/String;I)Landroid/content/pm/PackageInfo;"),
+    CACHE_MEMBER(settings_secure_get_string, settings_secure, MEMBER_STATIC_METHOD,
+                 JAVA_METHOD_GET_STRING,
+                 "(Landroid/content/ContentResolver;Ljava/lang/String;)Ljava/lang/String;"),
+    CACHE_MEMBER(build_serial, build, MEMBER_STATIC_FIELD, "SERIAL", "Ljava/lang/String;"),
+    CACHE_MEMBER(xiaomi_get_oaid, xiaomi_id_provider, MEMBER_STATIC_METHOD,
+                 "getOAID", "(Landroid/content/Context;)Ljava/lang/String;"),
+    CACHE_MEMBER(huawei_get_info, huawei_ad_client, MEMBER_STATIC_METHOD,
+                 "getAdvertisingIdInfo",
+                 "(Landroid/content/Context;)Lcom/huawei/hms/ads/identifier/AdvertisingIdClient$Info;"),
+    CACHE_MEMBER(huawei_info_get_id, huawei_info, MEMBER_METHOD,
+                 "getId", "()Ljava/lang/String;"),
+    CACHE_MEMBER(oppo_get_oaid, oppo_id_manager, MEMBER_STATIC_METHOD,
+                 "getOAID", "(Landroid/content/Context;)Ljava/lang/String;"),
+    CACHE_MEMBER(vivo_get_oaid, vivo_id_manager, MEMBER_STATIC_METHOD,
+                 "getOAID", "(Landroid/content/Context;)Ljava/lang/String;"),
+    CACHE_MEMBER(google_get_info, google_ad_client, MEMBER_STATIC_METHOD,
+                 "getAdvertisingIdInfo",
+                 "(Landroid/content/Context;)Lcom/google/android/gms/ads/identifier/AdvertisingIdClient$Info;"),
+    CACHE_MEMBER(google_info_get_id, google_info, MEMBER_METHOD,
+                 "getId", "()Ljava/lang/String;"),
+};
+
+#undef CACHE_CLASS
+#undef CACHE_MEMBER
+
+template <typename T>
+T& slot(size_t offset) {
+    return *reinterpret_cast<T*>(reinterpret_cast<char*>(&g_cache) + offset);
+}
+
+bool is_optional_class(size_t class_offset) {
+    for (const ClassEntry& entry : kClasses) {
+        if (entry.offset == class_offset) return entry.optional;
+    }
+    return false;
+}
+
+} // namespace
+
+bool jni_cache_init(JNIEnv* env) {
+    if (!env) return false;
+    
+    bool complete = true;
+    
+    for (const ClassEntry& entry : kClasses) {
+        jclass local = find_class_safe(env, entry.name);
+        if (!local) {
+            if (entry.optional) {
+                log_debug(LOG_TAG, "Optional class not present: %s", entry.name);
+            } else {
+                log_error(LOG_TAG, "Failed to resolve class %s", entry.name);
+                complete = false;
+            }
+            continue;
+        }
+        slot<jclass>(entry.offset) = (jclass)env->NewGlobalRef(local);
+        env->DeleteLocalRef(local);
+    }
+    
+    for (const MemberEntry& entry : kMembers) {
+        jclass clazz = slot<jclass>(entry.class_offset);
+        if (!clazz) continue;   // Already reported with its class
+        
+        bool found = false;
+        switch (entry.kind) {
+            case MEMBER_METHOD:
+                slot<jmethodID>(entry.offset) =
+                    get_method_id_safe(env, clazz, entry.name, entry.signature);
+                found = slot<jmethodID>(entry.offset) != nullptr;
+                break;
+            case MEMBER_STATIC_METHOD:
+                slot<jmethodID>(entry.offset) =
+                    get_static_method_id_safe(env, clazz, entry.name, entry.signature);
+                found = slot<jmethodID>(entry.offset) != nullptr;
+                break;
+            case MEMBER_STATIC_FIELD:
+                slot<jfieldID>(entry.offset) =
+                    get_static_field_id_safe(env, clazz, entry.name, entry.signature);
+                found = slot<jfieldID>(entry.offset) != nullptr;
+                break;
+        }
+        
+        if (!found) {
+            if (is_optional_class(entry.class_offset)) {
+                log_debug(LOG_TAG, "Optional member not present: %s%s", entry.name, entry.signature);
+            } else {
+                log_error(LOG_TAG, "Failed to resolve member %s%s", entry.name, entry.signature);
+                complete = false;
+            }
+        }
+    }
+    
+    return complete;
+}
+
+void jni_cache_release(JNIEnv* env) {
+    for (const ClassEntry& entry : kClasses) {
+        jclass& clazz = slot<jclass>(entry.offset);
+        if (clazz && env) env->DeleteGlobalRef(clazz);
+    }
+    memset(&g_cache, 0, sizeof(g_cache));
+}
+
+const JniCache* jni_cache() {
+    return &g_cache;
+}
@@ -12,6 +12,11 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
         return JNI_ERR;
     }
     
+    // Missing entries are logged once here; call sites then just check for null
+    if (!jni_cache_init(env)) {
+        log_warn(LOG_TAG, "Some framework classes could not be resolved");
+    }
+    
     init_anti_debugging();
     init_anti_tampering();
     
@@ -23,48 +28,29 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
 void JNI_OnUnload(JavaVM* vm, void* reserved) {
     log_info(LOG_TAG, "libmsaoaidsec unloading");
     msaoaidsec_cleanup();
+    
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv((void**)&env, JNI_VERSION_1_6) != JNI_OK) env = nullptr;
+    jni_cache_release(env);
+    
     g_jvm = nullptr;
+    common_log_flush();
 }
 
 jobject get_application_context(JNIEnv* env) {
     if (!env) return nullptr;
     
-    jclass activity_thread_class = find_class_safe(env, JAVA_CLASS_ACTIVITY_THREAD);
-    if (!activity_thread_class) {
-        log_error(LOG_TAG, "Failed to find ActivityThread class");
-        return nullptr;
-    }
-    
-    jmethodID current_activity_thread = get_static_method_id_safe(env, activity_thread_class,
-                                                                   JAVA_METHOD_CURRENT_APPLICATION_THREAD,
-                                                                   JAVA_SIGNATURE_CURRENT_ACTIVITY_THREAD);
-    if (!current_activity_thread) {
-        log_error(LOG_TAG, "Failed to find currentActivityThread method");
-        env->DeleteLocalRef(activity_thread_class);
-        return nullptr;
-    }
+    const JniCache* cache = jni_cache();
+    if (!cache->activity_thread_get_application) return nullptr;
     
-    jobject activity_thread = env->CallStaticObjectMethod(activity_thread_class, current_activity_thread);
+    jobject activity_thread = get_current_activity_thread(env);
     if (!activity_thread) {
         log_error(LOG_TAG, "Failed to get ActivityThread instance");
-        env->DeleteLocalRef(activity_thread_class);
         return nullptr;
     }
     
-    jmethodID get_application = get_method_id_safe(env, activity_thread_class,
-                                                    JAVA_METHOD_GET_APPLICATION,
-                                                    JAVA_SIGNATURE_GET_APPLICATION);
-    if (!get_application) {
-        log_error(LOG_TAG, "Failed to find getApplication method");
-        env->DeleteLocalRef(activity_thread);
-        env->DeleteLocalRef(activity_thread_class);
-        return nullptr;
-    }
-    
-    jobject application = env->CallObjectMethod(activity_thread, get_application);
-    
+    jobject application = env->CallObjectMethod(activity_thread, cache->activity_thread_get_application);
     env->DeleteLocalRef(activity_thread);
-    env->DeleteLocalRef(activity_thread_class);
     
     return application;
 }
@@ -72,21 +58,10 @@ jobject get_application_context(JNIEnv* env) {
 jobject get_current_activity_thread(JNIEnv* env) {
     if (!env) return nullptr;
     
-    jclass activity_thread_class = find_class_safe(env, JAVA_CLASS_ACTIVITY_THREAD);
-    if (!activity_thread_class) return nullptr;
-    
-    jmethodID current_activity_thread = get_static_method_id_safe(env, activity_thread_class,
-                                                                   JAVA_METHOD_CURRENT_APPLICATION_THREAD,
-                                                                   JAVA_SIGNATURE_CURRENT_ACTIVITY_THREAD);
-    if (!current_activity_thread) {
-        env->DeleteLocalRef(activity_thread_class);
-        return nullptr;
-    }
-    
-    jobject activity_thread = env->CallStaticObjectMethod(activity_thread_class, current_activity_thread);
-    env->DeleteLocalRef(activity_thread_class);
+    const JniCache* cache = jni_cache();
+    if (!cache->activity_thread_current) return nullptr;
     
-    return activity_thread;
+    return env->CallStaticObjectMethod(cache->activity_thread, cache->activity_thread_current);
 }
 
 JNI_METHOD(jstring, DeviceInfo_getDeviceId)(JNIEnv* env, jobject thiz, jobject context) {
@@ -1,4 +1,5 @@
 #include "msaoaidsec.h"
+#include "common/trace.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -35,6 +36,7 @@ void set_application_context_cached(void* context) {
 }
 
 int msaoaidsec_init(JNIEnv* env, jobject context) {
+    COMMON_TRACE_FUNCTION();
     if (!env) {
         log_error(LOG_TAG, "Invalid JNIEnv");
         return ERROR_INVALID_ARGUMENT;
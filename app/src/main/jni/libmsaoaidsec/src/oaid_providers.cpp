@@ -57,81 +57,72 @@ const char* get_oaid_provider_name(OAIDProvider provider) {
     }
 }
 
-char* get_xiaomi_oaid(JNIEnv* env, jobject context) {
+// Vendor SDKs exposing a static String getOAID(Context)
+static char* call_static_get_oaid(JNIEnv* env, jobject context, jclass clazz,
+                                  jmethodID get_oaid_method, const char* vendor) {
     if (!env || !context) return nullptr;
     
-    jclass id_provider_class = find_class_safe(env, "com/android/id/impl/IdProviderImpl");
-    if (!id_provider_class) {
-        log_debug(LOG_TAG, "Xiaomi OAID service not available");
+    if (!get_oaid_method) {
+        log_debug(LOG_TAG, "%s OAID service not available", vendor);
         return nullptr;
     }
     
-    jmethodID get_oaid_method = get_static_method_id_safe(env, id_provider_class,
-                                                           "getOAID",
-                                                           "(Landroid/content/Context;)Ljava/lang/String;");
-    if (!get_oaid_method) {
-        env->DeleteLocalRef(id_provider_class);
+    jstring oaid_jstr = (jstring)env->CallStaticObjectMethod(clazz, get_oaid_method, context);
+    if (check_jni_exception(env)) {
+        clear_jni_exception(env);
         return nullptr;
     }
-    
-    jstring oaid_jstr = (jstring)env->CallStaticObjectMethod(id_provider_class, get_oaid_method, context);
-    env->DeleteLocalRef(id_provider_class);
-    
     if (!oaid_jstr) return nullptr;
     
     char* oaid = jstring_to_string(env, oaid_jstr);
     env->DeleteLocalRef(oaid_jstr);
     
-    log_info(LOG_TAG, "Retrieved Xiaomi OAID: %s", oaid ? oaid : "null");
+    log_info(LOG_TAG, "Retrieved %s OAID: %s", vendor, oaid ? oaid : "null");
     return oaid;
 }
 
-char* get_huawei_oaid(JNIEnv* env, jobject context) {
+// Vendor SDKs exposing AdvertisingIdClient.getAdvertisingIdInfo(Context).getId()
+static char* call_advertising_id_client(JNIEnv* env, jobject context, jclass clazz,
+                                        jmethodID get_info_method, jmethodID get_id_method,
+                                        const char* vendor) {
     if (!env || !context) return nullptr;
     
-    jclass oaid_client_class = find_class_safe(env, "com/huawei/hms/ads/identifier/AdvertisingIdClient");
-    if (!oaid_client_class) {
-        log_debug(LOG_TAG, "Huawei OAID service not available");
+    if (!get_info_method || !get_id_method) {
+        log_debug(LOG_TAG, "%s advertising ID service not available", vendor);
         return nullptr;
     }
     
-    jmethodID get_advertising_id_info = get_static_method_id_safe(env, oaid_client_class,
-                                                                   "getAdvertisingIdInfo",
-                                                                   "(Landroid/content/Context;)Lcom/huawei/hms/ads/identifier/AdvertisingIdClient$Info;");
-    if (!get_advertising_id_info) {
-        env->DeleteLocalRef(oaid_client_class);
-        return nullptr;
-    }
-    
-    jobject info = env->CallStaticObjectMethod(oaid_client_class, get_advertising_id_info, context);
+    jobject info = env->CallStaticObjectMethod(clazz, get_info_method, context);
     if (!info || check_jni_exception(env)) {
         clear_jni_exception(env);
-        env->DeleteLocalRef(oaid_client_class);
         return nullptr;
     }
     
-    jclass info_class = env->GetObjectClass(info);
-    jmethodID get_id = get_method_id_safe(env, info_class, "getId", "()Ljava/lang/String;");
-    
-    if (!get_id) {
-        env->DeleteLocalRef(info);
-        env->DeleteLocalRef(info_class);
-        env->DeleteLocalRef(oaid_client_class);
+    jstring id_jstr = (jstring)env->CallObjectMethod(info, get_id_method);
+    env->DeleteLocalRef(info);
+    if (check_jni_exception(env)) {
+        clear_jni_exception(env);
         return nullptr;
     }
+    if (!id_jstr) return nullptr;
     
-    jstring oaid_jstr = (jstring)env->CallObjectMethod(info, get_id);
-    env->DeleteLocalRef(info);
-    env->DeleteLocalRef(info_class);
-    env->DeleteLocalRef(oaid_client_class);
-    
-    if (!oaid_jstr) return nullptr;
+    char* id = jstring_to_string(env, id_jstr);
+    env->DeleteLocalRef(id_jstr);
     
-    char* oaid = jstring_to_string(env, oaid_jstr);
-    env->DeleteLocalRef(oaid_jstr);
-    
-    log_info(LOG_TAG, "Retrieved Huawei OAID: %s", oaid ? oaid : "null");
-    return oaid;
+    log_info(LOG_TAG, "Retrieved %s advertising ID: %s", vendor, id ? id : "null");
+    return id;
+}
+
+char* get_xiaomi_oaid(JNIEnv* env, jobject context) {
+    const JniCache* cache = jni_cache();
+    return call_static_get_oaid(env, context, cache->xiaomi_id_provider,
+                                cache->xiaomi_get_oaid, "Xiaomi");
+}
+
+char* get_huawei_oaid(JNIEnv* env, jobject context) {
+    const JniCache* cache = jni_cache();
+    return call_advertising_id_client(env, context, cache->huawei_ad_client,
+                                      cache->huawei_get_info, cache->huawei_info_get_id, "Huawei");
 }
 
 char* get_samsung_oaid(JNIEnv* env, jobject context) {
@@ -141,61 +132,15 @@ char* get_samsung_oaid(JNIEnv* env, jobject context) {
 }
 
 char* get_oppo_oaid(JNIEnv* env, jobject context) {
-    if (!env || !context) return nullptr;
-    
-    jclass oaid_manager_class = find_class_safe(env, "com/heytap/openid/sdk/IdentifierManager");
-    if (!oaid_manager_class) {
-        log_debug(LOG_TAG, "Oppo OAID service not available");
-        return nullptr;
-    }
-    
-    jmethodID get_oaid_method = get_static_method_id_safe(env, oaid_manager_class,
-                                                           "getOAID",
-                                                           "(Landroid/content/Context;)Ljava/lang/String;");
-    if (!get_oaid_method) {
-        env->DeleteLocalRef(oaid_manager_class);
-        return nullptr;
-    }
-    
-    jstring oaid_jstr = (jstring)env->CallStaticObjectMethod(oaid_manager_class, get_oaid_method, context);
-    env->DeleteLocalRef(oaid_manager_class);
-    
-    if (!oaid_jstr) return nullptr;
-    
-    char* oaid = jstring_to_string(env, oaid_jstr);
-    env->DeleteLocalRef(oaid_jstr);
-    
-    log_info(LOG_TAG, "Retrieved Oppo OAID: %s", oaid ? oaid : "null");
-    return oaid;
+    const JniCache* cache = jni_cache();
+    return call_static_get_oaid(env, context, cache->oppo_id_manager,
+                                cache->oppo_get_oaid, "Oppo");
 }
 
 char* get_vivo_oaid(JNIEnv* env, jobject context) {
-    if (!env || !context) return nullptr;
-    
-    jclass oaid_manager_class = find_class_safe(env, "com/vivo/identifier/IdentifierManager");
-    if (!oaid_manager_class) {
-        log_debug(LOG_TAG, "Vivo OAID service not available");
-        return nullptr;
-    }
-    
-    jmethodID get_oaid_method = get_static_method_id_safe(env, oaid_manager_class,
-                                                           "getOAID",
-                                                           "(Landroid/content/Context;)Ljava/lang/String;");
-    if (!get_oaid_method) {
-        env->DeleteLocalRef(oaid_manager_class);
-        return nullptr;
-    }
-    
-    jstring oaid_jstr = (jstring)env->CallStaticObjectMethod(oaid_manager_class, get_oaid_method, context);
-    env->DeleteLocalRef(oaid_manager_class);
-    
-    if (!oaid_jstr) return nullptr;
-    
-    char* oaid = jstring_to_string(env, oaid_jstr);
-    env->DeleteLocalRef(oaid_jstr);
-    
-    log_info(LOG_TAG, "Retrieved Vivo OAID: %s", oaid ? oaid : "null");
-    return oaid;
+    const JniCache* cache = jni_cache();
+    return call_static_get_oaid(env, context, cache->vivo_id_manager,
+                                cache->vivo_get_oaid, "Vivo");
 }
 
 char* get_oneplus_oaid(JNIEnv* env, jobject context) {
@@ -221,51 +166,9 @@ char* get_lenovo_oaid(JNIEnv* env, jobject context) {
 }
 
 char* get_google_advertising_id(JNIEnv* env, jobject context) {
-    if (!env || !context) return nullptr;
-    
-    jclass advertising_id_client_class = find_class_safe(env, "com/google/android/gms/ads/identifier/AdvertisingIdClient");
-    if (!advertising_id_client_class) {
-        log_debug(LOG_TAG, "Google Advertising ID service not available");
-        return nullptr;
-    }
-    
-    jmethodID get_advertising_id_info = get_static_method_id_safe(env, advertising_id_client_class,
-                                                                   "getAdvertisingIdInfo",
-                                                                   "(Landroid/content/Context;)Lcom/google/android/gms/ads/identifier/AdvertisingIdClient$Info;");
-    if (!get_advertising_id_info) {
-        env->DeleteLocalRef(advertising_id_client_class);
-        return nullptr;
-    }
-    
-    jobject info = env->CallStaticObjectMethod(advertising_id_client_class, get_advertising_id_info, context);
-    if (!info || check_jni_exception(env)) {
-        clear_jni_exception(env);
-        env->DeleteLocalRef(advertising_id_client_class);
-        return nullptr;
-    }
-    
-    jclass info_class = env->GetObjectClass(info);
-    jmethodID get_id = get_method_id_safe(env, info_class, "getId", "()Ljava/lang/String;");
-    
-    if (!get_id) {
-        env->DeleteLocalRef(info);
-        env->DeleteLocalRef(info_class);
-        env->DeleteLocalRef(advertising_id_client_class);
-        return nullptr;
-    }
-    
-    jstring ad_id_jstr = (jstring)env->CallObjectMethod(info, get_id);
-    env->DeleteLocalRef(info);
-    env->DeleteLocalRef(info_class);
-    env->DeleteLocalRef(advertising_id_client_class);
-    
-    if (!ad_id_jstr) return nullptr;
-    
-    char* ad_id = jstring_to_string(env, ad_id_jstr);
-    env->DeleteLocalRef(ad_id_jstr);
-    
-    log_info(LOG_TAG, "Retrieved Google Advertising ID: %s", ad_id ? ad_id : "null");
-    return ad_id;
+    const JniCache* cache = jni_cache();
+    return call_advertising_id_client(env, context, cache->google_ad_client,
+                                      cache->google_get_info, cache->google_info_get_id, "Google");
 }
 
 char* get_oaid_by_provider(JNIEnv* env, jobject context, OAIDProvider provider) {
@@ -337,40 +240,20 @@ bool is_limit_ad_tracking_enabled(JNIEnv* env, jobject context) {
 bool check_oaid_service_available(JNIEnv* env, jobject context, const char* package_name) {
     if (!env || !context || !package_name) return false;
     
-    jclass context_class = env->GetObjectClass(context);
-    jmethodID get_package_manager = get_method_id_safe(env, context_class,
-                                                        "getPackageManager",
-                                                        "()Landroid/content/pm/PackageManager;");
-    if (!get_package_manager) {
-        env->DeleteLocalRef(context_class);
-        return false;
-    }
-    
-    jobject package_manager = env->CallObjectMethod(context, get_package_manager);
-    if (!package_manager) {
-        env->DeleteLocalRef(context_class);
+    const JniCache* cache = jni_cache();
+    if (!cache->context_get_package_manager || !cache->package_manager_get_package_info) {
         return false;
     }
     
-    jclass package_manager_class = env->GetObjectClass(package_manager);
-    jmethodID get_package_info = get_method_id_safe(env, package_manager_class,
-                                                     "getPackageInfo",
-                                                     "(Ljava/lang/String;I)Landroid/content/pm/PackageInfo;");
-    
-    if (!get_package_info) {
-        env->DeleteLocalRef(package_manager);
-        env->DeleteLocalRef(package_manager_class);
-        env->DeleteLocalRef(context_class);
-        return false;
-    }
+    jobject package_manager = env->CallObjectMethod(context, cache->context_get_package_manager);
+    if (!package_manager) return false;
     
     jstring package_name_jstr = env->NewStringUTF(package_name);
-    jobject package_info = env->CallObjectMethod(package_manager, get_package_info, package_name_jstr, 0);
+    jobject package_info = env->CallObjectMethod(package_manager, cache->package_manager_get_package_info,
+                                                 package_name_jstr, 0);
     
     env->DeleteLocalRef(package_name_jstr);
     env->DeleteLocalRef(package_manager);
-    env->DeleteLocalRef(package_manager_class);
-    env->DeleteLocalRef(context_class);
     
     bool available = package_info != nullptr && !check_jni_exception(env);
     
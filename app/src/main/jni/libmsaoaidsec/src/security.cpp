@@ -1,4 +1,5 @@
 #include "msaoaidsec.h"
+#include "common/trace.h"
 #include <sys/ptrace.h>
 #include <sys/wait.h>
 #include <sys/prctl.h>
@@ -55,6 +56,7 @@ bool detect_debugger_via_timing() {
 }
 
 bool detect_debugger() {
+    COMMON_TRACE_FUNCTION();
     if (detect_debugger_via_tracerpid()) {
         log_warn(LOG_TAG, "Debugger detected via TracerPid");
         return true;
@@ -141,6 +143,7 @@ bool detect_root_via_system_properties() {
 }
 
 bool detect_root() {
+    COMMON_TRACE_FUNCTION();
     if (detect_root_via_su_binary()) return true;
     if (detect_root_via_superuser_apk()) return true;
     if (detect_root_via_build_tags()) return true;
@@ -254,6 +257,7 @@ bool detect_emulator_via_hardware() {
 }
 
 bool detect_emulator() {
+    COMMON_TRACE_FUNCTION();
     if (detect_emulator_via_files()) return true;
     if (detect_emulator_via_properties()) return true;
     if (detect_emulator_via_build_info()) return true;
@@ -276,6 +280,7 @@ bool detect_xposed_via_method_hooking() {
 }
 
 bool detect_xposed() {
+    COMMON_TRACE_FUNCTION();
     char* maps = read_file(MAPS_PATH);
     if (!maps) return false;
     
@@ -354,6 +359,7 @@ bool detect_frida_via_maps() {
 }
 
 bool detect_frida() {
+    COMMON_TRACE_FUNCTION();
     if (detect_frida_via_library()) return true;
     if (detect_frida_via_thread()) return true;
     if (detect_frida_via_port()) return true;
@@ -429,6 +435,7 @@ SecurityCheckResult* perform_full_security_check(JNIEnv* env, jobject context) {
 }
 
 bool is_running_in_secure_environment(JNIEnv* env, jobject context) {
+    COMMON_TRACE_FUNCTION();
     SecurityCheckResult* result = perform_full_security_check(env, context);
     if (!result) return false;
     
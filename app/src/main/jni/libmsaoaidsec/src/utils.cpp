@@ -1,4 +1,6 @@
 #include "msaoaidsec.h"
+#include "common/trace.h"
+#include "common/jni_string.h"
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -6,8 +8,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <dirent.h>
-#include <android/log.h>
 #include <stdarg.h>
+#include <errno.h>
 #include <ctype.h>
 #include <time.h>
 #include <sys/time.h>
@@ -46,30 +48,51 @@ bool directory_exists(const char* path) {
 }
 
 char* read_file(const char* path) {
-    if (!path || !file_exists(path)) return nullptr;
-    
-    FILE* fp = fopen(path, "r");
-    if (!fp) return nullptr;
-    
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-    
-    if (size <= 0 || size > MAX_PATH_LENGTH * 10) {
-        fclose(fp);
-        return nullptr;
+    COMMON_TRACE_FUNCTION();
+    if (!path) return nullptr;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+
+    // Read straight into the returned buffer. Regular files are sized from
+    // fstat; procfs files report size 0 (and can change between calls), so
+    // the buffer grows until read() hits EOF either way
+    struct stat st;
+    size_t capacity = 4096;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        // NUL plus one spare byte, so the read that sees EOF needs no grow
+        capacity = (size_t)st.st_size + 2;
     }
-    
-    char* buffer = (char*)malloc(size + 1);
-    if (!buffer) {
-        fclose(fp);
+
+    char* buffer = (char*)malloc(capacity);
+    size_t length = 0;
+    while (buffer) {
+        if (length + 1 == capacity) {
+            char* grown = (char*)realloc(buffer, capacity * 2);
+            if (!grown) {
+                free(buffer);
+                buffer = nullptr;
+                break;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, buffer + length, capacity - 1 - length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            free(buffer);
+            buffer = nullptr;
+        }
+        if (n <= 0) break;
+        length += (size_t)n;
+    }
+    close(fd);
+
+    if (buffer && length == 0) {
+        free(buffer);
         return nullptr;
     }
-    
-    size_t read_size = fread(buffer, 1, size, fp);
-    buffer[read_size] = '\0';
-    fclose(fp);
-    
+    if (buffer) buffer[length] = '\0';
     return buffer;
 }
 
@@ -102,14 +125,21 @@ char* read_file_line(const char* path, const char* prefix) {
 
 int read_file_to_buffer(const char* path, char* buffer, size_t size) {
     if (!path || !buffer || size == 0) return -1;
-    
-    FILE* fp = fopen(path, "r");
-    if (!fp) return -1;
-    
-    size_t bytes_read = fread(buffer, 1, size - 1, fp);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // Small pseudo-files come back in one read; loop for anything longer
+    size_t bytes_read = 0;
+    while (bytes_read < size - 1) {
+        ssize_t n = read(fd, buffer + bytes_read, size - 1 - bytes_read);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        bytes_read += (size_t)n;
+    }
     buffer[bytes_read] = '\0';
-    fclose(fp);
-    
+    close(fd);
+
     return (int)bytes_read;
 }
 
@@ -244,17 +274,20 @@ bool is_thread_running(const char* thread_name) {
 char* jstring_to_string(JNIEnv* env, jstring jstr) {
     if (!env || !jstr) return nullptr;
     
-    const char* str = env->GetStringUTFChars(jstr, nullptr);
-    if (!str) return nullptr;
+    // One copy into the caller's buffer instead of a VM copy plus strdup
+    jsize len = env->GetStringUTFLength(jstr);
+    char* result = (char*)malloc((size_t)len + 1);
+    if (!result) return nullptr;
     
-    char* result = strdup(str);
-    env->ReleaseStringUTFChars(jstr, str);
+    env->GetStringUTFRegion(jstr, 0, env->GetStringLength(jstr), result);
+    result[len] = '\0';
     return result;
 }
 
 jstring string_to_jstring(JNIEnv* env, const char* str) {
     if (!env || !str) return nullptr;
-    return env->NewStringUTF(str);
+    // Property and file contents are not guaranteed to be modified UTF-8
+    return common::newStringUtf(env, str);
 }
 
 jbyteArray bytes_to_jbytearray(JNIEnv* env, const uint8_t* bytes, size_t len) {
@@ -354,31 +387,32 @@ void sleep_ms(uint32_t ms) {
     usleep(ms * 1000);
 }
 
-void log_debug(const char* tag, const char* fmt, ...) {
+// Parenthesized names bypass the level-guard macros in utils.h
+void (log_debug)(const char* tag, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    __android_log_vprint(ANDROID_LOG_DEBUG, tag ? tag : LOG_TAG, fmt, args);
+    common_logv(COMMON_LOG_DEBUG, tag ? tag : LOG_TAG, fmt, args);
     va_end(args);
 }
 
-void log_info(const char* tag, const char* fmt, ...) {
+void (log_info)(const char* tag, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    __android_log_vprint(ANDROID_LOG_INFO, tag ? tag : LOG_TAG, fmt, args);
+    common_logv(COMMON_LOG_INFO, tag ? tag : LOG_TAG, fmt, args);
     va_end(args);
 }
 
-void log_warn(const char* tag, const char* fmt, ...) {
+void (log_warn)(const char* tag, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    __android_log_vprint(ANDROID_LOG_WARN, tag ? tag : LOG_TAG, fmt, args);
+    common_logv(COMMON_LOG_WARN, tag ? tag : LOG_TAG, fmt, args);
     va_end(args);
 }
 
-void log_error(const char* tag, const char* fmt, ...) {
+void (log_error)(const char* tag, const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    __android_log_vprint(ANDROID_LOG_ERROR, tag ? tag : LOG_TAG, fmt, args);
+    common_logv(COMMON_LOG_ERROR, tag ? tag : LOG_TAG, fmt, args);
     va_end(args);
 }
 